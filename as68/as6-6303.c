@@ -45,6 +45,7 @@ SYM	sym[] = {
 	{	0,	".literal",	TSEGMENT,	LITERAL	},
 	{	0,	".commondata",	TSEGMENT,	COMMONDATA },
 	{	0,	".buffers",	TSEGMENT,	BUFFERS	},
+	{	0,	".stackinfo",	TSEGMENT,	STACKINFO },
 	{	0,	".setcpu",	TSETCPU,	XXXX	},
 
 	/* 0x0X		:	Implicit */
@@ -86,6 +86,7 @@ static uint16_t dot;			/* Working address as we link */
 static unsigned progress;		/* Did we make forward progress ?
 					   Used while library linking */
 static const char *segmentorder = "CLDBX";	/* Segment default order */
+static uint16_t stacksize;		/* Stack available for check removal */
 
 static FILE *relocf;
 
@@ -874,6 +875,417 @@ static uint16_t target_get(struct object *o, uint16_t size)
 	}
 }
 
+/*
+ *	Stack depth analysis
+ *
+ *	The compiler puts a record for each stack checked function into the
+ *	STACKINFO segment. This is never loaded. Each record is a sequence of
+ *	words
+ *
+ *		function address
+ *		bytes the function itself uses including its return address
+ *		number of stack check calls
+ *		addresses of the stkchk/cstkchk calls
+ *		number of callees, top bit set if it also calls indirectly
+ *		callee addresses
+ *
+ *	From this we work out the worst case depth below each function and
+ *	report it in the map. Given a stack size (-k) we also work out the
+ *	worst case depth at which each function reachable from main can be
+ *	entered, and where the whole lot provably fits the stack checks in
+ *	that function are turned into a harmless instruction as we write the
+ *	code out.
+ */
+
+#define SF_INDIRECT	0x8000		/* In the callee count */
+
+#define SF_ACTIVE	1		/* On the walk stack */
+#define SF_DONE		2		/* Depth computed */
+#define SF_UNBOUNDED	4		/* No limit can be proved */
+#define SF_RECURSIVE	8		/* Reached from itself */
+#define SF_UNKNOWN	16		/* Calls code with no information */
+#define SF_REACHED	32		/* Reachable from main */
+#define SF_DEEP		64		/* Entry depth cannot be proved */
+#define SF_SAFE		128		/* Checks removed */
+
+/* Runtime helpers and assembler routines without records are leaves that
+   are assumed to need no more than this below their caller's frame */
+#define HELPER_STACK	16
+
+#define DEPTH_MAX	0xFFFF
+
+struct stackfunc {
+	uint16_t addr;
+	uint16_t frame;
+	uint16_t ncheck;
+	uint16_t *check;
+	uint16_t ncall;
+	uint16_t *call;
+	uint16_t depth;
+	uint16_t entry;
+	uint8_t flags;
+	struct symbol *name;
+};
+
+static struct stackfunc *stackfunc;	/* Sorted by address */
+static unsigned nstackfunc;
+static uint16_t *stackpatch;		/* Check calls to remove, sorted */
+static unsigned nstackpatch;
+static uint16_t *nextpatch;		/* Next one we will meet */
+
+/*
+ *	Read a word from the stack information of an object, relocating
+ *	it as we go. Returns 0 at the end of the segment.
+ */
+static int stack_word(struct object *o, uint16_t *v)
+{
+	uint8_t c[2];
+	uint8_t code;
+	struct symbol *s;
+	unsigned r;
+	int i;
+
+	for (i = 0; i < 2; i++) {
+		c[i] = target_pgetb();
+		if (c[i] != REL_ESC)
+			continue;
+		code = target_pgetb();
+		/* An escaped 0xDA byte */
+		if (code == REL_REL)
+			continue;
+		if (i == 0 && code == REL_EOF)
+			return 0;
+		if (i || ((code & S_SIZE) >> 4) != 1)
+			error("corrupt stack information");
+		if (code & REL_SIMPLE) {
+			*v = target_get(o, 2) + o->base[code & S_SEGMENT];
+			return 1;
+		}
+		if ((code & REL_TYPE) != REL_SYMBOL)
+			error("corrupt stack information");
+		r = io_read16();
+		if (r >= o->nsym)
+			error("invalid reloc sym");
+		s = o->syment[r];
+		*v = target_get(o, 2);
+		/* Undefined symbols are reported when the code is written */
+		if (s->type & S_UNKNOWN)
+			*v = 0;
+		else
+			*v += s->value;
+		return 1;
+	}
+	if (o->oh->o_flags & OF_BIGENDIAN)
+		*v = (c[0] << 8) | c[1];
+	else
+		*v = c[0] | (c[1] << 8);
+	return 1;
+}
+
+static uint16_t stack_get(struct object *o)
+{
+	uint16_t v;
+	if (stack_word(o, &v) == 0)
+		error("corrupt stack information");
+	return v;
+}
+
+/*
+ *	Load the stack records of every object. Must be called once the
+ *	segment bases are known.
+ */
+static void load_stack_info(void)
+{
+	struct object *o;
+	struct stackfunc *f;
+	unsigned space = 0;
+	uint16_t v;
+	unsigned i;
+
+	for (o = objects; o != NULL; o = o->next) {
+		openobject(o);
+		if (o->oh->o_size[STACKINFO]) {
+			processing = o;
+			io_lseek(o->off + o->oh->o_segbase[STACKINFO]);
+			while (stack_word(o, &v)) {
+				if (nstackfunc == space) {
+					space = space ? space * 2 : 32;
+					stackfunc = realloc(stackfunc, space * sizeof(struct stackfunc));
+					if (stackfunc == NULL)
+						error("out of memory");
+				}
+				f = stackfunc + nstackfunc++;
+				memset(f, 0, sizeof(*f));
+				f->addr = v;
+				f->frame = stack_get(o);
+				f->ncheck = stack_get(o);
+				f->check = xmalloc(f->ncheck * sizeof(uint16_t) + 1);
+				for (i = 0; i < f->ncheck; i++)
+					f->check[i] = stack_get(o);
+				f->ncall = stack_get(o);
+				f->call = xmalloc((f->ncall & ~SF_INDIRECT) * sizeof(uint16_t) + 1);
+				for (i = 0; i < (f->ncall & ~SF_INDIRECT); i++)
+					f->call[i] = stack_get(o);
+			}
+			processing = NULL;
+		}
+		put_object(o);
+		io_close();
+	}
+}
+
+static int stack_compare(const void *a, const void *b)
+{
+	const struct stackfunc *fa = a;
+	const struct stackfunc *fb = b;
+	return (int)fa->addr - (int)fb->addr;
+}
+
+static struct stackfunc *stack_find(uint16_t addr)
+{
+	struct stackfunc key;
+	key.addr = addr;
+	if (nstackfunc == 0)
+		return NULL;
+	return bsearch(&key, stackfunc, nstackfunc, sizeof(struct stackfunc), stack_compare);
+}
+
+/*
+ *	Worst case stack use of a function and everything it calls
+ */
+static uint16_t stack_depth(struct stackfunc *f)
+{
+	struct stackfunc *g;
+	unsigned long below = HELPER_STACK;
+	unsigned i;
+
+	if (f->flags & SF_DONE)
+		return f->depth;
+	/* Calling something that is already on the walk is recursion */
+	if (f->flags & SF_ACTIVE) {
+		f->flags |= SF_RECURSIVE | SF_UNBOUNDED;
+		return DEPTH_MAX;
+	}
+	f->flags |= SF_ACTIVE;
+	if (f->ncall & SF_INDIRECT)
+		f->flags |= SF_UNBOUNDED;
+	for (i = 0; i < (f->ncall & ~SF_INDIRECT); i++) {
+		g = stack_find(f->call[i]);
+		if (g == NULL) {
+			f->flags |= SF_UNKNOWN;
+			continue;
+		}
+		if (stack_depth(g) == DEPTH_MAX)
+			f->flags |= SF_UNBOUNDED;
+		else if (g->depth > below)
+			below = g->depth;
+	}
+	f->flags &= ~SF_ACTIVE;
+	f->flags |= SF_DONE;
+	if (f->flags & SF_UNBOUNDED || below + f->frame >= DEPTH_MAX)
+		f->depth = DEPTH_MAX;
+	else
+		f->depth = below + f->frame;
+	return f->depth;
+}
+
+static void stack_reach(struct stackfunc *f)
+{
+	struct stackfunc *g;
+	unsigned i;
+
+	if (f->flags & SF_REACHED)
+		return;
+	f->flags |= SF_REACHED;
+	for (i = 0; i < (f->ncall & ~SF_INDIRECT); i++) {
+		g = stack_find(f->call[i]);
+		if (g)
+			stack_reach(g);
+	}
+}
+
+static void stack_deep(struct stackfunc *f)
+{
+	struct stackfunc *g;
+	unsigned i;
+
+	if (f->flags & SF_DEEP)
+		return;
+	f->flags |= SF_DEEP;
+	for (i = 0; i < (f->ncall & ~SF_INDIRECT); i++) {
+		g = stack_find(f->call[i]);
+		if (g)
+			stack_deep(g);
+	}
+}
+
+/*
+ *	Work out how deep into the stack each function reachable from main
+ *	can be entered. This is the longest path to it from main, so we
+ *	relax the entry depths until they settle. Anything still moving after
+ *	one pass per function is in or below recursion and has no limit.
+ */
+static void stack_entry(struct stackfunc *root)
+{
+	struct stackfunc *f, *g;
+	unsigned long e;
+	unsigned pass, n, i;
+	int changed = 1;
+
+	stack_reach(root);
+	for (pass = 0; pass <= nstackfunc && changed; pass++) {
+		changed = 0;
+		for (n = 0; n < nstackfunc; n++) {
+			f = stackfunc + n;
+			if (!(f->flags & SF_REACHED))
+				continue;
+			e = (unsigned long)f->entry + f->frame;
+			if (e >= DEPTH_MAX)
+				e = DEPTH_MAX;
+			for (i = 0; i < (f->ncall & ~SF_INDIRECT); i++) {
+				g = stack_find(f->call[i]);
+				if (g && g->entry < e) {
+					g->entry = e;
+					if (pass == nstackfunc)
+						stack_deep(g);
+					changed = 1;
+				}
+			}
+		}
+	}
+}
+
+static int patch_compare(const void *a, const void *b)
+{
+	return (int)*(const uint16_t *)a - (int)*(const uint16_t *)b;
+}
+
+/*
+ *	Analyse the call graph and decide which checks can go
+ */
+static void stack_analysis(void)
+{
+	struct stackfunc *f, *root = NULL;
+	struct symbol *s;
+	unsigned n, i = 0;
+	int indirect = 0;
+
+	load_stack_info();
+	if (nstackfunc == 0)
+		return;
+	qsort(stackfunc, nstackfunc, sizeof(struct stackfunc), stack_compare);
+
+	/* Name the records from the code symbols */
+	for (n = 0; n < NHASH; n++) {
+		for (s = symhash[n]; s != NULL; s = s->next) {
+			if ((s->type & (S_UNKNOWN | S_SEGMENT)) != CODE)
+				continue;
+			f = stack_find(s->value);
+			if (f && f->name == NULL)
+				f->name = s;
+			if (strncmp(s->name, "_main", NAMELEN) == 0)
+				root = f;
+		}
+	}
+	for (n = 0; n < nstackfunc; n++)
+		stack_depth(stackfunc + n);
+
+	if (stacksize == 0 || root == NULL || ldmode == LD_RFLAG)
+		return;
+
+	stack_entry(root);
+	/* An indirect call could enter anything at any depth */
+	for (n = 0; n < nstackfunc; n++) {
+		f = stackfunc + n;
+		if ((f->flags & SF_REACHED) && (f->ncall & SF_INDIRECT))
+			indirect = 1;
+	}
+	if (indirect) {
+		if (verbose)
+			printf("Indirect calls: not removing stack checks.\n");
+		return;
+	}
+	/* We only know how to rewrite the 6800 family calls */
+	if (arch != OA_6800)
+		return;
+	for (n = 0; n < nstackfunc; n++)
+		i += stackfunc[n].ncheck;
+	stackpatch = xmalloc(i * sizeof(uint16_t) + 1);
+	for (n = 0; n < nstackfunc; n++) {
+		f = stackfunc + n;
+		if ((f->flags & (SF_REACHED | SF_DEEP)) != SF_REACHED ||
+			f->depth == DEPTH_MAX ||
+			(unsigned long)f->entry + f->depth > stacksize)
+			continue;
+		f->flags |= SF_SAFE;
+		for (i = 0; i < f->ncheck; i++)
+			stackpatch[nstackpatch++] = f->check[i];
+	}
+	if (nstackpatch) {
+		qsort(stackpatch, nstackpatch, sizeof(uint16_t), patch_compare);
+		nextpatch = stackpatch;
+	}
+	if (verbose)
+		printf("Removing %d stack checks.\n", nstackpatch);
+}
+
+/*
+ *	We have reached a stack check call we proved unnecessary. Turn the
+ *	jsr into a cpx # which skips the address, and a jmp into a return.
+ */
+static uint8_t stack_patch(uint8_t code)
+{
+	if (code == 0xBD)		/* jsr */
+		code = 0x8C;		/* cpx # */
+	else if (code == 0x7E)		/* jmp */
+		code = 0x39;		/* rts */
+	else
+		error("stack check call expected");
+	if (++nextpatch == stackpatch + nstackpatch)
+		nextpatch = NULL;
+	return code;
+}
+
+/*
+ *	Append the stack analysis to the map file
+ */
+static void write_stack_map(FILE *fp)
+{
+	struct stackfunc *f;
+	unsigned n;
+
+	if (nstackfunc == 0)
+		return;
+	fprintf(fp, "\nFrame Depth Entry Function\n");
+	for (n = 0; n < nstackfunc; n++) {
+		f = stackfunc + n;
+		fprintf(fp, " %04X ", f->frame);
+		if (f->depth == DEPTH_MAX)
+			fprintf(fp, " ----");
+		else
+			fprintf(fp, " %04X", f->depth);
+		if (!(f->flags & SF_REACHED))
+			fprintf(fp, "      ");
+		else if (f->flags & SF_DEEP)
+			fprintf(fp, "  ----");
+		else
+			fprintf(fp, "  %04X", f->entry);
+		if (f->name)
+			fprintf(fp, " %.*s", NAMELEN, f->name->name);
+		else
+			fprintf(fp, " %04X", f->addr);
+		if (f->flags & SF_RECURSIVE)
+			fprintf(fp, " recursive");
+		if (f->ncall & SF_INDIRECT)
+			fprintf(fp, " indirect");
+		if (f->flags & SF_UNKNOWN)
+			fprintf(fp, " calls-unknown");
+		if (f->flags & SF_SAFE)
+			fprintf(fp, " unchecked");
+		fputc('\n', fp);
+	}
+}
+
 static void record_reloc(struct object *o, unsigned high, unsigned size, unsigned seg, uint16_t addr)
 {
 	if (!relocf)
@@ -935,6 +1347,8 @@ static void relocate_stream(struct object *o, int segment, FILE * op)
 
 		/* Unescaped material is just copied over */
 		if (code != REL_ESC) {
+			if (nextpatch && dot == *nextpatch && segment == CODE)
+				code = stack_patch(code);
 			fputc(code, op);
 			dot++;
 			continue;
@@ -1204,13 +1618,14 @@ static void write_binary(FILE * op, FILE *mp)
 	/* Absolute images may contain things other than code/data/bss */
 	if (ldmode == LD_ABSOLUTE) {
 		for (i = 4; i < OSEG; i++) {
-			write_stream(op, i);
+			if (i != STACKINFO)
+				write_stream(op, i);
 		}
 	}
 	else {
 		/* ZP is ok in Fuzix but is not initialized in a defined way */
 		for (i = ldmode == LD_FUZIX ? 5 : 4; i < OSEG; i++) {
-			if (i != LITERAL && size[i]) {
+			if (i != LITERAL && i != STACKINFO && size[i]) {
 				fprintf(stderr, "Unsupported data in non-standard segment %d.\n", i);
 				break;
 			}
@@ -1319,7 +1734,7 @@ int main(int argc, char *argv[])
 
 	arg0 = argv[0];
 
-	while ((opt = getopt(argc, argv, "rbvtsiu:o:m:f:R:A:B:C:D:S:X:Z:8:")) != -1) {
+	while ((opt = getopt(argc, argv, "rbvtsiu:o:m:f:k:R:A:B:C:D:S:X:Z:8:")) != -1) {
 		switch (opt) {
 		case 'r':
 			ldmode = LD_RFLAG;
@@ -1352,6 +1767,9 @@ int main(int argc, char *argv[])
 		case 'f':
 			segmentorder = optarg;
 			break;
+		case 'k':	/* Stack available to main */
+			stacksize = xstrtoul(optarg);
+			break;
 		case 'R':
 			relocf = xfopen(optarg, "w");
 			break;
@@ -1430,6 +1848,9 @@ int main(int argc, char *argv[])
 	if (verbose)
 		printf("Computing memory map.\n");
 	set_segment_bases();
+	if (verbose)
+		printf("Analysing stack use.\n");
+	stack_analysis();
 	if (verbose)
 		printf("Writing output.\n");
 
@@ -1439,6 +1860,7 @@ int main(int argc, char *argv[])
 		if (verbose)
 			printf("Writing map file.\n");
 		write_map_file(mp);
+		write_stack_map(mp);
 		fclose(mp);
 	}
 	write_binary(bp,mp);
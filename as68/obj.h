@@ -148,7 +148,8 @@ struct objhdr
 #define LITERAL		7		/* Literals (mostly a compiler helper) */
 #define COMMONDATA	8		/* Common for writables */
 #define BUFFERS		9		/* Buffers for kernel */
-/* Special cases 10+ don't exist as real segments */
+#define STACKINFO	10		/* Compiler stack usage, read by ld */
+/* Special cases 11+ don't exist as real segments */
 #define PCREL		14		/* assumed signed */
 /* and 15 is 'any' */
 
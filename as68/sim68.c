@@ -0,0 +1,1138 @@
+/*
+ *	sim68: run a binary from ld68 on a simulated 6800, 6803 or 6303 and
+ *	count the clock cycles it takes.
+ *
+ *	The instruction decode is built from the assembler opcode table in
+ *	as6-6303.c so the two cannot disagree about what an opcode is. The
+ *	cycle counts are per CPU and also say which opcodes that CPU has.
+ *
+ *	The program sees 64K of RAM apart from a 16 byte trap page, by
+ *	default at $FF00, which provides
+ *
+ *	+0	write: put a character on stdout, read: get one from stdin
+ *	+1	read: non zero once stdin has reached end of file
+ *	+2	write: exit with this status
+ *	+3	write: 1 starts and 0 stops the timed cycle count
+ *	+4-7	read: the cycle count, latched when +4 is read
+ *
+ *	The stack starts just below the trap page holding a return address
+ *	in it, so returning from the entry point also ends the run with the
+ *	status in B. The internal registers of the 6803/6303 are not
+ *	simulated, nor are interrupts or Fuzix system calls.
+ *
+ *	Given the ld68 map file the cycles are also charged to the code
+ *	symbol at or below each instruction, giving a flat profile.
+ *
+ *	With -d the whole 64K of memory is written to a file at the end of
+ *	the run, which is what cc68 --profile-use reads its counters from.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <stdint.h>
+
+#include "as.h"
+
+static const uint8_t cycles6800[256] = {
+	 0,  2,  0,  0,  0,  0,  2,  2,  4,  4,  2,  2,  2,  2,  2,  2,	/* 00 */
+	 2,  2,  0,  0,  0,  0,  2,  2,  0,  2,  0,  2,  0,  0,  0,  0,	/* 10 */
+	 4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,	/* 20 */
+	 4,  4,  4,  4,  4,  4,  4,  4,  0,  5,  0, 10,  0,  0,  9, 12,	/* 30 */
+	 2,  0,  0,  2,  2,  0,  2,  2,  2,  2,  2,  0,  2,  2,  0,  2,	/* 40 */
+	 2,  0,  0,  2,  2,  0,  2,  2,  2,  2,  2,  0,  2,  2,  0,  2,	/* 50 */
+	 7,  0,  0,  7,  7,  0,  7,  7,  7,  7,  7,  0,  7,  7,  4,  7,	/* 60 */
+	 6,  0,  0,  6,  6,  0,  6,  6,  6,  6,  6,  0,  6,  6,  3,  6,	/* 70 */
+	 2,  2,  2,  0,  2,  2,  2,  0,  2,  2,  2,  2,  3,  8,  3,  0,	/* 80 */
+	 3,  3,  3,  0,  3,  3,  3,  4,  3,  3,  3,  3,  4,  0,  4,  5,	/* 90 */
+	 5,  5,  5,  0,  5,  5,  5,  6,  5,  5,  5,  5,  6,  8,  6,  7,	/* A0 */
+	 4,  4,  4,  0,  4,  4,  4,  5,  4,  4,  4,  4,  5,  9,  5,  6,	/* B0 */
+	 2,  2,  2,  0,  2,  2,  2,  0,  2,  2,  2,  2,  0,  0,  3,  0,	/* C0 */
+	 3,  3,  3,  0,  3,  3,  3,  4,  3,  3,  3,  3,  0,  0,  4,  5,	/* D0 */
+	 5,  5,  5,  0,  5,  5,  5,  6,  5,  5,  5,  5,  0,  0,  6,  7,	/* E0 */
+	 4,  4,  4,  0,  4,  4,  4,  5,  4,  4,  4,  4,  0,  0,  5,  6,	/* F0 */
+};
+
+static const uint8_t cycles6803[256] = {
+	 0,  2,  0,  0,  3,  3,  2,  2,  3,  3,  2,  2,  2,  2,  2,  2,	/* 00 */
+	 2,  2,  0,  0,  0,  0,  2,  2,  0,  2,  0,  2,  0,  0,  0,  0,	/* 10 */
+	 3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,	/* 20 */
+	 3,  3,  4,  4,  3,  3,  3,  3,  5,  5,  3, 10,  4, 10,  9, 12,	/* 30 */
+	 2,  0,  0,  2,  2,  0,  2,  2,  2,  2,  2,  0,  2,  2,  0,  2,	/* 40 */
+	 2,  0,  0,  2,  2,  0,  2,  2,  2,  2,  2,  0,  2,  2,  0,  2,	/* 50 */
+	 6,  0,  0,  6,  6,  0,  6,  6,  6,  6,  6,  0,  6,  6,  3,  6,	/* 60 */
+	 6,  0,  0,  6,  6,  0,  6,  6,  6,  6,  6,  0,  6,  6,  3,  6,	/* 70 */
+	 2,  2,  2,  4,  2,  2,  2,  0,  2,  2,  2,  2,  4,  6,  3,  0,	/* 80 */
+	 3,  3,  3,  5,  3,  3,  3,  3,  3,  3,  3,  3,  5,  5,  4,  4,	/* 90 */
+	 4,  4,  4,  6,  4,  4,  4,  4,  4,  4,  4,  4,  6,  6,  5,  5,	/* A0 */
+	 4,  4,  4,  6,  4,  4,  4,  4,  4,  4,  4,  4,  6,  6,  5,  5,	/* B0 */
+	 2,  2,  2,  4,  2,  2,  2,  0,  2,  2,  2,  2,  3,  0,  3,  0,	/* C0 */
+	 3,  3,  3,  5,  3,  3,  3,  3,  3,  3,  3,  3,  4,  4,  4,  4,	/* D0 */
+	 4,  4,  4,  6,  4,  4,  4,  4,  4,  4,  4,  4,  5,  5,  5,  5,	/* E0 */
+	 4,  4,  4,  6,  4,  4,  4,  4,  4,  4,  4,  4,  5,  5,  5,  5,	/* F0 */
+};
+
+static const uint8_t cycles6303[256] = {
+	 0,  1,  0,  0,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,	/* 00 */
+	 1,  1,  0,  0,  0,  0,  1,  1,  2,  2,  4,  1,  0,  0,  0,  0,	/* 10 */
+	 3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,	/* 20 */
+	 1,  1,  3,  3,  1,  1,  4,  4,  4,  5,  1, 10,  5,  7,  9, 12,	/* 30 */
+	 1,  0,  0,  1,  1,  0,  1,  1,  1,  1,  1,  0,  1,  1,  0,  1,	/* 40 */
+	 1,  0,  0,  1,  1,  0,  1,  1,  1,  1,  1,  0,  1,  1,  0,  1,	/* 50 */
+	 6,  7,  7,  6,  6,  7,  6,  6,  6,  6,  6,  5,  6,  4,  3,  5,	/* 60 */
+	 6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  4,  6,  4,  3,  5,	/* 70 */
+	 2,  2,  2,  3,  2,  2,  2,  0,  2,  2,  2,  2,  3,  5,  3,  0,	/* 80 */
+	 3,  3,  3,  4,  3,  3,  3,  3,  3,  3,  3,  3,  4,  5,  4,  4,	/* 90 */
+	 4,  4,  4,  5,  4,  4,  4,  4,  4,  4,  4,  4,  5,  5,  5,  5,	/* A0 */
+	 4,  4,  4,  5,  4,  4,  4,  4,  4,  4,  4,  4,  5,  6,  5,  5,	/* B0 */
+	 2,  2,  2,  3,  2,  2,  2,  0,  2,  2,  2,  2,  3,  0,  3,  0,	/* C0 */
+	 3,  3,  3,  4,  3,  3,  3,  3,  3,  3,  3,  3,  4,  4,  4,  4,	/* D0 */
+	 4,  4,  4,  5,  4,  4,  4,  4,  4,  4,  4,  4,  5,  5,  5,  5,	/* E0 */
+	 4,  4,  4,  5,  4,  4,  4,  4,  4,  4,  4,  4,  5,  5,  5,  5,	/* F0 */
+};
+
+/* Addressing modes */
+#define M_NONE	0
+#define M_IMPL	1
+#define M_REL	2
+#define M_IMM	3
+#define M_IMM16	4
+#define M_DIR	5
+#define M_IDX	6
+#define M_EXT	7
+#define M_BDIR	8		/* 6303 aim #n,addr */
+#define M_BIDX	9		/* 6303 aim #n,off,x */
+
+static SYM *opsym[256];
+static uint8_t opmode[256];
+
+/* Condition codes */
+#define CC_H	0x20
+#define CC_I	0x10
+#define CC_N	0x08
+#define CC_Z	0x04
+#define CC_V	0x02
+#define CC_C	0x01
+
+#define CPU_6800	0
+#define CPU_6803	1
+#define CPU_6303	2
+
+static int cpu = CPU_6803;
+static const uint8_t *cyc = cycles6803;
+
+static uint8_t mem[65536];
+static uint8_t ra, rb, cc;
+static uint16_t rx, rs, pc;
+
+static uint64_t cycles;
+static uint64_t timed;
+static uint64_t timestart;
+static int timing;
+static uint32_t latched;
+static uint64_t limit;
+
+static uint16_t ioport = 0xFF00;
+static int halted;
+static int status;
+static int in_eof;
+static int trace;
+
+struct func {
+	uint16_t addr;
+	char *name;
+	uint64_t cycles;
+	unsigned long calls;
+};
+
+static struct func *funcs;
+static unsigned nfunc;
+static uint16_t *owner;		/* Function index + 1 for each address */
+
+static char *arg0;
+
+/*
+ *	The assembler table is only wanted for its contents, but
+ *	syminit() expects these from the rest of the assembler.
+ */
+SYM *phash[NHASH];
+
+int symhash(char *p)
+{
+	return (uint8_t)*p % NHASH;
+}
+
+void aerr(uint8_t n)
+{
+}
+
+static void setop(unsigned op, SYM *sp, uint8_t mode)
+{
+	/* Aliases share an opcode, keep the first name in the table */
+	if (opsym[op] == NULL || sp < opsym[op]) {
+		opsym[op] = sp;
+		opmode[op] = mode;
+	}
+}
+
+/*
+ *	Work out the addressing mode of each opcode from the
+ *	assembler tables
+ */
+static void build_decode(void)
+{
+	SYM *sp;
+	unsigned v;
+	int i;
+
+	syminit();
+	for (i = 0; i < NHASH; i++) {
+		for (sp = phash[i]; sp != NULL; sp = sp->s_fp) {
+			v = sp->s_value & 0xFF;
+			switch(sp->s_type & TMMODE) {
+			case TIMPL:
+			case TIMPL6803:
+			case TIMPL6303:
+				setop(v, sp, M_IMPL);
+				break;
+			case TREL8:
+				setop(v, sp, M_REL);
+				break;
+			case TXE:
+				setop(v, sp, M_IDX);
+				setop(v + 0x10, sp, M_EXT);
+				break;
+			case TDIXE:
+			case TDIXE3:
+				setop(v, sp, M_IMM);
+				/* Fall through */
+			case TDXE:
+			case TDXE3:
+				setop(v + 0x10, sp, M_DIR);
+				setop(v + 0x20, sp, M_IDX);
+				setop(v + 0x30, sp, M_EXT);
+				break;
+			case T16DIXE:
+			case T16DIXE3:
+				setop(v, sp, M_IMM16);
+				/* Fall through */
+			case T16DXE:
+			case T16DXE3:
+				setop(v + 0x10, sp, M_DIR);
+				setop(v + 0x20, sp, M_IDX);
+				setop(v + 0x30, sp, M_EXT);
+				break;
+			case TIDX6303:
+				setop(v, sp, M_BIDX);
+				setop(v + 0x10, sp, M_BDIR);
+				break;
+			}
+		}
+	}
+}
+
+/*
+ *	Memory and the trap page
+ */
+static uint8_t io_read(unsigned r)
+{
+	int c;
+
+	switch(r) {
+	case 0:
+		fflush(stdout);
+		c = getchar();
+		if (c == EOF) {
+			in_eof = 1;
+			return 0;
+		}
+		return c;
+	case 1:
+		return in_eof;
+	case 4:
+		latched = cycles;
+		return latched >> 24;
+	case 5:
+		return latched >> 16;
+	case 6:
+		return latched >> 8;
+	case 7:
+		return latched;
+	}
+	return 0xFF;
+}
+
+static void io_write(unsigned r, uint8_t v)
+{
+	switch(r) {
+	case 0:
+		putchar(v);
+		break;
+	case 2:
+		status = v;
+		halted = 1;
+		break;
+	case 3:
+		if (v && !timing)
+			timestart = cycles;
+		else if (!v && timing)
+			timed += cycles - timestart;
+		timing = v;
+		break;
+	}
+}
+
+static uint8_t rd(uint16_t addr)
+{
+	if ((addr & 0xFFF0) == ioport)
+		return io_read(addr & 0x0F);
+	return mem[addr];
+}
+
+static uint16_t rd16(uint16_t addr)
+{
+	return (rd(addr) << 8) | rd(addr + 1);
+}
+
+static void wr(uint16_t addr, uint8_t v)
+{
+	if ((addr & 0xFFF0) == ioport)
+		io_write(addr & 0x0F, v);
+	else
+		mem[addr] = v;
+}
+
+static void wr16(uint16_t addr, uint16_t v)
+{
+	wr(addr, v >> 8);
+	wr(addr + 1, v);
+}
+
+static uint8_t fetch(void)
+{
+	return rd(pc++);
+}
+
+static uint16_t fetch16(void)
+{
+	uint16_t v = rd16(pc);
+	pc += 2;
+	return v;
+}
+
+static void push(uint8_t v)
+{
+	wr(rs--, v);
+}
+
+static uint8_t pull(void)
+{
+	return rd(++rs);
+}
+
+static void push16(uint16_t v)
+{
+	push(v);
+	push(v >> 8);
+}
+
+static uint16_t pull16(void)
+{
+	uint16_t v = pull() << 8;
+	return v | pull();
+}
+
+/*
+ *	Flags
+ */
+static void nz8(uint8_t v)
+{
+	cc &= ~(CC_N | CC_Z | CC_V);
+	if (v & 0x80)
+		cc |= CC_N;
+	if (v == 0)
+		cc |= CC_Z;
+}
+
+static void nz16(uint16_t v)
+{
+	cc &= ~(CC_N | CC_Z | CC_V);
+	if (v & 0x8000)
+		cc |= CC_N;
+	if (v == 0)
+		cc |= CC_Z;
+}
+
+static uint8_t add8(uint8_t l, uint8_t r, int c)
+{
+	unsigned v = l + r + c;
+	nz8(v);
+	cc &= ~(CC_H | CC_C);
+	if ((l ^ r ^ v) & 0x10)
+		cc |= CC_H;
+	if (~(l ^ r) & (l ^ v) & 0x80)
+		cc |= CC_V;
+	if (v & 0x100)
+		cc |= CC_C;
+	return v;
+}
+
+static uint8_t sub8(uint8_t l, uint8_t r, int c)
+{
+	unsigned v = l - r - c;
+	nz8(v);
+	cc &= ~CC_C;
+	if ((l ^ r) & (l ^ v) & 0x80)
+		cc |= CC_V;
+	if (v & 0x100)
+		cc |= CC_C;
+	return v;
+}
+
+static uint16_t add16(uint16_t l, uint16_t r)
+{
+	uint32_t v = l + r;
+	nz16(v);
+	cc &= ~CC_C;
+	if (~(l ^ r) & (l ^ v) & 0x8000)
+		cc |= CC_V;
+	if (v & 0x10000)
+		cc |= CC_C;
+	return v;
+}
+
+static uint16_t sub16(uint16_t l, uint16_t r)
+{
+	uint32_t v = l - r;
+	nz16(v);
+	cc &= ~CC_C;
+	if ((l ^ r) & (l ^ v) & 0x8000)
+		cc |= CC_V;
+	if (v & 0x10000)
+		cc |= CC_C;
+	return v;
+}
+
+/* Set V to N ^ C as the shifts do */
+static void shiftv(void)
+{
+	cc &= ~CC_V;
+	if (!(cc & CC_N) != !(cc & CC_C))
+		cc |= CC_V;
+}
+
+/*
+ *	The read/modify/write group shared by A, B and memory
+ */
+static uint8_t rmw(unsigned op, uint8_t v)
+{
+	int c = cc & CC_C;
+
+	switch(op & 0x0F) {
+	case 0x0:	/* NEG */
+		return sub8(0, v, 0);
+	case 0x3:	/* COM */
+		v = ~v;
+		nz8(v);
+		cc |= CC_C;
+		return v;
+	case 0x4:	/* LSR */
+		cc = (cc & ~CC_C) | (v & 1);
+		v >>= 1;
+		nz8(v);
+		shiftv();
+		return v;
+	case 0x6:	/* ROR */
+		cc = (cc & ~CC_C) | (v & 1);
+		v = (v >> 1) | (c << 7);
+		nz8(v);
+		shiftv();
+		return v;
+	case 0x7:	/* ASR */
+		cc = (cc & ~CC_C) | (v & 1);
+		v = (v >> 1) | (v & 0x80);
+		nz8(v);
+		shiftv();
+		return v;
+	case 0x8:	/* ASL */
+		cc = (cc & ~CC_C) | (v >> 7);
+		v <<= 1;
+		nz8(v);
+		shiftv();
+		return v;
+	case 0x9:	/* ROL */
+		cc = (cc & ~CC_C) | (v >> 7);
+		v = (v << 1) | c;
+		nz8(v);
+		shiftv();
+		return v;
+	case 0xA:	/* DEC */
+		nz8(v - 1);
+		if (v == 0x80)
+			cc |= CC_V;
+		return v - 1;
+	case 0xC:	/* INC */
+		nz8(v + 1);
+		if (v == 0x7F)
+			cc |= CC_V;
+		return v + 1;
+	case 0xD:	/* TST */
+		nz8(v);
+		cc &= ~CC_C;
+		return v;
+	case 0xF:	/* CLR */
+		nz8(0);
+		cc &= ~CC_C;
+		return 0;
+	}
+	return v;
+}
+
+static int branch(unsigned op)
+{
+	int n = !!(cc & CC_N);
+	int z = !!(cc & CC_Z);
+	int v = !!(cc & CC_V);
+	int c = !!(cc & CC_C);
+	int r;
+
+	switch(op & 0x0E) {
+	case 0x0:
+		r = 1;
+		break;
+	case 0x2:
+		r = !(c | z);
+		break;
+	case 0x4:
+		r = !c;
+		break;
+	case 0x6:
+		r = !z;
+		break;
+	case 0x8:
+		r = !v;
+		break;
+	case 0xA:
+		r = !n;
+		break;
+	case 0xC:
+		r = !(n ^ v);
+		break;
+	default:
+		r = !(z | (n ^ v));
+		break;
+	}
+	/* Odd opcodes are the opposite test */
+	return (op & 1) ? !r : r;
+}
+
+static void daa(void)
+{
+	unsigned fix = 0;
+	unsigned v;
+
+	if ((cc & CC_H) || (ra & 0x0F) > 9)
+		fix |= 0x06;
+	if ((cc & CC_C) || ra > 0x99)
+		fix |= 0x60;
+	v = ra + fix;
+	ra = v;
+	nz8(ra);
+	if (v & 0x100)
+		cc |= CC_C;
+}
+
+static void call(uint16_t addr)
+{
+	push16(pc);
+	pc = addr;
+	if (owner && owner[addr] && funcs[owner[addr] - 1].addr == addr)
+		funcs[owner[addr] - 1].calls++;
+}
+
+static void show(uint16_t addr, uint8_t op)
+{
+	fprintf(stderr, "%04X %02X %-5s A:%02X B:%02X X:%04X S:%04X CC:%02X\n",
+		addr, op, opsym[op] ? opsym[op]->s_id : "???",
+		ra, rb, rx, rs, cc);
+}
+
+/*
+ *	Execute one instruction
+ */
+static void step(void)
+{
+	uint16_t addr = pc;
+	uint8_t op = fetch();
+	uint16_t ea = 0;
+	uint8_t imm = 0;
+	uint8_t *r;
+	uint16_t w;
+
+	if (cyc[op] == 0 || opmode[op] == M_NONE) {
+		fprintf(stderr, "%s: illegal instruction %02X at %04X.\n",
+			arg0, op, addr);
+		status = 255;
+		halted = 1;
+		return;
+	}
+	if (trace)
+		show(addr, op);
+
+	cycles += cyc[op];
+	if (owner && owner[addr])
+		funcs[owner[addr] - 1].cycles += cyc[op];
+
+	switch(opmode[op]) {
+	case M_REL:
+		imm = fetch();
+		ea = pc + (int8_t)imm;
+		break;
+	case M_IMM:
+		ea = pc++;
+		break;
+	case M_IMM16:
+		ea = pc;
+		pc += 2;
+		break;
+	case M_DIR:
+		ea = fetch();
+		break;
+	case M_IDX:
+		ea = rx + fetch();
+		break;
+	case M_EXT:
+		ea = fetch16();
+		break;
+	case M_BDIR:
+		imm = fetch();
+		ea = fetch();
+		break;
+	case M_BIDX:
+		imm = fetch();
+		ea = rx + fetch();
+		break;
+	}
+
+	if (op >= 0x80) {
+		r = (op & 0x40) ? &rb : &ra;
+		switch(op & 0x0F) {
+		case 0x0:	/* SUB */
+			*r = sub8(*r, rd(ea), 0);
+			break;
+		case 0x1:	/* CMP */
+			sub8(*r, rd(ea), 0);
+			break;
+		case 0x2:	/* SBC */
+			*r = sub8(*r, rd(ea), cc & CC_C);
+			break;
+		case 0x3:	/* SUBD / ADDD */
+			w = (ra << 8) | rb;
+			if (op & 0x40)
+				w = add16(w, rd16(ea));
+			else
+				w = sub16(w, rd16(ea));
+			ra = w >> 8;
+			rb = w;
+			break;
+		case 0x4:	/* AND */
+			*r &= rd(ea);
+			nz8(*r);
+			break;
+		case 0x5:	/* BIT */
+			nz8(*r & rd(ea));
+			break;
+		case 0x6:	/* LDA */
+			*r = rd(ea);
+			nz8(*r);
+			break;
+		case 0x7:	/* STA */
+			wr(ea, *r);
+			nz8(*r);
+			break;
+		case 0x8:	/* EOR */
+			*r ^= rd(ea);
+			nz8(*r);
+			break;
+		case 0x9:	/* ADC */
+			*r = add8(*r, rd(ea), cc & CC_C);
+			break;
+		case 0xA:	/* ORA */
+			*r |= rd(ea);
+			nz8(*r);
+			break;
+		case 0xB:	/* ADD */
+			*r = add8(*r, rd(ea), 0);
+			break;
+		case 0xC:
+			if (op & 0x40) {	/* LDD */
+				w = rd16(ea);
+				ra = w >> 8;
+				rb = w;
+				nz16(w);
+			} else if (cpu == CPU_6800) {
+				/* CPX only compares the high bytes properly */
+				w = rd16(ea);
+				imm = cc & CC_C;
+				sub8(rx >> 8, w >> 8, 0);
+				cc = (cc & ~(CC_Z | CC_C)) | imm;
+				if (rx == w)
+					cc |= CC_Z;
+			} else
+				sub16(rx, rd16(ea));
+			break;
+		case 0xD:
+			if (op & 0x40) {	/* STD */
+				w = (ra << 8) | rb;
+				wr16(ea, w);
+				nz16(w);
+			} else		/* BSR / JSR */
+				call(ea);
+			break;
+		case 0xE:	/* LDS / LDX */
+			w = rd16(ea);
+			if (op & 0x40)
+				rx = w;
+			else
+				rs = w;
+			nz16(w);
+			break;
+		case 0xF:	/* STS / STX */
+			w = (op & 0x40) ? rx : rs;
+			wr16(ea, w);
+			nz16(w);
+			break;
+		}
+		return;
+	}
+	if (op >= 0x60) {
+		switch(op & 0x0F) {
+		case 0x1:	/* AIM */
+			imm &= rd(ea);
+			wr(ea, imm);
+			nz8(imm);
+			break;
+		case 0x2:	/* OIM */
+			imm |= rd(ea);
+			wr(ea, imm);
+			nz8(imm);
+			break;
+		case 0x5:	/* EIM */
+			imm ^= rd(ea);
+			wr(ea, imm);
+			nz8(imm);
+			break;
+		case 0xB:	/* TIM */
+			nz8(imm & rd(ea));
+			break;
+		case 0xD:	/* TST */
+			rmw(op, rd(ea));
+			break;
+		case 0xE:	/* JMP */
+			pc = ea;
+			break;
+		default:
+			wr(ea, rmw(op, rd(ea)));
+			break;
+		}
+		return;
+	}
+	if (op >= 0x50) {
+		rb = rmw(op, rb);
+		return;
+	}
+	if (op >= 0x40) {
+		ra = rmw(op, ra);
+		return;
+	}
+	if (op >= 0x20 && op < 0x30) {
+		if (branch(op))
+			pc = ea;
+		return;
+	}
+	switch(op) {
+	case 0x01:	/* NOP */
+		break;
+	case 0x04:	/* LSRD */
+		w = (ra << 8) | rb;
+		cc = (cc & ~CC_C) | (w & 1);
+		w >>= 1;
+		goto setd;
+	case 0x05:	/* ASLD */
+		w = (ra << 8) | rb;
+		cc = (cc & ~CC_C) | (w >> 15);
+		w <<= 1;
+	setd:
+		ra = w >> 8;
+		rb = w;
+		nz16(w);
+		shiftv();
+		break;
+	case 0x06:	/* TAP */
+		cc = ra & 0x3F;
+		break;
+	case 0x07:	/* TPA */
+		ra = cc | 0xC0;
+		break;
+	case 0x08:	/* INX */
+		rx++;
+		goto zx;
+	case 0x09:	/* DEX */
+		rx--;
+	zx:
+		cc &= ~CC_Z;
+		if (rx == 0)
+			cc |= CC_Z;
+		break;
+	case 0x0A:
+		cc &= ~CC_V;
+		break;
+	case 0x0B:
+		cc |= CC_V;
+		break;
+	case 0x0C:
+		cc &= ~CC_C;
+		break;
+	case 0x0D:
+		cc |= CC_C;
+		break;
+	case 0x0E:
+		cc &= ~CC_I;
+		break;
+	case 0x0F:
+		cc |= CC_I;
+		break;
+	case 0x10:	/* SBA */
+		ra = sub8(ra, rb, 0);
+		break;
+	case 0x11:	/* CBA */
+		sub8(ra, rb, 0);
+		break;
+	case 0x16:	/* TAB */
+		rb = ra;
+		nz8(rb);
+		break;
+	case 0x17:	/* TBA */
+		ra = rb;
+		nz8(ra);
+		break;
+	case 0x18:	/* XGDX */
+		w = rx;
+		rx = (ra << 8) | rb;
+		ra = w >> 8;
+		rb = w;
+		break;
+	case 0x19:
+		daa();
+		break;
+	case 0x1A:	/* SLP */
+		fprintf(stderr, "%s: slp at %04X.\n", arg0, addr);
+		halted = 1;
+		break;
+	case 0x1B:	/* ABA */
+		ra = add8(ra, rb, 0);
+		break;
+	case 0x30:	/* TSX */
+		rx = rs + 1;
+		break;
+	case 0x31:	/* INS */
+		rs++;
+		break;
+	case 0x32:
+		ra = pull();
+		break;
+	case 0x33:
+		rb = pull();
+		break;
+	case 0x34:	/* DES */
+		rs--;
+		break;
+	case 0x35:	/* TXS */
+		rs = rx - 1;
+		break;
+	case 0x36:
+		push(ra);
+		break;
+	case 0x37:
+		push(rb);
+		break;
+	case 0x38:
+		rx = pull16();
+		break;
+	case 0x39:	/* RTS */
+		pc = pull16();
+		break;
+	case 0x3A:	/* ABX */
+		rx += rb;
+		break;
+	case 0x3B:	/* RTI */
+		cc = pull() & 0x3F;
+		rb = pull();
+		ra = pull();
+		rx = pull16();
+		pc = pull16();
+		break;
+	case 0x3C:
+		push16(rx);
+		break;
+	case 0x3D:	/* MUL */
+		w = ra * rb;
+		ra = w >> 8;
+		rb = w;
+		cc &= ~CC_C;
+		if (rb & 0x80)
+			cc |= CC_C;
+		break;
+	case 0x3E:	/* WAI */
+		fprintf(stderr, "%s: wai at %04X.\n", arg0, addr);
+		halted = 1;
+		break;
+	case 0x3F:	/* SWI */
+		push16(pc);
+		push16(rx);
+		push(ra);
+		push(rb);
+		push(cc);
+		cc |= CC_I;
+		pc = rd16(0xFFFA);
+		break;
+	}
+}
+
+/*
+ *	Map file handling for the profile
+ */
+static int funccmp(const void *a, const void *b)
+{
+	const struct func *fa = a, *fb = b;
+	return fa->addr - fb->addr;
+}
+
+static int cyclecmp(const void *a, const void *b)
+{
+	const struct func *fa = a, *fb = b;
+	if (fa->cycles == fb->cycles)
+		return 0;
+	return fa->cycles < fb->cycles ? 1 : -1;
+}
+
+static void load_map(const char *name)
+{
+	FILE *fp = fopen(name, "r");
+	char buf[128];
+	char sym[64];
+	unsigned addr;
+	char type;
+	unsigned i;
+	unsigned n;
+
+	if (fp == NULL) {
+		perror(name);
+		exit(1);
+	}
+	while (fgets(buf, sizeof(buf), fp)) {
+		if (sscanf(buf, "%x %c %63s", &addr, &type, sym) != 3)
+			continue;
+		if (type != 'C' && type != 'c')
+			continue;
+		funcs = realloc(funcs, (nfunc + 1) * sizeof(struct func));
+		if (funcs == NULL) {
+			fprintf(stderr, "%s: out of memory.\n", arg0);
+			exit(1);
+		}
+		memset(funcs + nfunc, 0, sizeof(struct func));
+		funcs[nfunc].addr = addr;
+		funcs[nfunc].name = strdup(sym);
+		nfunc++;
+	}
+	fclose(fp);
+	if (nfunc == 0)
+		return;
+	qsort(funcs, nfunc, sizeof(struct func), funccmp);
+	owner = calloc(65536, sizeof(uint16_t));
+	if (owner == NULL) {
+		fprintf(stderr, "%s: out of memory.\n", arg0);
+		exit(1);
+	}
+	/* Each address belongs to the last code symbol at or below it */
+	for (i = 0; i < nfunc; i++) {
+		unsigned end = i + 1 < nfunc ? funcs[i + 1].addr : 0x10000;
+		for (n = funcs[i].addr; n < end; n++)
+			owner[n] = i + 1;
+	}
+}
+
+static uint16_t find_symbol(const char *name)
+{
+	unsigned i;
+	for (i = 0; i < nfunc; i++)
+		if (strcmp(funcs[i].name, name) == 0)
+			return funcs[i].addr;
+	return 0;
+}
+
+static void report(FILE *fp)
+{
+	unsigned i;
+
+	fprintf(fp, "%llu cycles\n", (unsigned long long)cycles);
+	if (timed || timing)
+		fprintf(fp, "%llu timed cycles\n", (unsigned long long)
+			(timed + (timing ? cycles - timestart : 0)));
+	if (nfunc == 0)
+		return;
+	qsort(funcs, nfunc, sizeof(struct func), cyclecmp);
+	fprintf(fp, "\n%12s %6s %8s  %s\n", "cycles", "%", "calls", "function");
+	for (i = 0; i < nfunc; i++) {
+		if (funcs[i].cycles == 0)
+			break;
+		fprintf(fp, "%12llu %5.1f%% %8lu  %s\n",
+			(unsigned long long)funcs[i].cycles,
+			100.0 * funcs[i].cycles / cycles,
+			funcs[i].calls, funcs[i].name);
+	}
+}
+
+static void usage(void)
+{
+	fprintf(stderr, "%s: [-c cpu] [-f] [-l addr] [-e addr] [-m map] [-r report] [-d dump] [-i port] [-n cycles] [-x] binary\n", arg0);
+	exit(1);
+}
+
+int main(int argc, char *argv[])
+{
+	FILE *fp;
+	FILE *rp = stderr;
+	const char *mapname = NULL;
+	const char *repname = NULL;
+	const char *dumpname = NULL;
+	long load = -1;
+	long entry = -1;
+	int fuzix = 0;
+	size_t len;
+	int opt;
+
+	arg0 = argv[0];
+
+	while ((opt = getopt(argc, argv, "c:fl:e:m:r:d:i:n:x")) != -1) {
+		switch(opt) {
+		case 'c':
+			if (strcmp(optarg, "6800") == 0) {
+				cpu = CPU_6800;
+				cyc = cycles6800;
+			} else if (strcmp(optarg, "6803") == 0) {
+				cpu = CPU_6803;
+				cyc = cycles6803;
+			} else if (strcmp(optarg, "6303") == 0) {
+				cpu = CPU_6303;
+				cyc = cycles6303;
+			} else {
+				fprintf(stderr, "%s: unknown cpu '%s'.\n", arg0, optarg);
+				exit(1);
+			}
+			break;
+		case 'f':
+			fuzix = 1;
+			break;
+		case 'l':
+			load = strtoul(optarg, NULL, 0);
+			break;
+		case 'e':
+			entry = strtoul(optarg, NULL, 0);
+			break;
+		case 'm':
+			mapname = optarg;
+			break;
+		case 'r':
+			repname = optarg;
+			break;
+		case 'd':
+			dumpname = optarg;
+			break;
+		case 'i':
+			ioport = strtoul(optarg, NULL, 0) & 0xFFF0;
+			break;
+		case 'n':
+			limit = strtoull(optarg, NULL, 0);
+			break;
+		case 'x':
+			trace = 1;
+			break;
+		default:
+			usage();
+		}
+	}
+	if (optind != argc - 1)
+		usage();
+
+	build_decode();
+	if (mapname)
+		load_map(mapname);
+
+	/* ld68 -b images start at 0, Fuzix ones at the code base */
+	if (load == -1)
+		load = fuzix ? 0x0100 : 0;
+	if (entry == -1 && nfunc)
+		entry = find_symbol("__code");
+	if (entry <= 0 && load)
+		entry = load;
+	if (entry <= 0) {
+		fprintf(stderr, "%s: need -e or -m to find the start address.\n", arg0);
+		exit(1);
+	}
+
+	fp = fopen(argv[optind], "r");
+	if (fp == NULL) {
+		perror(argv[optind]);
+		exit(1);
+	}
+	len = fread(mem + load, 1, sizeof(mem) - load, fp);
+	fclose(fp);
+	if (len == 0) {
+		fprintf(stderr, "%s: %s: empty image.\n", arg0, argv[optind]);
+		exit(1);
+	}
+
+	/* Returning from the program lands in the trap page */
+	rs = ioport - 1;
+	push16(ioport + 8);
+	pc = entry;
+	cc = CC_I;
+
+	while (!halted) {
+		if (pc == ioport + 8) {
+			status = rb;
+			break;
+		}
+		if (limit && cycles >= limit) {
+			fprintf(stderr, "%s: cycle limit reached at %04X.\n", arg0, pc);
+			status = 255;
+			break;
+		}
+		step();
+	}
+	fflush(stdout);
+
+	if (dumpname) {
+		fp = fopen(dumpname, "w");
+		if (fp == NULL || fwrite(mem, sizeof(mem), 1, fp) != 1 ||
+		    fclose(fp)) {
+			perror(dumpname);
+			exit(1);
+		}
+	}
+
+	if (repname) {
+		rp = fopen(repname, "w");
+		if (rp == NULL) {
+			perror(repname);
+			exit(1);
+		}
+	}
+	report(rp);
+	if (rp != stderr)
+		fclose(rp);
+	return status;
+}
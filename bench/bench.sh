@@ -0,0 +1,112 @@
+#!/bin/sh
+#
+#	bench.sh run "cpus" "programs"
+#		Build each program for each cpu with the staged compiler
+#		driver and print the results
+#
+#	bench.sh compare baseline results threshold
+#		Compare results with a baseline and fail if a program got
+#		more than threshold percent bigger or slower, or its result
+#		changed
+#
+#	A result line is "cpu program symbol kind value". Symbol "*" is the
+#	whole program: its code size, its cycles under sim68 and the exit
+#	status of the run. The rest are the sizes of each code symbol
+#	from the ld68 map.
+#
+
+SIM=../as68/sim68
+LIMIT=200000000
+
+run() {
+	for cpu in $1; do
+		mkdir -p out/$cpu
+		for prog in $2; do
+			bin=out/$cpu/$prog
+			rm -f $bin $bin.map
+			if ! ./cc68 -m$cpu -M -o $bin $prog.c >out/$cpu/$prog.log 2>&1; then
+				echo "$cpu $prog * build failed" >&2
+				echo "$cpu $prog * status failed"
+				continue
+			fi
+			# Code symbols in address order; each runs up to the next
+			awk -v cpu=$cpu -v prog=$prog '
+				function hex(s,  i, n) {
+					n = 0
+					for (i = 1; i <= length(s); i++)
+						n = n * 16 + index("0123456789ABCDEF", toupper(substr(s, i, 1))) - 1
+					return n
+				}
+				$2 == "C" || $2 == "c" { addr[$3] = hex($1) }
+				$3 == "__code_size" { size = hex($1) }
+				END {
+					n = 0
+					for (s in addr)
+						sym[n++] = s
+					for (i = 1; i < n; i++)
+						for (j = i; j > 0 && addr[sym[j - 1]] > addr[sym[j]]; j--) {
+							t = sym[j]; sym[j] = sym[j - 1]; sym[j - 1] = t
+						}
+					end = addr["__code"] + size
+					for (i = 0; i < n; i++) {
+						next_addr = i + 1 < n ? addr[sym[i + 1]] : end
+						if (next_addr > addr[sym[i]])
+							print cpu, prog, sym[i], "size", next_addr - addr[sym[i]]
+					}
+					print cpu, prog, "*", "size", size
+				}' $bin.map
+			$SIM -c $cpu -n $LIMIT -m $bin.map -r out/$cpu/$prog.prof $bin >/dev/null 2>out/$cpu/$prog.err
+			status=$?
+			cycles=`awk '$2 == "cycles" { print $1; exit }' out/$cpu/$prog.prof`
+			echo "$cpu $prog * cycles ${cycles:-0}"
+			echo "$cpu $prog * status $status"
+		done
+	done
+}
+
+compare() {
+	awk -v limit=$3 '
+		FILENAME == ARGV[1] { base[$1 " " $2 " " $3 " " $4] = $5; next }
+		{
+			key = $1 " " $2 " " $3 " " $4
+			if (!(key in base)) {
+				if ($3 == "*")
+					printf("%s: new, %s\n", key, $5)
+				next
+			}
+			old = base[key]
+			if ($4 == "status") {
+				if (old != $5) {
+					printf("%s: was %s now %s  FAIL\n", key, old, $5)
+					fail = 1
+				}
+				next
+			}
+			if (old == $5)
+				next
+			pct = old ? ($5 - old) * 100 / old : 100
+			if ($3 != "*") {
+				printf("%s: %d -> %d (%+.1f%%)\n", key, old, $5, pct)
+				next
+			}
+			if (pct > limit) {
+				printf("%s: %d -> %d (%+.1f%%)  FAIL\n", key, old, $5, pct)
+				fail = 1
+			} else
+				printf("%s: %d -> %d (%+.1f%%)\n", key, old, $5, pct)
+		}
+		END { exit fail }' $1 $2
+}
+
+case "$1" in
+run)
+	run "$2" "$3"
+	;;
+compare)
+	compare "$2" "$3" "$4"
+	;;
+*)
+	echo "$0: run|compare" >&2
+	exit 1
+	;;
+esac
@@ -0,0 +1,185 @@
+/*
+ *	A cut down Dhrystone style mix of records, strings, enums and calls
+ */
+
+#include <string.h>
+
+typedef enum { Ident1, Ident2, Ident3, Ident4, Ident5 } Enumeration;
+
+typedef struct record {
+	struct record *PtrComp;
+	Enumeration Discr;
+	Enumeration EnumComp;
+	int IntComp;
+	char StringComp[31];
+} Record;
+
+static Record Glob1, Glob2;
+static Record *PtrGlb;
+static int IntGlob;
+static char Char1Glob, Char2Glob;
+static int Array1Glob[50];
+static int Array2Glob[50][50];
+
+static int Func3(Enumeration EnumParIn)
+{
+	return EnumParIn == Ident3;
+}
+
+static Enumeration Func1(char CharPar1, char CharPar2)
+{
+	if (CharPar1 != CharPar2)
+		return Ident1;
+	return Ident2;
+}
+
+static int Func2(char *StrParI1, char *StrParI2)
+{
+	int IntLoc = 1;
+	char CharLoc = 0;
+
+	while (IntLoc <= 1)
+		if (Func1(StrParI1[IntLoc], StrParI2[IntLoc + 1]) == Ident1) {
+			CharLoc = 'A';
+			IntLoc++;
+		}
+	if (CharLoc >= 'W' && CharLoc <= 'Z')
+		IntLoc = 7;
+	if (CharLoc == 'X')
+		return 1;
+	if (strcmp(StrParI1, StrParI2) > 0) {
+		IntLoc += 7;
+		return 1;
+	}
+	return 0;
+}
+
+static void Proc7(int IntParI1, int IntParI2, int *IntParOut)
+{
+	*IntParOut = IntParI2 + IntParI1 + 2;
+}
+
+static void Proc6(Enumeration EnumParIn, Enumeration *EnumParOut)
+{
+	*EnumParOut = EnumParIn;
+	if (!Func3(EnumParIn))
+		*EnumParOut = Ident4;
+	switch (EnumParIn) {
+	case Ident1:
+		*EnumParOut = Ident1;
+		break;
+	case Ident2:
+		*EnumParOut = IntGlob > 100 ? Ident1 : Ident4;
+		break;
+	case Ident3:
+		*EnumParOut = Ident2;
+		break;
+	case Ident4:
+		break;
+	case Ident5:
+		*EnumParOut = Ident3;
+		break;
+	}
+}
+
+static void Proc8(int *Array1Par, int Array2Par[50][50], int IntParI1, int IntParI2)
+{
+	int IntLoc = IntParI1 + 5;
+	int IntIndex;
+
+	Array1Par[IntLoc] = IntParI2;
+	Array1Par[IntLoc + 1] = Array1Par[IntLoc];
+	Array1Par[IntLoc + 30] = IntLoc;
+	for (IntIndex = IntLoc; IntIndex <= IntLoc + 1; ++IntIndex)
+		Array2Par[IntLoc][IntIndex] = IntLoc;
+	++Array2Par[IntLoc][IntLoc - 1];
+	Array2Par[IntLoc + 20][IntLoc] = Array1Par[IntLoc];
+	IntGlob = 5;
+}
+
+static void Proc3(Record **PtrParOut)
+{
+	if (PtrGlb != 0)
+		*PtrParOut = PtrGlb->PtrComp;
+	else
+		IntGlob = 100;
+	Proc7(10, IntGlob, &PtrGlb->IntComp);
+}
+
+static void Proc1(Record *PtrParIn)
+{
+	Record *NextRecord = PtrParIn->PtrComp;
+
+	memcpy(NextRecord, PtrGlb, sizeof(Record));
+	PtrParIn->IntComp = 5;
+	NextRecord->IntComp = PtrParIn->IntComp;
+	NextRecord->PtrComp = PtrParIn->PtrComp;
+	Proc3(&NextRecord->PtrComp);
+	if (NextRecord->Discr == Ident1) {
+		NextRecord->IntComp = 6;
+		Proc6(PtrParIn->EnumComp, &NextRecord->EnumComp);
+		NextRecord->PtrComp = PtrGlb->PtrComp;
+		Proc7(NextRecord->IntComp, 10, &NextRecord->IntComp);
+	} else
+		memcpy(PtrParIn, PtrParIn->PtrComp, sizeof(Record));
+}
+
+static void Proc2(int *IntParIO)
+{
+	int IntLoc = *IntParIO + 10;
+	Enumeration EnumLoc = Ident2;
+
+	for (;;) {
+		if (Char1Glob == 'A') {
+			--IntLoc;
+			*IntParIO = IntLoc - IntGlob;
+			EnumLoc = Ident1;
+		}
+		if (EnumLoc == Ident1)
+			break;
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	int IntLoc1, IntLoc2, IntLoc3;
+	char String1Loc[31];
+	char String2Loc[31];
+	Enumeration EnumLoc;
+	unsigned run;
+	unsigned check = 0;
+
+	PtrGlb = &Glob1;
+	PtrGlb->PtrComp = &Glob2;
+	PtrGlb->Discr = Ident1;
+	PtrGlb->EnumComp = Ident3;
+	PtrGlb->IntComp = 40;
+	strcpy(PtrGlb->StringComp, "DHRYSTONE PROGRAM, SOME STRING");
+	strcpy(String1Loc, "DHRYSTONE PROGRAM, 1'ST STRING");
+
+	for (run = 0; run < 50; run++) {
+		Char1Glob = 'A';
+		IntLoc1 = 2;
+		IntLoc2 = 3;
+		strcpy(String2Loc, "DHRYSTONE PROGRAM, 2'ND STRING");
+		EnumLoc = Ident2;
+		if (!Func2(String1Loc, String2Loc))
+			Char2Glob = 'B';
+		while (IntLoc1 < IntLoc2) {
+			IntLoc3 = 5 * IntLoc1 - IntLoc2;
+			Proc7(IntLoc1, IntLoc2, &IntLoc3);
+			++IntLoc1;
+		}
+		Proc8(Array1Glob, Array2Glob, IntLoc1, IntLoc3);
+		Proc1(PtrGlb);
+		for (Char2Glob = 'A'; Char2Glob <= 'C'; ++Char2Glob)
+			if (EnumLoc == Func1(Char2Glob, 'C'))
+				Proc6(Ident1, &EnumLoc);
+		IntLoc3 = IntLoc2 * IntLoc1;
+		IntLoc2 = IntLoc3 / IntLoc1;
+		IntLoc2 = 7 * (IntLoc3 - IntLoc2) - IntLoc1;
+		Proc2(&IntLoc1);
+		check += IntLoc1 + IntLoc2 + IntLoc3 + EnumLoc;
+	}
+	return check & 0xFF;
+}
@@ -0,0 +1,105 @@
+/*
+ *	Switch heavy dispatch: a tiny stack machine interpreter
+ */
+
+enum {
+	OP_PUSH, OP_ADD, OP_SUB, OP_DUP, OP_SWAP, OP_DROP, OP_JNZ,
+	OP_DEC, OP_AND, OP_OR, OP_SHL, OP_SHR, OP_OVER, OP_ROT, OP_NOP,
+	OP_HALT
+};
+
+static const unsigned char prog[] = {
+	OP_PUSH, 0, OP_PUSH, 200,	/* acc count */
+	/* loop: */
+	OP_SWAP, OP_OVER, OP_ADD, OP_DUP, OP_PUSH, 3, OP_SHL, OP_OR,
+	OP_PUSH, 0x7F, OP_AND, OP_SWAP, OP_DEC, OP_NOP, OP_DUP,
+	OP_JNZ, 4,
+	OP_DROP, OP_HALT
+};
+
+static int stack[16];
+
+static int run(const unsigned char *pc)
+{
+	const unsigned char *base = pc;
+	int *sp = stack;
+	int t;
+
+	for (;;) {
+		switch (*pc++) {
+		case OP_PUSH:
+			*sp++ = *pc++;
+			break;
+		case OP_ADD:
+			sp--;
+			sp[-1] += *sp;
+			break;
+		case OP_SUB:
+			sp--;
+			sp[-1] -= *sp;
+			break;
+		case OP_DUP:
+			*sp = sp[-1];
+			sp++;
+			break;
+		case OP_SWAP:
+			t = sp[-1];
+			sp[-1] = sp[-2];
+			sp[-2] = t;
+			break;
+		case OP_DROP:
+			sp--;
+			break;
+		case OP_JNZ:
+			if (*--sp)
+				pc = base + *pc;
+			else
+				pc++;
+			break;
+		case OP_DEC:
+			sp[-1]--;
+			break;
+		case OP_AND:
+			sp--;
+			sp[-1] &= *sp;
+			break;
+		case OP_OR:
+			sp--;
+			sp[-1] |= *sp;
+			break;
+		case OP_SHL:
+			sp--;
+			sp[-1] <<= *sp;
+			break;
+		case OP_SHR:
+			sp--;
+			sp[-1] >>= *sp;
+			break;
+		case OP_OVER:
+			*sp = sp[-2];
+			sp++;
+			break;
+		case OP_ROT:
+			t = sp[-3];
+			sp[-3] = sp[-2];
+			sp[-2] = sp[-1];
+			sp[-1] = t;
+			break;
+		case OP_NOP:
+			break;
+		case OP_HALT:
+			return sp[-1];
+		default:
+			return -1;
+		}
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	int r = 0;
+	int i;
+	for (i = 0; i < 10; i++)
+		r += run(prog);
+	return r & 0xFF;
+}
@@ -0,0 +1,116 @@
+/*
+ *	CoreMark style kernels: CRC, a small matrix multiply, a state
+ *	machine over a string and a bubble sort
+ */
+
+static int ma[6][6], mb[6][6], mc[6][6];
+static int data[40];
+
+static unsigned crc16(unsigned crc, unsigned char v)
+{
+	unsigned char i;
+	crc ^= v;
+	for (i = 0; i < 8; i++) {
+		if (crc & 1)
+			crc = (crc >> 1) ^ 0xA001;
+		else
+			crc >>= 1;
+	}
+	return crc;
+}
+
+static void matmul(void)
+{
+	unsigned char i, j, k;
+	int s;
+	for (i = 0; i < 6; i++)
+		for (j = 0; j < 6; j++) {
+			s = 0;
+			for (k = 0; k < 6; k++)
+				s += ma[i][k] * mb[k][j];
+			mc[i][j] = s;
+		}
+}
+
+static const char input[] = "12,-345,+6.78,0x1f,9e2,,abc,42.;";
+
+static int states(const char *p)
+{
+	int state = 0;
+	int count = 0;
+	while (*p) {
+		char c = *p++;
+		switch (state) {
+		case 0:
+			if (c >= '0' && c <= '9')
+				state = 1;
+			else if (c == '+' || c == '-')
+				state = 2;
+			else
+				state = 4;
+			break;
+		case 1:
+			if (c == '.')
+				state = 3;
+			else if (c == ',')
+				count++, state = 0;
+			else if (c < '0' || c > '9')
+				state = 4;
+			break;
+		case 2:
+			state = (c >= '0' && c <= '9') ? 1 : 4;
+			break;
+		case 3:
+			if (c == ',')
+				count += 2, state = 0;
+			else if (c < '0' || c > '9')
+				state = 4;
+			break;
+		default:
+			if (c == ',')
+				state = 0;
+			break;
+		}
+	}
+	return count;
+}
+
+static void sort(int *v, unsigned char n)
+{
+	unsigned char i, j;
+	int t;
+	for (i = 0; i < n - 1; i++)
+		for (j = 0; j < n - 1 - i; j++)
+			if (v[j] > v[j + 1]) {
+				t = v[j];
+				v[j] = v[j + 1];
+				v[j + 1] = t;
+			}
+}
+
+int main(int argc, char *argv[])
+{
+	unsigned crc = 0xFFFF;
+	unsigned char i, j;
+	unsigned seed = 1;
+
+	for (i = 0; i < 6; i++)
+		for (j = 0; j < 6; j++) {
+			ma[i][j] = i + j;
+			mb[i][j] = i - j;
+		}
+	matmul();
+	for (i = 0; i < 6; i++)
+		for (j = 0; j < 6; j++)
+			crc = crc16(crc, mc[i][j]);
+	for (i = 0; i < 40; i++) {
+		seed = seed * 75 + 74;
+		data[i] = seed;
+	}
+	sort(data, 40);
+	for (i = 0; i < 40; i++)
+		crc = crc16(crc, data[i] >> 4);
+	for (i = 0; i < 10; i++)
+		crc += states(input);
+	return crc & 0xFF;
+}
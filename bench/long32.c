@@ -0,0 +1,56 @@
+/*
+ *	32bit arithmetic: a clock style counter, multiply, divide and shifts
+ */
+
+static unsigned long seconds;
+static unsigned long ticks;
+
+static unsigned long isqrt(unsigned long v)
+{
+	unsigned long r = 0;
+	unsigned long b = 1UL << 30;
+	while (b > v)
+		b >>= 2;
+	while (b) {
+		if (v >= r + b) {
+			v -= r + b;
+			r = (r >> 1) + b;
+		} else
+			r >>= 1;
+		b >>= 2;
+	}
+	return r;
+}
+
+static unsigned long lcg(unsigned long x)
+{
+	return x * 1103515245UL + 12345UL;
+}
+
+static void tick(void)
+{
+	if (++ticks == 50) {
+		ticks = 0;
+		seconds++;
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	unsigned long x = 1;
+	unsigned long sum = 0;
+	long s = 0;
+	unsigned i;
+
+	for (i = 0; i < 2000; i++)
+		tick();
+	for (i = 0; i < 100; i++) {
+		x = lcg(x);
+		sum += x / 1000 + x % 60;
+		sum ^= x >> (i & 15);
+		s += (long)(x >> 8) / -7;
+		sum += isqrt(x >> 4);
+	}
+	sum += seconds * 3600UL + (sum >> 3);
+	return (sum ^ s) & 0xFF;
+}
@@ -0,0 +1,90 @@
+/*
+ *	String handling: copies, lengths, compares and in place edits
+ */
+
+#include <string.h>
+
+static char buf[128];
+static char work[128];
+
+static const char *words[] = {
+	"alpha", "bravo", "charlie", "delta", "echo", "foxtrot",
+	"golf", "hotel", "india", "juliet", "kilo", "lima"
+};
+
+#define NWORDS	(sizeof(words) / sizeof(words[0]))
+
+static int compare(const char *a, const char *b)
+{
+	while (*a && *a == *b) {
+		a++;
+		b++;
+	}
+	return (unsigned char)*a - (unsigned char)*b;
+}
+
+static void reverse(char *p)
+{
+	char *e = p + strlen(p) - 1;
+	char t;
+	while (p < e) {
+		t = *p;
+		*p++ = *e;
+		*e-- = t;
+	}
+}
+
+static void upper(char *p)
+{
+	while (*p) {
+		if (*p >= 'a' && *p <= 'z')
+			*p -= 32;
+		p++;
+	}
+}
+
+static unsigned hash(const char *p)
+{
+	unsigned h = 0;
+	while (*p)
+		h = (h << 5) + h + *p++;
+	return h;
+}
+
+static void sort(const char **v, int n)
+{
+	int i, j;
+	const char *t;
+	for (i = 1; i < n; i++) {
+		t = v[i];
+		for (j = i; j > 0 && compare(v[j - 1], t) > 0; j--)
+			v[j] = v[j - 1];
+		v[j] = t;
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	const char *list[NWORDS];
+	unsigned h = 0;
+	unsigned i;
+	int n;
+
+	for (n = 0; n < 20; n++) {
+		for (i = 0; i < NWORDS; i++)
+			list[i] = words[NWORDS - 1 - i];
+		sort(list, NWORDS);
+		buf[0] = 0;
+		for (i = 0; i < NWORDS; i++) {
+			strcpy(buf + strlen(buf), list[i]);
+			strcpy(work, list[i]);
+			reverse(work);
+			upper(work);
+			h += hash(work);
+		}
+		memset(work, '*', 40);
+		memcpy(work + 40, buf, strlen(buf) + 1);
+		h += hash(work) + strlen(work);
+	}
+	return h & 0xFF;
+}
@@ -0,0 +1,91 @@
+/*
+ *	Struct and pointer walks: a linked list, a binary tree and a table
+ */
+
+struct node {
+	struct node *left;
+	struct node *right;
+	int key;
+	unsigned char count;
+};
+
+struct item {
+	struct item *next;
+	char tag;
+	int value;
+	long total;
+};
+
+static struct node nodes[64];
+static struct item items[32];
+static unsigned nnodes;
+
+static struct node *insert(struct node *root, int key)
+{
+	struct node **p = &root;
+	while (*p) {
+		if (key == (*p)->key) {
+			(*p)->count++;
+			return root;
+		}
+		p = key < (*p)->key ? &(*p)->left : &(*p)->right;
+	}
+	*p = &nodes[nnodes++];
+	(*p)->key = key;
+	(*p)->count = 1;
+	return root;
+}
+
+static int depth(struct node *n)
+{
+	int l, r;
+	if (n == 0)
+		return 0;
+	l = depth(n->left);
+	r = depth(n->right);
+	return 1 + (l > r ? l : r);
+}
+
+static unsigned walk(struct node *n)
+{
+	if (n == 0)
+		return 0;
+	return walk(n->left) + n->key * n->count + walk(n->right);
+}
+
+static struct item *build(void)
+{
+	struct item *head = 0;
+	unsigned i;
+	for (i = 0; i < 32; i++) {
+		items[i].next = head;
+		items[i].tag = 'a' + (i & 15);
+		items[i].value = i * 37;
+		items[i].total = 0;
+		head = &items[i];
+	}
+	return head;
+}
+
+int main(int argc, char *argv[])
+{
+	struct node *root = 0;
+	struct item *p;
+	unsigned key = 7;
+	unsigned sum = 0;
+	int i;
+
+	for (i = 0; i < 60; i++) {
+		key = (key * 13 + 5) & 63;
+		root = insert(root, key);
+	}
+	sum = walk(root) + depth(root);
+	for (i = 0; i < 10; i++) {
+		for (p = build(); p; p = p->next) {
+			p->total += p->value;
+			if (p->tag == 'c')
+				sum += p->value;
+		}
+	}
+	return sum & 0xFF;
+}
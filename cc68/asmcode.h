@@ -92,11 +92,19 @@ void RemoveCodeRange (const CodeMark* Start, const CodeMark* End);
 void RemoveCode (const CodeMark* M);
 /* Remove all code after the given code marker */
 
+void InsertCodeLine (const CodeMark* M, const char* Text);
+/* Insert a line of code at the given code marker */
+
 void MoveCode (const CodeMark* Start, const CodeMark* End, const CodeMark* Target);
 /* Move the code between Start (inclusive) and End (exclusive) to
 ** (before) Target. The code marks aren't updated.
 */
 
+int CodeMarksInOrder (const CodeMark* const* Marks, unsigned Count);
+/* Return true if all the markers still refer to live code and appear in
+** the given order.
+*/
+
 int CodeRangeIsEmpty (const CodeMark* Start, const CodeMark* End);
 /* Return true if the given code range is empty (no code between Start and End) */
 
@@ -56,6 +56,7 @@
 #include "expr.h"
 #include "function.h"
 #include "litpool.h"
+#include "loop.h"
 #include "scanner.h"
 #include "segments.h"
 #include "stackptr.h"
@@ -272,6 +273,9 @@ static void ParseLVarArg (StrBuf* T, unsigned Arg)
     ** if this is the case.
     */
 
+    /* The assembler can do what it likes with the variable now */
+    Sym->Flags |= SC_ADDRTAKEN;
+
     /* Calculate the current offset from SP */
     Offs = Sym->V.Offs - StackPtr;
 
@@ -428,6 +432,9 @@ void AsmStatement (void)
     /* Skip the ASM */
     NextToken ();
 
+    /* We can't see what the assembler does to the flow of control */
+    LoopBarrier ();
+
     /* An optional volatile qualifier disables optimization for
     ** the entire function [same as #pragma optimize(push, off)].
     */
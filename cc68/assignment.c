@@ -51,6 +51,7 @@
 #include "expr.h"
 #include "loadexpr.h"
 #include "scanner.h"
+#include "stackptr.h"
 #include "stdnames.h"
 #include "typecmp.h"
 #include "typeconv.h"
@@ -149,8 +150,11 @@ void Assignment (ExprDesc* Expr)
                     /* Load the size of the struct into X */
                     g_push (CF_INT | CF_USINGX | CF_UNSIGNED | CF_CONST, CheckedSizeOf (ltype));
                 g_call (CF_FIXARGC, Func_memcpy, 6);
-                /* Now drop the stacked arguments */
-                g_drop(6, 0);
+                /* Now drop the stacked arguments, on the 6800 memcpy
+                   does that itself */
+                if (CPU != CPU_6800)
+                    g_drop(6, 0);
+                StackPtr += 6;
             }
 
         } else {
@@ -262,17 +266,37 @@ void Assignment (ExprDesc* Expr)
         /* Get the address on stack if needed */
         PushAddr (Expr);
 
-        /* Read the expression on the right side of the '=' */
-        hie1 (&Expr2);
+        /* Read the expression on the right side of the '='. When storing a
+        ** char only the low byte of it matters.
+        */
+        if (CheckedSizeOf (ltype) == SIZEOF_CHAR) {
+            LowByteExpr (hie1, &Expr2);
+        } else {
+            hie1 (&Expr2);
+        }
 
-        /* Do type conversion if necessary */
-        TypeConversion (&Expr2, ltype);
+        if (CheckedSizeOf (ltype) == SIZEOF_CHAR && ED_GetLoc (Expr) != E_LOC_PRIMARY &&
+            IsClassInt (Expr2.Type) &&
+            CheckedSizeOf (Expr2.Type) > SIZEOF_CHAR && !ED_IsConstAbs (&Expr2)) {
 
-        /* If necessary, load the value into the primary register */
-        LoadExpr (CF_NONE, &Expr2);
+            /* The store only uses B, so leave turning the value into a
+            ** char until afterwards. It is dropped if nobody uses it.
+            */
+            LoadExpr (CF_NONE, &Expr2);
+            Store (Expr, 0);
+            g_charresult (TypeOf (ltype));
 
-        /* Generate a store instruction */
-        Store (Expr, 0);
+        } else {
+
+            /* Do type conversion if necessary */
+            TypeConversion (&Expr2, ltype);
+
+            /* If necessary, load the value into the primary register */
+            LoadExpr (CF_NONE, &Expr2);
+
+            /* Generate a store instruction */
+            Store (Expr, 0);
+        }
 
     }
 
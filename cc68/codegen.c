@@ -75,6 +75,7 @@
 #include "check.h"
 #include "cpu.h"
 #include "inttypes.h"
+#include "mulplan.h"
 #include "strbuf.h"
 #include "xmalloc.h"
 #include "xsprintf.h"
@@ -166,6 +167,57 @@ static const char* GetLabelName (unsigned Flags, uintptr_t Label, long Offs, int
 unsigned FramePtr;		/* True if we are using a frame pointer */
 unsigned XState;
 
+/* A vararg function sets up @fp on entry whether it needs it or not. We
+   remember where the setup went and whether anything referenced the frame
+   so that g_leave can throw the setup away again for functions that never
+   touch their arguments */
+static unsigned FrameUsed;
+static CodeMark FrameStart;
+
+/* Set once anything in the function has worked out an address on the stack.
+   A pointer into our frame may then be passed on, so the frame must stay
+   put until the callee returns */
+static unsigned FrameAddrTaken;
+static CodeMark FrameEnd;
+
+/* With stack checking on we tell the linker how much stack each function
+   uses, what it calls and where the checks are so that it can work out the
+   worst case depth and remove the checks it proves cannot fail */
+static unsigned StackMax;		/* Deepest we have pushed */
+static int StackIndirect;		/* Made a call through a pointer */
+static Collection StackChecks = STATIC_COLLECTION_INITIALIZER;
+static Collection StackCalls = STATIC_COLLECTION_INITIALIZER;
+
+/* Runtime helpers that take an operand from the stack and pop it before
+   returning, with the number of bytes they pop. The operand sits behind
+   the return address so a call to one of these must never become a jump */
+static const struct {
+    const char *Name;
+    unsigned char Pops;
+} PopHelpers[] = {
+    { "tosadd0ax", 4 }, { "tosaddeax", 4 }, { "tosand0ax", 4 },
+    { "tosandeax", 4 }, { "tosaslax", 2 }, { "tosasleax", 4 },
+    { "tosasrax", 2 }, { "tosasreax", 4 }, { "tosdivax", 2 },
+    { "tosdiveax", 4 }, { "toseqax", 2 }, { "toseqeax", 4 },
+    { "tosgeax", 2 }, { "tosgeeax", 4 }, { "tosgtax", 2 },
+    { "tosgteax", 4 }, { "tosleax", 2 }, { "tosleeax", 4 },
+    { "tosltax", 2 }, { "toslteax", 4 }, { "tosmodax", 2 },
+    { "tosmodeax", 4 }, { "tosmulax", 2 }, { "tosmuleax", 4 },
+    { "tosneax", 2 }, { "tosneeax", 4 }, { "tosor0ax", 4 },
+    { "tosoreax", 4 }, { "tosshlax", 2 }, { "tosshleax", 4 },
+    { "tosshrax", 2 }, { "tosshreax", 4 }, { "tossubax", 2 },
+    { "tossubeax", 4 }, { "tosudivax", 2 }, { "tosudiveax", 4 },
+    { "tosugeax", 2 }, { "tosugeeax", 4 }, { "tosugtax", 2 },
+    { "tosugteax", 4 }, { "tosuleax", 2 }, { "tosuleeax", 4 },
+    { "tosultax", 2 }, { "tosulteax", 4 }, { "tosumodax", 2 },
+    { "tosumodeax", 4 }, { "tosumulax", 2 }, { "tosumuleax", 4 },
+    { "tosxor0ax", 4 }, { "tosxoreax", 4 },
+    { NULL, 0 }
+};
+
+/* True if the last instruction was a call to one of them */
+static int LastCallPops;
+
 #define XSTATE_VALID	0x8000
 
 /* Force a TSX and reset the tracking state */
@@ -232,9 +284,209 @@ static void InvalidateX(void)
     XState = 0;
 }
 
+/*
+ *	A long is held in D and @sreg. We track when @sreg holds a known
+ *	constant or a copy of the upper half of a variable so that we can
+ *	avoid loading it again. g_noteline sees every line we generate and
+ *	drops the knowledge when it might no longer be true.
+ */
+
+#define SREG_UNKNOWN	0
+#define SREG_CONST	1	/* A known constant */
+#define SREG_LOCAL	2	/* Upper half of the local at SregValue */
+#define SREG_STATIC	3	/* Upper half of the static SregLabel */
+
+static unsigned SregState;
+static unsigned SregValue;
+static char SregLabel[64];
+
+static void InvalidateSreg(void)
+{
+    SregState = SREG_UNKNOWN;
+}
+
+/*
+ *	In the same way we track when D or X holds a known constant or the
+ *	value of an int variable. Loads of something already there are then
+ *	skipped. Anything that changes the register or writes memory the
+ *	variable might live in ends the tracking, again via g_noteline.
+ */
+
+#define VAL_UNKNOWN	0
+#define VAL_CONST	1	/* A known constant */
+#define VAL_LOCAL	2	/* The int local at Value */
+#define VAL_STATIC	3	/* The int static Label */
+
+struct RegValue {
+    unsigned State;
+    unsigned Value;
+    char Label[64];
+};
+
+static struct RegValue DValue;
+static struct RegValue DAlias;	/* D was also stored here */
+static struct RegValue XValue;
+
+static void InvalidateD(void)
+{
+    DValue.State = VAL_UNKNOWN;
+    DAlias.State = VAL_UNKNOWN;
+}
+
+static void InvalidateValues(void)
+{
+    InvalidateD();
+    XValue.State = VAL_UNKNOWN;
+}
+
+static void SetValue(struct RegValue *R, unsigned State, unsigned Value,
+                     const char *Label)
+{
+    R->State = State;
+    R->Value = Value;
+    if (Label) {
+        if (strlen(Label) >= sizeof(R->Label)) {
+            R->State = VAL_UNKNOWN;
+            return;
+        }
+        strcpy(R->Label, Label);
+    }
+}
+
+static int ValueIs(const struct RegValue *R, unsigned State, unsigned Value,
+                   const char *Label)
+{
+    if (R->State != State || R->Value != Value)
+        return 0;
+    if (Label && strcmp(Label, R->Label))
+        return 0;
+    return 1;
+}
+
+static int SameValue(const struct RegValue *A, const struct RegValue *B)
+{
+    if (A->State == VAL_UNKNOWN)
+        return 0;
+    return ValueIs(B, A->State, A->Value,
+                   A->State == VAL_STATIC ? A->Label : NULL);
+}
+
+/* D has been loaded with something new */
+static void SetD(unsigned State, unsigned Value, const char *Label)
+{
+    SetValue(&DValue, State, Value, Label);
+    DAlias.State = VAL_UNKNOWN;
+}
+
+/* D has been stored to a variable. Keep what we knew as well if we can */
+static void StoredD(unsigned State, unsigned Value, const char *Label)
+{
+    if (DValue.State == VAL_UNKNOWN)
+        SetValue(&DValue, State, Value, Label);
+    else
+        SetValue(&DAlias, State, Value, Label);
+}
+
+static int DIs(unsigned State, unsigned Value, const char *Label)
+{
+    return ValueIs(&DValue, State, Value, Label) ||
+        ValueIs(&DAlias, State, Value, Label);
+}
+
+/* A write to Target, which is a label or off,x, has happened. Drop the
+   value if it might be a copy of the memory written */
+static void ValueWritten(struct RegValue *R, const char *Target)
+{
+    size_t n;
+
+    if (R->State == VAL_UNKNOWN || R->State == VAL_CONST)
+        return;
+    /* Anything via X could be a pointer to the variable */
+    if (strstr(Target, ",x")) {
+        R->State = VAL_UNKNOWN;
+        return;
+    }
+    /* Labels don't alias stack locals */
+    if (R->State == VAL_LOCAL)
+        return;
+    /* Different symbols are different memory. Absolute addresses and
+       offsets from the same symbol may overlap */
+    n = strcspn(R->Label, "+-");
+    if (*Target == '$' || (strncmp(Target, R->Label, n) == 0 &&
+        strchr("+- \t", Target[n])))
+        R->State = VAL_UNKNOWN;
+}
+
+/*
+ *	On the 6303 a char op= with a constant is done in memory with
+ *	aim/oim/eim. The value is then loaded in case it is used. If the
+ *	statement throws it away we remove the load again. Likewise a char
+ *	& constant is loaded normally but turned into a tim if all we want
+ *	is the condition codes. Any other code in between cancels either.
+ *	A store to a char also makes its result afterwards so that a
+ *	statement that doesn't use it can drop the conversion.
+ */
+
+#define BIT_NONE	0
+#define BIT_RESULT	1	/* BitStart onwards loads a result */
+#define BIT_TEST	2	/* BitStart onwards could be a tim */
+
+static unsigned BitPending;
+static CodeMark BitStart;
+static char BitAddr[64];
+static unsigned BitViaX;	/* BitAddr is a label we must reach via X */
+static unsigned char BitMask;
+
+/*
+ *	A compare normally ends by calling one of the bool helpers to turn
+ *	the flags into 0 or 1, or one of the tos helpers that does the whole
+ *	compare. When all that looks at the result is a conditional jump we
+ *	throw the call away and branch on the flags instead. As with the bit
+ *	operations any other code in between cancels this.
+ */
+
+#define CMP_NONE	0
+#define CMP_BOOL	1	/* CmpStart onwards is a jsr boolxx */
+#define CMP_TOS		2	/* CmpStart onwards is a tos compare helper */
+
+static unsigned CmpPending;
+static CodeMark CmpStart;
+static const char *CmpCond;
+static unsigned CmpFlags;
+
+static void BoolResult(const char *Cond)
+{
+    GetCodePos(&CmpStart);
+    AddCodeLine("jsr bool%s", Cond);
+    CmpPending = CMP_BOOL;
+    CmpCond = Cond;
+}
+
+static void SetSreg(unsigned State, unsigned Value, const char *Label)
+{
+    SregState = State;
+    SregValue = Value;
+    if (Label) {
+        if (strlen(Label) >= sizeof(SregLabel)) {
+            SregState = SREG_UNKNOWN;
+            return;
+        }
+        strcpy(SregLabel, Label);
+    }
+}
+
+static int SregIs(unsigned State, unsigned Value, const char *Label)
+{
+    if (SregState != State || SregValue != Value)
+        return 0;
+    if (Label && strcmp(Label, SregLabel))
+        return 0;
+    return 1;
+}
+
 /* Assign a value to D in the most efficient way possible. It also
    needs to ensure EQ/NE is set correctly */
-static void AssignD(unsigned short value, int keepc)
+static void DoAssignD(unsigned short value, int keepc)
 {
     uint8_t hi = value >> 8;
     uint8_t lo = value;
@@ -270,8 +522,8 @@ static void AssignD(unsigned short value, int keepc)
             AddCodeLine("ldaa #$%02X", hi);
             AddCodeLine("ldab #$%02X", lo);
         } else {
-            AddCodeLine("ldab #$%02X", hi);
-            AddCodeLine("ldaa #$%02X", lo);
+            AddCodeLine("ldab #$%02X", lo);
+            AddCodeLine("ldaa #$%02X", hi);
         }
         return;
     }
@@ -284,6 +536,12 @@ static void AssignD(unsigned short value, int keepc)
         AddCodeLine("ldd #$%04X", value);
 }
 
+static void AssignD(unsigned short value, int keepc)
+{
+    DoAssignD(value, keepc);
+    SetD(VAL_CONST, value, NULL);
+}
+
 static void AssignX(unsigned short value)
 {
     if (value == 0)
@@ -292,6 +550,7 @@ static void AssignX(unsigned short value)
         AddCodeLine("ldx @one");
     else
         AddCodeLine("ldx #$%04X", value);
+    SetValue(&XValue, VAL_CONST, value, NULL);
 }
 
 static void LoadD(const char *from, int offset)
@@ -739,7 +998,7 @@ static void LsrDBy(int n)
     if (n == 15) {
         AddCodeLine("rola");	/* top bit into carry */
         AssignD(0, 1);
-        AddCodeLine("rorb");	/* carry into bottom bit */
+        AddCodeLine("rolb");	/* carry into bottom bit */
         return;
     }
 
@@ -789,7 +1048,7 @@ static void AslDBy(int n)
     }
 
     if (n == 15) {
-        AddCodeLine("rolb");		/* Low bit into carry */
+        AddCodeLine("rorb");		/* Low bit into carry */
         AssignD(0, 1);			/* Clear */
         AddCodeLine("rora");		/* Carry into top bit */
         return;
@@ -808,11 +1067,17 @@ static void AslDBy(int n)
 /* Get D into X, may mash D */
 static void DToX(void)
 {
+    /* X already holds the same value */
+    if (SameValue(&XValue, &DValue) || SameValue(&XValue, &DAlias)) {
+        InvalidateX();
+        return;
+    }
     switch (CPU) {
         case CPU_6800:
         case CPU_6803:
             StoreD("@tmp", 0);
             AddCodeLine("ldx @tmp");
+            XValue = DValue.State != VAL_UNKNOWN ? DValue : DAlias;
             break;
         default:
             AddCodeLine("xgdx; DtoX");	/* Comments to help optimizer tracking */
@@ -843,8 +1108,10 @@ static void XToD(void)
 static int GenOffsetIndirect(int Offs)
 {
     /* Frame pointer argument */
-    if (Offs > 0 && FramePtr)
+    if (Offs > 0 && FramePtr) {
+        FrameUsed = 1;
         return Offs + 2;
+    }
     Offs -= StackPtr;
     return Offs;
 }
@@ -867,6 +1134,7 @@ static int GenOffset(unsigned Flags, int Offs, int save_d, int exact)
     /* Frame pointer using function, use the frame pointer only for
        arguments not locals */
     if (Offs > 0 && FramePtr) {
+        FrameUsed = 1;
         InvalidateX();
         AddCodeLine(";Genoffset %u %d %d %d\n",
             Flags, Offs, save_d, exact);
@@ -937,10 +1205,12 @@ static int GenOffset(unsigned Flags, int Offs, int save_d, int exact)
         if (save_d) {
             AddCodeLine("pshb");
             AddCodeLine("psha");
+            /* S is now two lower */
+            Offs += 2;
         }
         AddCodeLine("sts @tmp");
         AssignD(Offs + 1, 0);		/* So it matches a TSX based offset */
-        AddCodeLine("addd @tmp");
+        AddD("@tmp", 0);
         DToX();
         if (save_d) {
             AddCodeLine("pula");
@@ -1054,6 +1324,10 @@ void g_fileinfo (const char* Name, unsigned long Size, unsigned long MTime)
 void g_moveable (void)
 {
     InvalidateX();
+    InvalidateSreg();
+    InvalidateValues();
+    BitPending = BIT_NONE;
+    CmpPending = CMP_NONE;
 }
 
 /* We have generated code and thrown it away. OPTIMISE: we can do better in this
@@ -1061,6 +1335,106 @@ void g_moveable (void)
 void g_removed (void)
 {
     InvalidateX();
+    InvalidateSreg();
+    InvalidateValues();
+    BitPending = BIT_NONE;
+    CmpPending = CMP_NONE;
+}
+
+/* Instructions that leave D alone. Anything else we see ends our knowledge
+   of D. The memory forms of the read-modify-write ops are checked for
+   separately */
+static const char *keepsd[] = {
+    "abx", "bcc", "bcs", "beq", "bge", "bgt", "bhi", "bhs", "bita", "bitb",
+    "ble", "blo", "bls", "blt", "bmi", "bne", "bpl", "bra", "brn", "bvc",
+    "bvs", "cmpa", "cmpb", "cpx", "des", "dex", "ins", "inx", "jmp", "ldx",
+    "nop", "psha", "pshb", "pshx", "pulx", "rts", "staa", "stab", "std",
+    "sts", "stx", "tim", "tst", "tsta", "tstb", "tsx", "txs", NULL
+};
+
+/* Instructions that change X */
+static const char *changesx[] = {
+    "abx", "dex", "inx", "ldx", "pulx", "tsx", NULL
+};
+
+static int InList(const char **list, const char *op)
+{
+    while (*list && strcmp(*list, op))
+        list++;
+    return *list != NULL;
+}
+
+/* Every line we generate passes through here. Anything that might change
+   @sreg, or memory we think @sreg is a copy of, ends the tracking. The
+   same goes for what we know about D and X. Any line also ends a pending
+   bit operation or compare */
+void g_noteline (const char *Line)
+{
+    static const char *writes[] = {
+        "aim", "asl", "asr", "clr", "com", "dec", "eim", "inc", "lsl",
+        "lsr", "neg", "oim", "rol", "ror", NULL
+    };
+    char op[8];
+    unsigned n = 0;
+    struct RegValue t;
+
+    BitPending = BIT_NONE;
+    CmpPending = CMP_NONE;
+    if (-StackPtr > (int) StackMax)
+        StackMax = -StackPtr;
+    while (*Line == ' ' || *Line == '\t')
+        Line++;
+    if (*Line != ';' && *Line != 0)
+        LastCallPops = strncmp (Line, "jsr", 3) == 0 &&
+                       g_helperpops (Line + 3 + strspn (Line + 3, " \t")) > 0;
+    if (SregState == SREG_UNKNOWN && DValue.State == VAL_UNKNOWN &&
+        DAlias.State == VAL_UNKNOWN && XValue.State == VAL_UNKNOWN)
+        return;
+    if (*Line == ';' || *Line == 0)
+        return;
+    /* Labels and calls */
+    if (strchr(Line, ':') || strncmp(Line, "jsr", 3) == 0 ||
+        strncmp(Line, "bsr", 3) == 0 || strncmp(Line, "swi", 3) == 0) {
+        InvalidateSreg();
+        InvalidateValues();
+        return;
+    }
+    while (n < 7 && *Line && *Line != ' ' && *Line != '\t' && *Line != ';')
+        op[n++] = *Line++;
+    op[n] = 0;
+    while (*Line == ' ' || *Line == '\t')
+        Line++;
+    /* Register changes */
+    if (strcmp(op, "xgdx") == 0) {
+        t = DValue.State != VAL_UNKNOWN ? DValue : DAlias;
+        DValue = XValue;
+        DAlias.State = VAL_UNKNOWN;
+        XValue = t;
+    } else {
+        if (!InList(keepsd, op) && (*Line == 0 || !InList(writes, op)))
+            InvalidateD();
+        /* copt turns a push of D into ldx/pshx when it sees X loaded
+           next, so the value can't be relied on to stay in D */
+        if (CPU != CPU_6800 && strcmp(op, "psha") == 0)
+            InvalidateD();
+        if (InList(changesx, op))
+            XValue.State = VAL_UNKNOWN;
+    }
+    /* Only memory forms write */
+    if (*Line == 0)
+        return;
+    if ((op[0] != 's' || op[1] != 't') && !InList(writes, op))
+        return;
+    /* Compiler temporaries never alias a variable */
+    if (strncmp(Line, "@tmp", 4) == 0)
+        return;
+    if (strncmp(Line, "@sreg", 5) == 0 || SregState != SREG_CONST)
+        InvalidateSreg();
+    if (strncmp(Line, "@sreg", 5)) {
+        ValueWritten(&DValue, Line);
+        ValueWritten(&DAlias, Line);
+        ValueWritten(&XValue, Line);
+    }
 }
 
 
@@ -1278,12 +1652,17 @@ void g_enter (const char *name, unsigned flags, unsigned argsize)
 /* Function prologue */
 {
     push (CF_INT);		/* Return address */
+    StackMax = 0;
+    StackIndirect = 0;
     AddCodeLine(".export _%s", name);
     AddCodeLine("_%s:",name);
 
     /* We have no valid X state on entry */
 
     /* Uglies from the L->R stack handling for varargs */
+    GetCodePos(&FrameStart);
+    FrameUsed = 0;
+    FrameAddrTaken = 0;
     if ((flags & CF_FIXARGC) == 0) {
         /* Frame pointer is required for varargs mode */
         if (CPU == CPU_6800) {
@@ -1300,21 +1679,51 @@ void g_enter (const char *name, unsigned flags, unsigned argsize)
         FramePtr = 1;
     } else
         FramePtr = 0;
+    GetCodePos(&FrameEnd);
     InvalidateX();
 }
 
 
 
-void g_leave(int voidfunc, unsigned flags, unsigned argsize)
-/* Function epilogue */
+int g_helperpops (const char *Name)
+/* Return the number of bytes the helper Name pops from the stack, or -1 if
+   it is not one of the helpers that take an operand from the stack */
 {
-    /* Should always be zero : however ignore this being wrong if we took
-       a C level error as that may be the real cause. Only valid code failing
-       this check is a problem */
+    unsigned I;
+
+    for (I = 0; PopHelpers[I].Name; I++) {
+        if (strcmp (PopHelpers[I].Name, Name) == 0)
+            return PopHelpers[I].Pops;
+    }
+    return -1;
+}
 
-    if (StackPtr && !ErrorCount)
-        Internal("g_leave: stack unbalanced by %d", StackPtr);
 
+
+int g_aftertoscall (void)
+/* Return true if the last instruction called a helper that pops its operand
+   from behind the return address. A return placed straight after it would
+   be folded into a jump to the helper by the optimizer, so it must go via
+   the shared exit code instead */
+{
+    return LastCallPops;
+}
+
+
+
+int g_hasframe (void)
+/* Return true if the function is using a frame pointer so cannot simply
+   return from the middle of its body */
+{
+    return FramePtr;
+}
+
+
+
+void g_return (int voidfunc, unsigned flags, unsigned argsize)
+/* Return from a function whose stack is already back at the return
+   address */
+{
     /* Recover the previous frame pointer if we were vararg */
     if (FramePtr) {
         if (CPU == CPU_6800) {
@@ -1326,7 +1735,9 @@ void g_leave(int voidfunc, unsigned flags, unsigned argsize)
             AddCodeLine("rts");
         }
     } else {
-        if (CPU == CPU_6800 && argsize) {
+        /* A vararg function that lost its frame is cleaned up by the
+           caller on all processors */
+        if (CPU == CPU_6800 && argsize && (flags & CF_FIXARGC)) {
             /* The 6800 ABI is for space reasons called function cleans up
                arguments. The 6803/303 ABI is not because it's rather faster
                and cleaner that way */
@@ -1358,6 +1769,154 @@ void g_leave(int voidfunc, unsigned flags, unsigned argsize)
 
 
 
+void g_leave(int voidfunc, unsigned flags, unsigned argsize)
+/* Function epilogue */
+{
+    /* Should always be zero : however ignore this being wrong if we took
+       a C level error as that may be the real cause. Only valid code failing
+       this check is a problem */
+
+    if (StackPtr && !ErrorCount)
+        Internal("g_leave: stack unbalanced by %d", StackPtr);
+
+    /* Nothing ever looked at the arguments via @fp so the frame we built
+       on entry is dead weight */
+    if (FramePtr && !FrameUsed) {
+        RemoveCodeRange(&FrameStart, &FrameEnd);
+        FramePtr = 0;
+    }
+    g_return(voidfunc, flags, argsize);
+}
+
+
+
+static void StackNote (Collection* C, const char* Name)
+/* Remember a name for the stack record if we don't have it already */
+{
+    unsigned I;
+
+    for (I = 0; I < CollCount (C); I++) {
+        if (strcmp (CollConstAt (C, I), Name) == 0)
+            return;
+    }
+    CollAppend (C, xstrdup (Name));
+}
+
+
+
+static void StackForget (Collection* C)
+{
+    unsigned I;
+
+    for (I = 0; I < CollCount (C); I++)
+        xfree (CollAt (C, I));
+    CollDeleteAll (C);
+}
+
+
+
+void g_stackinfo (const char* name)
+/* Emit the stack usage record for the linker if the function was checked */
+{
+    unsigned I;
+
+    if (CollCount (&StackChecks)) {
+        AddCodeLine (".stackinfo");
+        AddCodeLine (".word _%s", name);
+        /* Our return address, any frame pointer and the most we pushed */
+        AddCodeLine (".word $%04X", 2 + 2 * FramePtr + StackMax);
+        AddCodeLine (".word $%04X", CollCount (&StackChecks));
+        for (I = 0; I < CollCount (&StackChecks); I++)
+            AddCodeLine (".word %s", (const char*) CollConstAt (&StackChecks, I));
+        AddCodeLine (".word $%04X", CollCount (&StackCalls) | (StackIndirect ? 0x8000 : 0));
+        for (I = 0; I < CollCount (&StackCalls); I++)
+            AddCodeLine (".word _%s", (const char*) CollConstAt (&StackCalls, I));
+        AddCodeLine (".code");
+    }
+    StackForget (&StackChecks);
+    StackForget (&StackCalls);
+}
+
+
+
+/* Turn the call whose arguments are on the top of the stack into a jump. The
+   arguments are copied down over our own arguments, which must be big enough
+   to hold them, and everything else we have on the stack is dropped. The
+   callee then sees exactly the frame it would have seen from our caller and
+   returns directly to it */
+
+int g_cantailcall (unsigned Flags, unsigned ParamSize, unsigned ArgSize, int SP)
+/* Return true if a call with ParamSize bytes of arguments pushed, leaving
+   the stack pointer at SP, can be turned into a tail call */
+{
+    /* The frame pointer would need restoring and a vararg callee needs
+       its caller to clean up behind it */
+    if (FramePtr || !(Flags & CF_FIXARGC))
+        return 0;
+    /* The arguments are copied over ours and our locals dropped, which
+       would pull the frame out from under any pointer into it */
+    if (FrameAddrTaken)
+        return 0;
+    /* On the 6800 the callee will drop its arguments for us, so they must
+       be exactly the size of ours. On the 6803 our caller drops our
+       arguments and the callee only looks at the bottom of them */
+    if (CPU == CPU_6800) {
+        if (ParamSize != ArgSize)
+            return 0;
+    } else if (ParamSize > ArgSize)
+        return 0;
+    /* Everything must be reachable off a single tsx */
+    return 2 - SP + ParamSize <= 256;
+}
+
+
+
+static void TailCallFrame (unsigned ParamSize)
+/* Copy the stacked arguments over our own and drop the rest */
+{
+    unsigned Dest = 2 - StackPtr;
+    unsigned n = 0;
+
+    ForceTSX();
+    if (CPU == CPU_6800) {
+        for (n = 0; n < ParamSize; n++) {
+            AddCodeLine("ldaa $%02X,x", n);
+            AddCodeLine("staa $%02X,x", Dest + n);
+        }
+    } else {
+        for (n = 0; n + 1 < ParamSize; n += 2) {
+            AddCodeLine("ldd $%02X,x", n);
+            AddCodeLine("std $%02X,x", Dest + n);
+        }
+        if (n < ParamSize) {
+            AddCodeLine("ldab $%02X,x", n);
+            AddCodeLine("stab $%02X,x", Dest + n);
+        }
+    }
+    g_drop(-StackPtr, 0);
+}
+
+
+
+void g_tailcall (const char* Label, unsigned ParamSize)
+/* Tail call the specified subroutine name */
+{
+    TailCallFrame(ParamSize);
+    StackNote(&StackCalls, Label);
+    AddCodeLine("jmp _%s", Label);
+}
+
+
+
+void g_tailjump (unsigned Label, unsigned ParamSize)
+/* Tail call ourself by jumping back to the start of the function body */
+{
+    TailCallFrame(ParamSize);
+    AddCodeLine("jmp %s", LocalLabelName(Label));
+}
+
+
+
 /*****************************************************************************/
 /*                           Fetching memory cells                           */
 /*****************************************************************************/
@@ -1387,9 +1946,11 @@ void g_getimmed (unsigned Flags, unsigned long Val, long Offs)
                 /* FALL THROUGH */
             case CF_INT:
                 if (Flags & CF_USINGX) {
-                    AssignX(Val);
+                    if (!ValueIs(&XValue, VAL_CONST, (unsigned short)Val, NULL))
+                        AssignX(Val);
                     InvalidateX();
-                } else
+                } else if ((Flags & CF_TEST) ||
+                           !DIs(VAL_CONST, (unsigned short)Val, NULL))
                     AssignD(Val, 0);
                 break;
 
@@ -1405,10 +1966,15 @@ void g_getimmed (unsigned Flags, unsigned long Val, long Offs)
                     StoreD("@sreg", 0);
                     AssignX(W1);
                     InvalidateX();
+                    SetSreg(SREG_CONST, W2, NULL);
+                } else if (SregIs(SREG_CONST, W2, NULL)) {
+                    /* The upper half is already there */
+                    AssignD(W1, 0);
                 } else {
                     /* Load the value */
                     AssignD(W2, 0);
                     StoreD("@sreg", 0);
+                    SetSreg(SREG_CONST, W2, NULL);
                     /* OPTIMIZE: for 6800 we should try and do byte not word sized
                        pair optimizing */
                     if (W1 != W2)
@@ -1475,21 +2041,37 @@ void g_getstatic (unsigned flags, uintptr_t label, long offs)
         case CF_INT:
             if (flags & CF_USINGX) {
                     InvalidateX();
-                    AddCodeLine ("ldx %s", lbuf);
-            }
-            else
+                    if ((flags & CF_VOLATILE) ||
+                        !ValueIs(&XValue, VAL_STATIC, 0, lbuf)) {
+                        AddCodeLine ("ldx %s", lbuf);
+                        if (!(flags & CF_VOLATILE))
+                            SetValue(&XValue, VAL_STATIC, 0, lbuf);
+                    }
+            } else if ((flags & CF_TEST) && CPU == CPU_6800) {
+                /* The loads only set Z from the byte loaded last */
+                AddCodeLine ("ldab %s+1", lbuf);
+                AddCodeLine ("orab %s", lbuf);
+            } else if ((flags & (CF_TEST | CF_VOLATILE)) ||
+                       !DIs(VAL_STATIC, 0, lbuf)) {
                 LoadD(lbuf, 0);
+                if (!(flags & CF_VOLATILE))
+                    SetD(VAL_STATIC, 0, lbuf);
+            }
             break;
 
         case CF_LONG:
             if (flags & CF_TEST) {
                 NotViaX();
-                LoadD(lbuf, 2);
+                AddCodeLine ("ldab %s+3", lbuf);
+                AddCodeLine ("orab %s+2", lbuf);
                 AddCodeLine ("orab %s+1", lbuf);
                 AddCodeLine ("orab %s+0", lbuf);
             } else {
-                LoadD(lbuf, 0);
-                StoreD("@sreg", 0);
+                if (!SregIs(SREG_STATIC, 0, lbuf)) {
+                    LoadD(lbuf, 0);
+                    StoreD("@sreg", 0);
+                    SetSreg(SREG_STATIC, 0, lbuf);
+                }
                 if (flags & CF_USINGX) {
                     InvalidateX();
                     AddCodeLine ("ldx %s+2", lbuf);
@@ -1509,8 +2091,16 @@ void g_getstatic (unsigned flags, uintptr_t label, long offs)
 void g_getlocal (unsigned Flags, int Offs)
 /* Fetch specified local object (local var). */
 {
+    int FrameOffs = Offs;
+
     NotViaX();
 
+    /* Already in D ? */
+    if ((Flags & CF_TYPEMASK) == CF_INT &&
+        !(Flags & (CF_TEST | CF_VOLATILE)) &&
+        DIs(VAL_LOCAL, FrameOffs, NULL))
+        return;
+
     Offs = GenOffset(Flags, Offs, 0, 0);
 
     switch (Flags & CF_TYPEMASK) {
@@ -1531,12 +2121,22 @@ void g_getlocal (unsigned Flags, int Offs)
             break;
 
         case CF_INT:
+            if ((Flags & CF_TEST) && CPU == CPU_6800) {
+                AddCodeLine ("ldab $%02X+1,x", Offs);
+                AddCodeLine ("orab $%02X,x", Offs);
+                break;
+            }
             LoadDViaX(Offs);
+            if (!(Flags & CF_VOLATILE))
+                SetD(VAL_LOCAL, FrameOffs, NULL);
             break;
 
         case CF_LONG:
-            LoadDViaX(Offs);
-            StoreD("@sreg", 0);
+            if (!SregIs(SREG_LOCAL, FrameOffs, NULL)) {
+                LoadDViaX(Offs);
+                StoreD("@sreg", 0);
+                SetSreg(SREG_LOCAL, FrameOffs, NULL);
+            }
             LoadDViaX(Offs + 2);
             if (Flags & CF_TEST)
                 g_test (Flags);
@@ -1638,6 +2238,11 @@ void g_getind (unsigned Flags, unsigned Offs)
 
         case CF_INT:
             DToX();
+            if ((Flags & CF_TEST) && CPU == CPU_6800) {
+                AddCodeLine ("ldab $%02X+1,x", Offs);
+                AddCodeLine ("orab $%02X,x", Offs);
+                break;
+            }
             LoadDViaX(Offs);
             break;
 
@@ -1665,7 +2270,9 @@ void g_leasp (unsigned Flags, int Offs)
     /* FramePtr indicates a Varargs function where arguments are relative
        to fp */
     AddCodeLine(";leasp %d %d\n", FramePtr, Offs);
+    FrameAddrTaken = 1;
     if (FramePtr && Offs > 0) {
+        FrameUsed = 1;
         /* Because of the frame pointer */
         Offs += 2;
         if (!(Flags & CF_USINGX) || Offs > 255 || CPU == CPU_6800) {
@@ -1766,22 +2373,25 @@ void g_putstatic (unsigned flags, uintptr_t label, long offs)
             if (flags & CF_USINGX) {
                 InvalidateX();
                 AddCodeLine ("stx %s", lbuf);
-            } else
+                if (!(flags & CF_VOLATILE))
+                    SetValue(&XValue, VAL_STATIC, 0, lbuf);
+            } else {
                 StoreD(lbuf, 0);
+                if (!(flags & CF_VOLATILE))
+                    StoredD(VAL_STATIC, 0, lbuf);
+            }
             break;
 
         case CF_LONG:
-            if (flags & CF_USINGX) {
+            if (flags & CF_USINGX)
                 AddCodeLine ("stx %s+2", lbuf);
-                AddCodeLine ("ldx @sreg");
-                AddCodeLine ("stx %s", lbuf);
-                InvalidateX();
-            } else {
+            else
                 StoreD(lbuf, 2);
-                LoadD("@sreg", 0);
-                StoreD(lbuf, 0);
-                LoadD(lbuf, 2);
-            }
+            /* Move the upper half via X so D is left alone */
+            AddCodeLine ("ldx @sreg");
+            AddCodeLine ("stx %s", lbuf);
+            InvalidateX();
+            SetSreg(SREG_STATIC, 0, lbuf);
             break;
 
         default:
@@ -1795,6 +2405,8 @@ void g_putstatic (unsigned flags, uintptr_t label, long offs)
 void g_putlocal (unsigned Flags, int Offs, long Val)
 /* Put data into local object. */
 {
+    int FrameOffs = Offs;
+
     Offs = GenOffset (Flags, Offs, (Flags & CF_CONST) ? 0 : 1, 0);
 
     NotViaX();		/* We need X for our index */
@@ -1812,9 +2424,12 @@ void g_putlocal (unsigned Flags, int Offs, long Val)
             break;
 
         case CF_INT:
-            if (Flags & CF_CONST)
+            if ((Flags & CF_CONST) &&
+                !DIs(VAL_CONST, (unsigned short)Val, NULL))
                 AssignD(Val, 0);
             StoreDViaX(Offs);
+            if (!(Flags & CF_VOLATILE))
+                StoredD(VAL_LOCAL, FrameOffs, NULL);
             break;
 
         case CF_LONG:
@@ -1831,6 +2446,7 @@ void g_putlocal (unsigned Flags, int Offs, long Val)
                 StoreDViaX(Offs);
                 /* Cheaper than push/pop */
                 LoadDViaX(Offs + 2);
+                SetSreg(SREG_LOCAL, FrameOffs, NULL);
             }
             break;
 
@@ -1932,11 +2548,11 @@ void g_putind (unsigned Flags, unsigned Offs)
            to clean this up well */
         case CF_LONG:
             if (CPU != CPU_6800) {
-                AddCodeLine("std @tmp");
+                /* Reloading is cheaper than saving D */
                 StoreDViaX(Offs + 2);
                 LoadD("@sreg", 0);
                 StoreDViaX(Offs);
-                AddCodeLine("ldd @tmp");
+                LoadDViaX(Offs + 2);
             } else {
                 AddCodeLine("psha");
                 StoreDViaX(Offs + 2);
@@ -1972,43 +2588,29 @@ void g_toslong (unsigned flags)
 
         case CF_CHAR:
         case CF_INT:
+            /* The primary is live so build the upper 16bits without D */
             NotViaX();	/* For now */
             InvalidateX();
-            if (flags & CF_UNSIGNED) {
-                /* Push a new upper 16bits of zero */
-                if (CPU == CPU_6800) {
-                    AddCodeLine("clrb");
-                    AddCodeLine("pshb");
-                    AddCodeLine("pshb");
-                } else {
-                    AssignX(0);
-                    AddCodeLine("pshx");
-                }
+            if (CPU == CPU_6800) {
+                AddCodeLine("des");
+                AddCodeLine("des");
+                AddCodeLine("tsx");
+                AddCodeLine("clr ,x");
+                AddCodeLine("clr 1,x");
             } else {
-                if (CPU == CPU_6800) {
-                    /* need to sign extend */
-                    unsigned L = GetLocalLabel();
-                    AddCodeLine("pula");
-                    AddCodeLine("clrb");
-                    AddCodeLine("oraa #0");	/* generate N flag */
-                    AddCodeLine("bpl %s", LocalLabelName (L));
-                    AddCodeLine("decb");  /* B to -1 */
-                    g_defcodelabel (L);
-                    AddCodeLine("psha");
-                    AddCodeLine("pshb");
-                    AddCodeLine("pshb");
-                } else {
-                    /* need to sign extend */
-                    unsigned L = GetLocalLabel();
-                    AddCodeLine("pula");
-                    AssignX(0);
-                    AddCodeLine("oraa #0");	/* generate N flag */
-                    AddCodeLine("bpl %s", LocalLabelName (L));
-                    AddCodeLine("dex");	/* X to -1 */
-                    g_defcodelabel (L);
-                    AddCodeLine("psha");
-                    AddCodeLine("pshx");
-                }
+                AssignX(0);
+                AddCodeLine("pshx");
+            }
+            if (!(flags & CF_UNSIGNED)) {
+                /* need to sign extend */
+                unsigned L = GetLocalLabel();
+                if (CPU != CPU_6800)
+                    AddCodeLine("tsx");
+                AddCodeLine("tst 2,x");
+                AddCodeLine("bpl %s", LocalLabelName (L));
+                AddCodeLine("com ,x");
+                AddCodeLine("com 1,x");
+                g_defcodelabel (L);
             }
             push (CF_INT);
             break;
@@ -2175,12 +2777,19 @@ unsigned g_typeadjust (unsigned lhs, unsigned rhs)
 
     /* Determine the result type for the operation:
     **  - The result is const if both operands are const.
-    **  - The result is unsigned if one of the operands is unsigned.
+    **  - The result is unsigned if one of the operands is an unsigned int
+    **    or long. An unsigned char fits in an int so promotes to a signed
+    **    one.
     **  - The result is long if one of the operands is long.
     **  - Otherwise the result is int sized.
     */
     result = (lhs & CF_CONST) & (rhs & CF_CONST);
-    result |= (lhs & CF_UNSIGNED) | (rhs & CF_UNSIGNED);
+    if (ltype != CF_CHAR) {
+        result |= lhs & CF_UNSIGNED;
+    }
+    if (rtype != CF_CHAR) {
+        result |= rhs & CF_UNSIGNED;
+    }
     if (rtype == CF_LONG || ltype == CF_LONG) {
         result |= CF_LONG;
     } else {
@@ -2380,7 +2989,7 @@ void g_addlocal (unsigned flags, int offs)
 
         case CF_INT:
             offs = GenOffset(flags, offs, 1, 0);
-            AddCodeLine ("addd $%02X,x", offs & 0xFF);
+            AddDViaX(offs & 0xFF);
             break;
 
         case CF_LONG:
@@ -2436,6 +3045,93 @@ void g_addstatic (unsigned flags, uintptr_t label, long offs)
 
 
 
+static void OpDMem (unsigned flags, int op, const char* Hi, const char* Lo)
+/* Apply +, -, &, | or ^ with a variable in memory to d. Hi and Lo are the
+** operands for the high and low bytes. A char is unsigned and only uses Lo.
+** With CF_FORCECHAR only the low byte of the result is wanted.
+*/
+{
+    const char* Insn;
+
+    switch (op) {
+        case '+':   Insn = "add";   break;
+        case '-':   Insn = "sub";   break;
+        case '&':   Insn = "and";   break;
+        case '|':   Insn = "ora";   break;
+        default:    Insn = "eor";   break;
+    }
+
+    if (flags & CF_FORCECHAR) {
+        AddCodeLine ("%sb %s", Insn, Lo);
+        return;
+    }
+
+    if ((flags & CF_TYPEMASK) == CF_CHAR) {
+        AddCodeLine ("%sb %s", Insn, Lo);
+        if (op == '+') {
+            AddCodeLine ("adca #0");
+        } else if (op == '-') {
+            AddCodeLine ("sbca #0");
+        } else if (op == '&') {
+            AddCodeLine ("clra");
+        }
+        return;
+    }
+
+    if (op == '+' && CPU != CPU_6800) {
+        AddCodeLine ("addd %s", Hi);
+    } else if (op == '-' && CPU != CPU_6800) {
+        AddCodeLine ("subd %s", Hi);
+    } else {
+        AddCodeLine ("%sb %s", Insn, Lo);
+        /* The high byte of an add or sub needs the carry */
+        if (op == '+') {
+            Insn = "adc";
+        } else if (op == '-') {
+            Insn = "sbc";
+        }
+        AddCodeLine ("%sa %s", Insn, Hi);
+    }
+}
+
+
+
+void g_oplocal (unsigned flags, int offs, int op)
+/* Primary = primary op local variable for +, -, &, | and ^ */
+{
+    char Hi[16], Lo[16];
+
+    NotViaX();
+
+    offs = GenOffset(flags, offs, 1, 0);
+    xsprintf (Hi, sizeof (Hi), "$%02X,x", offs & 0xFF);
+    if ((flags & CF_TYPEMASK) == CF_CHAR) {
+        OpDMem (flags, op, Hi, Hi);
+    } else {
+        xsprintf (Lo, sizeof (Lo), "$%02X+1,x", offs & 0xFF);
+        OpDMem (flags, op, Hi, Lo);
+    }
+}
+
+
+
+void g_opstatic (unsigned flags, uintptr_t label, long offs, int op)
+/* Primary = primary op static variable for +, -, &, | and ^ */
+{
+    char Hi[256];
+
+    NotViaX();
+
+    strcpy (Hi, GetLabelName (flags, label, offs, 0));
+    if ((flags & CF_TYPEMASK) == CF_CHAR) {
+        OpDMem (flags, op, Hi, Hi);
+    } else {
+        OpDMem (flags, op, Hi, GetLabelName (flags, label, offs + 1, 0));
+    }
+}
+
+
+
 /*****************************************************************************/
 /*                           Special op= functions                           */
 /*****************************************************************************/
@@ -2460,19 +3156,18 @@ void g_addeqstatic (unsigned flags, uintptr_t label, long offs,
                 AddCodeLine("ldx #%s", lbuf);
                 if (flags & CF_FORCECHAR) {
                     if (flags & CF_CONST) {
-                        if (val <= 4) {
+                        if (val >= 1 && val <= 4) {
                             if (flags & CF_UNSIGNED) {
                                 while(val--)
                                     AddCodeLine("inc ,x");
                                 AddCodeLine("ldab ,x");
-                            } else {
+                            } else
                                 AddCodeLine("jsr baddeqstatic%d", (int)val);
-                                return;
-                            }
-                        } else {
-                            AddCodeLine("ldab #%d", (int)val);
+                            return;
                         }
-                    } else if (flags & CF_UNSIGNED) {
+                        AddCodeLine("ldab #$%02X", (unsigned char)val);
+                    }
+                    if (flags & CF_UNSIGNED) {
                         AddCodeLine("clra");
                         AddCodeLine("addb ,x");
                         AddCodeLine("stab ,x");
@@ -2514,7 +3209,7 @@ void g_addeqstatic (unsigned flags, uintptr_t label, long offs,
                 InvalidateX();
                 AddCodeLine("ldx #%s", lbuf);
                 if (flags & CF_CONST) {
-                    if (val <= 4) {
+                    if (val >= 1 && val <= 4) {
                         AddCodeLine("jsr addeqstatic%d", (int)val);
                         return;
                     } else if (val < 256) {
@@ -2915,6 +3610,142 @@ void g_subeqind (unsigned flags, unsigned offs, unsigned long val)
 
 
 
+/*****************************************************************************/
+/*                        6303 memory bit operations                         */
+/*****************************************************************************/
+
+
+
+static void BitStaticAddr (unsigned flags, uintptr_t label, long offs)
+/* Work out how to address a static. The bit instructions have no extended
+** form so anything outside the direct page has to go via X.
+*/
+{
+    BitViaX = 0;
+    if ((flags & CF_ADDRMASK) == CF_ABSOLUTE && label + offs < 0x100) {
+        sprintf (BitAddr, "$%02X", (unsigned)(label + offs));
+        return;
+    }
+    strcpy (BitAddr, GetLabelName (flags, label, offs, 0));
+    BitViaX = 1;
+}
+
+
+
+static void BitReach (void)
+/* Make BitAddr usable by aim/oim/eim/tim */
+{
+    if (BitViaX) {
+        InvalidateX();
+        AddCodeLine ("ldx #%s", BitAddr);
+        strcpy (BitAddr, "$00,x");
+        BitViaX = 0;
+    }
+}
+
+
+
+static void BitLocalAddr (unsigned flags, int Offs)
+/* Work out how aim/oim/eim/tim can reach a local */
+{
+    Offs = GenOffset (flags, Offs, 0, 0);
+    sprintf (BitAddr, "$%02X,x", Offs);
+    BitViaX = 0;
+}
+
+
+
+static void BitLoad (unsigned flags)
+/* Load the char at BitAddr as the result of the expression */
+{
+    AddCodeLine ("clra");
+    AddCodeLine ("ldab %s", BitAddr);
+    if ((flags & CF_UNSIGNED) == 0) {
+        unsigned L = GetLocalLabel();
+        AddCodeLine ("bpl %s", LocalLabelName (L));
+        AddCodeLine ("coma");
+        g_defcodelabel (L);
+    }
+}
+
+
+
+static void BitOpEq (unsigned flags, int op, unsigned long val)
+/* Do a char op= in memory and then load the result */
+{
+    const char* Insn;
+
+    BitReach ();
+    switch (op) {
+        case '&':   Insn = "aim";   break;
+        case '|':   Insn = "oim";   break;
+        default:    Insn = "eim";   break;
+    }
+    AddCodeLine ("%s #$%02X,%s", Insn, (unsigned char)val, BitAddr);
+    GetCodePos (&BitStart);
+    BitLoad (flags);
+    BitPending = BIT_RESULT;
+}
+
+
+
+void g_bitopeqstatic (unsigned flags, uintptr_t label, long offs,
+                      int op, unsigned long val)
+/* Emit a char &=, |= or ^= with a constant for a static variable (6303) */
+{
+    NotViaX();
+    BitStaticAddr (flags, label, offs);
+    BitOpEq (flags, op, val);
+}
+
+
+
+void g_bitopeqlocal (unsigned flags, int Offs, int op, unsigned long val)
+/* Emit a char &=, |= or ^= with a constant for a local variable (6303) */
+{
+    NotViaX();
+    BitLocalAddr (flags, Offs);
+    BitOpEq (flags, op, val);
+}
+
+
+
+static void BitAnd (unsigned char val)
+/* Load the char at BitAddr and mask it. If only the condition codes are
+** wanted g_test turns this into a tim.
+*/
+{
+    GetCodePos (&BitStart);
+    AddCodeLine ("clra");
+    AddCodeLine ("ldab %s", BitAddr);
+    AddCodeLine ("andb #$%02X", val);
+    BitMask = val;
+    BitPending = BIT_TEST;
+}
+
+
+
+void g_bitandstatic (unsigned flags, uintptr_t label, long offs,
+                     unsigned char val)
+/* Primary = static char & val, zero extended (6303) */
+{
+    NotViaX();
+    BitStaticAddr (flags, label, offs);
+    BitAnd (val);
+}
+
+
+
+void g_bitandlocal (unsigned flags, int Offs, unsigned char val)
+/* Primary = local char & val, zero extended (6303) */
+{
+    NotViaX();
+    BitLocalAddr (flags, Offs);
+    BitAnd (val);
+}
+
+
+
 /*****************************************************************************/
 /*                 Add a variable address to the value in d                 */
 /*****************************************************************************/
@@ -2929,7 +3760,8 @@ void g_addaddr_local (unsigned flags attribute ((unused)), int offs)
     NotViaX();		/* For now: can improve on this due to abx */
     
     if (offs > 0 && FramePtr) {
-        AddCodeLine("addd @fp");
+        FrameUsed = 1;
+        AddD("@fp", 0);
         offs += 2;
         if (offs != 0)
             AddDConst(offs);
@@ -2970,6 +3802,59 @@ void g_addaddr_static (unsigned flags, uintptr_t label, long offs)
 
 
 
+void g_subaddr_static (unsigned flags, uintptr_t label, long offs)
+/* Subtract the address of a static variable from d */
+{
+    const char* lbuf = GetLabelName (flags, label, offs, 1);
+
+    NotViaX();
+    if (CPU == CPU_6800) {
+        AddCodeLine ("subb #<%s", lbuf);
+        AddCodeLine ("sbca #>%s", lbuf);
+    } else
+        AddCodeLine ("subd #%s", lbuf);
+}
+
+
+
+static void CmpAddrStatic (unsigned flags, uintptr_t label, long offs)
+/* Compare d with the address of a static variable, leaving C and Z valid
+   for an unsigned compare */
+{
+    const char* lbuf = GetLabelName (flags, label, offs, 1);
+
+    NotViaX();
+    if (CPU == CPU_6800) {
+        unsigned L = GetLocalLabel();
+        AddCodeLine ("cmpa #>%s", lbuf);
+        AddCodeLine ("bne %s", LocalLabelName (L));
+        AddCodeLine ("cmpb #<%s", lbuf);
+        g_defcodelabel (L);
+    } else
+        AddCodeLine ("subd #%s", lbuf);
+}
+
+
+
+void g_ltaddr_static (unsigned flags, uintptr_t label, long offs)
+/* Unsigned test of d less than the address of a static variable. This is
+   used for pointers that walk an array */
+{
+    CmpAddrStatic (flags, label, offs);
+    BoolResult ("ult");
+}
+
+
+
+void g_neaddr_static (unsigned flags, uintptr_t label, long offs)
+/* Test d not equal to the address of a static variable */
+{
+    CmpAddrStatic (flags, label, offs);
+    BoolResult ("ne");
+}
+
+
+
 /*****************************************************************************/
 /*                                                                           */
 /*****************************************************************************/
@@ -3110,10 +3995,38 @@ static void oper (unsigned Flags, unsigned long Val, const char* const* Subs)
 
 
 
+static void CmpOper (unsigned Flags, unsigned long Val, const char* const* Subs,
+                     const char* Cond)
+/* Encode a compare via the tos helpers, but allow a following jump to
+** replace the helper with an inline compare and branch.
+*/
+{
+    if (Flags & CF_CONST) {
+        g_getimmed (Flags, Val, 0);
+        Flags &= ~CF_CONST;
+    }
+    GetCodePos (&CmpStart);
+    oper (Flags, Val, Subs);
+    if (sizeofarg (Flags) != 1) {
+        CmpPending = CMP_TOS;
+        CmpCond = Cond;
+        CmpFlags = Flags;
+    }
+}
+
+
+
 void g_test (unsigned flags)
 /* Test the value in the primary and set the condition codes */
 {
     NotViaX();
+    /* A masked char we can test in place */
+    if (BitPending == BIT_TEST && (flags & CF_TYPEMASK) != CF_LONG) {
+        RemoveCode (&BitStart);
+        BitReach ();
+        AddCodeLine ("tim #$%02X,%s", BitMask, BitAddr);
+        return;
+    }
     switch (flags & CF_TYPEMASK) {
         case CF_CHAR:
             if (flags & CF_FORCECHAR) {
@@ -3194,7 +4107,7 @@ void g_push (unsigned flags, unsigned long val)
                         /* Optimize some common cases */
                         switch(val) {
                         case 0xFFFFFFFF:	/* aka -1 */
-                            AddCodeLine("lda #0xFF");
+                            AddCodeLine("ldaa #$FF");
                             AddCodeLine("psha");
                             AddCodeLine("psha");
                             AddCodeLine("psha");
@@ -3350,6 +4263,7 @@ void g_call (unsigned Flags, const char* Label, int ArgSize)
         else
             AddCodeLine("clrb");
     }
+    StackNote (&StackCalls, Label);
     AddCodeLine ("jsr _%s", Label);
 }
 
@@ -3361,6 +4275,7 @@ void g_callind (unsigned Flags, int Offs, int ArgSize)
 /* Call subroutine indirect */
 {
     InvalidateX();
+    StackIndirect = 1;
     if ((Flags & CF_LOCAL) == 0) {
         /* Address is in d */
         if ((Flags & CF_USINGX) == 0)
@@ -3392,7 +4307,185 @@ void g_callind (unsigned Flags, int Offs, int ArgSize)
 void g_jump (unsigned Label)
 /* Jump to specified internal label number */
 {
-    AddCodeLine ("jmp %s", LocalLabelName (Label));
+    AddCodeLine ("jmp %s", LocalLabelName (Label));
+}
+
+
+
+static const char* CmpBranch (const char* Cond, int True)
+/* Return the long branch for a condition left in the flags by a compare,
+** or for its opposite.
+*/
+{
+    static const char* const Branches[][3] = {
+        { "eq",     "jeq",  "jne" },
+        { "ne",     "jne",  "jeq" },
+        { "lt",     "jlt",  "jge" },
+        { "le",     "jle",  "jgt" },
+        { "gt",     "jgt",  "jle" },
+        { "ge",     "jge",  "jlt" },
+        { "ult",    "jlo",  "jhs" },
+        { "ule",    "jls",  "jhi" },
+        { "ugt",    "jhi",  "jls" },
+        { "uge",    "jhs",  "jlo" },
+    };
+    unsigned I;
+
+    for (I = 0; I < sizeof (Branches) / sizeof (Branches[0]); ++I) {
+        if (strcmp (Branches[I][0], Cond) == 0) {
+            return Branches[I][True ? 1 : 2];
+        }
+    }
+    Internal ("CmpBranch: bad condition %s", Cond);
+    return NULL;
+}
+
+
+
+static void BoolJump (const char* Cond, int True, unsigned Label)
+/* Branch on the flags a bool helper would have looked at */
+{
+    unsigned L;
+
+    /* boolge is Z or greater, which isn't quite jge if the flags come
+       from more than one instruction so do exactly what it does */
+    if (strcmp (Cond, "ge") == 0) {
+        if (True) {
+            AddCodeLine ("jeq %s", LocalLabelName (Label));
+            AddCodeLine ("jgt %s", LocalLabelName (Label));
+        } else {
+            L = GetLocalLabel ();
+            AddCodeLine ("beq %s", LocalLabelName (L));
+            AddCodeLine ("jlt %s", LocalLabelName (Label));
+            g_defcodelabel (L);
+        }
+        return;
+    }
+    AddCodeLine ("%s %s", CmpBranch (Cond, True), LocalLabelName (Label));
+}
+
+
+
+static void TosCompare (unsigned Flags, const char* Cond, int True,
+                        unsigned Label)
+/* Compare the value on the stack with the primary, drop it from the stack
+** and branch on the result. This replaces the tos compare helpers.
+*/
+{
+    static const char* const Swapped[][2] = {
+        { "lt", "gt" }, { "le", "ge" }, { "gt", "lt" }, { "ge", "le" },
+        { "eq", "eq" }, { "ne", "ne" }
+    };
+    int Long = (Flags & CF_TYPEMASK) == CF_LONG;
+    int Eq = Cond[0] == 'e' || Cond[0] == 'n';
+    unsigned Size = Long ? 4 : 2;
+    unsigned L = 0;
+    unsigned I;
+    char Buf[8];
+
+    ForceTSX ();
+    if (Eq) {
+        /* We need all of Z */
+        L = GetLocalLabel ();
+        if (CPU == CPU_6800) {
+            if (Long) {
+                AddCodeLine ("cmpa $02,x");
+                AddCodeLine ("bne %s", LocalLabelName (L));
+                AddCodeLine ("cmpb $03,x");
+                AddCodeLine ("bne %s", LocalLabelName (L));
+                AddCodeLine ("ldaa @sreg");
+                AddCodeLine ("ldab @sreg+1");
+            }
+            AddCodeLine ("cmpa $00,x");
+            AddCodeLine ("bne %s", LocalLabelName (L));
+            AddCodeLine ("cmpb $01,x");
+        } else if (Long) {
+            AddCodeLine ("subd $02,x");
+            AddCodeLine ("bne %s", LocalLabelName (L));
+            AddCodeLine ("ldd @sreg");
+            AddCodeLine ("subd $00,x");
+        } else {
+            AddCodeLine ("subd $00,x");
+        }
+    } else if ((CPU != CPU_6800 && !Long) ||
+               strcmp (Cond, "gt") == 0 || strcmp (Cond, "le") == 0) {
+        /* Work out primary - stack. The flags are then the right way
+           around for the swapped condition. Only a 16bit subd gives us
+           a usable Z, which is what gt and le need */
+        if (CPU == CPU_6800) {
+            AddCodeLine ("subb $%02X,x", Size - 1);
+            AddCodeLine ("sbca $%02X,x", Size - 2);
+        } else {
+            AddCodeLine ("subd $%02X,x", Size - 2);
+        }
+        if (Long) {
+            LoadD ("@sreg", 0);
+            AddCodeLine ("sbcb $01,x");
+            AddCodeLine ("sbca $00,x");
+        }
+        for (I = 0; strcmp (Swapped[I][0], Cond); ++I)
+            ;
+        Cond = Swapped[I][1];
+    } else {
+        /* Work out stack - primary for lt and ge */
+        StoreD ("@tmp", 0);
+        if (CPU == CPU_6800) {
+            AddCodeLine ("ldaa $%02X,x", Size - 2);
+            AddCodeLine ("ldab $%02X,x", Size - 1);
+            AddCodeLine ("subb @tmp+1");
+            AddCodeLine ("sbca @tmp");
+        } else {
+            AddCodeLine ("ldd $%02X,x", Size - 2);
+            AddCodeLine ("subd @tmp");
+        }
+        if (Long) {
+            if (CPU == CPU_6800) {
+                AddCodeLine ("ldaa $00,x");
+                AddCodeLine ("ldab $01,x");
+            } else {
+                AddCodeLine ("ldd $00,x");
+            }
+            AddCodeLine ("sbcb @sreg+1");
+            AddCodeLine ("sbca @sreg");
+        }
+    }
+    if (L) {
+        g_defcodelabel (L);
+    }
+
+    /* Drop the stacked value, none of this touches the flags */
+    for (I = 0; I < Size; I += 2) {
+        PullX (0);
+    }
+    InvalidateX ();
+
+    if (Flags & CF_UNSIGNED && !Eq) {
+        xsprintf (Buf, sizeof (Buf), "u%s", Cond);
+        Cond = Buf;
+    }
+    AddCodeLine ("%s %s", CmpBranch (Cond, True), LocalLabelName (Label));
+}
+
+
+
+static int CmpJump (int True, unsigned Label)
+/* If a compare is pending turn it into a branch */
+{
+    int SP = StackPtr;
+    unsigned Pending = CmpPending;
+
+    if (Pending == CMP_NONE) {
+        return 0;
+    }
+    RemoveCode (&CmpStart);
+    if (Pending == CMP_BOOL) {
+        BoolJump (CmpCond, True, Label);
+    } else {
+        TosCompare (CmpFlags, CmpCond, True, Label);
+    }
+    StackPtr = SP;
+    InvalidateX ();
+    return 1;
 }
 
 
@@ -3400,7 +4493,9 @@ void g_jump (unsigned Label)
 void g_truejump (unsigned flags attribute ((unused)), unsigned label)
 /* Jump to label if zero flag clear */
 {
-    AddCodeLine ("jne %s", LocalLabelName (label));
+    if (!CmpJump (1, label)) {
+        AddCodeLine ("jne %s", LocalLabelName (label));
+    }
 }
 
 
@@ -3408,7 +4503,9 @@ void g_truejump (unsigned flags attribute ((unused)), unsigned label)
 void g_falsejump (unsigned flags attribute ((unused)), unsigned label)
 /* Jump to label if zero flag set */
 {
-    AddCodeLine ("jeq %s", LocalLabelName (label));
+    if (!CmpJump (0, label)) {
+        AddCodeLine ("jeq %s", LocalLabelName (label));
+    }
 }
 
 
@@ -3513,16 +4610,51 @@ void g_space (int Space, int save_d)
 }
 
 
+static void StackCheck (const char* Helper)
+/* Label the check so the linker can find it again */
+{
+    unsigned Label = GetLocalLabel ();
+
+    g_defcodelabel (Label);
+    StackNote (&StackChecks, LocalLabelName (Label));
+    AddCodeLine ("jsr %s", Helper);
+}
+
 void g_cstackcheck (void)
 /* Check for a C stack overflow */
 {
-    AddCodeLine ("jsr cstkchk");
+    StackCheck ("cstkchk");
 }
 
 void g_stackcheck (void)
 /* Check for a stack overflow */
 {
-    AddCodeLine ("jsr stkchk");
+    StackCheck ("stkchk");
+}
+
+void g_profcount (unsigned Label, unsigned Offs)
+/* Bump the 16bit profile counter at Label+Offs */
+{
+    unsigned Skip = GetLocalLabel ();
+
+    AddCodeLine ("inc %s+%u", LocalLabelName (Label), Offs + 1);
+    AddCodeLine ("bne %s", LocalLabelName (Skip));
+    AddCodeLine ("inc %s+%u", LocalLabelName (Label), Offs);
+    g_defcodelabel (Skip);
+}
+
+void g_fmtcall (const char* Helper)
+/* Call a formatted output helper, they take any argument in D or sreg:D */
+{
+    InvalidateX ();
+    AddCodeLine ("jsr %s", Helper);
+}
+
+void g_fmtfield (unsigned char Field)
+/* Set the width and flags for the next formatted output helper */
+{
+    AddCodeLine ("ldab #$%02X", Field);
+    AddCodeLine ("stab pfwid");
 }
 
 void g_add (unsigned flags, unsigned long val)
@@ -3703,16 +4835,156 @@ void g_rsub (unsigned flags, unsigned long val)
 
 
 
+/*
+ *	Constant multiply and divide
+ *
+ *	The multiply plans come from mulplan in common, which mulgen also
+ *	uses to write the library mulaxN helpers.
+ *
+ *	An unsigned divide by a constant becomes a multiply by the reciprocal
+ *	keeping the upper half. The constants are checked against every
+ *	possible input so they are exact.
+ */
+
+static void PlanMul(struct MulPlan *Best, unsigned long Val, unsigned Width)
+{
+    MulPlanBest(Best, Val, Width, CPU, IS_Get(&CodeSizeFactor));
+}
+
+static void MulEmit(const struct MulPlan *P, unsigned Width, unsigned long Val)
+{
+    MulPlanEmit(P, Width, Val, CPU, AddCodeLine);
+}
+
+/* Find M and S such that x / Div == (x * M) >> (Bits + S) for every Bits wide
+   x. If the multiplier needs one bit more than we have then Add is set and M
+   holds the low bits. The sequence is then t = (x * M) >> Bits,
+   q = (((x - t) >> 1) + t) >> (S - 1) */
+static int FindReciprocal(unsigned Bits, unsigned long Div, unsigned long *M,
+                          unsigned *S, int *Add)
+{
+    unsigned long Range = 1UL << Bits;
+    unsigned long X, T, Mul;
+    unsigned Shift;
+
+    for (*Add = 0; *Add < 2; (*Add)++) {
+        for (Shift = *Add; Shift <= Bits; Shift++) {
+            Mul = ((1UL << (Bits + Shift)) + Div - 1) / Div;
+            if (Mul >= (Range << *Add) || (*Add && Mul < Range))
+                continue;
+            for (X = 0; X < Range; X++) {
+                if (*Add == 0)
+                    T = (X * Mul) >> (Bits + Shift);
+                else {
+                    T = (X * (Mul - Range)) >> Bits;
+                    T = (((X - T) >> 1) + T) >> (Shift - 1);
+                }
+                if (T != X / Div)
+                    break;
+            }
+            if (X == Range) {
+                *M = Mul & (Range - 1);
+                *S = Shift;
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+/* Unsigned divide or modulus of the primary by a constant. The 6800 has no
+   multiply instruction so leaves it to the library */
+static int DivConst(unsigned flags, unsigned long val, int Mod)
+{
+    struct MulPlan P;
+    unsigned long M;
+    unsigned S;
+    int Add;
+
+    if (CPU == CPU_6800 || !(flags & CF_UNSIGNED) || val < 3)
+        return 0;
+
+    switch (flags & CF_TYPEMASK) {
+    case CF_CHAR:
+        if (flags & CF_FORCECHAR) {
+            if (val > 0xFF || !FindReciprocal(8, val, &M, &S, &Add))
+                return 0;
+            if (Mod || Add)
+                AddCodeLine("stab @tmp");
+            AddCodeLine("ldaa #$%02X", (unsigned)M);
+            AddCodeLine("mul");
+            if (Add) {
+                AddCodeLine("staa @tmp1");
+                AddCodeLine("ldab @tmp");
+                AddCodeLine("subb @tmp1");
+                AddCodeLine("lsrb");
+                AddCodeLine("addb @tmp1");
+                while (--S)
+                    AddCodeLine("lsrb");
+            } else {
+                while (S--)
+                    AddCodeLine("lsra");
+                AddCodeLine("tab");
+            }
+            if (Mod) {
+                PlanMul(&P, val, MW_8);
+                MulEmit(&P, MW_8, val);
+                AddCodeLine("stab @tmp1");
+                AddCodeLine("ldab @tmp");
+                AddCodeLine("subb @tmp1");
+            }
+            return 1;
+        }
+        /* FALLTHROUGH */
+    case CF_INT:
+        if (val > 0xFFFF || !FindReciprocal(16, val, &M, &S, &Add))
+            return 0;
+        /* umulhiax leaves the original value in @tmp */
+        InvalidateX();
+        AssignX(M);
+        AddCodeLine("jsr umulhiax");
+        if (Add) {
+            AddCodeLine("std @tmp1");
+            AddCodeLine("ldd @tmp");
+            AddCodeLine("subd @tmp1");
+            AddCodeLine("lsrd");
+            AddCodeLine("addd @tmp1");
+            S--;
+        }
+        LsrDBy(S);
+        if (Mod) {
+            PlanMul(&P, val, MW_16);
+            MulEmit(&P, MW_16, val);
+            AddCodeLine("std @tmp1");
+            AddCodeLine("ldd @tmp");
+            AddCodeLine("subd @tmp1");
+        }
+        return 1;
+    }
+    return 0;
+}
+
+
+
 void g_mul (unsigned flags, unsigned long val)
 /* Primary = TOS * Primary */
 {
     static const char* const ops[4] = {
         "tosmulax", "tosumulax", "tosmuleax", "tosumuleax"
     };
-
+    struct MulPlan P;
     int p2;
 
     NotViaX();
+    /* Anything times zero, or a byte times a multiple of 256, is zero.
+       There is no plan to inline for it */
+    if ((flags & CF_CONST) &&
+        ((flags & CF_TYPEMASK) == CF_LONG ? val :
+         (flags & CF_FORCECHAR) ? val & 0xFF : val & 0xFFFF) == 0) {
+        g_getimmed (flags, 0, 0);
+        return;
+    }
+
     /* Do strength reduction if the value is constant and a power of two */
     if (flags & CF_CONST && (p2 = PowerOf2 (val)) >= 0) {
         /* Generate a shift instead */
@@ -3720,8 +4992,6 @@ void g_mul (unsigned flags, unsigned long val)
         return;
     }
 
-    /* OPTIMIZE: Spot near powers of two by bit count for add/push/add/pop/add
-       sequences ? */
     /* If the right hand side is const, the lhs is not on stack but still
     ** in the primary register.
     */
@@ -3731,68 +5001,40 @@ void g_mul (unsigned flags, unsigned long val)
 
             case CF_CHAR:
                 if (flags & CF_FORCECHAR) {
-                    /* Handle some special cases */
-                    switch (val) {
-
-                        case 3:
-                            AddCodeLine ("stab @tmp1");
-                            AddCodeLine ("aslb");
-                            AddCodeLine ("addb @tmp1");
-                            return;
-
-                        case 5:
-                            AddCodeLine ("stab @tmp1");
-                            AddCodeLine ("aslb");
-                            AddCodeLine ("aslb");
-                            AddCodeLine ("addb @tmp1");
-                            return;
-
-                        case 6:
-                            AddCodeLine ("stab @tmp1");
-                            AddCodeLine ("aslb");
-                            AddCodeLine ("addb @tmp1");
-                            AddCodeLine ("aslb");
-                            return;
-
-                        case 10:
-                            AddCodeLine ("stab @tmp1");
-                            AddCodeLine ("aslb");
-                            AddCodeLine ("aslb");
-                            AddCodeLine ("addb @tmp1");
-                            AddCodeLine ("aslb");
-                            return;
-                    }
+                    /* Always smaller and faster inline */
+                    PlanMul (&P, val, MW_8);
+                    MulEmit (&P, MW_8, val);
+                    return;
                 }
                 /* FALLTHROUGH */
 
             case CF_INT:
                 InvalidateX();
-                switch (val) {
-                    case 3:
-                        AddCodeLine ("jsr mulax3");
-                        return;
-                    case 5:
-                        AddCodeLine ("jsr mulax5");
-                        return;
-                    case 6:
-                        AddCodeLine ("jsr mulax6");
-                        return;
-                    case 7:
-                        AddCodeLine ("jsr mulax7");
-                        return;
-                    case 9:
-                        AddCodeLine ("jsr mulax9");
-                        return;
-                    case 10:
-                        AddCodeLine ("jsr mulax10");
-                        return;
-                    case 12:
-                        AddCodeLine ("jsr mulax12");
-                        return;
+                PlanMul (&P, val, MW_16);
+                /* The library has mulgen written helpers for the small
+                   values */
+                if (MulHelper (val) &&
+                    P.Bytes * 100 > 4 * IS_Get (&CodeSizeFactor)) {
+                    AddCodeLine ("jsr mulax%u", (unsigned)val);
+                    return;
+                }
+                /* The 6803 library multiply is quite fast */
+                if (P.Bytes * 100 <= 16 * IS_Get (&CodeSizeFactor) &&
+                    (CPU == CPU_6800 || P.Cycles < 90)) {
+                    MulEmit (&P, MW_16, val);
+                    return;
                 }
                 break;
 
             case CF_LONG:
+                if (CPU == CPU_6800)
+                    break;
+                InvalidateX();
+                PlanMul (&P, val, MW_32);
+                if (P.Bytes * 100 <= 24 * IS_Get (&CodeSizeFactor)) {
+                    MulEmit (&P, MW_32, val);
+                    return;
+                }
                 break;
 
             default:
@@ -3829,6 +5071,8 @@ void g_div (unsigned flags, unsigned long val)
     if ((flags & CF_CONST) && (p2 = PowerOf2 (val)) >= 0) {
         /* Generate a shift instead */
         g_asr (flags, p2);
+    } else if ((flags & CF_CONST) && DivConst (flags, val, 0)) {
+        /* Multiplied by the reciprocal */
     } else {
         /* Generate a division */
         if (flags & CF_CONST) {
@@ -3856,6 +5100,8 @@ void g_mod (unsigned flags, unsigned long val)
     if ((flags & CF_CONST) && (flags & CF_UNSIGNED) && val != 0xFFFFFFFF && (p2 = PowerOf2 (val)) >= 0) {
         /* We can do that with an AND operation */
         g_and (flags, val - 1);
+    } else if ((flags & CF_CONST) && DivConst (flags, val, 1)) {
+        /* Multiplied by the reciprocal and subtracted */
     } else {
         /* Do it the hard way... */
         if (flags & CF_CONST) {
@@ -4136,6 +5382,170 @@ void g_and (unsigned Flags, unsigned long Val)
 
 
 
+/*
+ *	32bit shifts by a constant. Whole bytes are moved and then at most
+ *	seven bits are shifted, and only the bytes that can still hold part of
+ *	the value are shifted.
+ */
+
+/* Is it worth inlining Bytes of code instead of Calls bytes of helper calls */
+static int InlineShift(unsigned Bytes, unsigned Calls)
+{
+    return Bytes * 100 <= (Calls + 4) * IS_Get(&CodeSizeFactor);
+}
+
+/* Shift the full 32bits left */
+static void AslLongBits(unsigned n)
+{
+    if (n == 0)
+        return;
+    if (!InlineShift(n * (CPU == CPU_6800 ? 8 : 7), n > 4 ? 6 : 3)) {
+        InvalidateX();
+        if (n > 4) {
+            AddCodeLine("jsr shleax4");
+            n -= 4;
+        }
+        AddCodeLine("jsr shleax%u", n);
+        return;
+    }
+    while(n--) {
+        AslD();
+        AddCodeLine("rol @sreg+1");
+        AddCodeLine("rol @sreg");
+    }
+}
+
+/* Shift the full 32bits right */
+static void AsrLongBits(unsigned flags, unsigned n)
+{
+    const char *h = (flags & CF_UNSIGNED) ? "shreax" : "asreax";
+    if (n == 0)
+        return;
+    if (!InlineShift(n * 8, n > 4 ? 6 : 3)) {
+        InvalidateX();
+        if (n > 4) {
+            AddCodeLine("jsr %s4", h);
+            n -= 4;
+        }
+        AddCodeLine("jsr %s%u", h, n);
+        return;
+    }
+    while(n--) {
+        AddCodeLine((flags & CF_UNSIGNED) ? "lsr @sreg" : "asr @sreg");
+        AddCodeLine("ror @sreg+1");
+        AddCodeLine("rora");
+        AddCodeLine("rorb");
+    }
+}
+
+static void AslLong(unsigned val)
+{
+    unsigned n = val & 7;
+
+    switch(val >> 3) {
+    case 0:
+        AslLongBits(n);
+        break;
+    case 1:
+        /* One case that is awkward on 6803 */
+        AddCodeLine ("psha");
+        AddCodeLine ("ldaa @sreg+1");
+        AddCodeLine ("staa @sreg");
+        AddCodeLine ("pula");
+        AddCodeLine ("staa @sreg+1");
+        AddCodeLine ("tba");
+        AddCodeLine ("clrb");
+        /* The low byte is now zero so leave it be */
+        if (!InlineShift(n * 7, n > 4 ? 6 : 3)) {
+            AslLongBits(n);
+            break;
+        }
+        while(n--) {
+            AddCodeLine ("asla");
+            AddCodeLine ("rol @sreg+1");
+            AddCodeLine ("rol @sreg");
+        }
+        break;
+    case 2:
+        /* Shift while it is still only 16bits */
+        AslDBy(n);
+        StoreD("@sreg", 0);
+        AssignD(0, 0);
+        break;
+    case 3:
+        while(n--)
+            AddCodeLine ("aslb");
+        AddCodeLine ("stab @sreg");
+        AddCodeLine ("clra");
+        AddCodeLine ("clrb");
+        AddCodeLine ("staa @sreg+1");
+        break;
+    }
+}
+
+/* Fill @sreg with the sign (or zero) of the upper byte loaded into A */
+static void SignFillSreg(unsigned flags)
+{
+    AssignX(0);
+    if ((flags & CF_UNSIGNED) == 0) {
+        unsigned L = GetLocalLabel();
+        AddCodeLine ("tsta");
+        AddCodeLine ("bpl %s", LocalLabelName (L));
+        AddCodeLine ("dex");
+        g_defcodelabel (L);
+    }
+    AddCodeLine ("stx @sreg");
+}
+
+static void AsrLong(unsigned flags, unsigned val)
+{
+    unsigned n = val & 7;
+
+    switch(val >> 3) {
+    case 0:
+        AsrLongBits(flags, n);
+        break;
+    case 1:
+        if (flags & CF_UNSIGNED)
+            AddCodeLine ("jsr shreax8");
+        else
+            AddCodeLine ("jsr asreax8");
+        /* The top byte is now zero or sign so leave it be */
+        if (!InlineShift(n * 7, n > 4 ? 6 : 3)) {
+            AsrLongBits(flags, n);
+            break;
+        }
+        while(n--) {
+            AddCodeLine ((flags & CF_UNSIGNED) ? "lsr @sreg+1" : "asr @sreg+1");
+            AddCodeLine ("rora");
+            AddCodeLine ("rorb");
+        }
+        break;
+    case 2:
+        LoadD("@sreg", 0);
+        SignFillSreg(flags);
+        if (flags & CF_UNSIGNED)
+            LsrDBy(n);
+        else while(n--)
+            AsrD();
+        break;
+    case 3:
+        AddCodeLine ("ldaa @sreg");
+        SignFillSreg(flags);
+        AddCodeLine ("tab");
+        if (flags & CF_UNSIGNED) {
+            AddCodeLine ("clra");
+            while(n--)
+                AddCodeLine ("lsrb");
+        } else {
+            AddCodeLine ("ldaa @sreg");
+            while(n--)
+                AddCodeLine ("asrb");
+        }
+        break;
+    }
+}
+
 void g_asr (unsigned flags, unsigned long val)
 /* Primary = TOS >> Primary */
 {
@@ -4184,61 +5594,7 @@ void g_asr (unsigned flags, unsigned long val)
 
             case CF_LONG:
                 /* REVIEW: we could go with oversize shift = 0 better ? */
-                val &= 0x1F;
-                if (val >= 24) {
-                    AssignX(0);
-                    AddCodeLine ("ldab @sreg");
-                    if ((flags & CF_UNSIGNED) == 0) {
-                        unsigned L = GetLocalLabel();
-                        AddCodeLine ("bpl %s", LocalLabelName (L));
-                        AddCodeLine ("dex");
-                        g_defcodelabel (L);
-                    }
-                    AddCodeLine ("stx @sreg");
-                    /* For unsigned the sreg goes to 0, for signed it's
-                       FFFF or 0000, and copy a byte of that into the top
-                       half of our 16bit accumulator */
-                    if ((flags & CF_UNSIGNED) == 0)
-                        AddCodeLine("ldaa @sreg");
-                    else
-                        AddCodeLine("clra");
-                    val -= 24;
-                }
-                if (val >= 16) {
-                    AssignX(0);
-                    LoadD("@sreg", 0);
-                    if ((flags & CF_UNSIGNED) == 0) {
-                        unsigned L = GetLocalLabel();
-                        AddCodeLine ("bpl %s", LocalLabelName (L));
-                        AddCodeLine ("dex");
-                        g_defcodelabel (L);
-                    }
-                    AddCodeLine ("stx @sreg");
-                    val -= 16;
-                }
-                if (val >= 8) {
-                    if (flags & CF_UNSIGNED) {
-                        AddCodeLine ("jsr shreax8");
-                    } else {
-                        AddCodeLine ("jsr asreax8");
-                    }
-                    val -= 8;
-                }
-                if (val >= 4) {
-                    if (flags & CF_UNSIGNED) {
-                        AddCodeLine ("jsr shreax4");
-                    } else {
-                        AddCodeLine ("jsr asreax4");
-                    }
-                    val -= 4;
-                }
-                if (val > 0) {
-                    if (flags & CF_UNSIGNED) {
-                        AddCodeLine ("jsr shreax%ld", val);
-                    } else {
-                        AddCodeLine ("jsr asreax%ld", val);
-                    }
-                }
+                AsrLong (flags, val & 0x1F);
                 return;
 
             default:
@@ -4279,48 +5635,7 @@ void g_asl (unsigned flags, unsigned long val)
                 return;
 
             case CF_LONG:
-                val &= 0x1F;
-                if (val >= 24) {
-                    AddCodeLine ("stab @sreg+1");
-                    AddCodeLine ("clrb");
-                    AddCodeLine ("clra");
-                    AddCodeLine ("stab @sreg");
-                    val -= 24;
-                }
-                if (val >= 16) {
-                    StoreD("@sreg", 0);
-                    AddCodeLine ("clra");
-                    AddCodeLine ("clrb");
-                    val -= 16;
-                }
-                if (val >= 8) {
-                    /* One case that is awkward on 6803 */
-                    AddCodeLine ("psha");
-                    AddCodeLine ("ldaa @sreg+1");
-                    AddCodeLine ("staa @sreg");
-                    AddCodeLine ("pula");
-                    AddCodeLine ("staa @sreg+1");
-                    AddCodeLine ("tba");
-                    AddCodeLine ("clrb");
-                    val -= 8;
-                }
-                if (val > 4) {
-                    InvalidateX();
-                    if (flags & CF_UNSIGNED) {
-                        AddCodeLine ("jsr shleax4");
-                    } else {
-                        AddCodeLine ("jsr asleax4");
-                    }
-                    val -= 4;
-                }
-                if (val > 0) {
-                    InvalidateX();
-                    if (flags & CF_UNSIGNED) {
-                        AddCodeLine ("jsr shleax%ld", val);
-                    } else {
-                        AddCodeLine ("jsr asleax%ld", val);
-                    }
-                }
+                AslLong (val & 0x1F);
                 return;
 
             default:
@@ -4622,14 +5937,14 @@ void g_eq (unsigned flags, unsigned long val)
                         AddCodeLine ("cmpb #$%02X", (unsigned char)val);
                     else
                         AddCodeLine ("tstb");
-                    AddCodeLine ("jsr booleq");
+                    BoolResult ("eq");
                     return;
                 }
                 /* FALLTHROUGH */
 
             case CF_INT:
                 SubDConstCompare(val);
-                AddCodeLine ("jsr booleq");
+                BoolResult ("eq");
                 return;
 
             case CF_LONG:
@@ -4653,7 +5968,7 @@ void g_eq (unsigned flags, unsigned long val)
                 offs = GenTSXByte(1);
                 AddCodeLine ("cmpb $%02X,x", offs);
                 AddCodeLine("ins");
-                AddCodeLine ("jsr booleq");
+                BoolResult ("eq");
                 pop(flags);
                 return;
             }
@@ -4663,7 +5978,7 @@ void g_eq (unsigned flags, unsigned long val)
                 offs = GenTSXByte(1);
                 SubDViaX(offs);
                 PullX(0);
-                AddCodeLine ("jsr booleq");
+                BoolResult ("eq");
                 pop(flags);
                 return;
             }
@@ -4671,7 +5986,7 @@ void g_eq (unsigned flags, unsigned long val)
     }
 
     /* Use long way over the stack */
-    oper (flags, val, ops);
+    CmpOper (flags, val, ops, "eq");
 }
 
 
@@ -4700,14 +6015,14 @@ void g_ne (unsigned flags, unsigned long val)
                         AddCodeLine ("cmpb #$%02X", (unsigned char)val);
                     else
                         AddCodeLine ("tstb");
-                    AddCodeLine ("jsr boolne");
+                    BoolResult ("ne");
                     return;
                 }
                 /* FALLTHROUGH */
 
             case CF_INT:
                 SubDConstCompare(val);
-                AddCodeLine ("jsr boolne");
+                BoolResult ("ne");
                 return;
 
             case CF_LONG:
@@ -4732,7 +6047,7 @@ void g_ne (unsigned flags, unsigned long val)
                 offs = GenTSXByte(1);
                 AddCodeLine ("cmpb $%02X,x", offs);
                 AddCodeLine ("ins");
-                AddCodeLine ("jsr boolne");
+                BoolResult ("ne");
                 pop(flags);
                 return;
             }
@@ -4742,14 +6057,14 @@ void g_ne (unsigned flags, unsigned long val)
                 offs = GenTSXByte(1);
                 SubDViaX(offs);
                 PullX(0);
-                AddCodeLine ("jsr boolne");
+                BoolResult ("ne");
                 pop(flags);
                 return;
             }
     }
 
     /* Use long way over the stack */
-    oper (flags, val, ops);
+    CmpOper (flags, val, ops, "ne");
 }
 
 
@@ -4787,14 +6102,14 @@ void g_lt (unsigned flags, unsigned long val)
                 case CF_CHAR:
                     if (flags & CF_FORCECHAR) {
                         AddCodeLine ("cmpb #$%02X", (unsigned char)val);
-                        AddCodeLine ("jsr boolult");
+                        BoolResult ("ult");
                         return;
                     }
                     /* FALLTHROUGH */
 
                 case CF_INT:
                     SubDConstCompare(val);
-                    AddCodeLine ("jsr boolult");
+                    BoolResult ("ult");
                     return;
 
                 case CF_LONG:
@@ -4805,7 +6120,7 @@ void g_lt (unsigned flags, unsigned long val)
                     AddCodeLine ("sbcb #$%02X", (unsigned char)(val >> 16));
                     AddCodeLine ("ldaa @sreg");
                     AddCodeLine ("sbca #$%02X", (unsigned char)(val >> 24));
-                    AddCodeLine ("jsr boolult");
+                    BoolResult ("ult");
                     return;
 
                 default:
@@ -4835,7 +6150,7 @@ void g_lt (unsigned flags, unsigned long val)
 
                 case CF_LONG:
                     /* Just check the high byte */
-                    AddCodeLine ("ldab @sreg+1");
+                    AddCodeLine ("ldab @sreg");
                     AddCodeLine ("aslb");              /* Bit 7 -> carry */
                     AssignD(0, 1);
                     AddCodeLine ("rolb");
@@ -4853,7 +6168,7 @@ void g_lt (unsigned flags, unsigned long val)
                 case CF_CHAR:
                     if (flags & CF_FORCECHAR) {
                         AddCodeLine ("subb #$%02X", (unsigned int)val);
-                        AddCodeLine ("jsr boollt");
+                        BoolResult ("lt");
                         return;
                     }
                     /* FALLTHROUGH */
@@ -4862,7 +6177,7 @@ void g_lt (unsigned flags, unsigned long val)
                     if (CPU != CPU_6800) {
                         /* Do a subtraction */
                         SubDConst(val);
-                        AddCodeLine ("jsr boollt");
+                        BoolResult ("lt");
                         return;
                     }
 
@@ -4893,9 +6208,9 @@ void g_lt (unsigned flags, unsigned long val)
                     AddCodeLine("sba");
                     AddCodeLine("tba");
                     if (flags & CF_UNSIGNED)
-                        AddCodeLine ("jsr boolult");
+                        BoolResult ("ult");
                     else
-                        AddCodeLine ("jsr boollt");
+                        BoolResult ("lt");
                     pop (flags);
                     return;
                 }
@@ -4907,16 +6222,16 @@ void g_lt (unsigned flags, unsigned long val)
                     PullX(0);
                     SubD("@tmp", 0);
                     if (flags & CF_UNSIGNED)
-                        AddCodeLine ("jsr boolult");
+                        BoolResult ("ult");
                     else
-                        AddCodeLine ("jsr boollt");
+                        BoolResult ("lt");
                     pop (flags);
                     return;
                 }
         }
     }
     /* Use long way over the stack */
-    oper (flags, val, ops);
+    CmpOper (flags, val, ops, "lt");
 }
 
 
@@ -5040,9 +6355,9 @@ void g_le (unsigned flags, unsigned long val)
                     AddCodeLine("sba");
                     AddCodeLine("tba");
                     if (flags & CF_UNSIGNED)
-                        AddCodeLine ("jsr boolule");
+                        BoolResult ("ule");
                     else
-                        AddCodeLine ("jsr boolle");
+                        BoolResult ("le");
                     pop (flags);
                     return;
                 }
@@ -5054,9 +6369,9 @@ void g_le (unsigned flags, unsigned long val)
                     PullX(0);
                     SubD("@tmp", 0);
                     if (flags & CF_UNSIGNED)
-                        AddCodeLine ("jsr boolule");
+                        BoolResult ("ule");
                     else
-                        AddCodeLine ("jsr boolle");
+                        BoolResult ("le");
                     InvalidateX();
                     pop (flags);
                     return;
@@ -5064,7 +6379,7 @@ void g_le (unsigned flags, unsigned long val)
         }
     }
     /* Use long way over the stack */
-    oper (flags, val, ops);
+    CmpOper (flags, val, ops, "le");
 }
 
 
@@ -5204,9 +6519,9 @@ void g_gt (unsigned flags, unsigned long val)
                     AddCodeLine("sba");
                     AddCodeLine("tba");
                     if (flags & CF_UNSIGNED)
-                        AddCodeLine ("jsr boolugt");
+                        BoolResult ("ugt");
                     else
-                        AddCodeLine ("jsr boolgt");
+                        BoolResult ("gt");
                     pop (flags);
                     return;
                 }
@@ -5218,16 +6533,16 @@ void g_gt (unsigned flags, unsigned long val)
                     PullX(0);
                     SubD("@tmp", 0);
                     if (flags & CF_UNSIGNED)
-                        AddCodeLine ("jsr boolugt");
+                        BoolResult ("ugt");
                     else
-                        AddCodeLine ("jsr boolgt");
+                        BoolResult ("gt");
                     pop (flags);
                     return;
                 }
         }
     }
     /* Use long way over the stack */
-    oper (flags, val, ops);
+    CmpOper (flags, val, ops, "gt");
 }
 
 void g_ge (unsigned flags, unsigned long val)
@@ -5266,7 +6581,7 @@ void g_ge (unsigned flags, unsigned long val)
                         /* Do a subtraction. Condition is true if carry or z set */
                         AddCodeLine ("cmpb #$%02X", (unsigned char)val);
                         /* Do not usr clr as it clears carry */
-                        AddCodeLine ("jsr booluge");
+                        BoolResult ("uge");
                         return;
                     }
                     /* FALLTHROUGH */
@@ -5274,17 +6589,17 @@ void g_ge (unsigned flags, unsigned long val)
                 case CF_INT:
                     /* Do a subtraction. Condition is true if carry clear */
                     SubDConst(val);
-                    AddCodeLine ("jsr booluge");
+                    BoolResult ("uge");
                     return;
 
                 case CF_LONG:
                     /* Do a subtraction. Condition is true if carry clear */
                     SubDConst(val);
-                    AddCodeLine ("ldab @sreg");
-                    AddCodeLine ("sbcb #$%02X", (unsigned char)(val >> 16));
                     AddCodeLine ("ldab @sreg+1");
+                    AddCodeLine ("sbcb #$%02X", (unsigned char)(val >> 16));
+                    AddCodeLine ("ldab @sreg");
                     AddCodeLine ("sbcb #$%02X", (unsigned char)(val >> 24));
-                    AddCodeLine ("jsr booluge");
+                    BoolResult ("uge");
                     return;
 
                 default:
@@ -5317,7 +6632,7 @@ void g_ge (unsigned flags, unsigned long val)
                 case CF_LONG:
                     /* OPTIMIZE: 6303 can use TIM */
                     /* Just test the high byte */
-                    AddCodeLine ("ldab @sreg+1");
+                    AddCodeLine ("ldab @sreg");
                     AddCodeLine ("comb");
                     AddCodeLine ("rolb");
                     AssignD(0, 1);
@@ -5337,20 +6652,31 @@ void g_ge (unsigned flags, unsigned long val)
                     if (flags & CF_FORCECHAR) {
                         AddCodeLine ("subb #$%02X", (unsigned char)val);
                         if (flags & CF_UNSIGNED)
-                            AddCodeLine ("jsr booluge");
+                            BoolResult ("uge");
                         else
-                            AddCodeLine ("jsr boolge");
+                            BoolResult ("ge");
                         return;
                     }
                     /* FALLTHROUGH */
 
                 case CF_INT:
+                    /* The 6800 byte compare only gets the carry and zero
+                       flags right, and a subtract only gets the zero flag
+                       of the high byte. Flipping both sign bits turns the
+                       signed compare into an unsigned one that needs only
+                       the carry */
+                    if (CPU == CPU_6800 && !(flags & CF_UNSIGNED)) {
+                        AddCodeLine ("eora #$80");
+                        SubDConstCompare(val ^ 0x8000);
+                        BoolResult ("uge");
+                        return;
+                    }
                     /* Do a subtraction */
                     SubDConstCompare(val);
                     if (flags & CF_UNSIGNED)
-                        AddCodeLine ("jsr booluge");
+                        BoolResult ("uge");
                     else
-                        AddCodeLine ("jsr boolge");
+                        BoolResult ("ge");
                     return;
 
                 case CF_LONG:
@@ -5379,9 +6705,9 @@ void g_ge (unsigned flags, unsigned long val)
                     AddCodeLine("sba");
                     AddCodeLine("tba");
                     if (flags & CF_UNSIGNED)
-                        AddCodeLine ("jsr booluge");
+                        BoolResult ("uge");
                     else
-                        AddCodeLine ("jsr boolge");
+                        BoolResult ("ge");
                     pop (flags);
                     return;
                 }
@@ -5393,16 +6719,16 @@ void g_ge (unsigned flags, unsigned long val)
                     PullX(0);
                     SubD("@tmp", 0);
                     if (flags & CF_UNSIGNED)
-                        AddCodeLine ("jsr booluge");
+                        BoolResult ("uge");
                     else
-                        AddCodeLine ("jsr boolge");
+                        BoolResult ("ge");
                     pop (flags);
                     return;
                 }
         }
     }
     /* Use long way over the stack */
-    oper (flags, val, ops);
+    CmpOper (flags, val, ops, "ge");
 }
 
 
@@ -5589,9 +6915,12 @@ void g_initstatic (unsigned InitLabel, unsigned VarLabel, unsigned Size)
             AddCodeLine ("pshx");
         }
         AddCodeLine ("jsr %s", GetLabelName (CF_EXTERNAL, (uintptr_t) "memcpy", 0, 0));
-        PullX(0);
-        PullX(0);
-        PullX(0);
+        /* On the 6800 memcpy cleans up its own arguments */
+        if (CPU != CPU_6800) {
+            PullX(0);
+            PullX(0);
+            PullX(0);
+        }
     }
 }
 
@@ -5631,6 +6960,26 @@ void g_restore_regvar(int Offset, int Reg, unsigned Size)
 
 
 
+void g_switchhot (unsigned long Val, unsigned Label, unsigned Depth)
+/* Test for the most common case before the switch proper */
+{
+    unsigned Skip;
+
+    NotViaX();
+    AddCodeLine ("cmpb #$%02X", (unsigned char) Val);
+    if (Depth == 1) {
+        AddCodeLine ("jeq %s", LocalLabelName (Label));
+        return;
+    }
+    Skip = GetLocalLabel ();
+    AddCodeLine ("bne %s", LocalLabelName (Skip));
+    AddCodeLine ("cmpa #$%02X", (unsigned char) (Val >> 8));
+    AddCodeLine ("jeq %s", LocalLabelName (Label));
+    g_defcodelabel (Skip);
+}
+
+
+
 void g_switch (Collection* Nodes, unsigned DefaultLabel, unsigned Depth)
 /* Generate code for a switch statement */
 {
@@ -5714,12 +7063,37 @@ void g_switch (Collection* Nodes, unsigned DefaultLabel, unsigned Depth)
 /*                       Optimizer Hinting                                   */
 /*****************************************************************************/
 
+/* The markers tell copt the registers named are dead from here on and the
+   rules rely on that to drop or reorder loads, so we must not reuse a
+   value we are tracking in one of them */
 void g_statement(void)
 {
-    if (XState & XSTATE_VALID)
+    if (XState & XSTATE_VALID) {
         AddCodeLine(";invalid DP");
-    else
+        InvalidateD();
+    } else {
         AddCodeLine(";invalid XDP");
+        InvalidateValues();
+    }
+}
+
+void g_charresult (unsigned flags)
+/* A char was stored from B. Make the primary a char of the given type in
+** case the value is used.
+*/
+{
+    GetCodePos (&BitStart);
+    g_regchar (flags);
+    BitPending = BIT_RESULT;
+}
+
+
+
+void g_dropresult(void)
+/* The value of the expression just generated is not used */
+{
+    if (BitPending == BIT_RESULT)
+        RemoveCode(&BitStart);
 }
 
 /*****************************************************************************/
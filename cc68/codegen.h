@@ -92,6 +92,7 @@
 #define CF_FORCECHAR    0x0200  /* Handle chars as chars, not ints */
 #define CF_USINGX	0x0400	/* Working with X not D */
 #define CF_REG          0x0800  /* Value is in primary register */
+#define CF_VOLATILE     0x10000 /* Must really access memory each time */
 
 /* Type of static address */
 #define CF_ADDRMASK     0xF000  /* Type of address */
@@ -132,6 +133,13 @@ void g_moveable(void);
 /* Tell the code generator this block must not assume existing state as it
    will be moved about */
 
+void g_removed(void);
+/* Tell the code generator code has been thrown away */
+
+void g_noteline(const char *Line);
+/* Called for each line of code generated so the code generator can tell
+   when its idea of the long accumulator is no longer valid */
+
 
 /*****************************************************************************/
 /*                              Segment support                              */
@@ -239,6 +247,11 @@ unsigned g_typecast (unsigned lhs, unsigned rhs);
 ** by the lhs value. Return the result value.
 */
 
+void g_charresult (unsigned flags);
+/* A char was stored from B. Make the primary a char of the given type in
+** case the value is used.
+*/
+
 void g_scale (unsigned flags, long val);
 /* Scale the value in the primary register by the given value. If val is positive,
 ** scale up, is val is negative, scale down. This function is used to scale
@@ -260,6 +273,25 @@ void g_enter (const char *name, unsigned flags, unsigned argsize);
 void g_leave (int isvoid, unsigned flags, unsigned argsize);
 /* Function epilogue */
 
+void g_stackinfo (const char* name);
+/* Emit the stack usage record for the linker if the function was checked */
+
+int g_helperpops (const char *Name);
+/* Return the number of bytes the helper Name pops from the stack, or -1 if
+   it is not one of the helpers that take an operand from the stack */
+
+int g_aftertoscall (void);
+/* Return true if the last instruction called a helper that pops its operand
+   from behind the return address */
+
+int g_hasframe (void);
+/* Return true if the function is using a frame pointer so cannot simply
+   return from the middle of its body */
+
+void g_return (int isvoid, unsigned flags, unsigned argsize);
+/* Return from a function whose stack is already back at the return
+   address */
+
 /*****************************************************************************/
 /*                           Fetching memory cells                           */
 /*****************************************************************************/
@@ -323,6 +355,12 @@ void g_addlocal (unsigned flags, int offs);
 void g_addstatic (unsigned flags, uintptr_t label, long offs);
 /* Add a static variable to ax */
 
+void g_oplocal (unsigned flags, int offs, int op);
+/* Primary = primary op local variable for +, -, &, | and ^ */
+
+void g_opstatic (unsigned flags, uintptr_t label, long offs, int op);
+/* Primary = primary op static variable for +, -, &, | and ^ */
+
 
 
 /*****************************************************************************/
@@ -353,6 +391,28 @@ void g_subeqind (unsigned flags, unsigned offs, unsigned long val);
 
 
 
+/*****************************************************************************/
+/*                        6303 memory bit operations                         */
+/*****************************************************************************/
+
+
+
+void g_bitopeqstatic (unsigned flags, uintptr_t label, long offs,
+                      int op, unsigned long val);
+/* Emit a char &=, |= or ^= with a constant for a static variable (6303) */
+
+void g_bitopeqlocal (unsigned flags, int offs, int op, unsigned long val);
+/* Emit a char &=, |= or ^= with a constant for a local variable (6303) */
+
+void g_bitandstatic (unsigned flags, uintptr_t label, long offs,
+                     unsigned char val);
+/* Primary = static char & val, zero extended (6303) */
+
+void g_bitandlocal (unsigned flags, int offs, unsigned char val);
+/* Primary = local char & val, zero extended (6303) */
+
+
+
 /*****************************************************************************/
 /*                 Add a variable address to the value in ax                 */
 /*****************************************************************************/
@@ -365,6 +425,15 @@ void g_addaddr_local (unsigned flags, int offs);
 void g_addaddr_static (unsigned flags, uintptr_t label, long offs);
 /* Add the address of a static variable to ax */
 
+void g_subaddr_static (unsigned flags, uintptr_t label, long offs);
+/* Subtract the address of a static variable from ax */
+
+void g_ltaddr_static (unsigned flags, uintptr_t label, long offs);
+/* Unsigned test of ax less than the address of a static variable */
+
+void g_neaddr_static (unsigned flags, uintptr_t label, long offs);
+/* Test ax not equal to the address of a static variable */
+
 
 
 /*****************************************************************************/
@@ -398,6 +467,16 @@ void g_swap (unsigned flags);
 void g_call (unsigned Flags, const char* Label, int ArgSize);
 /* Call the specified subroutine name */
 
+int g_cantailcall (unsigned Flags, unsigned ParamSize, unsigned ArgSize, int SP);
+/* Return true if a call with ParamSize bytes of arguments pushed, leaving
+   the stack pointer at SP, can be turned into a tail call */
+
+void g_tailcall (const char* Label, unsigned ParamSize);
+/* Tail call the specified subroutine name */
+
+void g_tailjump (unsigned Label, unsigned ParamSize);
+/* Tail call ourself by jumping back to the start of the function body */
+
 void g_callind (unsigned Flags, int Offs, int ArgSize);
 /* Call subroutine indirect */
 
@@ -425,6 +504,15 @@ void g_cstackcheck (void);
 void g_stackcheck (void);
 /* Check for a stack overflow */
 
+void g_profcount (unsigned Label, unsigned Offs);
+/* Bump the 16bit profile counter at Label+Offs */
+
+void g_fmtcall (const char* Helper);
+/* Call a formatted output helper, they take any argument in D or sreg:D */
+
+void g_fmtfield (unsigned char Field);
+/* Set the width and flags for the next formatted output helper */
+
 void g_add (unsigned flags, unsigned long val);
 void g_sub (unsigned flags, unsigned long val);
 void g_rsub (unsigned flags, unsigned long val);
@@ -483,6 +571,9 @@ extern void g_restore_regvar(int Offs, int Reg, unsigned Size);
 
 
 
+void g_switchhot (unsigned long Val, unsigned Label, unsigned Depth);
+/* Test for the most common case before the switch proper */
+
 void g_switch (Collection* Nodes, unsigned DefaultLabel, unsigned Depth);
 /* Generate code for a switch statement */
 
@@ -493,6 +584,9 @@ void g_switch (Collection* Nodes, unsigned DefaultLabel, unsigned Depth);
 
 void g_statement (void);
 
+void g_dropresult (void);
+/* The value of the expression just generated is not used */
+
 
 /*****************************************************************************/
 /*                       User supplied assembler code                        */
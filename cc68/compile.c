@@ -63,14 +63,17 @@
 #include "expr.h"
 #include "function.h"
 #include "global.h"
+#include "inliner.h"
 #include "input.h"
 #include "litpool.h"
 #include "macrotab.h"
 #include "output.h"
 #include "pragma.h"
 #include "preproc.h"
+#include "profile.h"
 #include "standard.h"
 #include "symtab.h"
+#include "timer.h"
 
 
 
@@ -392,6 +395,9 @@ void Compile (const char* FileName)
     /* Open the input file */
     OpenMainFile (FileName);
 
+    /* Find the profile counts for this file if we are using them */
+    ProfileStart (FileName);
+
     /* Are we supposed to compile or just preprocess the input? */
     if (PreprocessOnly) {
 
@@ -399,6 +405,7 @@ void Compile (const char* FileName)
         OpenOutputFile ();
 
         /* Preprocess each line and write it to the output file */
+        TimerPhase (PHASE_PREPROCESS);
         while (NextLine ()) {
             Preprocess ();
             WriteOutput ("%.*s\n", (int) SB_GetLen (Line), SB_GetConstBuf (Line));
@@ -410,6 +417,7 @@ void Compile (const char* FileName)
     } else {
 
         /* Ok, start the ball rolling... */
+        TimerPhase (PHASE_PARSE);
         Parse ();
 
     }
@@ -429,6 +437,11 @@ void FinishCompile (void)
 {
     SymEntry* Entry;
 
+    TimerPhase (PHASE_OPTIMISE);
+
+    /* Drop any static functions that were inlined everywhere */
+    InlineFinish ();
+
     /* Reset the BSS segment name to its default; so that the below strcmp()
     ** will work as expected, at the beginning of the list of variables
     */
@@ -461,7 +474,12 @@ void FinishCompile (void)
     }
 
     /* Output the literal pool */
+    TimerPhase (PHASE_LITERALS);
     OutputLiteralPool ();
+    TimerPhase (PHASE_OPTIMISE);
+
+    /* Output the profile counters */
+    ProfileFinish ();
 
     /* Emit debug infos if enabled */
     EmitDebugInfo ();
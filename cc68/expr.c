@@ -17,6 +17,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 /* common */
 #include "check.h"
@@ -34,10 +35,13 @@
 #include "funcdesc.h"
 #include "function.h"
 #include "global.h"
+#include "inliner.h"
 #include "litpool.h"
 #include "loadexpr.h"
+#include "loop.h"
 #include "macrotab.h"
 #include "preproc.h"
+#include "printfcall.h"
 #include "scanner.h"
 #include "shiftexpr.h"
 #include "stackptr.h"
@@ -80,6 +84,27 @@ static GenDesc GenXOASGN = { TOK_XOR_ASSIGN,    GEN_NOPUSH,     g_xor };
 static GenDesc GenOASGN  = { TOK_OR_ASSIGN,     GEN_NOPUSH,     g_or  };
 
 
+/* The most recent direct function call, kept so that a return statement
+   can turn it into a tail call if nothing happened to the result */
+static struct {
+    const ExprDesc*     Expr;           /* Expression holding the result */
+    const char*         Name;           /* Function called */
+    unsigned            Flags;          /* Type flags of the function */
+    unsigned            ParamSize;      /* Bytes of arguments pushed */
+    CodeMark            Start;          /* Before the jsr, args stacked */
+    CodeMark            End;            /* After the call completed */
+} LastCall;
+
+/* Set while parsing an expression of which only the low byte is used, such
+** as the right side of an assignment to a char. The low byte of +, -, &, |
+** and ^ only depends on the low bytes of the operands, so if one of these
+** is the last operation before the value is used it can be done in B alone.
+** Operators that need all of an operand clear it while parsing that operand
+** and hie1 starts every new expression with it clear.
+*/
+static int LowByteOnly;
+static int LowByteNext;         /* Next hie1 parses a low byte expression */
+
 /* Flesh this out and keep the goals and Mark for the X version in
    the ExprDesc somewhere. Ideally we want the failure check to
    remove the old code so we can just regenerate with D. Need to flesh this
@@ -136,17 +161,21 @@ int SourceX(void)
 
 
 static unsigned GlobalModeFlags (const ExprDesc* Expr)
-/* Return the addressing mode flags for the given expression */
+/* Return the addressing mode flags for the given expression. A volatile
+** object also gets CF_VOLATILE so the code generator doesn't reuse a copy.
+*/
 {
+    unsigned Flags = IsQualVolatile (Expr->Type)? CF_VOLATILE : CF_NONE;
+
     switch (ED_GetLoc (Expr)) {
-        case E_LOC_ABS:         return CF_ABSOLUTE;
-        case E_LOC_GLOBAL:      return CF_EXTERNAL;
-        case E_LOC_STATIC:      return CF_STATIC;
-        case E_LOC_REGISTER:    return CF_REGVAR;
-        case E_LOC_STACK:       return CF_NONE;
-        case E_LOC_PRIMARY:     return CF_NONE;
-        case E_LOC_EXPR:        return CF_NONE;
-        case E_LOC_LITERAL:     return CF_STATIC;       /* Same as static */
+        case E_LOC_ABS:         return Flags | CF_ABSOLUTE;
+        case E_LOC_GLOBAL:      return Flags | CF_EXTERNAL;
+        case E_LOC_STATIC:      return Flags | CF_STATIC;
+        case E_LOC_REGISTER:    return Flags | CF_REGVAR;
+        case E_LOC_STACK:       return Flags;
+        case E_LOC_PRIMARY:     return Flags;
+        case E_LOC_EXPR:        return Flags;
+        case E_LOC_LITERAL:     return Flags | CF_STATIC;   /* Same as static */
         default:
             Internal ("GlobalModeFlags: Invalid location flags value: 0x%04X", Expr->Flags);
             /* NOTREACHED */
@@ -156,6 +185,69 @@ static unsigned GlobalModeFlags (const ExprDesc* Expr)
 
 
 
+static int IsBitLVal (const ExprDesc* Expr)
+/* Check if Expr is a char in memory that the 6303 aim/oim/eim/tim
+** instructions can work on directly.
+*/
+{
+    if (CPU != CPU_6303 || !ED_IsLVal (Expr) || ED_IsBitField (Expr) ||
+        CheckedSizeOf (Expr->Type) != SIZEOF_CHAR) {
+        return 0;
+    }
+    switch (ED_GetLoc (Expr)) {
+        case E_LOC_ABS:
+        case E_LOC_GLOBAL:
+        case E_LOC_STATIC:
+        case E_LOC_REGISTER:
+        case E_LOC_STACK:
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+
+
+static void BitOpEq (const ExprDesc* Expr, int Op, unsigned long Val)
+/* Generate a char &=, |= or ^= with a constant in memory */
+{
+    unsigned Flags = TypeOf (Expr->Type) | GlobalModeFlags (Expr);
+
+    switch (ED_GetLoc (Expr)) {
+        case E_LOC_ABS:
+            g_bitopeqstatic (Flags, Expr->IVal, 0, Op, Val);
+            break;
+        case E_LOC_STACK:
+            g_bitopeqlocal (Flags, Expr->IVal, Op, Val);
+            break;
+        default:
+            g_bitopeqstatic (Flags, Expr->Name, Expr->IVal, Op, Val);
+            break;
+    }
+}
+
+
+
+static void BitAnd (const ExprDesc* Expr, unsigned long Val)
+/* Generate a char & constant that may later become a test in memory */
+{
+    unsigned Flags = TypeOf (Expr->Type) | GlobalModeFlags (Expr);
+
+    switch (ED_GetLoc (Expr)) {
+        case E_LOC_ABS:
+            g_bitandstatic (Flags, Expr->IVal, 0, Val);
+            break;
+        case E_LOC_STACK:
+            g_bitandlocal (Flags, Expr->IVal, Val);
+            break;
+        default:
+            g_bitandstatic (Flags, Expr->Name, Expr->IVal, Val);
+            break;
+    }
+}
+
+
+
 void ExprWithCheck (void (*Func) (ExprDesc*), ExprDesc* Expr)
 /* Call an expression function with checks. */
 {
@@ -195,6 +287,50 @@ void MarkedExprWithCheck (void (*Func) (ExprDesc*), ExprDesc* Expr)
 
 
 
+void WideExprWithCheck (void (*Func) (ExprDesc*), ExprDesc* Expr)
+/* Like MarkedExprWithCheck, for an operand all of whose value is used even
+** when only the low byte of the whole expression is.
+*/
+{
+    int OldLowByte = LowByteOnly;
+
+    LowByteOnly = 0;
+    MarkedExprWithCheck (Func, Expr);
+    LowByteOnly = OldLowByte;
+}
+
+
+
+void LowByteExpr (void (*Func) (ExprDesc*), ExprDesc* Expr)
+/* Evaluate an expression via hie0 or hie1 when only the low byte of the
+** result will be used.
+*/
+{
+    LowByteNext = 1;
+    Func (Expr);
+    LowByteNext = 0;
+}
+
+
+
+static void LimitExprValue (ExprDesc* Expr)
+/* Wrap a folded constant to the size and sign of its type. The host long
+** may be wider than ours so the arithmetic can leave bits above it.
+*/
+{
+    unsigned Bits;
+
+    if (!IsClassInt (Expr->Type) || (Bits = SizeOf (Expr->Type) * 8) >= 64) {
+        return;
+    }
+    Expr->IVal &= (1UL << Bits) - 1;
+    if (IsSignSigned (Expr->Type) && (Expr->IVal & (1UL << (Bits - 1)))) {
+        Expr->IVal -= 1L << Bits;
+    }
+}
+
+
+
 static Type* promoteint (Type* lhst, Type* rhst)
 /* In an expression with two ints, return the type of the result */
 {
@@ -202,7 +338,14 @@ static Type* promoteint (Type* lhst, Type* rhst)
     **   - If one of the values is a long, the result is long.
     **   - If one of the values is unsigned, the result is also unsigned.
     **   - Otherwise the result is an int.
+    ** Chars are promoted to int first so an unsigned char doesn't count.
     */
+    if (IsTypeChar (lhst)) {
+        lhst = type_int;
+    }
+    if (IsTypeChar (rhst)) {
+        rhst = type_int;
+    }
     if (IsTypeLong (lhst) || IsTypeLong (rhst)) {
         if (IsSignUnsigned (lhst) || IsSignUnsigned (rhst)) {
             return type_ulong;
@@ -261,6 +404,110 @@ static unsigned typeadjust (ExprDesc* lhs, ExprDesc* rhs, int NoPush)
 
 
 
+static int IsMemOperand (const ExprDesc* Expr)
+/* Check if Expr is an int or unsigned char variable that an add, sub or
+** bit op can use directly from memory instead of pushing the other side.
+*/
+{
+    unsigned Size;
+
+    if (!ED_IsLVal (Expr) || ED_IsBitField (Expr) || !IsClassInt (Expr->Type)) {
+        return 0;
+    }
+    Size = CheckedSizeOf (Expr->Type);
+    if (Size != SIZEOF_INT &&
+        (Size != SIZEOF_CHAR || !IsSignUnsigned (Expr->Type))) {
+        return 0;
+    }
+    switch (ED_GetLoc (Expr)) {
+        case E_LOC_ABS:
+        case E_LOC_GLOBAL:
+        case E_LOC_STATIC:
+        case E_LOC_REGISTER:
+        case E_LOC_STACK:
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+
+
+static void MemOp (const ExprDesc* Mem, int Op, int Narrow)
+/* Primary = primary Op Mem where Mem is a variable in memory. If Narrow is
+** set only the low byte of the result is needed.
+*/
+{
+    unsigned Flags = TypeOf (Mem->Type) | GlobalModeFlags (Mem);
+
+    if (Narrow && ((Flags & CF_TYPEMASK) == CF_CHAR ||
+                   !IsQualVolatile (Mem->Type))) {
+        Flags |= CF_FORCECHAR;
+    }
+
+    switch (ED_GetLoc (Mem)) {
+        case E_LOC_ABS:
+            g_opstatic (Flags, Mem->IVal, 0, Op);
+            break;
+        case E_LOC_STACK:
+            g_oplocal (Flags, Mem->IVal, Op);
+            break;
+        default:
+            g_opstatic (Flags, Mem->Name, Mem->IVal, Op);
+            break;
+    }
+}
+
+
+
+static int CanNarrow (const Type* lhst, const Type* rhst)
+/* Check if an operation on lhst and rhst can be done on the low byte alone.
+** This is so in a low byte expression if the operation is the last one
+** before the value is used, which is the case when the expression ends
+** right after the rhs.
+*/
+{
+    if (!LowByteOnly || !IsClassInt (lhst) || !IsClassInt (rhst) ||
+        CheckedSizeOf (lhst) > SIZEOF_INT || CheckedSizeOf (rhst) > SIZEOF_INT) {
+        return 0;
+    }
+    return CurTok.Tok == TOK_SEMI || CurTok.Tok == TOK_COMMA ||
+           CurTok.Tok == TOK_RPAREN;
+}
+
+
+
+static void LoadNarrow (ExprDesc* Expr)
+/* Load the low byte of a memory operand into B */
+{
+    ExprDesc Low;
+
+    if (IsQualVolatile (Expr->Type)) {
+        LoadExpr (CF_NONE, Expr);
+        return;
+    }
+    Low = *Expr;
+    if (CheckedSizeOf (Low.Type) == SIZEOF_INT) {
+        /* Big endian, the low byte is the second one */
+        Low.IVal += 1;
+    }
+    Low.Type = type_uchar;
+    LoadExpr (CF_FORCECHAR, &Low);
+}
+
+
+
+static int IsAddMemOperand (const Type* lhst, const ExprDesc* Expr2)
+/* Check if the rhs of an add or sub can be used straight from memory */
+{
+    return IsMemOperand (Expr2) && ED_CodeRangeIsEmpty (Expr2) &&
+           CheckedSizeOf (lhst) <= SIZEOF_INT &&
+           (IsClassInt (lhst) ||
+            (IsClassPtr (lhst) && CheckedPSizeOf (lhst) == 1));
+}
+
+
+
 static const GenDesc* FindGen (token_t Tok, const GenDesc* Table)
 /* Find a token in a generator table */
 {
@@ -333,11 +580,12 @@ static void WarnConstCompareResult (void)
 
 
 
-static unsigned FunctionParamList (FuncDesc* Func)
+static unsigned FunctionParamList (FuncDesc* Func, PrintfCall* PF)
 /* Parse a function parameter list and pass the parameters to the called
 ** function. Depending on several criteria this may be done by just pushing
 ** each parameter separately, or creating the parameter frame once and then
-** storing into this frame.
+** storing into this frame. PF sees each argument in case it is a printf
+** format being taken apart.
 ** The function returns the size of the parameters pushed.
 */
 {
@@ -394,6 +642,15 @@ static unsigned FunctionParamList (FuncDesc* Func)
             Ellipsis = 1;
         }
 
+        /* A literal printf format is not pushed at all */
+        if (PrintfFormat (PF, ParamCount)) {
+            if (CurTok.Tok != TOK_COMMA) {
+                break;
+            }
+            NextToken ();
+            continue;
+        }
+
         /* Stack the previous argument computation for re-ordering */
 //        PushCode();
 
@@ -422,6 +679,8 @@ static unsigned FunctionParamList (FuncDesc* Func)
             */
             Expr.Type = PtrConversion (Expr.Type);
 
+            /* Unless it is for a conversion we took apart */
+            PrintfArg (PF, &Expr, ParamCount);
         }
 
         /* Use the type of the argument for the push */
@@ -440,6 +699,7 @@ static unsigned FunctionParamList (FuncDesc* Func)
 
         ArgSize = sizeofarg (Flags);
         g_push (Flags, Expr.IVal);
+        PrintfPushed (PF, TypeOf (Expr.Type), ParamCount);
         /* Hint to the optimizer that it can optimize use of X and D */
         g_statement();
         
@@ -481,6 +741,7 @@ static void FunctionCall (ExprDesc* Expr)
     int           PtrOffs = 0;    /* Offset of function pointer on stack */
     int           PtrOnStack = 0; /* True if a pointer copy is on stack */
     int		  NotVoid;	  /* Must preserve D on stack correction */
+    PrintfCall    PF;             /* In case it is a printf we can take apart */
 
     /* Skip the left paren */
     NextToken ();
@@ -536,14 +797,16 @@ static void FunctionCall (ExprDesc* Expr)
     }
 
     /* Parse the parameter list */
-    ParamSize = FunctionParamList (Func);
+    PrintfStart (&PF, IsFuncPtr ? 0 : Expr, Func);
+    ParamSize = FunctionParamList (Func, &PF);
 
     /* We need the closing paren here */
     ConsumeRParen ();
 
-    NotVoid = 0;
-
-    /* FIXME: how to get the Func and void flag ? !F_HasVoidReturn(Func); */
+    /* Dropping a lot of arguments goes via D so it must be kept if the
+       result is wanted */
+    NotVoid = !IsTypeVoid (GetFuncReturn (IsFuncPtr ? Expr->Type + 1
+                                                    : Expr->Type));
 
     /* Special handling for function pointers */
     if (IsFuncPtr) {
@@ -583,13 +846,31 @@ static void FunctionCall (ExprDesc* Expr)
         /* Skip T_PTR */
         ++Expr->Type;
 
+    } else if (PF.Taken) {
+        /* The format was taken apart so call the emitters instead */
+        PrintfEmit (&PF);
+        g_drop (ParamSize, NotVoid);
+        StackPtr += ParamSize;
+        LastCall.Expr = 0;
+    } else if (Expr->Sym && InlineCall (Expr->Sym, ParamSize)) {
+        /* The body has been copied in place of the call so we must always
+           drop the arguments ourselves */
+        g_drop (ParamSize, !IsTypeVoid (GetFuncReturn (Expr->Type)));
+        StackPtr += ParamSize;
+        LastCall.Expr = 0;
     } else {
         /* Normal function */
+        GetCodePos (&LastCall.Start);
         g_call (TypeOf (Expr->Type), (const char*) Expr->Name, ParamSize - Func->ParamSize);
         /* Drop parameters, preserve D if needed */
         if (CPU != CPU_6800 || (Func->Flags & FD_VARIADIC))
             g_drop(ParamSize, NotVoid);
         StackPtr += ParamSize;
+        LastCall.Expr = Expr;
+        LastCall.Name = (const char*) Expr->Name;
+        LastCall.Flags = TypeOf (Expr->Type);
+        LastCall.ParamSize = ParamSize;
+        GetCodePos (&LastCall.End);
     }
     /* FIXME: optimization - it would be worth tracking how many arguments
        we have accumulated to clean up - to say 16 bytes and then fix it
@@ -601,6 +882,42 @@ static void FunctionCall (ExprDesc* Expr)
 
 
 
+int TailCall (ExprDesc* Expr)
+/* If the value of Expr is the untouched result of the last function call and
+** the call was the last code generated, turn the call into a tail call.
+** Returns true if it did so, in which case the caller must not return.
+*/
+{
+    CodeMark Here;
+
+    if (LastCall.Expr != Expr || !ED_IsRVal (Expr) || !ED_IsLocExpr (Expr)) {
+        return 0;
+    }
+    /* Anything done to the result such as a type conversion means we still
+    ** have work to do after the call.
+    */
+    GetCodePos (&Here);
+    if (!CodeRangeIsEmpty (&LastCall.End, &Here)) {
+        return 0;
+    }
+    if (!g_cantailcall (LastCall.Flags, LastCall.ParamSize,
+                        F_GetParamSize (CurrentFunc), LastCall.Start.SP)) {
+        return 0;
+    }
+    RemoveCode (&LastCall.Start);
+    if (strcmp (LastCall.Name, F_GetFuncName (CurrentFunc)) == 0) {
+        /* Calling ourself, so just go round again */
+        g_tailjump (F_GetBodyLab (CurrentFunc), LastCall.ParamSize);
+    } else {
+        g_tailcall (LastCall.Name, LastCall.ParamSize);
+    }
+    StackPtr += LastCall.ParamSize;
+    LastCall.Expr = 0;
+    return 1;
+}
+
+
+
 static void Primary (ExprDesc* E)
 /* This is the lowest level of the expression parser. */
 {
@@ -698,6 +1015,7 @@ static void Primary (ExprDesc* E)
 
                 /* Mark the symbol as referenced */
                 Sym->Flags |= SC_REF;
+                LoopSymRef (Sym);
 
                 /* The expression type is the symbol type */
                 E->Type = Sym->Type;
@@ -711,6 +1029,7 @@ static void Primary (ExprDesc* E)
                     /* Function */
                     E->Flags = E_LOC_GLOBAL | E_RTYPE_LVAL;
                     E->Name = (uintptr_t) Sym->Name;
+                    InlineNoteUse (Sym);
                 } else if ((Sym->Flags & SC_AUTO) == SC_AUTO) {
                     /* Local variable. */
                     E->Flags = E_LOC_STACK | E_RTYPE_LVAL;
@@ -998,6 +1317,9 @@ static void ArrayRef (ExprDesc* Expr)
     } else {
 
         /* Array subscript is not constant. Load it into the primary */
+        int Walk = ConstBaseAddr && IsClassPtr (Expr->Type) &&
+                   (ED_GetLoc (Expr) == E_LOC_GLOBAL ||
+                    ED_GetLoc (Expr) == E_LOC_STATIC);
         GetCodePos (&Mark2);
         LoadExpr (CF_NONE, &Subscript);
 
@@ -1105,6 +1427,12 @@ static void ArrayRef (ExprDesc* Expr)
 
         }
 
+        /* A static array indexed by a local may be walked by a loop */
+        if (Walk) {
+            LoopNoteWalk (&Subscript, GlobalModeFlags (Expr), Expr->Name,
+                          Expr->IVal, CheckedSizeOf (ElementType), &Mark1);
+        }
+
         /* The result is an expression in the primary */
         ED_MakeRValExpr (Expr);
 
@@ -1683,8 +2011,9 @@ static void PostInc (ExprDesc* Expr)
 
         /* This doesn't work well because it ends up in X - we actually need
            the caller to try this via X - but the peephole can often clean
-           it up */
-        if (CanLoadViaX(Flags, Expr) && CanStoreViaX(Flags, Expr) && size <= 2) {
+           it up. A long only has its low half in X so can't go this way */
+        if ((Flags & CF_TYPEMASK) != CF_LONG &&
+            CanLoadViaX(Flags, Expr) && CanStoreViaX(Flags, Expr) && size <= 2) {
             LoadExprX(CF_NONE, Expr);
             g_inc(Flags | CF_CONST | CF_FORCECHAR | CF_USINGX, size);
             StoreX(Expr, 0);
@@ -1751,8 +2080,9 @@ static void PostDec (ExprDesc* Expr)
 
         /* This doesn't work well because it ends up in X - we actually need
            the caller to try this via X - but the peephole can often clean
-           it up */
-        if (CanLoadViaX(Flags, Expr) && CanStoreViaX(Flags, Expr) && size <= 2) {
+           it up. A long only has its low half in X so can't go this way */
+        if ((Flags & CF_TYPEMASK) != CF_LONG &&
+            CanLoadViaX(Flags, Expr) && CanStoreViaX(Flags, Expr) && size <= 2) {
             LoadExprX(CF_NONE, Expr);
             g_dec(Flags | CF_CONST | CF_FORCECHAR | CF_USINGX, size);
             StoreX(Expr, 0);
@@ -1799,18 +2129,21 @@ static void UnaryOp (ExprDesc* Expr)
 
     /* Check for a constant expression */
     if (ED_IsConstAbs (Expr)) {
-        /* Value is constant */
+        /* Value is constant, chars are promoted to int */
+        Expr->Type = IntPromotion (Expr->Type);
         switch (Tok) {
             case TOK_MINUS: Expr->IVal = -Expr->IVal;   break;
             case TOK_PLUS:                              break;
             case TOK_COMP:  Expr->IVal = ~Expr->IVal;   break;
             default:        Internal ("Unexpected token: %d", Tok);
         }
+        LimitExprValue (Expr);
     } else {
         /* Value is not constant */
         LoadExpr (CF_NONE, Expr);
 
-        /* Get the type of the expression */
+        /* Get the type of the expression. The load made chars an int */
+        Expr->Type = IntPromotion (Expr->Type);
         Flags = TypeOf (Expr->Type);
 
         /* Handle the operation */
@@ -1859,6 +2192,8 @@ void hie10 (ExprDesc* Expr)
                 ED_MakeRValExpr (Expr);
                 ED_TestDone (Expr);             /* bneg will set cc */
             }
+            /* Whatever we negated the result is an int */
+            Expr->Type = type_int;
             break;
 
         case TOK_STAR:
@@ -1919,6 +2254,12 @@ void hie10 (ExprDesc* Expr)
                     /* Do it anyway, just to avoid further warnings */
                     Expr->Flags &= ~E_BITFIELD;
                 }
+                /* Remember locals whose address escapes so the loop code
+                ** knows they can be changed behind its back.
+                */
+                if (Expr->Sym && ED_IsLocStack (Expr)) {
+                    Expr->Sym->Flags |= SC_ADDRTAKEN;
+                }
                 Expr->Type = PointerTo (Expr->Type);
                 /* The & operator yields an rvalue */
                 ED_MakeRVal (Expr);
@@ -1991,6 +2332,9 @@ static void hie_internal (const GenDesc* Ops,   /* List of generators */
     unsigned ltype, type;
     int lconst;                         /* Left operand is a constant */
     int rconst;                         /* Right operand is a constant */
+    int ldefer;                         /* Left operand is not loaded yet */
+    int Op;                             /* Bit op that can use memory */
+    int narrow;                         /* Only the low byte is needed */
 
 
     ExprWithCheck (hienext, Expr);
@@ -2012,10 +2356,22 @@ static void hie_internal (const GenDesc* Ops,   /* List of generators */
         Tok = CurTok.Tok;
         NextToken ();
 
+        /* The bit ops can take either side straight from memory */
+        switch (Tok) {
+            case TOK_AND:   Op = '&';   break;
+            case TOK_OR:    Op = '|';   break;
+            case TOK_XOR:   Op = '^';   break;
+            default:        Op = 0;     break;
+        }
+        if (CheckedSizeOf (Expr->Type) > SIZEOF_INT) {
+            Op = 0;
+        }
+
         /* Get the lhs on stack */
         GetCodePos (&Mark1);
         ltype = TypeOf (Expr->Type);
         lconst = ED_IsConstAbs (Expr);
+        ldefer = 0;
         if (lconst) {
             /* Constant value */
             GetCodePos (&Mark2);
@@ -2025,6 +2381,13 @@ static void hie_internal (const GenDesc* Ops,   /* List of generators */
             if ((Gen->Flags & GEN_COMM) == 0) {
                 g_push (ltype | CF_CONST, Expr->IVal);
             }
+        } else if (Op && IsMemOperand (Expr)) {
+            /* A variable, leave it where it is until we know what the
+            ** rhs looks like. If that turns out to be complex we can
+            ** work it out first and then apply the lhs from memory.
+            */
+            GetCodePos (&Mark2);
+            ldefer = 1;
         } else {
             /* Value not constant */
             LoadExpr (CF_NONE, Expr);
@@ -2035,18 +2398,66 @@ static void hie_internal (const GenDesc* Ops,   /* List of generators */
         /* Get the right hand side */
         MarkedExprWithCheck (hienext, &Expr2);
 
+        /* Check the type of the rhs */
+        if (!IsClassInt (Expr2.Type)) {
+            Error ("Integer expression expected");
+        }
+
         /* Check for a constant expression */
         rconst = (ED_IsConstAbs (&Expr2) && ED_CodeRangeIsEmpty (&Expr2));
+        narrow = Op && CanNarrow (Expr->Type, Expr2.Type);
+
+        if (Op && !lconst && !rconst) {
+            if (IsMemOperand (&Expr2) && ED_CodeRangeIsEmpty (&Expr2)) {
+                /* The rhs is a variable so there is no need to push the
+                ** lhs, use the rhs straight from memory.
+                */
+                if (!ldefer) {
+                    RemoveCode (&Mark2);
+                } else if (narrow) {
+                    LoadNarrow (Expr);
+                } else {
+                    LoadExpr (CF_NONE, Expr);
+                }
+                MemOp (&Expr2, Op, narrow);
+            } else if (ldefer && CheckedSizeOf (Expr2.Type) <= SIZEOF_INT) {
+                /* Work out the rhs then apply the lhs from memory */
+                LoadExpr (CF_NONE, &Expr2);
+                MemOp (Expr, Op, narrow);
+            } else if (ldefer) {
+                /* A long rhs. The op is commutative so push the rhs
+                ** and use the lhs as the primary.
+                */
+                LoadExpr (CF_NONE, &Expr2);
+                g_push (TypeOf (Expr2.Type), 0);
+                LoadExpr (CF_NONE, Expr);
+                Gen->Func (g_typeadjust (TypeOf (Expr2.Type), ltype), 0);
+            } else {
+                Op = 0;
+            }
+            if (Op) {
+                Expr->Type = promoteint (Expr->Type, Expr2.Type);
+                ED_MakeRValExpr (Expr);
+                continue;
+            }
+        }
+
+        if (ldefer) {
+            /* Constant rhs, load and push the lhs as usual */
+            if (narrow) {
+                LoadNarrow (Expr);
+            } else {
+                LoadExpr (CF_NONE, Expr);
+            }
+            GetCodePos (&Mark2);
+            g_push (ltype, 0);
+        }
+
         if (!rconst) {
             /* Not constant, load into the primary */
             LoadExpr (CF_NONE, &Expr2);
         }
 
-        /* Check the type of the rhs */
-        if (!IsClassInt (Expr2.Type)) {
-            Error ("Integer expression expected");
-        }
-
         /* Check for const operands */
         if (lconst && rconst) {
 
@@ -2132,6 +2543,7 @@ static void hie_internal (const GenDesc* Ops,   /* List of generators */
                         Internal ("hie_internal: got token 0x%X\n", Tok);
                 }
             }
+            LimitExprValue (Expr);
 
         } else if (lconst && (Gen->Flags & GEN_COMM) && !rconst) {
 
@@ -2159,6 +2571,18 @@ static void hie_internal (const GenDesc* Ops,   /* List of generators */
             /* We have a rvalue in the primary now */
             ED_MakeRValExpr (Expr);
 
+        } else if (rconst && Tok == TOK_AND && IsBitLVal (Expr) &&
+                   CheckedSizeOf (Expr2.Type) <= SIZEOF_INT &&
+                   (IsSignUnsigned (Expr->Type) || (Expr2.IVal & ~0xFFL) == 0)) {
+
+            /* A char in memory masked with a constant. Redo it so that it
+            ** can become a tim if only the condition codes are wanted.
+            */
+            RemoveCode (&Mark1);
+            BitAnd (Expr, Expr2.IVal);
+            Expr->Type = promoteint (Expr->Type, Expr2.Type);
+            ED_MakeRValExpr (Expr);
+
         } else {
 
             /* If the right hand side is constant, and the generator function
@@ -2186,6 +2610,13 @@ static void hie_internal (const GenDesc* Ops,   /* List of generators */
             type |= g_typeadjust (ltype, rtype);
             Expr->Type = promoteint (Expr->Type, Expr2.Type);
 
+            /* A bit op with a constant only needs B if that is all that is
+            ** looked at.
+            */
+            if (narrow && rconst && (Gen->Flags & GEN_NOPUSH) != 0) {
+                type = CF_CHAR | CF_FORCECHAR | CF_CONST | (type & CF_UNSIGNED);
+            }
+
             /* Generate code */
             Gen->Func (type, Expr2.IVal);
 
@@ -2244,7 +2675,7 @@ static void hie_compare (const GenDesc* Ops,    /* List of generators */
         }
 
         /* Get the right hand side */
-        MarkedExprWithCheck (hienext, &Expr2);
+        WideExprWithCheck (hienext, &Expr2);
 
         /* If rhs is a function, convert it to pointer to function */
         if (IsTypeFunc (Expr2.Type)) {
@@ -2253,6 +2684,7 @@ static void hie_compare (const GenDesc* Ops,    /* List of generators */
 
         /* Check for a constant expression */
         rconst = (ED_IsConstAbs (&Expr2) && ED_CodeRangeIsEmpty (&Expr2));
+        LoopNoteCompare (Tok, rconst, Expr2.IVal);
         if (!rconst) {
             /* Not constant, load into the primary */
             LoadExpr (CF_NONE, &Expr2);
@@ -2306,6 +2738,13 @@ static void hie_compare (const GenDesc* Ops,    /* List of generators */
             /* Both operands are constant, remove the generated code */
             RemoveCode (&Mark1);
 
+            /* Convert both to the type they are compared in */
+            if (IsClassInt (Expr->Type) && IsClassInt (Expr2.Type)) {
+                Expr->Type = Expr2.Type = promoteint (Expr->Type, Expr2.Type);
+                LimitExprValue (Expr);
+                LimitExprValue (&Expr2);
+            }
+
             /* Determine if this is a signed or unsigned compare */
             if (IsClassInt (Expr->Type) && IsSignSigned (Expr->Type) &&
                 IsClassInt (Expr2.Type) && IsSignSigned (Expr2.Type)) {
@@ -2358,8 +2797,12 @@ static void hie_compare (const GenDesc* Ops,    /* List of generators */
                 }
             }
 
-            /* Determine the type of the operation. */
-            if (IsTypeChar (Expr->Type) && rconst) {
+            /* Determine the type of the operation. A signed char against
+            ** an unsigned constant is an unsigned compare, so its range
+            ** doesn't tell us anything.
+            */
+            if (IsTypeChar (Expr->Type) && rconst &&
+                (RightSigned || !LeftSigned)) {
 
                 /* Left side is unsigned char, right side is constant.
                 ** Determine the minimum and maximum values
@@ -2570,6 +3013,9 @@ static void parseadd (ExprDesc* Expr)
     CodeMark Mark;              /* Remember code position */
     Type* lhst;                 /* Type of left hand side */
     Type* rhst;                 /* Type of right hand side */
+    int ldefer;                 /* Left hand side is not loaded yet */
+    int rconst;                 /* Right hand side is constant */
+    int narrow;                 /* Only the low byte is needed */
 
     /* Skip the PLUS token */
     NextToken ();
@@ -2602,6 +3048,7 @@ static void parseadd (ExprDesc* Expr)
                 /* Integer addition */
                 Expr->IVal += Expr2.IVal;
                 typeadjust (Expr, &Expr2, 1);
+                LimitExprValue (Expr);
             } else {
                 /* OOPS */
                 Error ("Invalid operands for binary operator '+'");
@@ -2696,16 +3143,36 @@ static void parseadd (ExprDesc* Expr)
 
     } else {
 
-        /* Left hand side is not constant. Get the value onto the stack. */
-        LoadExpr (CF_NONE, Expr);              /* --> primary register */
+        /* Left hand side is not constant. If it is a variable then leave
+        ** it in memory until we have seen the rhs, otherwise get the value
+        ** onto the stack.
+        */
+        ldefer = IsMemOperand (Expr);
+        if (!ldefer) {
+            LoadExpr (CF_NONE, Expr);              /* --> primary register */
+        }
         GetCodePos (&Mark);
-        g_push (TypeOf (Expr->Type), 0);        /* --> stack */
+        if (!ldefer) {
+            g_push (TypeOf (Expr->Type), 0);        /* --> stack */
+        }
 
         /* Evaluate the rhs */
         MarkedExprWithCheck (hie9, &Expr2);
+        rconst = ED_IsConstAbs (&Expr2) && ED_CodeRangeIsEmpty (&Expr2);
+        narrow = CanNarrow (lhst, Expr2.Type);
+
+        if (ldefer && rconst) {
+            /* The constant is added to the loaded lhs below */
+            if (narrow) {
+                LoadNarrow (Expr);
+            } else {
+                LoadExpr (CF_NONE, Expr);
+            }
+            GetCodePos (&Mark);
+        }
 
         /* Check for a constant rhs expression */
-        if (ED_IsConstAbs (&Expr2) && ED_CodeRangeIsEmpty (&Expr2)) {
+        if (rconst) {
 
             /* Right hand side is a constant. Get the rhs type */
             rhst = Expr2.Type;
@@ -2728,6 +3195,9 @@ static void parseadd (ExprDesc* Expr)
             } else if (IsClassInt (lhst) && IsClassInt (rhst)) {
                 /* Integer addition */
                 flags = typeadjust (Expr, &Expr2, 1);
+                if (narrow) {
+                    flags = CF_CHAR | CF_FORCECHAR | (flags & CF_UNSIGNED);
+                }
             } else {
                 /* OOPS */
                 Error ("Invalid operands for binary operator '+'");
@@ -2737,6 +3207,55 @@ static void parseadd (ExprDesc* Expr)
             /* Generate code for the add */
             g_inc (flags | CF_CONST, Expr2.IVal);
 
+        } else if (ldefer) {
+
+            /* The lhs is a variable and the rhs needs code. Either use the
+            ** rhs from memory as well or work out the rhs first and then
+            ** add the lhs to it from memory.
+            */
+            rhst = Expr2.Type;
+            if (IsAddMemOperand (lhst, &Expr2)) {
+                if (narrow) {
+                    LoadNarrow (Expr);
+                } else {
+                    LoadExpr (CF_NONE, Expr);
+                }
+                MemOp (&Expr2, '+', narrow);
+                Expr->Type = promoteint (lhst, rhst);
+            } else if (IsClassInt (rhst) && CheckedSizeOf (rhst) <= SIZEOF_INT) {
+                LoadExpr (CF_NONE, &Expr2);
+                MemOp (Expr, '+', narrow);
+                Expr->Type = promoteint (lhst, rhst);
+            } else {
+                /* Add is commutative so the rhs can go on the stack */
+                LoadExpr (CF_NONE, &Expr2);
+                g_push (TypeOf (rhst), 0);
+                LoadExpr (CF_NONE, Expr);
+                if (IsClassPtr (rhst)) {
+                    g_scale (CF_INT, CheckedPSizeOf (rhst));
+                    flags = CF_PTR;
+                    Expr->Type = rhst;
+                } else if (IsClassInt (rhst)) {
+                    flags = g_typeadjust (TypeOf (rhst), TypeOf (lhst));
+                    Expr->Type = promoteint (lhst, rhst);
+                } else {
+                    Error ("Invalid operands for binary operator '+'");
+                    flags = CF_INT;
+                }
+                g_add (flags, 0);
+            }
+
+        } else if (IsAddMemOperand (lhst, &Expr2)) {
+
+            /* The rhs is a variable, add it from memory instead of pushing
+            ** the lhs.
+            */
+            RemoveCode (&Mark);
+            MemOp (&Expr2, '+', narrow);
+            if (IsClassInt (lhst)) {
+                Expr->Type = promoteint (lhst, Expr2.Type);
+            }
+
         } else {
 
             /* Not constant, load into the primary */
@@ -2804,6 +3323,7 @@ static void parsesub (ExprDesc* Expr)
     CodeMark Mark1;             /* Save position of output queue */
     CodeMark Mark2;             /* Another position in the queue */
     int rscale;                 /* Scale factor for the result */
+    int narrow;                 /* Only the low byte is needed */
 
 
     /* lhs cannot be function or pointer to function */
@@ -2835,6 +3355,7 @@ static void parsesub (ExprDesc* Expr)
         /* Make it pointer to char to avoid further errors */
         Expr2.Type = type_uchar;
     }
+    narrow = CanNarrow (lhst, Expr2.Type);
 
     /* Check for a constant rhs expression */
     if (ED_IsConstAbs (&Expr2) && ED_CodeRangeIsEmpty (&Expr2)) {
@@ -2867,6 +3388,7 @@ static void parsesub (ExprDesc* Expr)
                 /* Integer subtraction */
                 typeadjust (Expr, &Expr2, 1);
                 Expr->IVal -= Expr2.IVal;
+                LimitExprValue (Expr);
             } else {
                 /* OOPS */
                 Error ("Invalid operands for binary operator '-'");
@@ -2900,6 +3422,9 @@ static void parsesub (ExprDesc* Expr)
             } else if (IsClassInt (lhst) && IsClassInt (rhst)) {
                 /* Integer subtraction */
                 flags = typeadjust (Expr, &Expr2, 1);
+                if (narrow) {
+                    flags = CF_CHAR | CF_FORCECHAR | (flags & CF_UNSIGNED);
+                }
             } else {
                 /* OOPS */
                 Error ("Invalid operands for binary operator '-'");
@@ -2920,6 +3445,21 @@ static void parsesub (ExprDesc* Expr)
 
         }
 
+    } else if (IsAddMemOperand (lhst, &Expr2)) {
+
+        /* The rhs is a variable, subtract it from memory instead of pushing
+        ** the lhs.
+        */
+        RemoveCode (&Mark2);
+        MemOp (&Expr2, '-', narrow);
+        if (IsClassInt (lhst)) {
+            Expr->Type = promoteint (lhst, Expr2.Type);
+        }
+
+        /* Result is a rvalue in the primary register */
+        ED_MakeRValExpr (Expr);
+        ED_MarkAsUntested (Expr);
+
     } else {
 
         /* Not constant, load into the primary */
@@ -3112,6 +3652,7 @@ static void hieAnd (ExprDesc* Expr, unsigned TrueLab, int* BoolOp)
 {
     int FalseLab;
     ExprDesc Expr2;
+    int OldLowByte;
 
     ExprWithCheck (hie2, Expr);
     if (CurTok.Tok == TOK_BOOL_AND) {
@@ -3139,8 +3680,11 @@ static void hieAnd (ExprDesc* Expr, unsigned TrueLab, int* BoolOp)
             /* Skip the && */
             NextToken ();
 
-            /* Get rhs */
+            /* Get rhs, all of which is tested */
+            OldLowByte = LowByteOnly;
+            LowByteOnly = 0;
             hie2 (&Expr2);
+            LowByteOnly = OldLowByte;
             if (!ED_IsTested (&Expr2)) {
                 ED_MarkForTest (&Expr2);
             }
@@ -3158,8 +3702,9 @@ static void hieAnd (ExprDesc* Expr, unsigned TrueLab, int* BoolOp)
         /* Define the false jump label here */
         g_defcodelabel (FalseLab);
 
-        /* The result is an rvalue in primary */
+        /* The result is an int rvalue in primary */
         ED_MakeRValExpr (Expr);
+        Expr->Type = type_int;
         ED_TestDone (Expr);     /* Condition codes are set */
     }
 }
@@ -3174,6 +3719,7 @@ static void hieOr (ExprDesc *Expr)
     int AndOp;                  /* Did we have a && operation? */
     unsigned TrueLab;           /* Jump to this label if true */
     unsigned DoneLab;
+    int OldLowByte;
 
     /* Get a label */
     TrueLab = GetLocalLabel ();
@@ -3208,9 +3754,12 @@ static void hieOr (ExprDesc *Expr)
             /* skip the || */
             NextToken ();
 
-            /* Get a subexpr */
+            /* Get a subexpr, all of which is tested */
             AndOp = 0;
+            OldLowByte = LowByteOnly;
+            LowByteOnly = 0;
             hieAnd (&Expr2, TrueLab, &AndOp);
+            LowByteOnly = OldLowByte;
             if (!ED_IsTested (&Expr2)) {
                 ED_MarkForTest (&Expr2);
             }
@@ -3221,8 +3770,9 @@ static void hieOr (ExprDesc *Expr)
 
         }
 
-        /* The result is an rvalue in primary */
+        /* The result is an int rvalue in primary */
         ED_MakeRValExpr (Expr);
+        Expr->Type = type_int;
         ED_TestDone (Expr);                     /* Condition codes are set */
     }
 
@@ -3387,8 +3937,10 @@ static void opeq (const GenDesc* Gen, ExprDesc* Expr, const char* Op)
 {
     ExprDesc Expr2;
     unsigned flags;
+    CodeMark LoadMark;
     CodeMark Mark;
     int MustScale;
+    int BitOp = 0;
 
     /* op= can only be used with lvalues */
     if (!ED_IsLVal (Expr)) {
@@ -3416,7 +3968,19 @@ static void opeq (const GenDesc* Gen, ExprDesc* Expr, const char* Op)
     flags = TypeOf (Expr->Type);
     MustScale = (Gen->Func == g_add || Gen->Func == g_sub) && IsTypePtr (Expr->Type);
 
+    /* Char &=, |= and ^= may be done in memory */
+    if (IsBitLVal (Expr)) {
+        if (Gen->Func == g_and) {
+            BitOp = '&';
+        } else if (Gen->Func == g_or) {
+            BitOp = '|';
+        } else if (Gen->Func == g_xor) {
+            BitOp = '^';
+        }
+    }
+
     /* Get the lhs address on stack (if needed) */
+    GetCodePos (&LoadMark);
     PushAddr (Expr);
 
     /* Fetch the lhs into the primary register if needed */
@@ -3439,6 +4003,13 @@ static void opeq (const GenDesc* Gen, ExprDesc* Expr, const char* Op)
 
     /* Check for a constant expression */
     if (ED_IsConstAbs (&Expr2) && ED_CodeRangeIsEmpty (&Expr2)) {
+        if (BitOp) {
+            /* Throw away the load and do the whole thing in memory */
+            RemoveCode (&LoadMark);
+            BitOpEq (Expr, BitOp, Expr2.IVal);
+            ED_MakeRValExpr (Expr);
+            return;
+        }
         /* The resulting value is a constant. If the generator has the NOPUSH
         ** flag set, don't push the lhs.
         */
@@ -3489,8 +4060,14 @@ static void opeq (const GenDesc* Gen, ExprDesc* Expr, const char* Op)
             flags |= CF_FORCECHAR;
         }
 
-        /* Adjust the types of the operands if needed */
-        Gen->Func (g_typeadjust (flags, TypeOf (Expr2.Type)), 0);
+        /* A shift has the type of the lhs, whatever the count is. Anything
+        ** else adjusts the types of the operands if needed.
+        */
+        if (Gen->Func == g_asl || Gen->Func == g_asr) {
+            Gen->Func (flags, 0);
+        } else {
+            Gen->Func (g_typeadjust (flags, TypeOf (Expr2.Type)), 0);
+        }
     }
     Store (Expr, 0);
     ED_MakeRValExpr (Expr);
@@ -3642,7 +4219,13 @@ static void addsubeq (const GenDesc* Gen, ExprDesc *Expr, const char* Op)
 void hie1 (ExprDesc* Expr)
 /* Parse first level of expression hierarchy. */
 {
+    int OldLowByte = LowByteOnly;
+
+    LowByteOnly = LowByteNext;
+    LowByteNext = 0;
     hieQuest (Expr);
+    LowByteOnly = OldLowByte;
+
     switch (CurTok.Tok) {
 
         case TOK_ASSIGN:
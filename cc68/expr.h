@@ -40,6 +40,16 @@ void MarkedExprWithCheck (void (*Func) (ExprDesc*), ExprDesc* Expr);
 ** generated code.
 */
 
+void WideExprWithCheck (void (*Func) (ExprDesc*), ExprDesc* Expr);
+/* Like MarkedExprWithCheck, for an operand all of whose value is used even
+** when only the low byte of the whole expression is.
+*/
+
+void LowByteExpr (void (*Func) (ExprDesc*), ExprDesc* Expr);
+/* Evaluate an expression via hie0 or hie1 when only the low byte of the
+** result will be used.
+*/
+
 void PushAddr (const ExprDesc* Expr);
 /* If the expression contains an address that was somehow evaluated,
 ** push this address on the stack. This is a helper function for all
@@ -96,6 +106,12 @@ void hie1 (ExprDesc* lval);
 void hie0 (ExprDesc* Expr);
 /* Parse comma operator. */
 
+int TailCall (ExprDesc* Expr);
+/* If the value of Expr is the untouched result of the last function call and
+** the call was the last code generated, turn the call into a tail call.
+** Returns true if it did so, in which case the caller must not return.
+*/
+
 
 void NotViaX(void);
 /* Tell the evaluator to give up doing this via X */
@@ -45,6 +45,7 @@
 /* common */
 #include "check.h"
 #include "xmalloc.h"
+#include "xsprintf.h"
 
 /* cc65 */
 #include "asmcode.h"
@@ -53,8 +54,10 @@
 #include "error.h"
 #include "funcdesc.h"
 #include "global.h"
+#include "inliner.h"
 #include "litpool.h"
 #include "locals.h"
+#include "profile.h"
 #include "scanner.h"
 #include "stackptr.h"
 #include "standard.h"
@@ -93,6 +96,7 @@ static Function* NewFunction (struct SymEntry* Sym)
     F->Desc       = GetFuncDesc (Sym->Type);
     F->Reserved   = 0;
     F->RetLab     = GetLocalLabel ();
+    F->BodyLab    = 0;
     F->TopLevelSP = 0;
     F->RegOffs    = RegisterSpace;
     F->Flags      = IsTypeVoid (F->ReturnType) ? FF_VOID_RETURN : FF_NONE;
@@ -170,6 +174,22 @@ int F_HasReturn (const Function* F)
 
 
 
+void F_ReturnJumped (Function* F)
+/* Mark the function as having a return that jumps to the exit code */
+{
+    F->Flags |= FF_RET_JUMP;
+}
+
+
+
+int F_HasReturnJump (const Function* F)
+/* Return true if a return statement jumps to the exit code */
+{
+    return (F->Flags & FF_RET_JUMP) != 0;
+}
+
+
+
 int F_IsMainFunc (const Function* F)
 /* Return true if this is the main function */
 {
@@ -201,6 +221,22 @@ unsigned F_GetRetLab (const Function* F)
 
 
 
+unsigned F_GetBodyLab (Function* F)
+/* Return the label at the start of the function body, creating it if this
+** is the first use.
+*/
+{
+    if (F->BodyLab == 0) {
+        char Buf[32];
+        F->BodyLab = GetLocalLabel ();
+        xsprintf (Buf, sizeof (Buf), "%s:", LocalLabelName (F->BodyLab));
+        InsertCodeLine (&F->BodyStart, Buf);
+    }
+    return F->BodyLab;
+}
+
+
+
 int F_GetTopLevelSP (const Function* F)
 /* Get the value of the stack pointer on function top level */
 {
@@ -374,6 +410,9 @@ void NewFunc (SymEntry* Func)
 /* Parse argument declarations and function body. */
 {
     int         C99MainFunc = 0;/* Flag for C99 main function returning int */
+    CodeMark    FuncStart;      /* Start of the function code */
+    unsigned    ProfId;         /* Profile counter for calls */
+    int         GotBreak = 0;   /* Last statement returned or jumped away */
 
     /* Get the function descriptor from the function entry */
     FuncDesc* D = Func->V.F.Func;
@@ -424,6 +463,9 @@ void NewFunc (SymEntry* Func)
     /* Allocate a new literal pool */
     PushLiteralPool (Func);
 
+    /* Remember where the function starts in case it is inlined everywhere */
+    GetCodePos (&FuncStart);
+
     /* Generate function entry code if needed */
     g_enter (Func->Name, TypeOf(Func->Type), F_GetParamSize(CurrentFunc));
 
@@ -432,6 +474,13 @@ void NewFunc (SymEntry* Func)
         g_stackcheck ();
     }
 
+    /* Count the calls if we are profiling */
+    ProfId = ProfileNew (1);
+    ProfileCount (ProfId);
+
+    /* Remember where the body starts so that self tail calls can loop */
+    GetCodePos (&CurrentFunc->BodyStart);
+
     /* Setup the stack */
     StackPtr = 0;
 
@@ -490,7 +539,7 @@ void NewFunc (SymEntry* Func)
 
     /* Now process statements in this block */
     while (CurTok.Tok != TOK_RCURLY && CurTok.Tok != TOK_CEOF) {
-        Statement (0);
+        GotBreak = Statement (0);
     }
 
     /* If this is not a void function, and not the main function in a C99
@@ -510,17 +559,30 @@ void NewFunc (SymEntry* Func)
         g_getimmed (CF_INT | CF_CONST, 0, 0);
     }
 
-    /* Output the function exit code label */
-    g_defcodelabel (F_GetRetLab (CurrentFunc));
+    /* If every return went back directly and the end of the body cannot
+    ** be reached then nothing uses the shared exit code.
+    */
+    if (!GotBreak || F_HasReturnJump (CurrentFunc)) {
+
+        /* Output the function exit code label */
+        g_defcodelabel (F_GetRetLab (CurrentFunc));
 
-    /* Restore the register variables */
-    /* FIXME: it would be better to combine this with any popping, so we
-       roll the pulx stx into the recovery logic */
-    F_RestoreRegVars (CurrentFunc);
+        /* Restore the register variables */
+        /* FIXME: it would be better to combine this with any popping, so we
+           roll the pulx stx into the recovery logic */
+        F_RestoreRegVars (CurrentFunc);
+
+        /* Generate the exit code */
+
+        g_leave (F_HasVoidReturn (CurrentFunc), TypeOf(Func->Type), F_GetParamSize(CurrentFunc));
+    }
 
-    /* Generate the exit code */
+    /* Tell the linker about our stack use if we checked it */
+    g_stackinfo (Func->Name);
 
-    g_leave (F_HasVoidReturn (CurrentFunc), TypeOf(Func->Type), F_GetParamSize(CurrentFunc));
+    /* Keep a copy of the body if it is worth inlining */
+    InlineCapture (Func, &FuncStart, &CurrentFunc->BodyStart,
+                   F_GetParamSize (CurrentFunc), ProfileHot (ProfId));
 
     /* Emit references to imports/exports */
     EmitExternals ();
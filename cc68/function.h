@@ -47,6 +47,9 @@
 
 #include "coll.h"
 
+/* cc68 */
+#include "asmcode.h"
+
 /*****************************************************************************/
 /*                                   Data                                    */
 /*****************************************************************************/
@@ -58,6 +61,7 @@ typedef enum {
     FF_HAS_RETURN       = 0x0001,       /* Function has a return statement */
     FF_IS_MAIN          = 0x0002,       /* This is the main function */
     FF_VOID_RETURN      = 0x0004,       /* Function returning void */
+    FF_RET_JUMP         = 0x0008,       /* A return jumps to the exit code */
 } funcflags_t;
 
 /* Structure that holds all data needed for function activation */
@@ -67,6 +71,8 @@ struct Function {
     FuncDesc*           Desc;             /* Function descriptor */
     int                 Reserved;         /* Reserved local space */
     unsigned            RetLab;           /* Return code label */
+    unsigned            BodyLab;          /* Body label for self tail calls */
+    CodeMark            BodyStart;        /* Where the body label goes */
     int                 TopLevelSP;       /* SP at function top level */
     unsigned            RegOffs;          /* Register variable space offset */
     funcflags_t         Flags;            /* Function flags */
@@ -108,6 +114,12 @@ void F_ReturnFound (Function* F);
 int F_HasReturn (const Function* F);
 /* Return true if the function contains a return statement*/
 
+void F_ReturnJumped (Function* F);
+/* Mark the function as having a return that jumps to the exit code */
+
+int F_HasReturnJump (const Function* F);
+/* Return true if a return statement jumps to the exit code */
+
 int F_IsMainFunc (const Function* F);
 /* Return true if this is the main function */
 
@@ -120,6 +132,11 @@ int F_HasOldStyleIntRet (const Function* F);
 unsigned F_GetRetLab (const Function* F);
 /* Return the return jump label */
 
+unsigned F_GetBodyLab (Function* F);
+/* Return the label at the start of the function body, creating it if this
+** is the first use.
+*/
+
 int F_GetTopLevelSP (const Function* F);
 /* Get the value of the stack pointer on function top level */
 
@@ -57,12 +57,15 @@ unsigned char DebugInfo         = 0;    /* Add debug info to the obj */
 unsigned char PreprocessOnly    = 0;    /* Just preprocess the input */
 unsigned char DebugOptOutput    = 0;    /* Output debug stuff */
 unsigned      RegisterSpace     = 6;    /* Space available for register vars */
+unsigned      InlineSize        = 8;    /* Instructions in an inlined function */
 
 /* Stackable options */
 IntStack WritableStrings    = INTSTACK(0);  /* Literal strings are r/w */
 IntStack LocalStrings       = INTSTACK(0);  /* Emit string literals immediately */
+IntStack LowerPrintf        = INTSTACK(0);  /* Take literal printf formats apart */
 IntStack InlineStdFuncs     = INTSTACK(0);  /* Inline some standard functions */
 IntStack EagerlyInlineFuncs = INTSTACK(0);  /* Eagerly inline some known functions */
+IntStack InlineFuncs        = INTSTACK(0);  /* Inline small static functions */
 IntStack EnableRegVars      = INTSTACK(0);  /* Enable register variables */
 IntStack AllowRegVarAddr    = INTSTACK(0);  /* Allow taking addresses of register vars */
 IntStack RegVarsToCallStack = INTSTACK(0);  /* Save reg variables on call stack */
@@ -65,12 +65,15 @@ extern unsigned char    DebugInfo;              /* Add debug info to the obj */
 extern unsigned char    PreprocessOnly;         /* Just preprocess the input */
 extern unsigned char    DebugOptOutput;         /* Output debug stuff */
 extern unsigned         RegisterSpace;          /* Space available for register vars */
+extern unsigned         InlineSize;             /* Instructions in an inlined function */
 
 /* Stackable options */
 extern IntStack         WritableStrings;        /* Literal strings are r/w */
 extern IntStack         LocalStrings;           /* Emit string literals immediately */
+extern IntStack         LowerPrintf;            /* Take literal printf formats apart */
 extern IntStack         InlineStdFuncs;         /* Inline some standard functions */
 extern IntStack         EagerlyInlineFuncs;     /* Eagerly inline some known functions */
+extern IntStack         InlineFuncs;            /* Inline small static functions */
 extern IntStack         EnableRegVars;          /* Enable register variables */
 extern IntStack         AllowRegVarAddr;        /* Allow taking addresses of register vars */
 extern IntStack         RegVarsToCallStack;     /* Save reg variables on call stack */
@@ -51,6 +51,7 @@
 #include "exprdesc.h"
 #include "expr.h"
 #include "loadexpr.h"
+#include "loop.h"
 #include "scanner.h"
 #include "standard.h"
 #include "symtab.h"
@@ -70,6 +71,9 @@ void GotoStatement (void)
     /* Eat the "goto" */
     NextToken ();
 
+    /* Jumps out of a loop defeat the loop optimizations */
+    LoopBarrier ();
+
     /* Label name must follow */
     if (CurTok.Tok == TOK_IDENT) {
 
@@ -160,6 +164,9 @@ void DoLabel (void)
     /* Add a label symbol */
     SymEntry* Entry = AddLabelSym (CurTok.Ident, SC_DEF);
 
+    /* As do jumps into one */
+    LoopBarrier ();
+
     /* Emit the jump label */
     CodeLabel* L = CS_AddLabel (CS->Code, LocalLabelName (Entry->V.L.Label));
 
@@ -0,0 +1,599 @@
+/*
+ *	CC6303:  A C compiler for the 6803/6303 processors
+ *	(C) 2019 Alan Cox
+ *
+ *	This compiler is built out of a much modified CC65 and all new code
+ *	is placed under the same licence as the original. Please direct all
+ *	cc6303 bugs to the author not to the cc65 developers unless you find
+ *	a bug that is also present in cc65.
+ */
+/*
+ *	Inline expansion of small static functions
+ *
+ *	We don't have a tree to work with so instead we work with the code we
+ *	generated for the function. Our stack frame is very simple. The caller
+ *	pushes the arguments and does a jsr, so the only difference between the
+ *	called code and the same code placed in the caller after the arguments
+ *	are pushed is the two byte return address. Every stack reference the
+ *	function makes goes via a tsx so all we have to do is follow the tsx and
+ *	the pushes and pulls and knock two off any offset that reaches past the
+ *	return address into the arguments.
+ *
+ *	Anything we don't fully understand simply means the function is not
+ *	inlined. In particular we must know what X holds every time it is used
+ *	as an index, and we must know the stack depth at every label.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* common */
+#include "coll.h"
+#include "cpu.h"
+#include "print.h"
+#include "xmalloc.h"
+
+/* cc65 */
+#include "asmcode.h"
+#include "asmlabel.h"
+#include "codegen.h"
+#include "datatype.h"
+#include "function.h"
+#include "global.h"
+#include "input.h"
+#include "stackptr.h"
+#include "symentry.h"
+#include "textlist.h"
+#include "inliner.h"
+
+
+/* The kinds of line we keep */
+#define IL_CODE		0	/* Instruction, copied as is */
+#define IL_LABEL	1	/* Local label definition */
+#define IL_BRANCH	2	/* Branch to a local label */
+#define IL_RETURN	3	/* Return from the function */
+
+typedef struct InlineLine {
+    unsigned char	Kind;
+    unsigned		Label;
+    char		Text[];
+} InlineLine;
+
+typedef struct InlineFunc {
+    const char*		Name;
+    int			Mode;		/* >0 forced, <0 never */
+    unsigned		Uses;		/* References to the function */
+    unsigned		Inlined;	/* Calls we expanded */
+    unsigned		ArgSize;
+    unsigned		Size;		/* Instructions in the body */
+    int			HasBody;
+    Collection		Lines;
+    CodeMark		Start;		/* Entire function for removal */
+    CodeMark		End;
+} InlineFunc;
+
+/* Label tracking while scanning a body */
+typedef struct LabelInfo {
+    unsigned		Label;
+    int			Depth;		/* Stack depth or -1 if not yet known */
+    unsigned		Refs;
+} LabelInfo;
+
+/* What we know about X while scanning a body */
+#define XS_UNKNOWN	0	/* Must be reloaded before use */
+#define XS_OTHER	1	/* Something that is not stack related */
+#define XS_STACK	2	/* tsx, adjusted by XDelta */
+
+/* All the functions we have heard of */
+static Collection Funcs = STATIC_COLLECTION_INITIALIZER;
+
+/* Functions we kept a body for, in the order they were compiled */
+static Collection Bodies = STATIC_COLLECTION_INITIALIZER;
+
+
+
+static InlineFunc* FindFunc (const char* Name, int Create)
+{
+    unsigned I;
+    InlineFunc* F;
+
+    for (I = 0; I < CollCount (&Funcs); I++) {
+        F = CollAtUnchecked (&Funcs, I);
+        if (strcmp (F->Name, Name) == 0)
+            return F;
+    }
+    if (!Create)
+        return NULL;
+    F = xmalloc (sizeof (InlineFunc));
+    memset (F, 0, sizeof (InlineFunc));
+    F->Name = xstrdup (Name);
+    InitCollection (&F->Lines);
+    CollAppend (&Funcs, F);
+    return F;
+}
+
+
+
+static void FreeLines (InlineFunc* F)
+{
+    unsigned I;
+    for (I = 0; I < CollCount (&F->Lines); I++)
+        xfree (CollAtUnchecked (&F->Lines, I));
+    CollDeleteAll (&F->Lines);
+}
+
+
+
+static void AddLine (InlineFunc* F, unsigned Kind, unsigned Label, const char* Text)
+{
+    InlineLine* L = xmalloc (sizeof (InlineLine) + strlen (Text) + 1);
+    L->Kind = Kind;
+    L->Label = Label;
+    strcpy (L->Text, Text);
+    CollAppend (&F->Lines, L);
+}
+
+
+
+static LabelInfo* FindLabel (Collection* C, unsigned Label)
+{
+    unsigned I;
+    LabelInfo* L;
+
+    for (I = 0; I < CollCount (C); I++) {
+        L = CollAtUnchecked (C, I);
+        if (L->Label == Label)
+            return L;
+    }
+    L = xmalloc (sizeof (LabelInfo));
+    L->Label = Label;
+    L->Depth = -1;
+    L->Refs = 0;
+    CollAppend (C, L);
+    return L;
+}
+
+
+
+/* Split a line of our own output into opcode and operand. Returns 0 for
+   lines that hold nothing of interest */
+static int SplitLine (const char* Line, char* Op, char* Arg)
+{
+    const char* P = Line;
+    char* E;
+
+    while (*P == ' ' || *P == '\t')
+        P++;
+    if (*P == 0 || *P == ';')
+        return 0;
+    while (*P && *P != ' ' && *P != '\t' && *P != ';')
+        *Op++ = *P++;
+    *Op = 0;
+    while (*P == ' ' || *P == '\t')
+        P++;
+    E = Arg;
+    while (*P && *P != ';')
+        *E++ = *P++;
+    while (E > Arg && (E[-1] == ' ' || E[-1] == '\t'))
+        E--;
+    *E = 0;
+    return 1;
+}
+
+
+
+static int IsBranch (const char* Op)
+{
+    static const char* const Conds[] = {
+        "cc", "cs", "eq", "ge", "gt", "hi", "hs", "le",
+        "lo", "ls", "lt", "mi", "ne", "pl", "vc", "vs"
+    };
+    unsigned I;
+
+    if (strcmp (Op, "bra") == 0 || strcmp (Op, "jmp") == 0)
+        return 2;
+    if (strlen (Op) != 3 || (*Op != 'b' && *Op != 'j'))
+        return 0;
+    for (I = 0; I < sizeof (Conds) / sizeof (Conds[0]); I++)
+        if (strcmp (Op + 1, Conds[I]) == 0)
+            return 1;
+    return 0;
+}
+
+
+
+static unsigned LabelNum (const char* Name)
+{
+    return strtoul (Name + 1, NULL, 16);
+}
+
+
+
+/* Parse the offset part of an n,x operand. We only ever generate $hex or
+   decimal numbers with an optional +n */
+static int ParseOffset (const char* S, const char* End, int* Val)
+{
+    char* P;
+
+    *Val = 0;
+    while (S < End) {
+        if (*S == '$')
+            *Val += strtoul (S + 1, &P, 16);
+        else
+            *Val += strtoul (S, &P, 10);
+        if (P == S || P > End)
+            return 0;
+        S = P;
+        if (S < End && *S++ != '+')
+            return 0;
+    }
+    return 1;
+}
+
+
+
+static int ParseBody (InlineFunc* F, TextList* T, TextList* Stop, unsigned ArgSize)
+/* Work through the generated body and build the inline copy */
+{
+    char Op[64];
+    char Arg[256];
+    char Buf[320];
+    Collection Labels = AUTO_COLLECTION_INITIALIZER;
+    TextList* P;
+    LabelInfo* L;
+    int Depth = 0;		/* Bytes we have pushed */
+    int Pops;			/* Bytes a helper pops */
+    int Dead = 0;		/* After an unconditional transfer */
+    int XS = XS_UNKNOWN;
+    int XDelta = 0;		/* inx/dex since the tsx */
+    int XDepth = 0;		/* Stack depth at the tsx */
+    int Ok = 0;
+    unsigned I;
+
+    /* We need to know which labels are used before we meet them */
+    for (P = T; P != Stop; P = P->next) {
+        if (SplitLine (P->str, Op, Arg) && IsBranch (Op) && IsLocalLabelName (Arg))
+            FindLabel (&Labels, LabelNum (Arg))->Refs++;
+    }
+
+    for (P = T; P != Stop; P = P->next) {
+        unsigned Len;
+        char* X;
+
+        if (!SplitLine (P->str, Op, Arg))
+            continue;
+        Len = strlen (Op);
+
+        /* Labels */
+        if (*Arg == 0 && Len && Op[Len - 1] == ':') {
+            Op[Len - 1] = 0;
+            if (!IsLocalLabelName (Op))
+                goto Fail;
+            L = FindLabel (&Labels, LabelNum (Op));
+            if (Dead) {
+                /* Nothing has jumped here yet so if anything does it
+                   will be from below and we don't know the depth */
+                if (L->Refs == 0)
+                    continue;
+                if (L->Depth < 0)
+                    goto Fail;
+                Depth = L->Depth;
+                Dead = 0;
+            } else if (L->Depth >= 0 && L->Depth != Depth)
+                goto Fail;
+            L->Depth = Depth;
+            XS = XS_UNKNOWN;
+            if (L->Refs)
+                AddLine (F, IL_LABEL, L->Label, "");
+            continue;
+        }
+        /* Code that cannot be reached */
+        if (Dead)
+            continue;
+        if (*Op == '.' || strstr (Arg, "@fp"))
+            goto Fail;
+
+        if (strcmp (Op, "rts") == 0) {
+            if (Depth)
+                goto Fail;
+            AddLine (F, IL_RETURN, 0, "");
+            Dead = 1;
+            continue;
+        }
+        if (IsBranch (Op)) {
+            if (IsLocalLabelName (Arg)) {
+                L = FindLabel (&Labels, LabelNum (Arg));
+                if (L->Depth >= 0 && L->Depth != Depth)
+                    goto Fail;
+                L->Depth = Depth;
+                AddLine (F, IL_BRANCH, L->Label, Op);
+                if (IsBranch (Op) == 2)
+                    Dead = 1;
+                continue;
+            }
+            /* The 6800 returns by jumping to the helper that drops the
+               arguments. The caller will do that for us once inlined */
+            if (CPU == CPU_6800 && strcmp (Op, "jmp") == 0 &&
+                strncmp (Arg, "ret", 3) == 0 && ArgSize &&
+                (unsigned) atoi (Arg + 3) == ArgSize) {
+                if (Depth)
+                    goto Fail;
+                AddLine (F, IL_RETURN, 0, "");
+                Dead = 1;
+                continue;
+            }
+            goto Fail;
+        }
+        if (strcmp (Op, "jsr") == 0 || strcmp (Op, "bsr") == 0) {
+            if (strncmp (Arg, "pshindvx", 8) == 0) {
+                /* Pushes the word at n,x */
+                int N = Arg[8] ? atoi (Arg + 8) : 0;
+                int Pos = XDelta + N;
+                if (XS != XS_STACK)
+                    goto Fail;
+                if (Pos >= XDepth && Pos < XDepth + 2)
+                    goto Fail;
+                if (Pos >= XDepth + 2) {
+                    N -= 2;
+                    if (N < 0)
+                        goto Fail;
+                }
+                if (N)
+                    sprintf (Buf, "jsr pshindvx%d", N);
+                else
+                    strcpy (Buf, "jsr pshindvx");
+                Depth += 2;
+                AddLine (F, IL_CODE, 0, Buf);
+                continue;
+            }
+            /* Helpers that work on the top of stack and remove it */
+            Pops = g_helperpops (Arg);
+            if (Pops > 0)
+                Depth -= Pops;
+            else if (strncmp (Arg, "bool", 4) != 0)
+                goto Fail;
+            if (Depth < 0)
+                goto Fail;
+            XS = XS_UNKNOWN;
+            AddLine (F, IL_CODE, 0, P->str);
+            continue;
+        }
+        if (strcmp (Op, "txs") == 0 || strcmp (Op, "lds") == 0 ||
+            strcmp (Op, "sts") == 0 || strcmp (Op, "swi") == 0 ||
+            strcmp (Op, "wai") == 0 || strcmp (Op, "rti") == 0)
+            goto Fail;
+
+        /* Anything reading X as a value rather than as an index must not see
+           a stack pointer */
+        if (XS == XS_STACK && (strcmp (Op, "stx") == 0 ||
+            strcmp (Op, "pshx") == 0 || strcmp (Op, "xgdx") == 0 ||
+            strcmp (Op, "cpx") == 0 || strcmp (Op, "abx") == 0))
+            goto Fail;
+
+        /* Indexed operands */
+        strcpy (Buf, P->str);
+        X = strstr (Arg, ",x");
+        if (X && X[2] == 0) {
+            char* S = X;
+            int V, Pos;
+            if (XS == XS_UNKNOWN)
+                goto Fail;
+            if (XS == XS_STACK) {
+                while (S > Arg && S[-1] != ' ' && S[-1] != '#')
+                    S--;
+                if (!ParseOffset (S, X, &V))
+                    goto Fail;
+                Pos = XDelta + V;
+                if (Pos < 0 || (Pos >= XDepth && Pos < XDepth + 2))
+                    goto Fail;
+                if (Pos >= XDepth + 2) {
+                    V -= 2;
+                    if (V < 0)
+                        goto Fail;
+                }
+                sprintf (Buf, "%s %.*s$%02X,x", Op, (int) (S - Arg), Arg, V);
+            }
+        }
+
+        /* Stack and X tracking */
+        if (strcmp (Op, "psha") == 0 || strcmp (Op, "pshb") == 0 ||
+            strcmp (Op, "des") == 0)
+            Depth++;
+        else if (strcmp (Op, "pula") == 0 || strcmp (Op, "pulb") == 0 ||
+            strcmp (Op, "ins") == 0)
+            Depth--;
+        else if (strcmp (Op, "pshx") == 0)
+            Depth += 2;
+        else if (strcmp (Op, "pulx") == 0) {
+            Depth -= 2;
+            XS = XS_OTHER;
+        } else if (strcmp (Op, "tsx") == 0) {
+            XS = XS_STACK;
+            XDelta = 0;
+            XDepth = Depth;
+        } else if (strcmp (Op, "inx") == 0)
+            XDelta++;
+        else if (strcmp (Op, "dex") == 0)
+            XDelta--;
+        else if (strcmp (Op, "ldx") == 0 || strcmp (Op, "xgdx") == 0)
+            XS = XS_OTHER;
+        if (Depth < 0)
+            goto Fail;
+        AddLine (F, IL_CODE, 0, Buf);
+    }
+    /* We must have finished with the return */
+    if (!Dead)
+        goto Fail;
+
+    /* Count the instructions not including the final return */
+    F->Size = 0;
+    for (I = 0; I + 1 < CollCount (&F->Lines); I++) {
+        InlineLine* IL = CollAtUnchecked (&F->Lines, I);
+        if (IL->Kind != IL_LABEL)
+            F->Size++;
+    }
+    Ok = 1;
+Fail:
+    for (I = 0; I < CollCount (&Labels); I++)
+        xfree (CollAtUnchecked (&Labels, I));
+    DoneCollection (&Labels);
+    return Ok;
+}
+
+
+
+void InlinePragma (const char* Name, int Mode)
+/* Force (Mode > 0) or forbid (Mode < 0) inlining of the named function */
+{
+    FindFunc (Name, 1)->Mode = Mode;
+}
+
+
+
+void InlineNoteUse (const SymEntry* Func)
+/* Note a reference to a function. Functions whose every reference has been
+   inlined can be removed at the end */
+{
+    FindFunc (Func->Name, 1)->Uses++;
+}
+
+
+
+void InlineCapture (const SymEntry* Func, const CodeMark* Start,
+                    const CodeMark* Body, unsigned ArgSize, int Heat)
+/* Called at the end of a function. If it is a suitable candidate then keep
+   the code from Body onwards for inline expansion. Heat is what the profile
+   says about calls to it (see ProfileHot) */
+{
+    InlineFunc* F;
+    CodeMark End;
+    unsigned Budget;
+
+    /* Only functions with internal linkage can be dropped once inlined */
+    if ((Func->Flags & (SC_STATIC | SC_EXTERN)) != SC_STATIC ||
+        !(TypeOf (Func->Type) & CF_FIXARGC))
+        return;
+    /* The stack records describe the calls each function makes itself */
+    if (IS_Get (&CheckStack))
+        return;
+    F = FindFunc (Func->Name, 1);
+    if (F->Mode < 0 || (F->Mode == 0 && !IS_Get (&InlineFuncs)))
+        return;
+    /* Copies of code the profile run never called are wasted space */
+    if (F->Mode == 0 && Heat < 0) {
+        Print (stderr, 1, "%s: not inlining '%s', never called\n",
+               GetCurrentFile (), F->Name);
+        return;
+    }
+
+    GetCodePos (&End);
+    if (!ParseBody (F, Body->Text->next, End.Text->next, ArgSize)) {
+        Print (stderr, 1, "%s: not inlining '%s', unsuitable code\n",
+               GetCurrentFile (), F->Name);
+        FreeLines (F);
+        return;
+    }
+    Budget = InlineSize * IS_Get (&CodeSizeFactor) / 100;
+    if (Heat > 0)
+        Budget *= 2;
+    if (F->Mode == 0 && F->Size > Budget) {
+        Print (stderr, 1, "%s: not inlining '%s', %u instructions\n",
+               GetCurrentFile (), F->Name, F->Size);
+        FreeLines (F);
+        return;
+    }
+    F->HasBody = 1;
+    F->ArgSize = ArgSize;
+    F->Start = *Start;
+    F->End = End;
+    CollAppend (&Bodies, F);
+}
+
+
+
+int InlineCall (const SymEntry* Func, unsigned ParamSize)
+/* Expand a call inline if possible. The arguments have been pushed. Returns
+   true if the function body was emitted */
+{
+    InlineFunc* F = FindFunc (Func->Name, 0);
+    Collection Map = AUTO_COLLECTION_INITIALIZER;
+    unsigned EndLab = 0;
+    unsigned Count;
+    unsigned I;
+
+    if (F == NULL || !F->HasBody || F->ArgSize != ParamSize)
+        return 0;
+
+    /* Each copy needs its own labels */
+    Count = CollCount (&F->Lines);
+    for (I = 0; I < Count; I++) {
+        InlineLine* IL = CollAtUnchecked (&F->Lines, I);
+        if (IL->Kind == IL_LABEL) {
+            LabelInfo* L = FindLabel (&Map, IL->Label);
+            L->Depth = GetLocalLabel ();
+        }
+    }
+
+    /* The body was already optimised as a function. Fence it with comments so
+       copt cannot match a pattern across the call site and the pasted code */
+    g_moveable ();
+    AddCodeLine (";inline %s", F->Name);
+    for (I = 0; I < Count; I++) {
+        InlineLine* IL = CollAtUnchecked (&F->Lines, I);
+        switch (IL->Kind) {
+        case IL_CODE:
+            AddCodeLine ("%s", IL->Text);
+            break;
+        case IL_LABEL:
+            g_defcodelabel (FindLabel (&Map, IL->Label)->Depth);
+            break;
+        case IL_BRANCH:
+            AddCodeLine ("%s %s", IL->Text,
+                         LocalLabelName (FindLabel (&Map, IL->Label)->Depth));
+            break;
+        case IL_RETURN:
+            /* The final return just falls through */
+            if (I + 1 == Count)
+                break;
+            if (EndLab == 0)
+                EndLab = GetLocalLabel ();
+            g_jump (EndLab);
+            break;
+        }
+    }
+    if (EndLab)
+        g_defcodelabel (EndLab);
+    AddCodeLine (";end inline %s", F->Name);
+    g_moveable ();
+
+    for (I = 0; I < CollCount (&Map); I++)
+        xfree (CollAtUnchecked (&Map, I));
+    DoneCollection (&Map);
+
+    F->Inlined++;
+    Print (stderr, 1, "%s: inlined '%s' into '%s'\n",
+           GetCurrentFile (), F->Name, F_GetFuncName (CurrentFunc));
+    return 1;
+}
+
+
+
+void InlineFinish (void)
+/* Remove any static functions that are no longer called and report */
+{
+    unsigned I = CollCount (&Bodies);
+
+    /* Work backwards so that the marks we use are still linked in */
+    while (I--) {
+        InlineFunc* F = CollAtUnchecked (&Bodies, I);
+        if (F->Inlined && F->Uses == F->Inlined) {
+            RemoveCodeRange (&F->Start, &F->End);
+            Print (stderr, 1, "%s: '%s' inlined at all %u call sites, removed\n",
+                   GetCurrentFile (), F->Name, F->Inlined);
+        } else if (F->Inlined) {
+            Print (stderr, 1, "%s: '%s' inlined at %u of %u references\n",
+                   GetCurrentFile (), F->Name, F->Inlined, F->Uses);
+        }
+    }
+}
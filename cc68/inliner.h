@@ -0,0 +1,43 @@
+/*
+ *	CC6303:  A C compiler for the 6803/6303 processors
+ *	(C) 2019 Alan Cox
+ *
+ *	This compiler is built out of a much modified CC65 and all new code
+ *	is placed under the same licence as the original. Please direct all
+ *	cc6303 bugs to the author not to the cc65 developers unless you find
+ *	a bug that is also present in cc65.
+ */
+#ifndef INLINER_H
+#define INLINER_H
+
+/* cc68 */
+#include "asmcode.h"
+#include "symentry.h"
+
+/*
+ *	Inline expansion of small static functions. The generated code of each
+ *	suitable function is kept and copied into the caller in place of the
+ *	jsr with its stack references adjusted for the missing return address.
+ */
+
+extern void InlinePragma (const char* Name, int Mode);
+/* Force (Mode > 0) or forbid (Mode < 0) inlining of the named function */
+
+extern void InlineNoteUse (const SymEntry* Func);
+/* Note a reference to a function. Functions whose every reference has been
+   inlined can be removed at the end */
+
+extern void InlineCapture (const SymEntry* Func, const CodeMark* Start,
+                           const CodeMark* Body, unsigned ArgSize, int Heat);
+/* Called at the end of a function. If it is a suitable candidate then keep
+   the code from Body onwards for inline expansion. Heat is what the profile
+   says about calls to it (see ProfileHot) */
+
+extern int InlineCall (const SymEntry* Func, unsigned ParamSize);
+/* Expand a call inline if possible. The arguments have been pushed. Returns
+   true if the function body was emitted */
+
+extern void InlineFinish (void);
+/* Remove any static functions that are no longer called and report */
+
+#endif
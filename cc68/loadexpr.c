@@ -152,6 +152,9 @@ void LoadExprX (unsigned Flags, struct ExprDesc* Expr)
             Flags |= CF_TEST;
             Internal("BadXTest");
         }
+        if (IsQualVolatile (Expr->Type)) {
+            Flags |= CF_VOLATILE;
+        }
 
         switch (ED_GetLoc (Expr)) {
 
@@ -225,6 +228,9 @@ void LoadExpr (unsigned Flags, struct ExprDesc* Expr)
         if (ED_NeedsTest (Expr)) {
             Flags |= CF_TEST;
         }
+        if (IsQualVolatile (Expr->Type)) {
+            Flags |= CF_VOLATILE;
+        }
 
         switch (ED_GetLoc (Expr)) {
 
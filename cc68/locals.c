@@ -262,15 +262,22 @@ static void ParseAutoDecl (Declaration* Decl)
                 /* Setup the type flags for the assignment */
                 Flags = (Size == SIZEOF_CHAR)? CF_FORCECHAR : CF_NONE;
 
-                /* Parse the expression */
-                hie1 (&Expr);
+                /* Parse the expression, a char only needs the low byte */
+                if (Size == SIZEOF_CHAR) {
+                    LowByteExpr (hie1, &Expr);
+                } else {
+                    hie1 (&Expr);
+                }
 
                 /* If the value is not const, load it into the primary.
                 ** Otherwise pass the information to the code generator.
                 */
                 if (ED_IsConstAbsInt (&Expr))
                     Flags |= CF_CONST;
-                else {
+                else if (Size == SIZEOF_CHAR && IsClassInt (Expr.Type)) {
+                    /* Only B is pushed so it needn't be made a char */
+                    LoadExpr (CF_NONE, &Expr);
+                } else {
                     /* Convert it to the target type */
                     TypeConversion (&Expr, Sym->Type);
                     LoadExpr (CF_NONE, &Expr);
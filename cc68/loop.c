@@ -47,9 +47,13 @@
 #include "xmalloc.h"
 
 /* cc65 */
+#include "codegen.h"
+#include "datatype.h"
 #include "error.h"
+#include "global.h"
 #include "loop.h" 
 #include "stackptr.h"
+#include "symtab.h"
 
 
 
@@ -80,6 +84,9 @@ LoopDesc* AddLoop (unsigned BreakLabel, unsigned ContinueLabel)
     L->StackPtr         = StackPtr;
     L->BreakLabel       = BreakLabel;
     L->ContinueLabel    = ContinueLabel;
+    L->IV               = 0;
+    L->IVArmed          = 0;
+    L->IVWalks          = 0;
 
     /* Insert it into the list */
     L->Next = LoopStack;
@@ -107,3 +114,390 @@ void DelLoop (void)
     LoopStack = LoopStack->Next;
     xfree (L);
 }
+
+
+
+/*****************************************************************************/
+/*                      Induction variable strength reduction                */
+/*****************************************************************************/
+
+
+
+/* A 'for' loop of the form
+
+        for (i = ...; i < N; i++)
+            ... a[i] ...
+
+   where i is an int local only ever used to index one static array is
+   rewritten so that i holds &a[i] for the duration of the loop. The index
+   scaling and the add of the array base vanish from the body, the test
+   becomes an unsigned compare against &a[N] and the increment adds the
+   element size. We are a single pass compiler so we can't know any of this
+   until the body has been generated. Instead we remember where the header
+   code and each array reference went and rewrite them once the body is
+   complete. Anything we don't understand simply leaves the loop alone */
+
+
+
+static int IsIVCandidate (const SymEntry* Sym)
+/* Check if a symbol is a simple int local we can rewrite */
+{
+    return Sym &&
+        (Sym->Flags & (SC_TYPE | SC_AUTO | SC_REGISTER | SC_STATIC |
+                       SC_ADDRTAKEN)) == SC_AUTO &&
+        IsTypeInt (Sym->Type) && !IsQualVolatile (Sym->Type);
+}
+
+
+
+void LoopIVTest (void)
+/* Called before parsing the test of a 'for' loop. If it has the form
+** "i < const", "i <= const" or "i != const" with i a plain int local
+** then start tracking i as an induction variable.
+*/
+{
+    LoopDesc* L = LoopStack;
+    SymEntry* Sym;
+
+    if (!IS_Get (&Optimize) || CurTok.Tok != TOK_IDENT) {
+        return;
+    }
+    if (NextTok.Tok != TOK_LT && NextTok.Tok != TOK_LE &&
+        NextTok.Tok != TOK_NE) {
+        return;
+    }
+    Sym = FindSym (CurTok.Ident);
+    if (!IsIVCandidate (Sym)) {
+        return;
+    }
+    L->IV = Sym;
+    L->IVRefs = 0;
+    L->IVArmed = 1;
+}
+
+
+
+void LoopIVTestDone (void)
+/* Called after parsing the test of a 'for' loop */
+{
+    LoopDesc* L = LoopStack;
+    unsigned long Max;
+
+    if (L->IV == 0) {
+        return;
+    }
+    /* The compare must have happened and been the only use of i */
+    if (L->IVArmed || L->IVRefs != 1) {
+        L->IV = 0;
+        L->IVArmed = 0;
+        return;
+    }
+    /* Turn <= into < and check the limit makes sense */
+    if (L->IVTest == TOK_LE) {
+        L->IVLimit++;
+        L->IVTest = TOK_LT;
+    }
+    Max = IsSignUnsigned (L->IV->Type) ? 0xFFFF : 0x7FFF;
+    if (L->IVLimit < 0 || L->IVLimit > (long) Max) {
+        L->IV = 0;
+    }
+}
+
+
+
+void LoopIVInc (void)
+/* Called before parsing the increment of a 'for' loop */
+{
+    LoopDesc* L = LoopStack;
+
+    if (L->IV == 0) {
+        return;
+    }
+    /* We want i++ or ++i */
+    if (!(CurTok.Tok == TOK_INC && NextTok.Tok == TOK_IDENT &&
+          FindSym (NextTok.Ident) == L->IV) &&
+        !(CurTok.Tok == TOK_IDENT && NextTok.Tok == TOK_INC &&
+          FindSym (CurTok.Ident) == L->IV)) {
+        L->IV = 0;
+        return;
+    }
+    L->IVRefs = 0;
+}
+
+
+
+void LoopIVIncDone (void)
+/* Called after parsing the increment of a 'for' loop */
+{
+    LoopDesc* L = LoopStack;
+
+    if (L->IV == 0) {
+        return;
+    }
+    if (L->IVRefs != 1 || CurTok.Tok != TOK_RPAREN) {
+        L->IV = 0;
+        return;
+    }
+    /* Now count the uses in the body */
+    L->IVRefs = 0;
+    L->IVWalks = 0;
+    L->IVSize = 0;
+}
+
+
+
+void LoopSymRef (const SymEntry* Sym)
+/* Note a reference to a symbol */
+{
+    LoopDesc* L;
+
+    for (L = LoopStack; L; L = L->Next) {
+        if (L->IV == Sym) {
+            L->IVRefs++;
+        }
+    }
+}
+
+
+
+void LoopNoteCompare (token_t Tok, int RConst, long Val)
+/* Note a compare operation with the given operator */
+{
+    LoopDesc* L = LoopStack;
+
+    /* We only care about the first compare in the loop test. The test
+       began with "i op" so this is it, and if the rhs was a constant that
+       ended the expression it was the whole test */
+    if (L == 0 || !L->IVArmed) {
+        return;
+    }
+    L->IVArmed = 0;
+    if (!RConst || CurTok.Tok != TOK_SEMI) {
+        L->IV = 0;
+        return;
+    }
+    L->IVTest = Tok;
+    L->IVLimit = Val;
+}
+
+
+
+void LoopNoteWalk (const ExprDesc* Subscript, unsigned Flags, uintptr_t Name,
+                   long Offs, unsigned Size, const CodeMark* Start)
+/* Note that the code from Start to the current position computed the
+** address of Name+Offs[Subscript] with elements of Size.
+*/
+{
+    LoopDesc* L;
+    IVWalk* W;
+
+    if (!ED_IsLVal (Subscript) || !ED_IsLocStack (Subscript)) {
+        return;
+    }
+    for (L = LoopStack; L; L = L->Next) {
+        if (L->IV && L->IV == Subscript->Sym) {
+            break;
+        }
+    }
+    /* Anything we can't handle is left counted as a reference and will
+       stop the rewrite */
+    if (L == 0 || L->IVWalks == MAX_IV_WALKS ||
+        Subscript->IVal != L->IV->V.Offs || Start->SP != StackPtr) {
+        return;
+    }
+    if (L->IVSize == 0) {
+        L->IVFlags = Flags;
+        L->IVName = Name;
+        L->IVOffs = Offs;
+        L->IVSize = Size;
+    } else if (L->IVFlags != Flags || L->IVName != Name ||
+               L->IVOffs != Offs || L->IVSize != Size) {
+        return;
+    }
+    W = &L->Walk[L->IVWalks++];
+    W->Start = *Start;
+    GetCodePos (&W->End);
+    L->IVRefs--;
+}
+
+
+
+void LoopBarrier (void)
+/* Control flow we can't follow (labels, gotos, inline assembler) means no
+** enclosing loop can be rewritten.
+*/
+{
+    LoopDesc* L;
+
+    for (L = LoopStack; L; L = L->Next) {
+        L->IV = 0;
+    }
+}
+
+
+
+void LoopCaseBarrier (void)
+/* A case label means no loop between it and its switch can be rewritten */
+{
+    LoopDesc* L;
+
+    /* The switch is the loop entry without a continue label */
+    for (L = LoopStack; L && L->ContinueLabel; L = L->Next) {
+        L->IV = 0;
+    }
+}
+
+
+
+static void LoadIV (const LoopDesc* L)
+/* Load the induction variable */
+{
+    g_getlocal (CF_INT | CF_UNSIGNED, L->IV->V.Offs);
+}
+
+
+
+static void StoreIV (const LoopDesc* L)
+/* Store the induction variable */
+{
+    g_putlocal (CF_INT | CF_UNSIGNED, L->IV->V.Offs, 0);
+}
+
+
+
+static void IVBlockStart (CodeMark* M, const CodeMark* At)
+/* Start generating code at the end that will replace the code at At */
+{
+    GetCodePosMovable (M);
+    StackPtr = At->SP;
+    XState = At->X;
+}
+
+
+
+static void IVBlockEnd (const CodeMark* M, const CodeMark* From,
+                        const CodeMark* To)
+/* Move the code generated since M into place and drop what it replaces */
+{
+    CodeMark End;
+
+    GetCodePos (&End);
+    MoveCode (M, &End, To);
+    RemoveCodeRange (From, To);
+}
+
+
+
+void LoopRewriteIV (unsigned BodyLabel)
+/* Called at the end of a 'for' loop once the increment and test have been
+** moved to the bottom. If the induction variable is only used to index a
+** single static array then turn it into a pointer that walks the array.
+*/
+{
+    LoopDesc* L = LoopStack;
+    const CodeMark* Order[5 + 2 * MAX_IV_WALKS];
+    CodeMark M;
+    unsigned N;
+    unsigned I;
+    int OldSP = StackPtr;
+
+    if (L->IV == 0) {
+        return;
+    }
+    /* Every use of i in the body must be one of the array walks and
+       nothing must have thrown the code away since */
+    if (L->IVRefs != 0 || L->IVWalks == 0) {
+        L->IV = 0;
+        return;
+    }
+    N = 0;
+    Order[N++] = &L->IVInit;
+    for (I = 0; I < L->IVWalks; I++) {
+        Order[N++] = &L->Walk[I].Start;
+        Order[N++] = &L->Walk[I].End;
+    }
+    Order[N++] = &L->IVIncStart;
+    Order[N++] = &L->IVIncEnd;
+    Order[N++] = &L->IVTestStart;
+    Order[N++] = &L->IVTestEnd;
+    if (!CodeMarksInOrder (Order, N)) {
+        L->IV = 0;
+        return;
+    }
+
+    /* Each array reference will become just a load of i. The code that
+       follows the reference may expect X to be left as it was so check
+       that first */
+    for (I = 0; I < L->IVWalks; I++) {
+        IVWalk* W = &L->Walk[I];
+        IVBlockStart (&M, &W->Start);
+        LoadIV (L);
+        N = (W->End.X && XState != W->End.X) || StackPtr != W->End.SP;
+        RemoveCode (&M);
+        if (N) {
+            StackPtr = OldSP;
+            L->IV = 0;
+            return;
+        }
+    }
+
+    /* Replace each piece of code working backwards, so that the marks for
+       the earlier pieces stay valid. The test becomes a pointer compare */
+    IVBlockStart (&M, &L->IVTestStart);
+    LoadIV (L);
+    if (L->IVTest == TOK_LT) {
+        g_ltaddr_static (L->IVFlags, L->IVName,
+                         L->IVOffs + L->IVLimit * L->IVSize);
+    } else {
+        g_neaddr_static (L->IVFlags, L->IVName,
+                         L->IVOffs + L->IVLimit * L->IVSize);
+    }
+    g_truejump (CF_NONE, BodyLabel);
+    IVBlockEnd (&M, &L->IVTestStart, &L->IVTestEnd);
+
+    /* The increment steps by the element size */
+    IVBlockStart (&M, &L->IVIncStart);
+    LoadIV (L);
+    g_inc (CF_INT | CF_UNSIGNED | CF_CONST, L->IVSize);
+    StoreIV (L);
+    IVBlockEnd (&M, &L->IVIncStart, &L->IVIncEnd);
+
+    /* The array references */
+    I = L->IVWalks;
+    while (I--) {
+        IVWalk* W = &L->Walk[I];
+        IVBlockStart (&M, &W->Start);
+        LoadIV (L);
+        IVBlockEnd (&M, &W->Start, &W->End);
+    }
+
+    /* And the initializer gains code to turn i into a pointer */
+    IVBlockStart (&M, &L->IVInit);
+    LoadIV (L);
+    g_scale (CF_INT, L->IVSize);
+    g_addaddr_static (L->IVFlags, L->IVName, L->IVOffs);
+    StoreIV (L);
+    IVBlockEnd (&M, &L->IVInit, &L->IVInit);
+
+    StackPtr = OldSP;
+}
+
+
+
+void LoopRewriteIVExit (void)
+/* Called after the break label of a 'for' loop that was rewritten by
+** LoopRewriteIV to turn the pointer back into an index.
+*/
+{
+    LoopDesc* L = LoopStack;
+
+    if (L->IV == 0) {
+        return;
+    }
+    /* The walk is an unsigned address, and for an int i the byte offset
+       can be past 0x7FFF, so scale down unsigned whatever the type of i */
+    LoadIV (L);
+    g_subaddr_static (L->IVFlags, L->IVName, L->IVOffs);
+    g_scale (CF_INT | CF_UNSIGNED, -(long) L->IVSize);
+    StoreIV (L);
+}
@@ -47,18 +47,54 @@
 
 
 
+/* cc68 */
+#include "asmcode.h"
+#include "exprdesc.h"
+#include "scanner.h"
+#include "symentry.h"
+
+
+
 /*****************************************************************************/
 /*                                   data                                    */
 /*****************************************************************************/
 
 
 
+/* Most array references we will rewrite in one loop */
+#define MAX_IV_WALKS    8
+
+/* An array reference indexed by the induction variable */
+typedef struct IVWalk IVWalk;
+struct IVWalk {
+    CodeMark    Start;          /* Code computing &a[i] */
+    CodeMark    End;
+};
+
 typedef struct LoopDesc LoopDesc;
 struct LoopDesc {
     LoopDesc*   Next;
     unsigned    StackPtr;
     unsigned    BreakLabel;
     unsigned    ContinueLabel;
+
+    /* Induction variable tracking for 'for' loops */
+    SymEntry*   IV;             /* Induction variable or NULL */
+    unsigned    IVRefs;         /* References to it in the current part */
+    int         IVArmed;        /* Waiting for the loop test compare */
+    token_t     IVTest;         /* The compare operator */
+    long        IVLimit;        /* and the constant it compares against */
+    unsigned    IVFlags;        /* Base array of the walks */
+    uintptr_t   IVName;
+    long        IVOffs;
+    unsigned    IVSize;         /* Element size */
+    unsigned    IVWalks;
+    IVWalk      Walk[MAX_IV_WALKS];
+    CodeMark    IVInit;         /* End of the initializer */
+    CodeMark    IVTestStart;    /* The test code */
+    CodeMark    IVTestEnd;
+    CodeMark    IVIncStart;     /* The increment code */
+    CodeMark    IVIncEnd;
 };
 
 
@@ -78,6 +114,52 @@ LoopDesc* CurrentLoop (void);
 void DelLoop (void);
 /* Remove the current loop */
 
+void LoopIVTest (void);
+/* Called before parsing the test of a 'for' loop. If it has the form
+** "i < const", "i <= const" or "i != const" with i a plain int local
+** then start tracking i as an induction variable.
+*/
+
+void LoopIVTestDone (void);
+/* Called after parsing the test of a 'for' loop */
+
+void LoopIVInc (void);
+/* Called before parsing the increment of a 'for' loop */
+
+void LoopIVIncDone (void);
+/* Called after parsing the increment of a 'for' loop */
+
+void LoopSymRef (const SymEntry* Sym);
+/* Note a reference to a symbol */
+
+void LoopNoteCompare (token_t Tok, int RConst, long Val);
+/* Note a compare operation with the given operator */
+
+void LoopNoteWalk (const ExprDesc* Subscript, unsigned Flags, uintptr_t Name,
+                   long Offs, unsigned Size, const CodeMark* Start);
+/* Note that the code from Start to the current position computed the
+** address of Name+Offs[Subscript] with elements of Size.
+*/
+
+void LoopBarrier (void);
+/* Control flow we can't follow (labels, gotos, inline assembler) means no
+** enclosing loop can be rewritten.
+*/
+
+void LoopCaseBarrier (void);
+/* A case label means no loop between it and its switch can be rewritten */
+
+void LoopRewriteIV (unsigned BodyLabel);
+/* Called at the end of a 'for' loop once the increment and test have been
+** moved to the bottom. If the induction variable is only used to index a
+** single static array then turn it into a pointer that walks the array.
+*/
+
+void LoopRewriteIVExit (void);
+/* Called after the break label of a 'for' loop that was rewritten by
+** LoopRewriteIV to turn the pointer back into an index.
+*/
+
 
 
 /* End of loop.h */
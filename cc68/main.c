@@ -72,9 +72,11 @@
 #include "input.h"
 #include "macrotab.h"
 #include "output.h"
+#include "profile.h"
 #include "scanner.h"
 #include "segments.h"
 #include "standard.h"
+#include "timer.h"
 
 
 
@@ -124,15 +126,21 @@ static void Usage (void)
             "  --eagerly-inline-funcs\tEagerly inline some known functions\n"
             "  --help\t\t\tHelp (this text)\n"
             "  --include-dir dir\t\tSet an include directory search path\n"
+            "  --inline-funcs\t\tInline small static functions\n"
+            "  --inline-size n\t\tSet the size limit for inlined functions\n"
             "  --inline-stdfuncs\t\tInline some standard functions\n"
             "  --list-warnings\t\tList available warning types for -W\n"
             "  --local-strings\t\tEmit string literals immediately\n"
+            "  --lower-printf\t\tTake literal printf formats apart\n"
+            "  --profile-generate\t\tCount how often code runs\n"
+            "  --profile-use dump\t\tOptimize using counts from a memory dump\n"
             "  --register-space b\t\tSet space available for register variables\n"
             "  --register-vars\t\tEnable register variables\n"
             "  --rodata-name seg\t\tSet the name of the RODATA segment\n"
             "  --signed-chars\t\tDefault characters are signed\n"
             "  --standard std\t\tLanguage standard (c89, c99, cc68)\n"
             "  --static-locals\t\tMake local variables static\n"
+            "  --time-report file\t\tAppend the phase times to file\n"
             "  --verbose\t\t\tIncrease verbosity\n"
             "  --version\t\t\tPrint the compiler version number\n"
             "  --writable-strings\t\tMake string literals writable\n",
@@ -357,6 +365,26 @@ static void OptIncludeDir (const char* Opt attribute ((unused)), const char* Arg
 
 
 
+static void OptInlineFuncs (const char* Opt attribute((unused)),
+                            const char* Arg attribute((unused)))
+/* Inline small static functions */
+{
+    IS_Set (&InlineFuncs, 1);
+}
+
+
+
+static void OptInlineSize (const char* Opt, const char* Arg)
+/* Handle the --inline-size option */
+{
+    /* Numeric argument expected */
+    if (sscanf (Arg, "%u", &InlineSize) != 1 || InlineSize > 1000) {
+        AbEnd ("Argument for option %s is invalid", Opt);
+    }
+}
+
+
+
 static void OptInlineStdFuncs (const char* Opt attribute((unused)),
                                const char* Arg attribute((unused)))
 /* Inline some standard functions */
@@ -388,6 +416,32 @@ static void OptLocalStrings (const char* Opt attribute ((unused)),
 
 
 
+static void OptLowerPrintf (const char* Opt attribute ((unused)),
+                            const char* Arg attribute ((unused)))
+/* Take printf and sprintf calls with a literal format apart */
+{
+    IS_Set (&LowerPrintf, 1);
+}
+
+
+
+static void OptProfileGenerate (const char* Opt attribute ((unused)),
+                                const char* Arg attribute ((unused)))
+/* Handle the --profile-generate option */
+{
+    ProfileGenerate ();
+}
+
+
+
+static void OptProfileUse (const char* Opt attribute ((unused)), const char* Arg)
+/* Handle the --profile-use option */
+{
+    ProfileUse (Arg);
+}
+
+
+
 static void OptRegisterSpace (const char* Opt, const char* Arg)
 /* Handle the --register-space option */
 {
@@ -454,6 +508,14 @@ static void OptStaticLocals (const char* Opt attribute ((unused)),
 
 
 
+static void OptTimeReport (const char* Opt attribute ((unused)), const char* Arg)
+/* Handle the --time-report option */
+{
+    TimerReport (Arg);
+}
+
+
+
 static void OptVerbose (const char* Opt attribute ((unused)),
                         const char* Arg attribute ((unused)))
 /* Increase verbosity */
@@ -546,15 +608,21 @@ int main (int argc, char* argv[])
         { "--eagerly-inline-funcs", 0,      OptEagerlyInlineFuncs   },
         { "--help",                 0,      OptHelp                 },
         { "--include-dir",          1,      OptIncludeDir           },
+        { "--inline-funcs",         0,      OptInlineFuncs          },
+        { "--inline-size",          1,      OptInlineSize           },
         { "--inline-stdfuncs",      0,      OptInlineStdFuncs       },
         { "--list-warnings",        0,      OptListWarnings         },
         { "--local-strings",        0,      OptLocalStrings         },
+        { "--lower-printf",         0,      OptLowerPrintf          },
+        { "--profile-generate",     0,      OptProfileGenerate      },
+        { "--profile-use",          1,      OptProfileUse           },
         { "--register-space",       1,      OptRegisterSpace        },
         { "--register-vars",        0,      OptRegisterVars         },
         { "--rodata-name",          1,      OptRodataName           },
         { "--signed-chars",         0,      OptSignedChars          },
         { "--standard",             1,      OptStandard             },
         { "--static-locals",        0,      OptStaticLocals         },
+        { "--time-report",          1,      OptTimeReport           },
         { "--verbose",              0,      OptVerbose              },
         { "--version",              0,      OptVersion              },
         { "--writable-strings",     0,      OptWritableStrings      },
@@ -654,6 +722,7 @@ int main (int argc, char* argv[])
                         switch (*P++) {
                             case 'i':
                                 IS_Set (&CodeSizeFactor, 200);
+                                IS_Set (&InlineFuncs, 1);
                                 break;
                             case 'r':
                                 IS_Set (&EnableRegVars, 1);
@@ -730,6 +799,7 @@ int main (int argc, char* argv[])
         OpenOutputFile ();
 
         /* Write the output to the file */
+        TimerPhase (PHASE_OUTPUT);
         WriteAsmOutput ();
         Print (stdout, 1, "Wrote output to '%s'\n", OutputFilename);
 
@@ -740,6 +810,9 @@ int main (int argc, char* argv[])
         CreateDependencies ();
     }
 
+    /* Report the phase times if asked */
+    TimerFinish (InputFile);
+
     /* Return an apropriate exit code */
     return (ErrorCount > 0)? EXIT_FAILURE : EXIT_SUCCESS;
 }
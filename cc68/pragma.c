@@ -54,6 +54,7 @@
 #include "error.h"
 #include "expr.h"
 #include "global.h"
+#include "inliner.h"
 #include "litpool.h"
 #include "scanner.h"
 #include "scanstrbuf.h"
@@ -82,9 +83,12 @@ typedef enum {
     PRAGMA_CODESIZE,
     PRAGMA_DATA_NAME,
     PRAGMA_DATASEG,                                     /* obsolete */
+    PRAGMA_INLINE,
+    PRAGMA_INLINE_FUNCS,
     PRAGMA_INLINE_STDFUNCS,
     PRAGMA_LOCAL_STRINGS,
     PRAGMA_MESSAGE,
+    PRAGMA_NOINLINE,
     PRAGMA_OPTIMIZE,
     PRAGMA_REGISTER_VARS,
     PRAGMA_REGVARADDR,
@@ -117,9 +121,12 @@ static const struct Pragma {
     { "codesize",               PRAGMA_CODESIZE           },
     { "data-name",              PRAGMA_DATA_NAME          },
     { "dataseg",                PRAGMA_DATASEG            },      /* obsolete */
+    { "inline",                 PRAGMA_INLINE             },
+    { "inline-funcs",           PRAGMA_INLINE_FUNCS       },
     { "inline-stdfuncs",        PRAGMA_INLINE_STDFUNCS    },
     { "local-strings",          PRAGMA_LOCAL_STRINGS      },
     { "message",                PRAGMA_MESSAGE            },
+    { "noinline",               PRAGMA_NOINLINE           },
     { "optimize",               PRAGMA_OPTIMIZE           },
     { "register-vars",          PRAGMA_REGISTER_VARS      },
     { "regvaraddr",             PRAGMA_REGVARADDR         },
@@ -388,6 +395,22 @@ static void StringPragma (StrBuf* B, void (*Func) (const char*))
 
 
 
+static void InlinePragmaName (StrBuf* B, int Mode)
+/* Handle a pragma that forces or forbids inlining of a named function */
+{
+    StrBuf Ident = AUTO_STRBUF_INITIALIZER;
+
+    if (SB_GetSym (B, &Ident, 0)) {
+        InlinePragma (SB_GetConstBuf (&Ident), Mode);
+    } else {
+        Error ("Function name expected");
+    }
+
+    SB_Done (&Ident);
+}
+
+
+
 static void SegNamePragma (StrBuf* B, segment_t Seg)
 /* Handle a pragma that expects a segment name parameter */
 {
@@ -723,6 +746,14 @@ static void ParsePragma (void)
             SegNamePragma (&B, SEG_DATA);
             break;
 
+        case PRAGMA_INLINE:
+            InlinePragmaName (&B, 1);
+            break;
+
+        case PRAGMA_INLINE_FUNCS:
+            FlagPragma (&B, &InlineFuncs);
+            break;
+
         case PRAGMA_INLINE_STDFUNCS:
             FlagPragma (&B, &InlineStdFuncs);
             break;
@@ -735,6 +766,10 @@ static void ParsePragma (void)
             StringPragma (&B, MakeMessage);
             break;
 
+        case PRAGMA_NOINLINE:
+            InlinePragmaName (&B, -1);
+            break;
+
         case PRAGMA_OPTIMIZE:
             FlagPragma (&B, &Optimize);
             break;
@@ -0,0 +1,274 @@
+/*
+ *	CC6303:  A C compiler for the 6803/6303 processors
+ *	(C) 2019 Alan Cox
+ *
+ *	This compiler is built out of a much modified CC65 and all new code
+ *	is placed under the same licence as the original. Please direct all
+ *	cc6303 bugs to the author not to the cc65 developers unless you find
+ *	a bug that is also present in cc65.
+ */
+/*
+ *	Take literal printf and sprintf formats apart
+ *
+ *	The format argument is never pushed. All the other arguments are
+ *	evaluated and pushed in order exactly as for the real call, so side
+ *	effects and nested calls behave, and then in place of the call we
+ *	load each one back and call the emitter for its conversion with the
+ *	literal text output in between. The emitters live in libfmt, which
+ *	also has a printf and sprintf that walk any other format with the
+ *	same code so the two always agree.
+ *
+ *	We understand %d %i %u %x %X %c %s and %%, an l on the integer ones,
+ *	the '-' and '0' flags and a width up to 63. Any other format is left
+ *	for the library to deal with at run time.
+ */
+
+#include <string.h>
+
+/* cc65 */
+#include "codegen.h"
+#include "error.h"
+#include "global.h"
+#include "litpool.h"
+#include "scanner.h"
+#include "stackptr.h"
+#include "typeconv.h"
+#include "printfcall.h"
+
+
+
+void PrintfStart (PrintfCall* P, const ExprDesc* Expr, const FuncDesc* Func)
+/* Called before the arguments of a call are parsed. Expr is 0 for a call
+   through a pointer */
+{
+    P->FmtArg = 0;
+    P->Taken = 0;
+    if (!IS_Get (&LowerPrintf) || Expr == 0 || Expr->Sym == 0 ||
+        (Func->Flags & FD_VARIADIC) == 0) {
+        return;
+    }
+    /* It has to look like the library one */
+    if (strcmp ((const char*) Expr->Name, "printf") == 0) {
+        P->FmtArg = 1;
+    } else if (strcmp ((const char*) Expr->Name, "sprintf") == 0) {
+        P->FmtArg = 2;
+    }
+    if (Func->ParamCount != P->FmtArg) {
+        P->FmtArg = 0;
+    }
+}
+
+
+
+static int ParseFormat (PrintfCall* P, const char* F, unsigned Len)
+/* Split the format up. Returns 0 if it has anything we don't handle */
+{
+    const char* End = F + Len;
+    PrintfConv* C = P->Conv;
+    unsigned Width;
+    int Long;
+
+    P->Count = 0;
+    C->Text = 0;
+    while (F < End && *F) {
+        if (*F != '%') {
+            SB_AppendChar (&P->Text, *F++);
+            continue;
+        }
+        if (++F < End && *F == '%') {
+            SB_AppendChar (&P->Text, *F++);
+            continue;
+        }
+        if (P->Count == PF_MAXCONV) {
+            return 0;
+        }
+        C->TextLen = SB_GetLen (&P->Text) - C->Text;
+        C->Field = 0;
+        for (; F < End; F++) {
+            if (*F == '-') {
+                C->Field |= 0x80;
+            } else if (*F == '0') {
+                C->Field |= 0x40;
+            } else {
+                break;
+            }
+        }
+        Width = 0;
+        while (F < End && *F >= '0' && *F <= '9') {
+            Width = Width * 10 + *F++ - '0';
+            if (Width > 63) {
+                return 0;
+            }
+        }
+        C->Field |= Width;
+        Long = 0;
+        if (F < End && *F == 'l') {
+            Long = 1;
+            F++;
+        }
+        if (F == End) {
+            return 0;
+        }
+        switch (*F++) {
+            case 'd':
+            case 'i':
+                C->Helper = Long ? "pfld" : "pfd";
+                C->ArgType = Long ? type_long : type_int;
+                break;
+            case 'u':
+                C->Helper = Long ? "pflu" : "pfu";
+                C->ArgType = Long ? type_ulong : type_uint;
+                break;
+            case 'x':
+                C->Helper = Long ? "pflx" : "pfx";
+                C->ArgType = Long ? type_ulong : type_uint;
+                break;
+            case 'X':
+                C->Helper = Long ? "pflX" : "pfX";
+                C->ArgType = Long ? type_ulong : type_uint;
+                break;
+            case 'c':
+                if (Long) {
+                    return 0;
+                }
+                C->Helper = "pfc";
+                C->ArgType = type_int;
+                break;
+            case 's':
+                if (Long) {
+                    return 0;
+                }
+                C->Helper = "pfs";
+                C->ArgType = 0;
+                break;
+            default:
+                return 0;
+        }
+        P->Count++;
+        C++;
+        C->Text = SB_GetLen (&P->Text);
+    }
+    C->TextLen = SB_GetLen (&P->Text) - C->Text;
+    C->Helper = 0;
+    return 1;
+}
+
+
+
+int PrintfFormat (PrintfCall* P, unsigned Arg)
+/* Called before argument Arg (counting from 1) is parsed. If it is a format
+   we can take apart it is consumed and 1 is returned, and the caller must
+   neither parse nor push it */
+{
+    if (Arg != P->FmtArg || CurTok.Tok != TOK_SCONST ||
+        (NextTok.Tok != TOK_COMMA && NextTok.Tok != TOK_RPAREN)) {
+        return 0;
+    }
+    SB_Init (&P->Text);
+    if (!ParseFormat (P, GetLiteralStr (CurTok.SVal),
+                      GetLiteralSize (CurTok.SVal))) {
+        SB_Done (&P->Text);
+        return 0;
+    }
+    /* Only the pieces are output so the format itself can go */
+    ReleaseLiteral (CurTok.SVal);
+    NextToken ();
+    P->Taken = 1;
+    P->Args = 0;
+    return 1;
+}
+
+
+
+void PrintfArg (PrintfCall* P, ExprDesc* Expr, unsigned Arg)
+/* Called once argument Arg is parsed. Converts an argument for a conversion
+   to the type the emitter wants */
+{
+    if (P->Taken && Arg > P->FmtArg) {
+        Arg -= P->FmtArg + 1;
+        if (Arg < P->Count && P->Conv[Arg].ArgType) {
+            TypeConversion (Expr, P->Conv[Arg].ArgType);
+        }
+    }
+}
+
+
+
+void PrintfPushed (PrintfCall* P, unsigned Flags, unsigned Arg)
+/* Called when argument Arg has been pushed with type flags Flags */
+{
+    /* The sprintf buffer is pushed before we see the format, so note where
+       it went in case the format turns out to be one we take apart */
+    if (Arg < P->FmtArg) {
+        P->BufOffs = StackPtr;
+        return;
+    }
+    if (!P->Taken) {
+        return;
+    }
+    if (Arg - P->FmtArg - 1 < P->Count) {
+        PrintfConv* C = P->Conv + Arg - P->FmtArg - 1;
+        C->Flags = Flags;
+        C->Offs = StackPtr;
+        P->Args = Arg - P->FmtArg;
+    }
+}
+
+
+
+static void EmitText (PrintfCall* P, const PrintfConv* C)
+/* Output the text in front of a conversion */
+{
+    const char* T = SB_GetConstBuf (&P->Text) + C->Text;
+    StrBuf S = STATIC_STRBUF_INITIALIZER;
+    Literal* L;
+
+    if (C->TextLen == 0) {
+        return;
+    }
+    if (C->TextLen == 1) {
+        g_getimmed (CF_CHAR | CF_FORCECHAR | CF_CONST, (unsigned char) *T, 0);
+        g_fmtcall ("pfchr");
+        return;
+    }
+    SB_AppendBuf (&S, T, C->TextLen);
+    SB_AppendChar (&S, 0);
+    L = AddLiteralStr (&S);
+    SB_Done (&S);
+    g_getimmed (CF_STATIC, GetLiteralLabel (L), 0);
+    g_fmtcall ("pfstr");
+}
+
+
+
+void PrintfEmit (PrintfCall* P)
+/* Output the text and emitter calls in place of the call. The result, the
+   number of characters written, is left in D */
+{
+    PrintfConv* C = P->Conv;
+    unsigned I;
+
+    if (P->FmtArg == 2) {
+        g_getlocal (CF_PTR, P->BufOffs);
+        g_fmtcall ("pfbuf");
+    } else {
+        g_fmtcall ("pfcon");
+    }
+    for (I = 0; I < P->Count; I++, C++) {
+        EmitText (P, C);
+        if (I >= P->Args) {
+            Warning ("Too few arguments for the format");
+            break;
+        }
+        if (C->Field) {
+            g_fmtfield (C->Field);
+        }
+        g_getlocal (C->Flags, C->Offs);
+        g_fmtcall (C->Helper);
+    }
+    if (I == P->Count) {
+        EmitText (P, C);
+    }
+    g_fmtcall ("pfend");
+    SB_Done (&P->Text);
+}
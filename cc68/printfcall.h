@@ -0,0 +1,71 @@
+/*
+ *	CC6303:  A C compiler for the 6803/6303 processors
+ *	(C) 2019 Alan Cox
+ *
+ *	This compiler is built out of a much modified CC65 and all new code
+ *	is placed under the same licence as the original. Please direct all
+ *	cc6303 bugs to the author not to the cc65 developers unless you find
+ *	a bug that is also present in cc65.
+ */
+#ifndef PRINTFCALL_H
+#define PRINTFCALL_H
+
+/*
+ *	With --lower-printf a printf or sprintf whose format is a string
+ *	literal is taken apart at compile time. The arguments are pushed as
+ *	usual but instead of the call we output the text and a call to the
+ *	library emitter for each conversion, so only the conversions used
+ *	get linked and nothing parses the format at run time.
+ */
+
+#include "strbuf.h"
+
+#include "exprdesc.h"
+#include "funcdesc.h"
+
+/* Most conversions we will take apart in one format */
+#define PF_MAXCONV	16
+
+typedef struct PrintfConv PrintfConv;
+struct PrintfConv {
+    unsigned            Text;           /* Text in front of the conversion */
+    unsigned            TextLen;
+    const char*         Helper;         /* Emitter, or 0 for the final text */
+    Type*               ArgType;        /* Type the argument is converted to */
+    unsigned char       Field;          /* Width and flags for the emitter */
+    unsigned            Flags;          /* Type of the pushed argument */
+    int                 Offs;           /* Where it was pushed */
+};
+
+typedef struct PrintfCall PrintfCall;
+struct PrintfCall {
+    unsigned            FmtArg;         /* Argument number of the format */
+    int                 Taken;          /* We have the format */
+    StrBuf              Text;           /* The text between conversions */
+    unsigned            Count;          /* Number of conversions */
+    unsigned            Args;           /* Arguments seen after the format */
+    int                 BufOffs;        /* Where the sprintf buffer was pushed */
+    PrintfConv          Conv[PF_MAXCONV + 1];
+};
+
+void PrintfStart (PrintfCall* P, const ExprDesc* Expr, const FuncDesc* Func);
+/* Called before the arguments of a call are parsed. Expr is 0 for a call
+   through a pointer */
+
+int PrintfFormat (PrintfCall* P, unsigned Arg);
+/* Called before argument Arg (counting from 1) is parsed. If it is a format
+   we can take apart it is consumed and 1 is returned, and the caller must
+   neither parse nor push it */
+
+void PrintfArg (PrintfCall* P, ExprDesc* Expr, unsigned Arg);
+/* Called once argument Arg is parsed. Converts an argument for a conversion
+   to the type the emitter wants */
+
+void PrintfPushed (PrintfCall* P, unsigned Flags, unsigned Arg);
+/* Called when argument Arg has been pushed with type flags Flags */
+
+void PrintfEmit (PrintfCall* P);
+/* Output the text and emitter calls in place of the call. The result, the
+   number of characters written, is left in D */
+
+#endif
@@ -0,0 +1,223 @@
+/*
+ *	CC6303:  A C compiler for the 6803/6303 processors
+ *	(C) 2019 Alan Cox
+ *
+ *	This compiler is built out of a much modified CC65 and all new code
+ *	is placed under the same licence as the original. Please direct all
+ *	cc6303 bugs to the author not to the cc65 developers unless you find
+ *	a bug that is also present in cc65.
+ */
+/*
+ *	Profile guided optimisation
+ *
+ *	Each source file that is instrumented gets one table in the data
+ *	segment so that it can be found in a memory dump of the target or in
+ *	the memory image sim68 -d writes out. The table is
+ *
+ *		"PROF"
+ *		16 byte file name, zero padded
+ *		16bit count of counters
+ *		16bit counters
+ *
+ *	all big endian as the target is. The counters wrap, so a profile run
+ *	should be kept short enough for that not to matter.
+ *
+ *	Counters are numbered in the order the parser meets the things they
+ *	count, never by what code we generate, so a --profile-use compile of
+ *	the same source asks for the same numbers whatever it decides to do
+ *	with them.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+/* common */
+#include "fname.h"
+#include "xmalloc.h"
+
+/* cc65 */
+#include "asmlabel.h"
+#include "codegen.h"
+#include "error.h"
+#include "segments.h"
+#include "profile.h"
+
+
+#define PROF_NAMELEN	16
+#define PROF_HEADER	(4 + PROF_NAMELEN + 2)
+
+static int Generate;			/* Instrumenting */
+static const char* UseFile;		/* Dump to read counts from */
+static char Module[PROF_NAMELEN];	/* Our name in the table */
+static unsigned NextId;			/* Counters handed out */
+static unsigned TableLabel;		/* Label of the table */
+
+static unsigned char* Counts;		/* Counters from the dump */
+static unsigned NumCounts;
+static unsigned long MaxCount;		/* Busiest counter */
+
+
+
+void ProfileGenerate (void)
+/* Instrument the code */
+{
+    Generate = 1;
+}
+
+
+
+void ProfileUse (const char* File)
+/* Take the counts from a dump */
+{
+    UseFile = File;
+}
+
+
+
+static unsigned long CountAt (unsigned Id)
+{
+    return (Counts[2 * Id] << 8) | Counts[2 * Id + 1];
+}
+
+
+
+static void LoadDump (void)
+/* Find our table in the dump */
+{
+    FILE* F = fopen (UseFile, "rb");
+    unsigned char* Buf;
+    long Len;
+    long I;
+    unsigned N;
+
+    if (F == NULL) {
+        Fatal ("Cannot open profile '%s': %s", UseFile, strerror (errno));
+    }
+    fseek (F, 0, SEEK_END);
+    Len = ftell (F);
+    rewind (F);
+    Buf = xmalloc (Len + 1);
+    if (fread (Buf, Len, 1, F) != 1 && Len) {
+        Fatal ("Cannot read profile '%s'", UseFile);
+    }
+    fclose (F);
+
+    for (I = 0; I + PROF_HEADER <= Len; I++) {
+        if (memcmp (Buf + I, "PROF", 4) ||
+            memcmp (Buf + I + 4, Module, PROF_NAMELEN)) {
+            continue;
+        }
+        N = (Buf[I + PROF_HEADER - 2] << 8) | Buf[I + PROF_HEADER - 1];
+        if (I + PROF_HEADER + 2 * N > Len) {
+            continue;
+        }
+        Counts = xmalloc (2 * N + 1);
+        memcpy (Counts, Buf + I + PROF_HEADER, 2 * N);
+        NumCounts = N;
+        for (N = 0; N < NumCounts; N++) {
+            if (CountAt (N) > MaxCount) {
+                MaxCount = CountAt (N);
+            }
+        }
+        break;
+    }
+    if (Counts == NULL) {
+        Warning ("No profile for '%.*s' in '%s'", PROF_NAMELEN, Module, UseFile);
+    }
+    xfree (Buf);
+}
+
+
+
+void ProfileStart (const char* FileName)
+/* Called before compiling. Loads the counts for this file if needed */
+{
+    strncpy (Module, FindName (FileName), PROF_NAMELEN - 1);
+    if (UseFile && !Generate) {
+        LoadDump ();
+    }
+}
+
+
+
+unsigned ProfileNew (unsigned Count)
+/* Allocate Count consecutive counters and return the first. The counters
+   are numbered in source order so a run with --profile-use sees the same
+   numbers as the instrumented one did */
+{
+    unsigned Id = NextId;
+    NextId += Count;
+    return Id;
+}
+
+
+
+void ProfileCount (unsigned Id)
+/* Generate the code to bump a counter if we are instrumenting */
+{
+    if (Generate) {
+        if (TableLabel == 0) {
+            TableLabel = GetLocalLabel ();
+        }
+        g_profcount (TableLabel, PROF_HEADER + 2 * Id);
+    }
+}
+
+
+
+long ProfileGet (unsigned Id)
+/* Return the count recorded for a counter or -1 if we don't know */
+{
+    if (Id >= NumCounts) {
+        return -1;
+    }
+    return CountAt (Id);
+}
+
+
+
+int ProfileHot (unsigned Id)
+/* Return 1 if the counter is among the busiest in the file, -1 if it
+   never ran in the profile and 0 if we don't know or it is in between */
+{
+    long N = ProfileGet (Id);
+
+    if (N < 0) {
+        return 0;
+    }
+    if (N == 0) {
+        return -1;
+    }
+    /* Within a factor of four of the busiest */
+    return (unsigned long) N * 4 >= MaxCount;
+}
+
+
+
+void ProfileFinish (void)
+/* Emit the counter table, or check the profile matched */
+{
+    char Buf[8 * PROF_NAMELEN];
+    unsigned I;
+
+    if (Counts && NumCounts != NextId) {
+        Warning ("Profile for '%.*s' does not match the source", PROF_NAMELEN, Module);
+    }
+    if (TableLabel == 0) {
+        return;
+    }
+    g_usedata ();
+    g_defdatalabel (TableLabel);
+    AddDataLine ("\t.byte\t$50,$52,$4F,$46");
+    for (I = 0; I < PROF_NAMELEN; I++) {
+        sprintf (Buf + 4 * I, "$%02X,", (unsigned char) Module[I]);
+    }
+    Buf[4 * PROF_NAMELEN - 1] = 0;
+    AddDataLine ("\t.byte\t%s", Buf);
+    AddDataLine ("\t.word\t$%04X", NextId);
+    for (I = 0; I < NextId; I++) {
+        AddDataLine ("\t.word\t$0000");
+    }
+}
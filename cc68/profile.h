@@ -0,0 +1,47 @@
+/*
+ *	CC6303:  A C compiler for the 6803/6303 processors
+ *	(C) 2019 Alan Cox
+ *
+ *	This compiler is built out of a much modified CC65 and all new code
+ *	is placed under the same licence as the original. Please direct all
+ *	cc6303 bugs to the author not to the cc65 developers unless you find
+ *	a bug that is also present in cc65.
+ */
+#ifndef PROFILE_H
+#define PROFILE_H
+
+/*
+ *	Profile guided optimisation. With --profile-generate each function
+ *	entry, if/else arm and case label increments a counter in a table in
+ *	the data segment. With --profile-use the table is found again in a
+ *	memory dump or simulator image and the counts steer the code layout.
+ */
+
+extern void ProfileGenerate (void);
+/* Instrument the code */
+
+extern void ProfileUse (const char* File);
+/* Take the counts from a dump */
+
+extern void ProfileStart (const char* FileName);
+/* Called before compiling. Loads the counts for this file if needed */
+
+extern unsigned ProfileNew (unsigned Count);
+/* Allocate Count consecutive counters and return the first. The counters
+   are numbered in source order so a run with --profile-use sees the same
+   numbers as the instrumented one did */
+
+extern void ProfileCount (unsigned Id);
+/* Generate the code to bump a counter if we are instrumenting */
+
+extern long ProfileGet (unsigned Id);
+/* Return the count recorded for a counter or -1 if we don't know */
+
+extern int ProfileHot (unsigned Id);
+/* Return 1 if the counter is among the busiest in the file, -1 if it
+   never ran in the profile and 0 if we don't know or it is in between */
+
+extern void ProfileFinish (void);
+/* Emit the counter table, or check the profile matched */
+
+#endif
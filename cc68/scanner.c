@@ -66,6 +66,7 @@
 #include "scanner.h"
 #include "standard.h"
 #include "symtab.h"
+#include "timer.h"
 
 
 
@@ -194,10 +195,13 @@ static int SkipWhite (void)
 {
     while (1) {
         while (CurC == '\0') {
+            unsigned Phase = TimerPhase (PHASE_PREPROCESS);
             if (NextLine () == 0) {
+                TimerPhase (Phase);
                 return 0;
             }
             Preprocess ();
+            TimerPhase (Phase);
         }
         if (IsSpace (CurC)) {
             NextChar ();
@@ -56,6 +56,7 @@
 
 /* cc65 */
 #include "codeent.h"
+#include "codegen.h"
 #include "codeseg.h"
 #include "dataseg.h"
 #include "error.h"
@@ -255,6 +256,7 @@ void AddCodeLine (const char* Format, ...)
     vsnprintf(buf, 512, Format, ap);
     CHECK (CS != 0);
 //    printf("C:%s\n", buf);
+    g_noteline(buf);
     AppendCode(buf);
     va_end (ap);
 }
@@ -64,6 +64,7 @@
 #include "locals.h"
 #include "loop.h"
 #include "pragma.h"
+#include "profile.h"
 #include "scanner.h"
 #include "stackptr.h"
 #include "stmt.h"
@@ -157,21 +158,72 @@ static void SkipPending (int PendingToken)
 
 
 
+static int SwappedIfStatement (unsigned ProfId)
+/* Handle an 'if' statement whose else branch ran more often in the profile.
+** The test jumps to the if branch, which is moved after the else branch so
+** that the busier path falls straight through.
+*/
+{
+    unsigned IfLabel  = GetLocalLabel ();
+    unsigned EndLabel = GetLocalLabel ();
+    CodeMark IfStart;
+    CodeMark IfEnd;
+    CodeMark ElseEnd;
+    int      GotBreak;
+
+    /* Parse the condition and jump if true */
+    TestInParens (IfLabel, 1);
+
+    /* Parse the if body */
+    GetCodePosMovable (&IfStart);
+    g_defcodelabel (IfLabel);
+    ProfileCount (ProfId);
+    GotBreak = Statement (0);
+    GetCodePosMovable (&IfEnd);
+
+    /* Parse the else body which follows the test */
+    if (CurTok.Tok == TOK_ELSE) {
+        NextToken ();
+        ProfileCount (ProfId + 1);
+        GotBreak &= Statement (0);
+    } else {
+        GotBreak = 0;
+    }
+    g_jump (EndLabel);
+
+    /* And put the if body after it */
+    GetCodePos (&ElseEnd);
+    MoveCode (&IfStart, &IfEnd, &ElseEnd);
+    g_defcodelabel (EndLabel);
+
+    return GotBreak;
+}
+
+
+
 static int IfStatement (void)
 /* Handle an 'if' statement */
 {
     unsigned Label1;
     unsigned TestResult;
     int GotBreak;
+    unsigned ProfId;
 
     /* Skip the if */
     NextToken ();
 
+    /* Counters for the two branches */
+    ProfId = ProfileNew (2);
+    if (ProfileGet (ProfId + 1) > ProfileGet (ProfId)) {
+        return SwappedIfStatement (ProfId);
+    }
+
     /* Generate a jump label and parse the condition */
     Label1 = GetLocalLabel ();
     TestResult = TestInParens (Label1, 0);
 
     /* Parse the if body */
+    ProfileCount (ProfId);
     GotBreak = Statement (0);
 
     /* Else clause present? */
@@ -204,6 +256,7 @@ static int IfStatement (void)
         g_defcodelabel (Label1);
 
         /* Total break only if both branches had a break. */
+        ProfileCount (ProfId + 1);
         GotBreak &= Statement (0);
 
         /* Generate the label for the else clause */
@@ -257,6 +310,8 @@ static void WhileStatement (void)
 /* Handle the 'while' statement */
 {
     int         PendingToken;
+    unsigned    TestResult;
+    CodeMark    JumpStart;      /* Start of the jump to the condition */
     CodeMark    CondCodeStart;  /* Start of condition evaluation code */
     CodeMark    CondCodeEnd;    /* End of condition evaluation code */
     CodeMark    Here;           /* "Here" location of code */
@@ -277,17 +332,25 @@ static void WhileStatement (void)
     /* We will move the code that evaluates the while condition to the end of
     ** the loop, so generate a jump here.
     */
+    GetCodePos (&JumpStart);
     g_jump (CondLabel);
 
     /* Remember the current position */
     GetCodePosMovable (&CondCodeStart);
 
     /* Test the loop condition */
-    TestInParens (LoopLabel, 1);
+    TestResult = TestInParens (LoopLabel, 1);
 
     /* Remember the end of the condition evaluation code */
     GetCodePos (&CondCodeEnd);
 
+    /* For an endless loop the condition is just a jump back to the top,
+    ** so there is nothing to jump to first.
+    */
+    if (TestResult == TESTEXPR_TRUE) {
+        RemoveCode (&JumpStart);
+    }
+
     /* Define the head label */
     g_defcodelabel (LoopLabel);
 
@@ -298,8 +361,12 @@ static void WhileStatement (void)
     g_defcodelabel (CondLabel);
 
     /* Move the test code here */
-    GetCodePos (&Here);
-    MoveCode (&CondCodeStart, &CondCodeEnd, &Here);
+    if (TestResult == TESTEXPR_TRUE) {
+        g_jump (LoopLabel);
+    } else {
+        GetCodePos (&Here);
+        MoveCode (&CondCodeStart, &CondCodeEnd, &Here);
+    }
 
     /* Exit label */
     g_defcodelabel (BreakLabel);
@@ -319,12 +386,20 @@ static void ReturnStatement (void)
 /* Handle the 'return' statement */
 {
     ExprDesc Expr;
+    int      TailCalled = 0;
 
     NextToken ();
     if (CurTok.Tok != TOK_SEMI) {
 
-        /* Evaluate the return expression */
-        hie0 (&Expr);
+        /* Evaluate the return expression. A char result only needs the
+        ** low byte.
+        */
+        if (!F_HasVoidReturn (CurrentFunc) &&
+            SizeOf (F_GetReturnType (CurrentFunc)) == SIZEOF_CHAR) {
+            LowByteExpr (hie0, &Expr);
+        } else {
+            hie0 (&Expr);
+        }
 
         /* If we return something in a void function, print an error and
         ** ignore the value. Otherwise convert the value to the type of the
@@ -338,6 +413,9 @@ static void ReturnStatement (void)
 
             /* Load the value into the primary */
             LoadExpr (CF_NONE, &Expr);
+
+            /* return f(x) may be able to hand our frame over to f */
+            TailCalled = TailCall (&Expr);
         }
 
     } else if (!F_HasVoidReturn (CurrentFunc) && !F_HasOldStyleIntRet (CurrentFunc)) {
@@ -347,11 +425,27 @@ static void ReturnStatement (void)
     /* Mark the function as having a return statement */
     F_ReturnFound (CurrentFunc);
 
+    if (TailCalled) {
+        return;
+    }
+
     /* Cleanup the stack in case we're inside a block with locals */
     g_space (StackPtr - F_GetTopLevelSP (CurrentFunc), 1);
 
-    /* Output a jump to the function exit code */
-    g_jump (F_GetRetLab (CurrentFunc));
+    /* If the function has no frame to tear down then return directly,
+    ** otherwise output a jump to the function exit code. A helper that
+    ** pops the stack cannot be followed by the return as the optimizer
+    ** would turn the pair into a jump to the helper.
+    */
+    if (F_GetTopLevelSP (CurrentFunc) == 0 && !g_hasframe () &&
+        !g_aftertoscall ()) {
+        const SymEntry* Func = CurrentFunc->FuncEntry;
+        g_return (F_HasVoidReturn (CurrentFunc), TypeOf (Func->Type),
+                  F_GetParamSize (CurrentFunc));
+    } else {
+        g_jump (F_GetRetLab (CurrentFunc));
+        F_ReturnJumped (CurrentFunc);
+    }
 }
 
 
@@ -423,10 +517,14 @@ static void ForStatement (void)
 {
     ExprDesc lval1;
     ExprDesc lval3;
-    int HaveIncExpr;
+    int HaveTest;
+    CodeMark TestStart;
+    CodeMark TestEnd;
     CodeMark IncExprStart;
     CodeMark IncExprEnd;
+    CodeMark Here;
     int PendingToken;
+    LoopDesc* L;
 
     /* Get several local labels needed later */
     unsigned TestLabel    = GetLocalLabel ();
@@ -440,7 +538,7 @@ static void ForStatement (void)
     /* Add the loop to the loop stack. A continue jumps to the start of the
     ** the increment condition.
     */
-    AddLoop (BreakLabel, IncLabel);
+    L = AddLoop (BreakLabel, IncLabel);
 
     /* Skip the opening paren */
     ConsumeLParen ();
@@ -455,16 +553,33 @@ static void ForStatement (void)
     }
     ConsumeSemi ();
 
+    /* The test and the increment are generated here but moved to the
+    ** bottom of the loop, so that each pass through the loop costs only
+    ** the one branch back to the body. That means we first have to jump
+    ** to the test. Keep track of where the header code goes in case the
+    ** loop variable can be strength reduced.
+    */
+    GetCodePos (&L->IVInit);
+    HaveTest = (CurTok.Tok != TOK_SEMI);
+    if (HaveTest) {
+        g_jump (TestLabel);
+    }
+
     /* Label for the test expressions */
+    GetCodePosMovable (&TestStart);
     g_defcodelabel (TestLabel);
+    GetCodePos (&L->IVTestStart);
 
     /* Parse the test expression */
-    if (CurTok.Tok != TOK_SEMI) {
+    if (HaveTest) {
+        LoopIVTest ();
         Test (BodyLabel, 1);
-        g_jump (BreakLabel);
+        LoopIVTestDone ();
+        GetCodePos (&L->IVTestEnd);
     } else {
         g_jump (BodyLabel);
     }
+    GetCodePos (&TestEnd);
     ConsumeSemi ();
 
     /* Remember the start of the increment expression */
@@ -472,15 +587,15 @@ static void ForStatement (void)
 
     /* Label for the increment expression */
     g_defcodelabel (IncLabel);
+    GetCodePos (&L->IVIncStart);
 
     /* Parse the increment expression */
-    HaveIncExpr = (CurTok.Tok != TOK_RPAREN);
-    if (HaveIncExpr) {
+    LoopIVInc ();
+    if (CurTok.Tok != TOK_RPAREN) {
         Expression0 (&lval3);
     }
-
-    /* Jump to the test */
-    g_jump (TestLabel);
+    LoopIVIncDone ();
+    GetCodePos (&L->IVIncEnd);
 
     /* Remember the end of the increment expression */
     GetCodePos (&IncExprEnd);
@@ -493,18 +608,16 @@ static void ForStatement (void)
     Statement (&PendingToken);
     g_statement();
 
-    /* If we had an increment expression, move the code to the bottom of
-    ** the loop. In this case we don't need to jump there at the end of
-    ** the loop body.
+    /* Move the increment and then the test to the bottom of the loop. The
+    ** increment falls through into the test.
     */
-    if (HaveIncExpr) {
-        CodeMark Here;
-        GetCodePos (&Here);
-        MoveCode (&IncExprStart, &IncExprEnd, &Here);
-    } else {
-        /* Jump back to the increment expression */
-        g_jump (IncLabel);
-    }
+    GetCodePos (&Here);
+    MoveCode (&IncExprStart, &IncExprEnd, &Here);
+    GetCodePos (&Here);
+    MoveCode (&TestStart, &TestEnd, &Here);
+
+    /* Turn an array index into a pointer if we can */
+    LoopRewriteIV (BodyLabel);
 
     /* Skip a pending token if we have one */
     SkipPending (PendingToken);
@@ -512,6 +625,9 @@ static void ForStatement (void)
     /* Declare the break label */
     g_defcodelabel (BreakLabel);
 
+    /* And turn any pointer back into an index */
+    LoopRewriteIVExit ();
+
     /* Remove the loop from the loop stack */
     DelLoop ();
 }
@@ -673,6 +789,8 @@ int Statement (int* PendingToken)
             GetCodePos (&Start);
             /* Actual statement */
             ExprWithCheck (hie0, &Expr);
+            /* The value itself is not used */
+            g_dropresult ();
             /* Load the result only if it is an lvalue and the type is
             ** marked as volatile. Otherwise the load is useless.
             */
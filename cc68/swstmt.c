@@ -58,6 +58,7 @@
 #include "expr.h"
 #include "global.h"
 #include "loop.h"
+#include "profile.h"
 #include "scanner.h"
 #include "stmt.h"
 #include "swstmt.h"
@@ -76,9 +77,10 @@ struct SwitchCtrl {
     TypeCode    ExprType;       /* Basic switch expression type */
     unsigned    Depth;          /* Number of bytes the selector type has */
     unsigned    DefaultLabel;   /* Label for the default branch */
-
-
-
+    long        Total;          /* Profile count of all the labels */
+    long        HotCount;       /* Profile count of the busiest case */
+    unsigned long HotVal;       /* Its value */
+    unsigned    HotLabel;       /* And its code label */
 };
 
 /* Pointer to current switch control struct */
@@ -144,6 +146,8 @@ void SwitchStatement (void)
     SwitchData.ExprType     = UnqualifiedType (SwitchExpr.Type[0].C);
     SwitchData.Depth        = SizeOf (SwitchExpr.Type);
     SwitchData.DefaultLabel = 0;
+    SwitchData.Total        = 0;
+    SwitchData.HotCount     = 0;
     OldSwitch = Switch;
     Switch = &SwitchData;
 
@@ -184,6 +188,10 @@ void SwitchStatement (void)
         /* No default label, use switch exit */
         SwitchData.DefaultLabel = ExitLabel;
     }
+    /* If the profile says one case dominates test it before the rest */
+    if (SwitchData.Depth <= 2 && SwitchData.HotCount * 2 > SwitchData.Total) {
+        g_switchhot (SwitchData.HotVal, SwitchData.HotLabel, SwitchData.Depth);
+    }
     g_switch (SwitchData.Nodes, SwitchData.DefaultLabel, SwitchData.Depth);
 
     /* Move the code to the front */
@@ -212,6 +220,25 @@ void SwitchStatement (void)
 
 
 
+static void ProfileLabel (long Val, unsigned CodeLabel)
+/* Count a case or default label and remember the busiest case */
+{
+    unsigned Id = ProfileNew (1);
+    long     N = ProfileGet (Id);
+
+    ProfileCount (Id);
+    if (N > 0) {
+        Switch->Total += N;
+        if (CodeLabel && N > Switch->HotCount) {
+            Switch->HotCount = N;
+            Switch->HotVal   = Val;
+            Switch->HotLabel = CodeLabel;
+        }
+    }
+}
+
+
+
 void CaseLabel (void)
 /* Handle a case sabel */
 {
@@ -223,6 +250,9 @@ void CaseLabel (void)
     /* Skip the "case" token */
     NextToken ();
 
+    /* Loops inside the switch can now be entered sideways */
+    LoopCaseBarrier ();
+
     /* Read the selector expression */
     ConstAbsIntExpr (hie1, &CaseExpr);
     Val = CaseExpr.IVal;
@@ -273,6 +303,7 @@ void CaseLabel (void)
 
         /* Define this label */
         g_defcodelabel (CodeLabel);
+        ProfileLabel (Val, CodeLabel);
 
     } else {
 
@@ -292,6 +323,7 @@ void DefaultLabel (void)
 {
     /* Default case */
     NextToken ();
+    LoopCaseBarrier ();
 
     /* Now check if we're inside a switch statement */
     if (Switch != 0) {
@@ -302,6 +334,7 @@ void DefaultLabel (void)
             /* Generate and emit the default label */
             Switch->DefaultLabel = GetLocalLabel ();
             g_defcodelabel (Switch->DefaultLabel);
+            ProfileLabel (0, 0);
 
         } else {
             /* We had the default label already */
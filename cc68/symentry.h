@@ -116,6 +116,7 @@ struct CodeEntry;
 #define SC_GOTO         0x20000U
 #define SC_SPADJUSTMENT 0x40000U
 #define SC_GOTO_IND     0x80000U        /* Indirect goto */
+#define SC_ADDRTAKEN    0x100000U       /* Address of a local was taken */
 
 
 
@@ -74,7 +74,7 @@ unsigned Test (unsigned Label, int Invert)
     if (ED_IsConstAbs (&Expr)) {
 
         /* Result is constant, so we know the outcome */
-        Result = (Expr.IVal != 0);
+        Result = (Expr.IVal != 0)? TESTEXPR_TRUE : TESTEXPR_FALSE;
 
         /* Constant rvalue */
         if (!Invert && Expr.IVal == 0) {
@@ -0,0 +1,130 @@
+/*
+ *	CC6303:  A C compiler for the 6803/6303 processors
+ *	(C) 2019 Alan Cox
+ *
+ *	This compiler is built out of a much modified CC65 and all new code
+ *	is placed under the same licence as the original. Please direct all
+ *	cc6303 bugs to the author not to the cc65 developers unless you find
+ *	a bug that is also present in cc65.
+ */
+/*
+ *	Compile time report
+ *
+ *	The preprocessor runs a line at a time as the parser asks for input
+ *	so the phases interleave. Each switch charges the wall and CPU time
+ *	since the last one to the phase we were in. The report has one line
+ *	per phase
+ *
+ *		file,phase,wall_us,cpu_us,maxrss_kb
+ *
+ *	in the format the cc driver writes for each tool it runs, so one
+ *	file covers a whole build. The memory figure is the peak for the
+ *	process when the phase was last left.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+
+/* cc65 */
+#include "error.h"
+#include "timer.h"
+
+
+
+static const char* ReportFile;		/* Where to append, 0 if off */
+static unsigned Current = PHASE_NONE;	/* Phase being charged */
+static long long LastWall;		/* Times at the last switch */
+static long long LastCPU;
+
+static struct {
+    long long   Wall;
+    long long   CPU;
+    long        MaxRSS;
+} Phases[PHASE_COUNT];
+
+static const char* PhaseNames[PHASE_COUNT] = {
+    "cc68",
+    "cc68.preprocess",
+    "cc68.parse",
+    "cc68.optimise",
+    "cc68.literals",
+    "cc68.output"
+};
+
+
+
+void TimerReport (const char* File)
+/* Report the phase times to File */
+{
+    ReportFile = File;
+}
+
+
+
+unsigned TimerPhase (unsigned Phase)
+/* Charge the time so far to the current phase and switch to Phase.
+   Returns the phase we were in so the caller can switch back */
+{
+    unsigned Old = Current;
+    struct timeval TV;
+    struct rusage RU;
+    long long Wall, CPU;
+
+    if (ReportFile == 0 || Phase == Current) {
+        return Old;
+    }
+    gettimeofday (&TV, 0);
+    getrusage (RUSAGE_SELF, &RU);
+    Wall = TV.tv_sec * 1000000LL + TV.tv_usec;
+    CPU = (RU.ru_utime.tv_sec + RU.ru_stime.tv_sec) * 1000000LL +
+          RU.ru_utime.tv_usec + RU.ru_stime.tv_usec;
+    Phases[Current].Wall += Wall - LastWall;
+    Phases[Current].CPU += CPU - LastCPU;
+    Phases[Current].MaxRSS = RU.ru_maxrss;
+    LastWall = Wall;
+    LastCPU = CPU;
+    Current = Phase;
+    return Old;
+}
+
+
+
+void TimerFinish (const char* FileName)
+/* Charge the last phase and append the times for FileName to the report */
+{
+    FILE* F;
+    int FD;
+    unsigned I;
+
+    if (ReportFile == 0) {
+        return;
+    }
+    TimerPhase (PHASE_NONE);
+
+    /* Appends from a parallel build are kept whole by the lock */
+    FD = open (ReportFile, O_WRONLY | O_APPEND | O_CREAT, 0666);
+    if (FD == -1 || (F = fdopen (FD, "a")) == 0) {
+        Warning ("Cannot write time report '%s': %s", ReportFile, strerror (errno));
+        if (FD != -1) {
+            close (FD);
+        }
+        return;
+    }
+    flock (FD, LOCK_EX);
+    /* Phase 0 holds the startup time before the first switch */
+    for (I = 1; I < PHASE_COUNT; I++) {
+        if (Phases[I].Wall || Phases[I].CPU) {
+            fprintf (F, "%s,%s,%lld,%lld,%ld\n", FileName, PhaseNames[I],
+                     Phases[I].Wall, Phases[I].CPU, Phases[I].MaxRSS);
+        }
+    }
+    fflush (F);
+    flock (FD, LOCK_UN);
+    fclose (F);
+}
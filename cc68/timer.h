@@ -0,0 +1,39 @@
+/*
+ *	CC6303:  A C compiler for the 6803/6303 processors
+ *	(C) 2019 Alan Cox
+ *
+ *	This compiler is built out of a much modified CC65 and all new code
+ *	is placed under the same licence as the original. Please direct all
+ *	cc6303 bugs to the author not to the cc65 developers unless you find
+ *	a bug that is also present in cc65.
+ */
+#ifndef TIMER_H
+#define TIMER_H
+
+/*
+ *	Compile time report. With --time-report the wall and CPU time spent
+ *	in each phase of the compiler, and the peak memory use at the end of
+ *	it, are appended to a CSV file shared with the cc driver.
+ */
+
+enum {
+    PHASE_NONE,
+    PHASE_PREPROCESS,		/* Reading and preprocessing lines */
+    PHASE_PARSE,		/* Parsing and code generation */
+    PHASE_OPTIMISE,		/* Per function cleanup and optimisation */
+    PHASE_LITERALS,		/* Literal pool output */
+    PHASE_OUTPUT,		/* Printing the code */
+    PHASE_COUNT
+};
+
+extern void TimerReport (const char* File);
+/* Report the phase times to File */
+
+extern unsigned TimerPhase (unsigned Phase);
+/* Charge the time so far to the current phase and switch to Phase.
+   Returns the phase we were in so the caller can switch back */
+
+extern void TimerFinish (const char* FileName);
+/* Charge the last phase and append the times for FileName to the report */
+
+#endif
@@ -147,10 +147,26 @@ static TextList *MarkToText(const CodeMark *m)
 void RemoveCode(const CodeMark *m)
 {
     TextListRemoveTail(&CodeHead, MarkToText(m)->prev);
+    g_removed();
     StackPtr = m->SP;
     XState = m->X;
 }
 
+/* Remove the code between Start (inclusive) and End (exclusive). Unlike
+   RemoveCode this is not the tail so there is no saved state to go back to */
+void RemoveCodeRange(const CodeMark *start, const CodeMark *end)
+{
+    TextListRemoveRange(start->Text, MarkToText(end));
+    g_removed();
+}
+
+/* Insert a line of code at an earlier mark. Any mark taken at the same
+   position now points before the new line */
+void InsertCodeLine(const CodeMark *m, const char *txt)
+{
+    TextListAppendAfter(m->Text, txt);
+}
+
 /* Move the code between Start (inclusive) and End (exclusive) to
 ** (before) Target. The code marks aren't updated.
 */
@@ -159,6 +175,28 @@ void MoveCode(const CodeMark *start,  const CodeMark *end, const CodeMark *targe
     if (!start->Movable)
        Internal("Moving non-movable block");
     TextListSplice(MarkToText(target)->prev, MarkToText(start), MarkToText(end)->prev);
+    g_removed();
+}
+
+/* Check that a set of marks still point into the live code and that they
+   appear in the order given. Removed lines are never freed so a mark into
+   code that has since been thrown away is safe to look at, it just won't
+   be found. A mark may repeat the position of the one before */
+int CodeMarksInOrder(const CodeMark *const *m, unsigned n)
+{
+    TextList *t = &CodeHead;
+    unsigned i = 0;
+
+    while (i < n) {
+        if (m[i]->Text == t) {
+            i++;
+            continue;
+        }
+        t = t->next;
+        if (t == &CodeHead)
+            return 0;
+    }
+    return 1;
 }
 
 void AppendCode(const char *txt)
@@ -0,0 +1,301 @@
+/*
+ *	CC6303:  A C compiler for the 6803/6303 processors
+ *	(C) 2019 Alan Cox
+ *
+ *	This compiler is built out of a much modified CC65 and all new code
+ *	is placed under the same licence as the original. Please direct all
+ *	cc6303 bugs to the author not to the cc65 developers unless you find
+ *	a bug that is also present in cc65.
+ */
+/*
+ *	Constant multiply
+ *
+ *	A multiply by a constant is broken down into shifts and adds or
+ *	subtracts of a saved copy of the value. We try a plain binary and a
+ *	signed digit (NAF) walk of the constant and also try splitting off
+ *	factors of the form 2^n +/- 1 and pick the cheapest.
+ */
+
+#include <string.h>
+
+#include "mulplan.h"
+
+
+
+/* Bytes and cycles for each operation by width. The 32bit forms are only
+   used on the 6803/6303 */
+static const unsigned char mulcost6800[2][6][2] = {
+    { { 2, 4 }, { 1, 2 }, { 2, 3 }, { 2, 3 }, { 1, 2 }, { 0, 0 } },
+    { { 4, 8 }, { 2, 4 }, { 4, 6 }, { 4, 6 }, { 4, 6 }, { 0, 0 } }
+};
+
+static const unsigned char mulcost6803[3][6][2] = {
+    { { 2, 3 }, { 1, 2 }, { 2, 3 }, { 2, 3 }, { 1, 2 }, { 3, 12 } },
+    { { 2, 4 }, { 1, 3 }, { 2, 5 }, { 2, 5 }, { 4, 6 }, { 0, 0 } },
+    { { 6, 12 }, { 7, 15 }, { 14, 33 }, { 14, 33 }, { 3, 60 }, { 0, 0 } }
+};
+
+/* What we are planning for */
+static cpu_t PlanCpu;
+static unsigned PlanSize;
+
+
+
+static void MulOp (struct MulPlan* P, unsigned Op, unsigned Width)
+{
+    const unsigned char* c;
+    if (P->Len == MAX_MOPS) {
+        P->Bytes = P->Cycles = 0xFFFF;
+        return;
+    }
+    P->Op[P->Len++] = Op;
+    if (PlanCpu == CPU_6800)
+        c = mulcost6800[Width][Op];
+    else
+        c = mulcost6803[Width][Op];
+    P->Bytes += c[0];
+    P->Cycles += c[1];
+}
+
+
+
+static unsigned MulScore (const struct MulPlan* P)
+{
+    return P->Bytes * 200 + P->Cycles * PlanSize;
+}
+
+
+
+static void MulBetter (struct MulPlan* Best, const struct MulPlan* P)
+{
+    if (MulScore (P) < MulScore (Best))
+        *Best = *P;
+}
+
+
+
+/* Walk the digits of an odd constant from the top, digits are -1/0/1 */
+static void MulHorner (struct MulPlan* P, const signed char* Digit, int Top,
+                       unsigned Width)
+{
+    MulOp (P, MOP_SAVE, Width);
+    while (Top--) {
+        MulOp (P, MOP_SHL, Width);
+        if (Digit[Top] == 1)
+            MulOp (P, MOP_ADD, Width);
+        else if (Digit[Top] == -1)
+            MulOp (P, MOP_SUB, Width);
+    }
+}
+
+
+
+static void MulPlanFor (struct MulPlan* Best, unsigned long Val, unsigned Width,
+                        int Depth)
+{
+    struct MulPlan P;
+    signed char Digit[34];
+    unsigned Bits = 8 << Width;
+    unsigned long Odd = Val;
+    unsigned long F, N;
+    unsigned Zeros = 0;
+    unsigned K;
+    int Top;
+
+    Best->Len = 0;
+    Best->Bytes = Best->Cycles = 0xFFFF;
+    if (Val == 0)
+        return;
+
+    while (!(Odd & 1)) {
+        Odd >>= 1;
+        Zeros++;
+    }
+
+    memset (&P, 0, sizeof (P));
+    if (Odd != 1) {
+        /* Plain binary */
+        Top = 0;
+        for (N = Odd; N; N >>= 1)
+            Digit[Top++] = N & 1;
+        MulHorner (&P, Digit, Top - 1, Width);
+        for (K = 0; K < Zeros; K++)
+            MulOp (&P, MOP_SHL, Width);
+        MulBetter (Best, &P);
+
+        /* Signed digits */
+        memset (&P, 0, sizeof (P));
+        Top = 0;
+        N = Odd;
+        while (N) {
+            if (N & 1) {
+                Digit[Top] = 2 - (N & 3);
+                N -= Digit[Top];
+            } else
+                Digit[Top] = 0;
+            Top++;
+            N >>= 1;
+        }
+        MulHorner (&P, Digit, Top - 1, Width);
+    }
+    for (K = 0; K < Zeros; K++)
+        MulOp (&P, MOP_SHL, Width);
+    MulBetter (Best, &P);
+
+    /* Factors of 2^n +/- 1 */
+    if (Depth > 2)
+        return;
+    for (K = 1; K < Bits; K++) {
+        for (F = (1UL << K) - 1; F <= (1UL << K) + 1; F += 2) {
+            if (F < 3 || F >= Odd || Odd % F)
+                continue;
+            MulPlanFor (&P, Odd / F, Width, Depth + 1);
+            MulOp (&P, MOP_SAVE, Width);
+            for (N = 0; N < K; N++)
+                MulOp (&P, MOP_SHL, Width);
+            MulOp (&P, F > (1UL << K) ? MOP_ADD : MOP_SUB, Width);
+            for (N = 0; N < Zeros; N++)
+                MulOp (&P, MOP_SHL, Width);
+            MulBetter (Best, &P);
+        }
+    }
+}
+
+
+
+void MulPlanBest (struct MulPlan* Best, unsigned long Val, unsigned Width,
+                  cpu_t Cpu, unsigned SizeFactor)
+/* Pick the best plan to multiply by Val. SizeFactor weighs cycles against
+   bytes as the compiler --codesize option does */
+{
+    struct MulPlan P;
+    unsigned long Mask = Width == MW_32 ? 0xFFFFFFFFUL : (1UL << (8 << Width)) - 1;
+
+    PlanCpu = Cpu;
+    PlanSize = SizeFactor;
+
+    Val &= Mask;
+    MulPlanFor (Best, Val, Width, 0);
+    MulPlanFor (&P, (~Val + 1) & Mask, Width, 0);
+    MulOp (&P, MOP_NEG, Width);
+    MulBetter (Best, &P);
+
+    /* The 6803 can just multiply bytes */
+    if (Width == MW_8 && Cpu != CPU_6800) {
+        memset (&P, 0, sizeof (P));
+        MulOp (&P, MOP_MUL, Width);
+        MulBetter (Best, &P);
+    }
+}
+
+
+
+void MulPlanEmit (const struct MulPlan* P, unsigned Width, unsigned long Val,
+                  cpu_t Cpu, void (*Line) (const char* Format, ...))
+/* Write out the instructions for a plan one line at a time. The value is
+   in B, D or sreg:D by width and only @tmp1 (and @tmp2 for 32bit) is
+   used */
+{
+    unsigned I, N;
+
+    for (I = 0; I < P->Len; I++) {
+        switch (P->Op[I]) {
+        case MOP_SAVE:
+            if (Width == MW_8)
+                Line ("stab @tmp1");
+            else if (Width == MW_16 && Cpu == CPU_6800) {
+                Line ("staa @tmp1");
+                Line ("stab @tmp1+1");
+            } else if (Width == MW_16)
+                Line ("std @tmp1");
+            else {
+                Line ("std @tmp1");
+                Line ("ldx @sreg");
+                Line ("stx @tmp2");
+            }
+            break;
+        case MOP_SHL:
+            for (N = I; N < P->Len && P->Op[N] == MOP_SHL; N++);
+            N -= I;
+            I += N - 1;
+            if (Width == MW_8) {
+                while (N--)
+                    Line ("aslb");
+            } else if (Width == MW_16) {
+                /* A byte at a time is a move */
+                if (N >= 8) {
+                    Line ("tba");
+                    Line ("clrb");
+                    for (N -= 8; N; N--)
+                        Line ("asla");
+                }
+                while (N--) {
+                    if (Cpu == CPU_6800) {
+                        Line ("aslb");
+                        Line ("rola");
+                    } else
+                        Line ("asld");
+                }
+            } else while (N--) {
+                Line ("asld");
+                Line ("rol @sreg+1");
+                Line ("rol @sreg");
+            }
+            break;
+        case MOP_ADD:
+        case MOP_SUB:
+            if (Width == MW_8)
+                Line (P->Op[I] == MOP_ADD ? "addb @tmp1" : "subb @tmp1");
+            else if (Width == MW_16 && Cpu == CPU_6800) {
+                if (P->Op[I] == MOP_ADD) {
+                    Line ("addb @tmp1+1");
+                    Line ("adca @tmp1");
+                } else {
+                    Line ("subb @tmp1+1");
+                    Line ("sbca @tmp1");
+                }
+            } else if (Width == MW_16)
+                Line (P->Op[I] == MOP_ADD ? "addd @tmp1" : "subd @tmp1");
+            else {
+                /* The carry survives the pushes and the ldd */
+                Line (P->Op[I] == MOP_ADD ? "addd @tmp1" : "subd @tmp1");
+                Line ("pshb");
+                Line ("psha");
+                Line ("ldd @sreg");
+                if (P->Op[I] == MOP_ADD) {
+                    Line ("adcb @tmp2+1");
+                    Line ("adca @tmp2");
+                } else {
+                    Line ("sbcb @tmp2+1");
+                    Line ("sbca @tmp2");
+                }
+                Line ("std @sreg");
+                Line ("pula");
+                Line ("pulb");
+            }
+            break;
+        case MOP_NEG:
+            if (Width == MW_8)
+                Line ("negb");
+            else if (Width == MW_16) {
+                Line ("nega");
+                Line ("negb");
+                Line ("sbca #0");
+            } else
+                Line ("jsr negeax");
+            break;
+        case MOP_MUL:
+            Line ("ldaa #$%02X", (unsigned char) Val);
+            Line ("mul");
+            break;
+        }
+    }
+}
+
+
+
+int MulHelper (unsigned long Val)
+/* Return 1 if the library has a mulaxN helper for Val */
+{
+    return Val >= 3 && Val <= MULAX_MAX && (Val & (Val - 1)) != 0;
+}
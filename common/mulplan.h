@@ -0,0 +1,67 @@
+/*
+ *	CC6303:  A C compiler for the 6803/6303 processors
+ *	(C) 2019 Alan Cox
+ *
+ *	This compiler is built out of a much modified CC65 and all new code
+ *	is placed under the same licence as the original. Please direct all
+ *	cc6303 bugs to the author not to the cc65 developers unless you find
+ *	a bug that is also present in cc65.
+ */
+/*
+ *	Multiply by a constant as shifts and adds. Shared by the compiler,
+ *	which inlines the short ones, and mulgen which writes the library
+ *	helpers for the rest.
+ */
+
+#ifndef MULPLAN_H
+#define MULPLAN_H
+
+
+
+#include "cpu.h"
+
+
+
+#define MOP_SAVE	0	/* Save the working value in @tmp1 */
+#define MOP_SHL		1	/* Shift left one bit */
+#define MOP_ADD		2	/* Add the saved value */
+#define MOP_SUB		3	/* Subtract the saved value */
+#define MOP_NEG		4	/* Negate */
+#define MOP_MUL		5	/* 8x8 hardware multiply (6803/6303) */
+
+#define MAX_MOPS	128
+
+#define MW_8		0
+#define MW_16		1
+#define MW_32		2
+
+struct MulPlan {
+    unsigned Len;
+    unsigned char Op[MAX_MOPS];
+    unsigned Bytes;
+    unsigned Cycles;
+};
+
+/* The library has a mulaxN helper for each N from 3 to this that is not a
+   power of two. lib6800 and lib6803 build the same set, see mulgen/mulax.mk */
+#define MULAX_MAX	63
+
+void MulPlanBest (struct MulPlan* Best, unsigned long Val, unsigned Width,
+                  cpu_t Cpu, unsigned SizeFactor);
+/* Pick the best plan to multiply by Val. SizeFactor weighs cycles against
+   bytes as the compiler --codesize option does */
+
+void MulPlanEmit (const struct MulPlan* P, unsigned Width, unsigned long Val,
+                  cpu_t Cpu, void (*Line) (const char* Format, ...));
+/* Write out the instructions for a plan one line at a time. The value is
+   in B, D or sreg:D by width and only @tmp1 (and @tmp2 for 32bit) is
+   used */
+
+int MulHelper (unsigned long Val);
+/* Return 1 if the library has a mulaxN helper for Val */
+
+
+
+/* End of mulplan.h */
+
+#endif
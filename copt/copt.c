@@ -6,6 +6,10 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
+#include <sys/file.h>
+#include <fcntl.h>
+#include <unistd.h>
 
 #define USE_REGEXP
 
@@ -30,6 +34,10 @@ int rpn_eval(const char* expr, char** vars);
 #define MAX_PASS 16
 
 int debug = 0;
+char *statfile = NULL; /* -S: per rule statistics */
+char *rulefile = ""; /* rules file being read */
+int lineno = 0; /* line in it */
+int ruleline = 0; /* line the current rule starts on */
 char *c_cpu = "6800";
 int global_again = 0; /* signalize that rule set has changed */
 #define FIRSTLAB 'L'
@@ -46,6 +54,13 @@ struct onode {
     struct lnode *o_old, *o_new;
     struct onode* o_next;
     long firecount;
+    struct onode* o_rule; /* rule from the file this came from */
+    char* o_file;
+    int o_line;
+    /* Statistics for -S, kept on o_rule */
+    unsigned long tries, fires;
+    long lines, bytes; /* saved */
+    double usecs; /* spent matching */
 }* opts = 0, *activerule = 0;
 
 void printlines(struct lnode* beg, struct lnode* end, FILE* out)
@@ -138,8 +153,10 @@ void getlst(FILE* fp, char* quit, struct lnode* p1, struct lnode* p2)
 
     connect(p1, p2);
     while (fgets(lin, MAXLINE, fp) != NULL && strcmp(lin, quit)) {
+        ++lineno;
         insert(install(lin), p2);
     }
+    ++lineno;
 }
 
 /* getlst_1 - link lines from fp in between p1 and p2 */
@@ -151,6 +168,7 @@ void getlst_1(FILE* fp, char* quit, struct lnode* p1, struct lnode* p2)
 
     connect(p1, p2);
     while (fgets(lin, MAXLINE, fp) != NULL && strcmp(lin, quit)) {
+        ++lineno;
         if (firstline) {
             char* p = lin;
             if (lin[0] == '#')
@@ -160,9 +178,11 @@ void getlst_1(FILE* fp, char* quit, struct lnode* p1, struct lnode* p2)
             if (!*p)
                 continue;
             firstline = 0;
+            ruleline = lineno;
         }
         insert(install(lin), p2);
     }
+    ++lineno;
 }
 
 /* init - read patterns file */
@@ -178,8 +198,12 @@ void init(FILE* fp)
         p = (struct onode*)malloc((unsigned)sizeof(struct onode));
         if (p == NULL)
             error("init: out of memory\n");
+        memset(p, 0, sizeof(struct onode));
         p->firecount = MAXFIRECOUNT;
+        p->o_rule = p;
+        p->o_file = rulefile;
         getlst_1(fp, "=\n", &head, &tail);
+        p->o_line = ruleline;
         head.l_next->l_prev = 0;
         if (tail.l_prev)
             tail.l_prev->l_next = 0;
@@ -481,14 +505,141 @@ struct lnode* copylist(
     return more;
 }
 
+/* now - microsecond clock for the match timings */
+double now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+/* linebytes - rough 680x size of an assembler line */
+int linebytes(char* p)
+{
+    char op[8];
+    int n = 0;
+    int bytes = 1;
+    char* imm;
+
+    if (!isspace(*p))
+        return 0; /* label */
+    while (isspace(*p))
+        ++p;
+    if (*p == 0 || *p == ';' || *p == '.')
+        return 0;
+    while (isalpha(*p) && n < 7)
+        op[n++] = tolower(*p++);
+    op[n] = 0;
+    while (*p == ' ' || *p == '\t')
+        ++p;
+    if (*p == 0 || *p == '\n' || *p == ';')
+        return 1;
+    if (n == 3 && op[0] == 'b')
+        return 2; /* branch */
+    if ((imm = strchr(p, '#')) != NULL) {
+        if (strcmp(op, "ldx") == 0 || strcmp(op, "ldd") == 0
+            || strcmp(op, "lds") == 0 || strcmp(op, "cpx") == 0
+            || strcmp(op, "addd") == 0 || strcmp(op, "subd") == 0)
+            bytes += 2;
+        else
+            bytes++;
+        /* aim and friends have an address after the immediate */
+        if ((p = strchr(imm, ',')) == NULL)
+            return bytes;
+        ++p;
+    }
+    if (strstr(p, ",x") || *p == '@' || *p == '<')
+        return bytes + 1;
+    return bytes + 2;
+}
+
+/* countlines - add the lines and bytes from p1 up to p2 to a rule */
+void countlines(struct lnode* p1, struct lnode* p2, int sign, struct onode* o)
+{
+    for (; p1 != p2; p1 = p1->l_next) {
+        o->lines += sign;
+        o->bytes += sign * linebytes(p1->l_text);
+    }
+}
+
+/* writestats - merge the rule statistics into the -S file */
+void writestats(void)
+{
+    FILE* fp;
+    int fd;
+    char lin[MAXLINE * 2];
+    char file[MAXLINE];
+    char **keep = NULL;
+    int nkeep = 0;
+    int i, line;
+    unsigned long tries, fires;
+    long lines, bytes;
+    double usecs;
+    struct onode* o;
+    struct lnode* p;
+    char* t;
+
+    /* Parallel builds share the file so hold a lock while we merge */
+    fd = open(statfile, O_RDWR | O_CREAT, 0666);
+    if (fd == -1 || (fp = fdopen(fd, "r+")) == NULL)
+        error("copt: can't open statistics file\n");
+    flock(fd, LOCK_EX);
+
+    while (fgets(lin, sizeof(lin), fp)) {
+        if (sscanf(lin, "%[^,],%d,%lu,%lu,%ld,%ld,%lf", file, &line,
+                &tries, &fires, &lines, &bytes, &usecs) != 7)
+            continue;
+        for (o = opts; o; o = o->o_next)
+            if (o->o_rule == o && o->o_line == line
+                && strcmp(o->o_file, file) == 0)
+                break;
+        if (o == NULL) {
+            /* A rule from another rules file: keep it as it is */
+            keep = realloc(keep, (nkeep + 1) * sizeof(char*));
+            if (keep == NULL || (keep[nkeep++] = strdup(lin)) == NULL)
+                error("writestats: out of memory\n");
+            continue;
+        }
+        o->tries += tries;
+        o->fires += fires;
+        o->lines += lines;
+        o->bytes += bytes;
+        o->usecs += usecs;
+    }
+
+    rewind(fp);
+    if (ftruncate(fd, 0))
+        error("copt: can't write statistics file\n");
+    fputs("file,line,tries,fires,lines_saved,bytes_saved,usecs,pattern\n", fp);
+    for (i = 0; i < nkeep; i++)
+        fputs(keep[i], fp);
+    for (o = opts; o; o = o->o_next) {
+        if (o->o_rule != o)
+            continue;
+        fprintf(fp, "%s,%d,%lu,%lu,%ld,%ld,%.0f,\"", o->o_file, o->o_line,
+            o->tries, o->fires, o->lines, o->bytes, o->usecs);
+        for (p = o->o_old; p->l_prev; p = p->l_prev)
+            ;
+        for (t = p->l_text; *t && *t != '\n'; t++) {
+            if (*t == '"')
+                putc('"', fp);
+            putc(*t, fp);
+        }
+        fputs("\"\n", fp);
+    }
+    fclose(fp);
+}
+
 /* opt - replace instructions ending at r if possible */
 struct lnode* opt(struct lnode* r)
 {
     char* vars[10];
     int i, lines;
-    struct lnode *c, *p;
+    struct lnode *c, *p, *end;
     struct onode* o;
     static char* activated = "%activated ";
+    double t0 = 0;
 
     for (o = opts; o; o = o->o_next) {
         activerule = o;
@@ -502,6 +653,10 @@ struct lnode* opt(struct lnode* r)
         }
         if (p == 0)
             continue; /* skip empty rules */
+        if (statfile) {
+            o->o_rule->tries++;
+            t0 = now();
+        }
         for (i = 0; i < 10; i++)
             vars[i] = 0;
         lines = 0;
@@ -532,8 +687,12 @@ struct lnode* opt(struct lnode* r)
             }
             p = p->l_prev;
         }
+        if (statfile)
+            o->o_rule->usecs += now() - t0;
         if (p != 0)
             continue;
+        if (statfile)
+            o->o_rule->fires++;
 
         /* decrease firecount */
         --o->firecount;
@@ -586,8 +745,9 @@ struct lnode* opt(struct lnode* r)
                     malloc((unsigned)sizeof(struct onode));
                 if (nn == NULL)
                     error("activate: out of memory\n");
-                nn->o_old = 0, nn->o_new = 0;
+                memset(nn, 0, sizeof(struct onode));
                 nn->firecount = MAXFIRECOUNT;
+                nn->o_rule = o->o_rule;
                 lnp = copylist(lnp, &nn->o_old, &nn->o_new, vars);
                 nn->o_next = last->o_next;
                 last->o_next = nn;
@@ -608,7 +768,12 @@ struct lnode* opt(struct lnode* r)
         }
 
         /* fire the rule */
-        r = rep(c, r->l_next, o->o_new, vars);
+        end = r->l_next;
+        if (statfile)
+            countlines(c->l_next, end, 1, o->o_rule);
+        r = rep(c, end, o->o_new, vars);
+        if (statfile)
+            countlines(c->l_next, end, -1, o->o_rule);
         activerule = 0;
         return r;
     }
@@ -633,10 +798,15 @@ int main(int argc, char** argv)
             debug = 1;
         else if ( strncmp(argv[i], "-m",2) == 0 )
             c_cpu = argv[i] + 2;
+        else if (strcmp(argv[i], "-S") == 0 && i + 1 < argc)
+            statfile = argv[++i];
         else if ((fp = fopen(argv[i], "r")) == NULL)
             error("copt: can't open patterns file\n");
-        else
+        else {
+            rulefile = argv[i];
+            lineno = 0;
             init(fp);
+        }
 
 #ifdef _TESTING
     if ((inp = fopen("input.asm", "r")) == NULL)
@@ -664,6 +834,8 @@ int main(int argc, char** argv)
     }
 
     printlines(head.l_next, &tail, stdout);
+    if (statfile)
+        writestats();
     exit(0);
     return 1; /* make compiler happy */
 }
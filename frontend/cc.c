@@ -53,6 +53,9 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <sys/wait.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <sys/file.h>
 
 #define CMD_AS		BINPATH"as68"
 #define CMD_CC		LIBPATH"cc68"
@@ -68,6 +71,8 @@
 #define LIB6303		LIBPATH"lib6303.a"
 #define LIBIO6800	LIBPATH"libio6800.a"
 #define LIBIO6803	LIBPATH"libio6803.a"
+#define LIBFMT6800	LIBPATH"libfmt6800.a"
+#define LIBFMT6803	LIBPATH"libfmt6803.a"
 #define LIBMC10 	LIBPATH"libmc10.a"
 #define LIBFLEX 	LIBPATH"libflex.a"
 #define CMD_TAPEIFY 	LIBPATH"mc10-tapeify"
@@ -115,10 +120,32 @@ int targetos;
 #define OS_MC10		2
 #define OS_FLEX		3
 int fuzixsub;
+char *coptstats;		/* Rule statistics file for copt */
+int timereport;			/* Print the time taken by each step */
+char *timelog;			/* CSV file to append the times to */
+char *curfile;			/* Input file being worked on */
+
+/*
+ *	One line of a time report. cc68 adds lines of its own for its
+ *	internal phases, named cc68.something, which are part of the time
+ *	of the cc68 line for the same file.
+ */
+struct timing {
+	struct timing *next;
+	char *file;
+	char *phase;
+	long long wall;		/* Microseconds */
+	long long cpu;
+	long rss;		/* Peak, kilobytes */
+};
+
+struct timing *timings;
+struct timing **timetail = &timings;
 
 #define MAXARG	512
 
 int arginfd, argoutfd;
+char *argphase;
 char *arglist[MAXARG];
 char **argptr;
 char *rmlist[MAXARG];
@@ -265,14 +292,38 @@ static void resolve_libraries(void)
 	}
 }
 
+static void add_timing(char *file, char *phase, long long wall,
+			long long cpu, long rss)
+{
+	struct timing *t = malloc(sizeof(struct timing));
+	if (t == NULL)
+		memory();
+	t->file = xstrdup(file, 0);
+	t->phase = xstrdup(phase, 0);
+	t->wall = wall;
+	t->cpu = cpu;
+	t->rss = rss;
+	t->next = NULL;
+	*timetail = t;
+	timetail = &t->next;
+}
+
+static long long usecs(struct timeval *tv)
+{
+	return tv->tv_sec * 1000000LL + tv->tv_usec;
+}
+
 static void run_command(void)
 {
 	pid_t pid, p;
 	int status;
+	struct timeval start, end;
+	struct rusage ru;
 
 	fflush(stdout);
 
 	*argptr = NULL;
+	gettimeofday(&start, NULL);
 
 	pid = fork();
 	if (pid == -1) {
@@ -306,12 +357,18 @@ static void run_command(void)
 		close(arginfd);
 	if (argoutfd)
 		close(argoutfd);
-	while ((p = waitpid(pid, &status, 0)) != pid) {
+	while ((p = wait4(pid, &status, 0, &ru)) != pid) {
 		if (p == -1) {
-			perror("waitpid");
+			perror("wait4");
 			fatal();
 		}
 	}
+	if (timereport || timelog) {
+		gettimeofday(&end, NULL);
+		add_timing(curfile ? curfile : target, argphase,
+			usecs(&end) - usecs(&start),
+			usecs(&ru.ru_utime) + usecs(&ru.ru_stime), ru.ru_maxrss);
+	}
 	if (WIFSIGNALED(status) || WEXITSTATUS(status)) {
 		printf("cc: %s failed.\n", arglist[0]);
 		fatal();
@@ -338,12 +395,162 @@ static void redirect_out(const char *p)
 
 static void build_arglist(char *p)
 {
+	char *n = strrchr(p, '/');
 	arginfd = -1;
 	argoutfd = -1;
 	argptr = arglist;
+	argphase = n ? n + 1 : p;
 	add_argument(p);
 }
 
+/* Pick up the phase times cc68 wrote for the file just compiled */
+static void read_timings(char *path)
+{
+	FILE *f = fopen(path, "r");
+	char buf[512];
+	char *phase, *p;
+	long long wall, cpu;
+	long rss;
+
+	if (f == NULL)
+		return;
+	while (fgets(buf, sizeof(buf), f)) {
+		/* The file name is already known, skip it */
+		phase = strchr(buf, ',');
+		if (phase == NULL)
+			continue;
+		p = strchr(++phase, ',');
+		if (p == NULL)
+			continue;
+		*p++ = 0;
+		if (sscanf(p, "%lld,%lld,%ld", &wall, &cpu, &rss) == 3)
+			add_timing(curfile, phase, wall, cpu, rss);
+	}
+	fclose(f);
+}
+
+/* Add up the lines for the same key: the phase, or for files the file
+   name leaving out the cc68 internal lines so nothing counts twice */
+static struct timing *total_timings(struct timing *t, int byfile)
+{
+	struct timing *list = NULL, *n;
+	char *key;
+
+	for (; t; t = t->next) {
+		if (byfile && strchr(t->phase, '.'))
+			continue;
+		key = byfile ? t->file : t->phase;
+		for (n = list; n; n = n->next)
+			if (strcmp(byfile ? n->file : n->phase, key) == 0)
+				break;
+		if (n == NULL) {
+			n = malloc(sizeof(struct timing));
+			if (n == NULL)
+				memory();
+			memset(n, 0, sizeof(struct timing));
+			n->file = t->file;
+			n->phase = t->phase;
+			n->next = list;
+			list = n;
+		}
+		n->wall += t->wall;
+		n->cpu += t->cpu;
+		if (t->rss > n->rss)
+			n->rss = t->rss;
+	}
+	return list;
+}
+
+/* Print the slowest entries first, at most max of them */
+static void print_timings(struct timing *list, int byfile, int max)
+{
+	struct timing *t, *worst;
+	while (list && max--) {
+		worst = list;
+		for (t = list->next; t; t = t->next)
+			if (t->wall > worst->wall)
+				worst = t;
+		fprintf(stderr, "  %-32s %10.3f %10.3f %8ld\n",
+			byfile ? worst->file : worst->phase,
+			worst->wall / 1000.0, worst->cpu / 1000.0, worst->rss);
+		/* Unlink it so the next pass finds the next slowest */
+		if (worst == list)
+			list = list->next;
+		else {
+			for (t = list; t->next != worst; t = t->next);
+			t->next = worst->next;
+		}
+	}
+}
+
+static void time_report(struct timing *list, int each)
+{
+	struct timing *t;
+	if (each) {
+		fprintf(stderr, "%-24s %-16s %10s %10s %8s\n",
+			"file", "phase", "wall ms", "cpu ms", "rss KB");
+		for (t = list; t; t = t->next)
+			fprintf(stderr, "%-24s %-16s %10.3f %10.3f %8ld\n",
+				t->file, t->phase, t->wall / 1000.0,
+				t->cpu / 1000.0, t->rss);
+	}
+	fprintf(stderr, "phases:%27s %10s %10s %8s\n",
+		"", "wall ms", "cpu ms", "rss KB");
+	print_timings(total_timings(list, 0), 0, -1);
+	fprintf(stderr, "slowest files:\n");
+	print_timings(total_timings(list, 1), 1, 10);
+}
+
+/* Append the times to the log, locked so a parallel build can share it */
+static void write_timelog(void)
+{
+	struct timing *t;
+	FILE *f;
+	int fd = open(timelog, O_WRONLY | O_APPEND | O_CREAT, 0666);
+
+	if (fd == -1 || (f = fdopen(fd, "a")) == NULL) {
+		perror(timelog);
+		return;
+	}
+	flock(fd, LOCK_EX);
+	for (t = timings; t; t = t->next)
+		fprintf(f, "%s,%s,%lld,%lld,%ld\n", t->file, t->phase,
+			t->wall, t->cpu, t->rss);
+	fflush(f);
+	flock(fd, LOCK_UN);
+	fclose(f);
+}
+
+/* Summarise a whole build from its log */
+static void time_summary(char *path)
+{
+	FILE *f = fopen(path, "r");
+	char buf[512];
+	char *phase, *p;
+	long long wall, cpu;
+	long rss;
+
+	if (f == NULL) {
+		perror(path);
+		exit(1);
+	}
+	while (fgets(buf, sizeof(buf), f)) {
+		phase = strchr(buf, ',');
+		if (phase == NULL)
+			continue;
+		*phase++ = 0;
+		p = strchr(phase, ',');
+		if (p == NULL)
+			continue;
+		*p++ = 0;
+		if (sscanf(p, "%lld,%lld,%ld", &wall, &cpu, &rss) == 3)
+			add_timing(buf, phase, wall, cpu, rss);
+	}
+	fclose(f);
+	time_report(timings, 0);
+	exit(0);
+}
+
 void convert_s_to_o(char *path)
 {
 	build_arglist(CMD_AS);
@@ -355,6 +562,7 @@ void convert_s_to_o(char *path)
 void convert_c_to_s(char *path)
 {
 	char *tmp, *t;
+	char *times = NULL;
 
 	build_arglist(CMD_CC);
 	add_argument_list("-I", &inclist);
@@ -382,12 +590,20 @@ void convert_c_to_s(char *path)
 		break;
 	case OS_MC10:	/* MC-10 */
 		add_argument("-D__TANDY_MC10__");
+		add_argument("--lower-printf");
 		break;
 	case OS_FLEX: /* FLEX */
 		add_argument("-D__FLEX__");
+		add_argument("--lower-printf");
 		break;
 	}
 	add_argument_list(NULL, &ccargs);
+	if (timereport || timelog) {
+		times = pathmod(xstrdup(path, 0), ".c", ".T", 0);
+		unlink(times);
+		add_argument("--time-report");
+		add_argument(times);
+	}
 	add_argument(path);
 	t = xstrdup(path, 0);
 	tmp = pathmod(t, ".c", ".@", 0);
@@ -395,7 +611,13 @@ void convert_c_to_s(char *path)
 		memory();
 	redirect_out(tmp);
 	run_command();
+	if (times)
+		read_timings(times);
 	build_arglist(CMD_COPT);
+	if (coptstats) {
+		add_argument("-S");
+		add_argument(coptstats);
+	}
 	if (cpu == 6800)
 		add_argument(COPT00_FILE);
 	else
@@ -409,6 +631,7 @@ void convert_c_to_s(char *path)
 void convert_S_to_s(char *path)
 {
 	build_arglist(CMD_CC);
+	argphase = "cpp";
 	add_argument("-E");
 	redirect_in(path);
 	redirect_out(pathmod(path, ".S", ".s", 1));
@@ -418,6 +641,7 @@ void convert_S_to_s(char *path)
 void preprocess_c(char *path)
 {
 	build_arglist(CMD_CC);
+	argphase = "cpp";
 
 	add_argument("-E");
 	add_argument_list("-I", &inclist);
@@ -497,6 +721,10 @@ void link_phase(void)
 			add_argument(CRT0);
 		append_obj(&libpathlist, LIBPATH, 0);
 		append_obj(&liblist, LIBC, TYPE_A);
+		/* The printf emitters need the target __putc so go first */
+		if (targetos == OS_MC10 || targetos == OS_FLEX)
+			append_obj(&liblist, cpu == 6800 ? LIBFMT6800 : LIBFMT6803,
+				   TYPE_A);
 		if (targetos == OS_MC10) {
 			append_obj(&liblist, LIBIO6803, TYPE_A);
 			append_obj(&liblist, LIBMC10, TYPE_A);
@@ -543,6 +771,7 @@ void link_phase(void)
 
 void sequence(struct obj *i)
 {
+	curfile = xstrdup(i->name, 0);
 //	printf("Last Phase %d\n", last_phase);
 //	printf("1:Processing %s %d\n", i->name, i->type);
 	if (i->type == TYPE_S) {
@@ -581,6 +810,7 @@ void processing_loop(void)
 		remove_temporaries();
 		i = i->next;
 	}
+	curfile = NULL;
 	if (last_phase < 4)
 		return;
 	link_phase();
@@ -700,7 +930,12 @@ static char *passopts[] = {
 	"*code-name",
 	"*data-name",
 	" debug",
+	" inline-funcs",
+	"*inline-size",
 	" inline-stdfuncs",
+	" lower-printf",
+	" profile-generate",
+	"*profile-use",
 	"*register-space",
 	" register-vars",
 	"*rodata-name",
@@ -715,6 +950,27 @@ char **longopt(char **ap)
 {
 	char *p = *ap + 2;
 	char **x = passopts;
+	if (strcmp(p, "time-report") == 0) {
+		timereport = 1;
+		return ap;
+	}
+	if (strcmp(p, "time-log") == 0) {
+		timelog = *++ap;
+		if (timelog == NULL)
+			usage();
+		return ap;
+	}
+	if (strcmp(p, "time-summary") == 0) {
+		if (ap[1] == NULL)
+			usage();
+		time_summary(ap[1]);
+	}
+	if (strcmp(p, "copt-stats") == 0) {
+		coptstats = *++ap;
+		if (coptstats == NULL)
+			usage();
+		return ap;
+	}
 	while(*x) {
 		char *t = *x++;
 		if (strcmp(t + 1, p) == 0) {
@@ -810,6 +1066,10 @@ int main(int argc, char *argv[])
 		case 'M':
 			mapfile = 1;
 			break;
+			/* Optimize, cc68 checks the letters that follow */
+		case 'O':
+			append_obj(&ccargs, *p, 0);
+			break;
 		case 't':
 			if (strcmp(*p + 2, "fuzix") == 0) {
 				targetos = OS_FUZIX;
@@ -859,5 +1119,9 @@ int main(int argc, char *argv[])
 		one_input();
 	processing_loop();
 	unused_files();
+	if (timelog)
+		write_timelog();
+	if (timereport)
+		time_report(timings, 1);
 	return 0;
 }
@@ -0,0 +1,29 @@
+/* malloc.h	Pools and arenas
+ */
+#ifndef __MALLOC_H
+#define __MALLOC_H
+
+#include <stdlib.h>
+
+/* Fixed size objects with no per object overhead. Freed objects only go
+   back to their own pool */
+struct pool {
+    void *free;
+    size_t size;
+};
+
+extern void pool_init(struct pool *__pool, size_t __size);
+extern void *pool_alloc(struct pool *__pool);
+extern void pool_free(struct pool *__pool, void *__obj);
+
+/* Allocation from a block of memory, freed all at once back to a mark */
+struct arena {
+    char *next;
+    char *end;
+};
+
+extern void arena_init(struct arena *__arena, void *__base, size_t __size);
+extern void *arena_alloc(struct arena *__arena, size_t __size);
+extern void arena_release(struct arena *__arena, void *__mark);
+
+#endif /* __MALLOC_H */
@@ -0,0 +1,17 @@
+/* stdlib.h	General utilities
+ */
+#ifndef __STDLIB_H
+#define __STDLIB_H
+
+#include <stddef.h>
+
+extern int abs(int __i);
+extern long labs(long __l);
+extern int atoi(const char *__s);
+
+extern void *malloc(size_t __size);
+extern void free(void *__ptr);
+extern void *calloc(size_t __count, size_t __size);
+extern void *realloc(void *__ptr, size_t __size);
+
+#endif /* __STDLIB_H */
@@ -0,0 +1,13 @@
+/* unistd.h	Heap break
+ */
+#ifndef __UNISTD_H
+#define __UNISTD_H
+
+#include <stddef.h>
+
+/* The break starts at the end of the program. Moving it also moves the
+   limit --check-stack checks against */
+extern int brk(void *__addr);
+extern void *sbrk(int __increment);
+
+#endif /* __UNISTD_H */
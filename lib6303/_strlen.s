@@ -0,0 +1,53 @@
+;
+;	strlen(s)
+;
+;	As the 6803 version but xgdx turns the end pointer into a length
+;	without going through memory.
+;
+	.export _strlen
+
+	.setcpu 6303
+	.code
+
+_strlen:
+	tsx
+	ldx	2,x
+loop:
+	ldaa	,x
+	beq	end0
+	ldaa	1,x
+	beq	end1
+	ldaa	2,x
+	beq	end2
+	ldaa	3,x
+	beq	end3
+	ldaa	4,x
+	beq	end4
+	ldaa	5,x
+	beq	end5
+	ldaa	6,x
+	beq	end6
+	ldaa	7,x
+	beq	end7
+	ldab	#8
+	abx
+	bra	loop
+end7:
+	inx
+end6:
+	inx
+end5:
+	inx
+end4:
+	inx
+end3:
+	inx
+end2:
+	inx
+end1:
+	inx
+end0:
+	xgdx
+	tsx
+	subd	2,x
+	rts
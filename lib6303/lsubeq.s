@@ -1,32 +1,40 @@
 ;
-;	On entry X points to the object
+;	Subtract sreg:D from a 32bit object
+;
+;	lsubeq		X points to the object
+;	lsubeqysp	X is the offset of the object from the stack as the
+;			caller sees it with tsx
+;
+;	Both return the new value in sreg:D
 ;
 	.code
 	.export lsubeq
-	.export lsubeqa
 	.export lsubeqysp
 	.setcpu 6303
 
-; In this form X is the stack offset. Turn that into X is a pointer and
-; fall into the static form
+; Turn the offset into a pointer and fall into the static form. The return
+; address means the object is 2 further up than the caller would see it
 lsubeqysp:
+	std @tmp3
 	stx @tmp
 	tsx
 	xgdx
 	addd @tmp
+	addd #2
 	xgdx
+	ldd @tmp3
 lsubeq:
 	std @tmp
-	ldd 4,x		; do the low 16bits
+	ldd 2,x		; do the low 16bits
 	subd @tmp
-	std 4,x
-	ldd 2,x
+	std 2,x
+	pshb		; Keep it for the result
+	psha
+	ldd ,x
 	sbcb @sreg+1
 	sbca @sreg
-	std 2,x
-	ldd 4,x
+	std ,x
+	std @sreg
+	pula
+	pulb
 	rts
-lsubeqa:
-	clr @sreg
-	clr @sreg+1
-	bra lsubeq
@@ -0,0 +1,17 @@
+
+		.export _abs
+
+		.setcpu 6800
+		.code
+
+_abs:
+		tsx
+		ldab 3,x
+		ldaa 2,x
+		bpl absdone
+		coma
+		comb
+		addb #1
+		adca #0
+absdone:
+		jmp ret2
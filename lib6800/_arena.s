@@ -0,0 +1,74 @@
+;
+;	Arenas
+;
+;	arena_init(arena, base, size)	hand out the memory at base
+;	arena_alloc(arena, size)	the next size bytes, or 0
+;	arena_release(arena, mark)	free everything from mark on, where
+;					mark is a pointer arena_alloc returned
+;
+;	An arena is the next free byte and the end.
+;
+	.export _arena_init
+	.export _arena_alloc
+	.export _arena_release
+
+	.setcpu 6800
+	.code
+
+_arena_init:
+	tsx
+	ldaa	4,x
+	ldab	5,x
+	addb	3,x
+	adca	2,x
+	staa	@tmp
+	stab	@tmp+1
+	ldaa	4,x
+	ldab	5,x
+	ldx	6,x
+	staa	,x
+	stab	1,x
+	ldaa	@tmp
+	ldab	@tmp+1
+	staa	2,x
+	stab	3,x
+	jmp	ret6
+
+_arena_alloc:
+	tsx
+	ldaa	2,x
+	ldab	3,x
+	staa	@tmp
+	stab	@tmp+1
+	ldx	4,x
+	ldaa	2,x		; room left
+	ldab	3,x
+	subb	1,x
+	sbca	,x
+	subb	@tmp+1
+	sbca	@tmp
+	bcs	full
+	ldaa	,x
+	ldab	1,x
+	pshb
+	psha
+	addb	@tmp+1
+	adca	@tmp
+	staa	,x
+	stab	1,x
+	pula
+	pulb
+	jmp	ret4
+full:
+	clra
+	clrb
+	jmp	ret4
+
+_arena_release:
+	tsx
+	ldaa	2,x
+	ldab	3,x
+	ldx	4,x
+	staa	,x
+	stab	1,x
+	jmp	ret4
@@ -0,0 +1,54 @@
+;
+;	Skip white space, take an optional sign and then as many digits as
+;	there are. Overflow is undefined so we just wrap.
+;
+		.export _atoi
+
+		.setcpu 6800
+		.code
+
+_atoi:
+		tsx
+		ldx 2,x
+		clr @tmp4		; sign
+skip:		ldaa ,x
+		cmpa #' '
+		beq next
+		cmpa #9			; \t \n \v \f \r
+		blo sign
+		cmpa #13
+		bhi sign
+next:		inx
+		bra skip
+sign:		cmpa #'-'
+		bne plus
+		inc @tmp4
+		bra over
+plus:		cmpa #'+'
+		bne digits
+over:		inx
+digits:		clra
+		clrb
+_atoil:		staa @tmp3		; value so far
+		stab @tmp3+1
+		ldab ,x
+		subb #'0'		; make digit
+		cmpb #9			; in range ?
+		bhi done
+		stab @tmp2
+		ldaa @tmp3
+		ldab @tmp3+1
+		jsr mulax10		; x 10
+		addb @tmp2		; + new
+		adca #0
+		inx			; next char
+		bra _atoil
+done:		ldaa @tmp3
+		ldab @tmp3+1
+		tst @tmp4
+		beq pos
+		coma
+		comb
+		addb #1
+		adca #0
+pos:		jmp ret2
@@ -0,0 +1,14 @@
+;
+;	calloc(count, size)
+;
+	.export _calloc
+
+	.setcpu 6800
+	.code
+
+_calloc:
+	tsx
+	inx
+	inx
+	jsr	__calloc
+	jmp	ret4
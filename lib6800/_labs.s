@@ -0,0 +1,19 @@
+
+		.export _labs
+
+		.setcpu 6800
+		.code
+
+_labs:
+		tsx
+		ldaa 2,x
+		ldab 3,x
+		staa @sreg
+		stab @sreg+1
+		ldaa 4,x
+		ldab 5,x
+		tst 2,x
+		bpl labsdone
+		jsr negeax
+labsdone:
+		jmp ret4
@@ -0,0 +1,21 @@
+;
+;	malloc(size) and free(p). The allocator is in malloc.s
+;
+	.export _malloc
+	.export _free
+
+	.setcpu 6800
+	.code
+
+_malloc:
+	tsx
+	ldaa	2,x
+	ldab	3,x
+	jsr	__malloc
+	jmp	ret2
+
+_free:
+	tsx
+	ldx	2,x
+	jsr	__free
+	jmp	ret2
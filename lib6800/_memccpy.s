@@ -0,0 +1,45 @@
+;
+;	Copy until we have copied the byte c or run out of length. Returns
+;	the byte after c in the destination, or NULL
+;
+		.export _memccpy
+		.setcpu 6800
+		.code
+_memccpy:
+		tsx
+		ldaa 5,x
+		staa @tmp1	; match char
+		ldaa 2,x
+		ldab 3,x
+		tstb		; count as 256 * A + B as memcpy
+		beq even
+		inca
+even:
+		staa @tmp3
+		beq none
+		ldx 8,x
+		stx @tmp2	; destination
+		tsx
+		ldx 6,x		; source
+loop:		ldaa ,x		; get a source byte
+		inx
+		stx @tmp
+		ldx @tmp2
+		staa ,x		; save it
+		inx
+		stx @tmp2
+		cmpa @tmp1	; did we match
+		beq match
+		ldx @tmp
+		decb
+		bne loop
+		dec @tmp3
+		bne loop
+none:
+		clra
+		clrb
+		jmp ret8
+match:
+		ldaa @tmp2
+		ldab @tmp2+1
+		jmp ret8
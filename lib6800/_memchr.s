@@ -0,0 +1,32 @@
+		.export _memchr
+		.setcpu 6800
+		.code
+
+_memchr:
+		tsx
+		ldaa 6,x
+		ldab 7,x
+		addb 3,x
+		adca 2,x
+		staa @tmp		; stop point
+		stab @tmp+1
+		ldab 5,x
+		ldx 6,x
+		bra memchrn
+		; Must do the compare before the end check, see the C
+		; standard.
+memchrl:
+		cmpb ,x
+		beq strmatch
+		inx
+memchrn:
+		cpx @tmp
+		bne memchrl
+		clra
+		clrb
+		jmp ret6
+strmatch:
+		stx @tmp
+		ldaa @tmp
+		ldab @tmp+1
+		jmp ret6
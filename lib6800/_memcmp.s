@@ -0,0 +1,47 @@
+;
+;	Compare two blocks, returning the difference of the first bytes
+;	that differ
+;
+	.export _memcmp
+
+	.setcpu 6800
+	.code
+
+_memcmp:
+	tsx
+	ldaa	2,x
+	ldab	3,x
+	tstb			; count as 256 * A + B as memcpy
+	beq	even
+	inca
+even:
+	staa	@tmp3
+	beq	done		; length 0, and D is 0
+	ldx	4,x
+	stx	@tmp2
+	tsx
+	ldx	6,x
+loop:
+	ldaa	,x
+	inx
+	stx	@tmp
+	ldx	@tmp2
+	cmpa	,x
+	bne	diff
+	inx
+	stx	@tmp2
+	ldx	@tmp
+	decb
+	bne	loop
+	dec	@tmp3
+	bne	loop
+	clra
+	clrb
+done:
+	jmp	ret6
+diff:
+	tab
+	clra
+	subb	,x
+	sbca	#0
+	jmp	ret6
@@ -1,6 +1,11 @@
 ;
-;	There isn't a nice way to do this on 680x/630x.
+;	There isn't a nice way to do this on 680x/630x. The 6800 has only
+;	the one index register, so each byte means reloading X for the
+;	source and then for the destination. We copy blocks of 8 with
+;	offsets off X so that the pointers only have to be moved on once
+;	per block, and then do the odd bytes one at a time.
 ;
+;	Cycles per byte for a long copy are about 23, the byte loop was 43.
 ;
 	.export _memcpy
 
@@ -9,45 +14,94 @@
 
 _memcpy:
 	tsx
-	ldaa	6,x
-	ldab	7,x
-	staa	@tmp		; destination
-	stab	@tmp+1
-	ldaa	2,x		; length
-	oraa	3,x
-	beq	nocopy
-	ldaa	2,x
 	ldab	3,x
-	ldx	4,x		; src
-	bsr	nextblock
+	andb	#7
+	stab	@tmp1		; odd bytes
+	ldaa	2,x		; length / 8 is the block count
+	ldab	3,x
+	lsra
+	rorb
+	lsra
+	rorb
+	lsra
+	rorb
+	tstb			; count as 256 * A + B where B = 0 means
+	beq	even		; 256, so A is one more unless B is 0
+	inca
+even:
+	staa	@tmp3
+	ldx	6,x
+	stx	@tmp2		; destination
 	tsx
-nocopy:
+	ldx	4,x
+	stx	@tmp		; source
+	tst	@tmp3
+	beq	tail
+block:
+	ldx	@tmp
+	ldaa	,x
+	ldx	@tmp2
+	staa	,x
+	ldx	@tmp
+	ldaa	1,x
+	ldx	@tmp2
+	staa	1,x
+	ldx	@tmp
+	ldaa	2,x
+	ldx	@tmp2
+	staa	2,x
+	ldx	@tmp
+	ldaa	3,x
+	ldx	@tmp2
+	staa	3,x
+	ldx	@tmp
+	ldaa	4,x
+	ldx	@tmp2
+	staa	4,x
+	ldx	@tmp
+	ldaa	5,x
+	ldx	@tmp2
+	staa	5,x
+	ldx	@tmp
 	ldaa	6,x
-	ldab	7,x
-	jmp	ret6
-
-nextblock:
-	tsta
-	beq	tailcopy
-	; Copy 256 bytes repeatedly until we get to the leftovers
-	pshb
-	psha
-	clrb
-	bsr	tailcopy
-	pula
-	pulb
-	deca
-	bra	nextblock
-
+	ldx	@tmp2
+	staa	6,x
+	ldx	@tmp
+	ldaa	7,x
+	ldx	@tmp2
+	staa	7,x
+	ldaa	@tmp+1		; move both pointers on 8
+	adda	#8
+	staa	@tmp+1
+	bcc	srcok
+	inc	@tmp
+srcok:
+	ldaa	@tmp2+1
+	adda	#8
+	staa	@tmp2+1
+	bcc	dstok
+	inc	@tmp2
+dstok:
+	decb
+	bne	block
+	dec	@tmp3
+	bne	block
+tail:
+	ldab	@tmp1
+	beq	done
 tailcopy:
-	ldaa	,x
-	inx
-	stx	@tmp2
 	ldx	@tmp
-	staa	,x
+	ldaa	,x
 	inx
 	stx	@tmp
 	ldx	@tmp2
+	staa	,x
+	inx
+	stx	@tmp2
 	decb
 	bne	tailcopy
-	rts
+done:
+	tsx
+	ldaa	6,x
+	ldab	7,x
+	jmp	ret6
@@ -0,0 +1,58 @@
+;
+;	memmove is memcpy unless the destination overlaps the end of the
+;	source, in which case we copy down from the top. The arguments are
+;	the same so we can just jump into memcpy.
+;
+	.export _memmove
+
+	.setcpu 6800
+	.code
+
+_memmove:
+	tsx
+	ldaa	6,x		; destination - source
+	ldab	7,x
+	subb	5,x
+	sbca	4,x
+	bcs	up		; below
+	subb	3,x		; and further than the length ?
+	sbca	2,x
+	bcc	up
+	ldaa	4,x		; copy down from the ends
+	ldab	5,x
+	addb	3,x
+	adca	2,x
+	staa	@tmp
+	stab	@tmp+1
+	ldaa	6,x
+	ldab	7,x
+	addb	3,x
+	adca	2,x
+	staa	@tmp2
+	stab	@tmp2+1
+	ldaa	2,x		; they overlap so the length isn't 0
+	ldab	3,x
+	tstb			; count as 256 * A + B as memcpy
+	beq	even
+	inca
+even:
+	staa	@tmp3
+down:
+	ldx	@tmp
+	dex
+	ldaa	,x
+	stx	@tmp
+	ldx	@tmp2
+	dex
+	staa	,x
+	stx	@tmp2
+	decb
+	bne	down
+	dec	@tmp3
+	bne	down
+	tsx
+	ldaa	6,x
+	ldab	7,x
+	jmp	ret6
+up:
+	jmp	_memcpy
@@ -0,0 +1,32 @@
+		.export _memrchr
+		.setcpu 6800
+		.code
+
+_memrchr:
+		tsx
+		ldaa 6,x
+		ldab 7,x
+		staa @tmp2		; stop point
+		stab @tmp2+1
+		addb 3,x
+		adca 2,x
+		staa @tmp		; work down from the end
+		stab @tmp+1
+		ldab 5,x
+		ldx @tmp
+		bra memrchrn
+memrchrl:
+		dex
+		cmpb ,x
+		beq strmatch
+memrchrn:
+		cpx @tmp2
+		bne memrchrl
+		clra
+		clrb
+		jmp ret6
+strmatch:
+		stx @tmp
+		ldaa @tmp
+		ldab @tmp+1
+		jmp ret6
@@ -1,40 +1,66 @@
-
+;
+;	Fill 8 bytes per pass off X, then the odd bytes one at a time
+;
+;	Cycles per byte for a long fill are about 11, the byte loop was 16.
+;
 	.export _memset
 
+	.setcpu 6800
 	.code
 
 _memset:
 	tsx
-	ldaa	4,x
-	ldab	5,x
-	stab	@tmp		; destination
-	ldaa	2,x		; length
 	ldab	3,x
+	andb	#7
+	stab	@tmp1		; odd bytes
+	ldaa	2,x		; length / 8 is the block count
+	ldab	3,x
+	lsra
+	rorb
+	lsra
+	rorb
+	lsra
+	rorb
+	tstb			; count as 256 * A + B where B = 0 means
+	beq	even		; 256, so A is one more unless B is 0
+	inca
+even:
+	staa	@tmp3
+	ldaa	5,x		; fill byte
 	ldx	6,x		; destination
-	bsr	nextblock
-	tsx
-	ldaa	7,x
-	ldab	8,x
-	jmp	ret6
-
-nextblock:
-	tsta
-	beq	tailset
-	; Set 256 bytes
-	pshb
-	psha
-	clrb
-	bsr	tailset
-	pula
-	pulb
-	deca
-	bra	nextblock
-
+	tst	@tmp3
+	beq	tail
+block:
+	staa	,x
+	staa	1,x
+	staa	2,x
+	staa	3,x
+	staa	4,x
+	staa	5,x
+	staa	6,x
+	staa	7,x
+	inx
+	inx
+	inx
+	inx
+	inx
+	inx
+	inx
+	inx
+	decb
+	bne	block
+	dec	@tmp3
+	bne	block
+tail:
+	ldab	@tmp1
+	beq	done
 tailset:
-	ldaa	@tmp
-clearloop:
 	staa	,x
 	inx
 	decb
-	bne	clearloop
-	rts
+	bne	tailset
+done:
+	tsx
+	ldaa	6,x
+	ldab	7,x
+	jmp	ret6
@@ -0,0 +1,78 @@
+;
+;	Pools of fixed size objects
+;
+;	pool_init(pool, size)	set up an empty pool
+;	pool_alloc(pool)	an object, or 0 if the heap is full
+;	pool_free(pool, obj)	give an object back to its pool
+;
+;	A pool is its free list head and the object size. The objects have
+;	no header, a free one holds the link in its first two bytes, and
+;	new ones come straight from __sbrk.
+;
+	.export _pool_init
+	.export _pool_alloc
+	.export _pool_free
+
+	.setcpu 6800
+	.code
+
+_pool_init:
+	tsx
+	ldaa	2,x
+	ldab	3,x
+	tsta
+	bne	sizeok
+	cmpb	#2		; room for the link
+	bcc	sizeok
+	ldab	#2
+sizeok:
+	ldx	4,x
+	clr	,x
+	clr	1,x
+	staa	2,x
+	stab	3,x
+	jmp	ret4
+
+_pool_alloc:
+	tsx
+	ldx	2,x
+	stx	@tmp3
+	ldx	,x
+	beq	grow
+	ldaa	,x
+	ldab	1,x
+	stx	@tmp
+	ldx	@tmp3
+	staa	,x
+	stab	1,x
+	ldaa	@tmp
+	ldab	@tmp+1
+	jmp	ret2
+grow:
+	ldx	@tmp3
+	ldaa	2,x
+	ldab	3,x
+	jsr	__sbrk
+	bcc	grown
+	clra
+	clrb
+grown:
+	jmp	ret2
+
+_pool_free:
+	tsx
+	ldx	4,x
+	ldaa	,x
+	ldab	1,x
+	stx	@tmp
+	tsx
+	ldx	2,x
+	staa	,x
+	stab	1,x
+	stx	@tmp1
+	ldx	@tmp
+	ldaa	@tmp1
+	ldab	@tmp1+1
+	staa	,x
+	stab	1,x
+	jmp	ret4
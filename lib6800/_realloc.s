@@ -0,0 +1,15 @@
+;
+;	realloc(p, size)
+;
+	.export _realloc
+
+	.setcpu 6800
+	.code
+
+_realloc:
+	tsx
+	ldaa	2,x
+	ldab	3,x
+	ldx	4,x
+	jsr	__realloc
+	jmp	ret4
@@ -0,0 +1,22 @@
+;
+;	sbrk(increment) and brk(addr). See brk.s
+;
+	.export _sbrk
+	.export _brk
+
+	.setcpu 6800
+	.code
+
+_sbrk:
+	tsx
+	ldaa	2,x
+	ldab	3,x
+	jsr	__sbrk
+	jmp	ret2
+
+_brk:
+	tsx
+	ldaa	2,x
+	ldab	3,x
+	jsr	__brk
+	jmp	ret2
@@ -0,0 +1,26 @@
+		.export _strchr
+		.setcpu 6800
+		.code
+
+_strchr:
+		tsx
+		ldab 3,x
+		ldx 4,x
+		; Must do the compare before the end check, see the C
+		; standard.
+_strchrl:
+		ldaa ,x
+		cba
+		beq strmatch
+		tsta
+		beq retnull
+		inx
+		bra _strchrl
+strmatch:
+		stx @tmp
+		ldaa @tmp
+		ldab @tmp+1
+		jmp ret4
+retnull:
+		clrb
+		jmp ret4
@@ -0,0 +1,67 @@
+;
+;	strcmp and strncmp share the compare loop. strcmp just has a limit
+;	too big to reach.
+;
+	.export _strcmp
+	.export _strncmp
+
+	.setcpu 6800
+	.code
+
+_strncmp:
+	tsx
+	ldaa	2,x
+	ldab	3,x
+	tstb			; count as 256 * A + B as memcpy
+	beq	even
+	inca
+even:
+	staa	@tmp3
+	beq	nret		; length 0, and D is 0
+	ldx	4,x
+	stx	@tmp2
+	tsx
+	ldx	6,x
+	stx	@tmp
+	bsr	compare
+nret:
+	jmp	ret6
+
+_strcmp:
+	tsx
+	ldx	2,x
+	stx	@tmp2
+	tsx
+	ldx	4,x
+	stx	@tmp
+	clrb
+	stab	@tmp3
+	bsr	compare
+	jmp	ret4
+
+compare:
+	ldx	@tmp
+	ldaa	,x
+	inx
+	stx	@tmp
+	ldx	@tmp2
+	cmpa	,x
+	bne	diff
+	inx
+	stx	@tmp2
+	tsta
+	beq	same
+	decb
+	bne	compare
+	dec	@tmp3
+	bne	compare
+same:
+	clra
+	clrb
+	rts
+diff:
+	tab
+	clra
+	subb	,x
+	sbca	#0
+	rts
@@ -1,32 +1,42 @@
 ;
-;	Another one that's really hard to do nicely
+;	Another one that's really hard to do nicely. strcat is the same
+;	copy once we have found the end of the destination.
 ;
-
 	.export _strcpy
+	.export _strcat
 
+	.setcpu 6800
 	.code
 
+_strcat:
+	tsx
+	ldx	4,x
+	bra	endtest
+endhunt:
+	inx
+endtest:
+	ldaa	,x
+	bne	endhunt
+	bra	copy
 _strcpy:
 	tsx
-	ldaa	7,x
-	ldab	8,x
-	staa	@tmp
-	stab	@tmp+1		; destination
-	ldaa	3,x		; length
-	ldab	4,x
-	ldx	5,x		; src
+	ldx	4,x
+copy:
+	stx	@tmp2		; destination
+	tsx
+	ldx	2,x		; source
 copyloop:
 	ldaa	,x
 	inx
-	stx	@tmp2
-	ldx	@tmp
-	staa	,x
-	inx
 	stx	@tmp
 	ldx	@tmp2
+	staa	,x
+	inx
+	stx	@tmp2
+	ldx	@tmp
 	tsta
-	bne copyloop
+	bne	copyloop
 	tsx
-	ldaa	7,x
-	ldab	8,x
+	ldaa	4,x
+	ldab	5,x
 	jmp	ret4
@@ -0,0 +1,111 @@
+;
+;	strlcpy and strlcat. strlcat finds the end of the destination within
+;	the size and then does a strlcpy of what room is left. Both return
+;	the length of the string they tried to make.
+;
+		.export _strlcpy
+		.export _strlcat
+
+		.setcpu 6800
+		.code
+
+_strlcpy:
+		tsx
+		ldx 4,x
+		stx @tmp	; source
+		stx @tmp1
+		tsx
+		ldx 6,x
+		stx @tmp2	; destination
+		tsx
+		ldaa 2,x	; room
+		ldab 3,x
+		bsr lcpy
+		jmp ret6
+
+_strlcat:
+		tsx
+		ldaa 6,x	; the end of the room
+		ldab 7,x
+		addb 3,x
+		adca 2,x
+		staa @tmp3
+		stab @tmp3+1
+		ldx 6,x
+		bra endtest
+endhunt:
+		tst ,x
+		beq end
+		inx
+endtest:
+		cpx @tmp3
+		bne endhunt
+end:
+		stx @tmp2	; where we copy to
+		tsx
+		ldab @tmp2+1	; length of the destination
+		subb 7,x
+		ldaa @tmp2
+		sbca 6,x
+		pshb
+		psha
+		ldx 4,x
+		stx @tmp	; source
+		stx @tmp1
+		ldab @tmp3+1	; room left
+		subb @tmp2+1
+		ldaa @tmp3
+		sbca @tmp2
+		bsr lcpy
+		tsx
+		addb 1,x
+		adca ,x
+		ins
+		ins
+		jmp ret6
+
+;
+;	Copy from @tmp to @tmp2 with room for D bytes including the
+;	terminator, and return the length of the string at @tmp1
+;
+lcpy:
+		subb #1		; leave room for the terminator
+		sbca #0
+		bcs scan	; no room at all
+		tstb		; count as 256 * A + B as memcpy
+		beq even
+		inca
+even:
+		staa @tmp3
+		beq term
+copy:
+		ldx @tmp
+		ldaa ,x
+		beq term
+		inx
+		stx @tmp
+		ldx @tmp2
+		staa ,x
+		inx
+		stx @tmp2
+		decb
+		bne copy
+		dec @tmp3
+		bne copy
+term:
+		ldx @tmp2
+		clr ,x
+scan:
+		ldx @tmp	; the length is to the end of the source
+		bra scantest
+scanloop:
+		inx
+scantest:
+		ldaa ,x
+		bne scanloop
+		stx @tmp
+		ldab @tmp+1
+		subb @tmp1+1
+		ldaa @tmp
+		sbca @tmp1
+		rts
@@ -1,5 +1,6 @@
-
-
+;
+;	Walk to the end and work the length out from the pointer
+;
 	.code
 	.export _strlen
 
@@ -7,14 +8,17 @@
 
 _strlen:
 	tsx
-	ldx 2,x
-	clra
-	clrb
-cl:	tst ,x
-	beq to_rts
+	ldx	2,x
+	bra	test
+loop:
 	inx
-	addb #1
-	adca #0
-	bra cl
-to_rts:
-	jmp ret2
+test:
+	ldaa	,x
+	bne	loop
+	stx	@tmp
+	tsx
+	ldab	@tmp+1
+	subb	3,x
+	ldaa	@tmp
+	sbca	2,x
+	jmp	ret2
@@ -0,0 +1,52 @@
+;
+;	Copy up to n bytes and pad the rest of the n with zero bytes
+;
+	.export _strncpy
+
+	.setcpu 6800
+	.code
+
+_strncpy:
+	tsx
+	ldaa	2,x
+	ldab	3,x
+	tstb			; count as 256 * A + B as memcpy
+	beq	even
+	inca
+even:
+	staa	@tmp3
+	beq	done
+	ldx	6,x
+	stx	@tmp2
+	tsx
+	ldx	4,x
+copy:
+	ldaa	,x
+	inx
+	stx	@tmp
+	ldx	@tmp2
+	staa	,x
+	inx
+	stx	@tmp2
+	decb
+	bne	next
+	dec	@tmp3
+	beq	done
+next:
+	tsta
+	beq	pad
+	ldx	@tmp
+	bra	copy
+	; Zero the rest, X is where we are in the destination
+pad:
+	clr	,x
+	inx
+	decb
+	bne	pad
+	dec	@tmp3
+	bne	pad
+done:
+	tsx
+	ldaa	6,x
+	ldab	7,x
+	jmp	ret6
@@ -0,0 +1,33 @@
+;
+;	As strlen but stop at the limit
+;
+	.code
+	.export _strnlen
+
+	.setcpu 6800
+
+_strnlen:
+	tsx
+	ldaa	4,x		; work out the stop mark
+	ldab	5,x
+	addb	3,x
+	adca	2,x
+	staa	@tmp
+	stab	@tmp+1
+	ldx	4,x
+	bra	test
+loop:
+	ldaa	,x
+	beq	end
+	inx
+test:
+	cpx	@tmp
+	bne	loop
+end:
+	stx	@tmp
+	tsx
+	ldab	@tmp+1
+	subb	5,x
+	ldaa	@tmp
+	sbca	4,x
+	jmp	ret4
@@ -0,0 +1,28 @@
+		.export _strrchr
+		.setcpu 6800
+		.code
+
+_strrchr:
+		tsx
+		clra
+		staa @tmp
+		staa @tmp+1
+		ldab 3,x
+		ldx 4,x
+		; Must do the compare before the end check, see the C
+		; standard.
+_strrchrl:
+		ldaa ,x
+		cba
+		bne nomatch
+		stx @tmp
+nomatch:
+		tsta
+		beq done
+		inx
+		bra _strrchrl
+done:
+		; tmp holds last match or NULL
+		ldaa @tmp
+		ldab @tmp+1
+		jmp ret4
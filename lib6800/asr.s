@@ -1,14 +1,29 @@
 ;
 ;	top of stack arithmetic shift right by D
+;
+;	Only the low 4bits of the count matter, anything bigger is undefined
+;	in C. A shift of 8 or more moves the high byte down first.
 ;
 	.export tosasrax
 	.code
 tosasrax:
 	tsx
+	andb #15
+	beq done
+	cmpb #8
+	blo asraxsh
+	ldaa 2,x		; move the high byte down
+	staa 3,x
+	asla			; and fill with the sign
+	ldaa #0
+	sbca #0
+	staa 2,x
+	subb #8
+	beq done
 asraxsh:
 	asr 2,x
 	ror 3,x
 	decb
 	bne asraxsh
+done:
 	jmp pop2get
-
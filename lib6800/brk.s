@@ -0,0 +1,97 @@
+;
+;	The heap grows up from the end of the program (__end) towards the
+;	stack. Every move of the break also moves _stklimit to it, so code
+;	built with --check-stack stops when the stack runs down into the
+;	heap instead of scribbling on it, and the break is never moved to
+;	within BRKGAP bytes of the stack pointer.
+;
+;	__sbrk	D = increment, returns the old break in D or -1
+;	__brk	D = new break, returns 0 or -1
+;
+;	Carry is set as well on failure. Uses @tmp to @tmp2, X is lost.
+;
+	.export __sbrk
+	.export __brk
+
+	.setcpu 6800
+	.code
+
+BRKGAP	.equ	256
+
+__sbrk:
+	staa	@tmp1
+	stab	@tmp1+1
+	bsr	curbrk
+	addb	@tmp1+1
+	adca	@tmp1
+	bcs	carry
+	tst	@tmp1		; no carry is only right going up
+	bmi	fail
+	bra	setbrk
+carry:
+	tst	@tmp1
+	bpl	fail
+	bra	setbrk
+
+__brk:
+	psha
+	pshb
+	bsr	curbrk
+	pulb
+	pula
+	bsr	setbrk
+	bcs	done
+	clra
+	clrb
+done:
+	rts
+;
+;	X = the break, set up the first time round. D is left alone
+;
+curbrk:
+	ldx	brkptr
+	bne	gotbrk
+	ldx	#__end
+	stx	brkptr
+gotbrk:
+	stx	@tmp
+	ldaa	@tmp
+	ldab	@tmp+1
+	rts
+;
+;	Move the break to D if that is allowed, X = the old break which is
+;	returned
+;
+setbrk:
+	staa	@tmp1
+	stab	@tmp1+1
+	subb	#<__end
+	sbca	#>__end
+	bcs	fail		; below the program
+	ldaa	@tmp1
+	ldab	@tmp1+1
+	addb	#<BRKGAP
+	adca	#>BRKGAP
+	bcs	fail
+	stx	@tmp
+	sts	@tmp2
+	subb	@tmp2+1
+	sbca	@tmp2
+	bcc	fail		; into the stack
+	ldx	@tmp1
+	stx	brkptr
+	stx	_stklimit
+	ldaa	@tmp
+	ldab	@tmp+1
+	clc
+	rts
+fail:
+	ldaa	#$FF
+	tab
+	sec
+	rts
+
+	.data
+
+brkptr:
+	.word	0
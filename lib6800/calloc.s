@@ -0,0 +1,74 @@
+;
+;	__calloc	X = the size and then the count as pushed, returns the
+;			cleared space in D or 0
+;
+	.export __calloc
+
+	.setcpu 6800
+	.code
+
+__calloc:
+	ldaa	,x
+	ldab	1,x
+	staa	@tmp
+	stab	@tmp+1
+	ldaa	2,x
+	ldab	3,x
+	staa	@tmp1
+	stab	@tmp1+1
+	clra
+	clrb
+mul:
+	lsr	@tmp1
+	ror	@tmp1+1
+	bcc	mul1
+	addb	@tmp+1
+	adca	@tmp
+	bcs	fail
+mul1:
+	tst	@tmp1
+	bne	mul2
+	tst	@tmp1+1
+	beq	mul3
+mul2:
+	asl	@tmp+1		; more to add so it must not overflow
+	rol	@tmp
+	bcs	fail
+	bra	mul
+mul3:
+	staa	ctot
+	stab	ctot+1
+	jsr	__malloc
+	staa	cptr
+	stab	cptr+1
+	ldx	cptr
+	beq	done
+	ldaa	ctot
+	ldab	ctot+1
+clr1:
+	tsta
+	bne	clr2
+	tstb
+	beq	clr3
+clr2:
+	clr	,x
+	inx
+	subb	#1
+	sbca	#0
+	bra	clr1
+clr3:
+	ldaa	cptr
+	ldab	cptr+1
+done:
+	rts
+fail:
+	clra
+	clrb
+	rts
+
+	.data
+
+cptr:
+	.word	0
+ctot:
+	.word	0
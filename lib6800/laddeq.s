@@ -1,59 +1,51 @@
 ;
-;	On entry X points to the object
+;	Add sreg:D to a 32bit object
 ;
-;	FIXME: need a review and rewrite as we sort out the 680x calling
-;	conventions for this versus 6502
+;	laddeq		X points to the object
+;	laddeqysp	X is the offset of the object from the stack as the
+;			caller sees it with tsx
+;
+;	Both return the new value in sreg:D
 ;
 	.code
-	.export laddeqa
 	.export laddeqysp
 	.export laddeq
 
-; In this form X is the stack offset. Turn that into X is a pointer and
-; fall into the static form
+; Turn the offset into a pointer and fall into the static form. We are
+; called and have pushed D so the object is 4 further up than the caller
+; would see it
 laddeqysp:
+	pshb
+	psha
 	stx @tmp
-	sts @tmp2
+	tsx
+	stx @tmp2
 	ldaa @tmp2
 	ldab @tmp2+1
-	addb @tmp2+1
+	addb @tmp+1
 	adca @tmp
+	addb #4
+	adca #0
 	staa @tmp
 	stab @tmp+1
 	ldx @tmp
-	inx
-laddeqa:
-	staa @tmp
-	stab @tmp+1
-	ldaa 2,x	; do the low 16bits
-	ldab 3,x
-	addb @tmp+1
-	adca @tmp
-	bcc l1
-	inc sreg	; carry - we don't have abcd
-l1:
-	staa 2,x
-	stab 3,x
-	ldaa ,x
-	ldab 1,x
-	addb @sreg+1
-	adca @sreg
-	staa ,x
-	stab 1,x
-	rts
-
-;
-;	Add the 32bit sreg/d to the variable at X
-;
+	pula
+	pulb
 laddeq:
 	addb 3,x		; Add the low word
 	stab 3,x
 	adca 2,x
 	staa 2,x
+	pshb			; Keep it for the result
+	psha
 	ldaa ,x			; High word
 	ldab 1,x
-	adcb @sreg+1		; 1,x + sreg+1 (byte 3)
-	adca @sreg		; ,x + sreg (byte 4)
+	adcb @sreg+1
+	adca @sreg
 	staa ,x
 	stab 1,x
+	staa @sreg
+	stab @sreg+1
+	pula
+	pulb
 	rts
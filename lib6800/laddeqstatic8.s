@@ -1,15 +1,22 @@
 		.export laddeqstatic8
 		.code
 
-		; Add B to 32bit int pointed to by X
+		; Add B to 32bit int pointed to by X and return the new
+		; value in sreg:D
 laddeqstatic8:
 		addb 3,x
 		stab 3,x
 		bcc done
-		inc 2,x
-		bcc done
+		inc 2,x		; inc doesn't set the carry
+		bne done
 		inc 1,x
-		bcc done
+		bne done
 		inc ,x
 done:
+		ldaa ,x
+		ldab 1,x
+		staa @sreg
+		stab @sreg+1
+		ldaa 2,x
+		ldab 3,x
 		rts
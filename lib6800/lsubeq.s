@@ -1,42 +1,55 @@
 ;
-;	On entry X points to the object
+;	Subtract sreg:D from a 32bit object
+;
+;	lsubeq		X points to the object
+;	lsubeqysp	X is the offset of the object from the stack as the
+;			caller sees it with tsx
+;
+;	Both return the new value in sreg:D
 ;
 	.code
 	.export lsubeq
-	.export lsubeqa
 	.export lsubeqysp
 
-; In this form X is the stack offset. Turn that into X is a pointer and
-; fall into the static form
+; Turn the offset into a pointer and fall into the static form. We are
+; called and have pushed D so the object is 4 further up than the caller
+; would see it
 lsubeqysp:
+	pshb
+	psha
 	stx @tmp
-	sts @tmp2
+	tsx
+	stx @tmp2
 	ldaa @tmp2
 	ldab @tmp2+1
 	addb @tmp+1
 	adca @tmp
+	addb #4
+	adca #0
 	staa @tmp
 	stab @tmp+1
 	ldx @tmp
+	pula
+	pulb
 lsubeq:
 	staa @tmp
 	stab @tmp+1
-	ldaa 5,x	; do the low 16bits
-	ldab 6,x
+	ldab 3,x		; do the low 16bits
 	subb @tmp+1
+	stab 3,x
+	ldaa 2,x
 	sbca @tmp
-	staa 5,x
-	stab 6,x
-	ldaa 3,x
-	ldab 4,x
+	staa 2,x
+	pshb			; Keep it for the result
+	psha
+	ldaa ,x			; High word
+	ldab 1,x
 	sbcb @sreg+1
 	sbca @sreg
-	staa 3,x
-	stab 4,x
-	ldaa 5,x
-	ldab 6,x
+	staa ,x
+	stab 1,x
+	staa @sreg
+	stab @sreg+1
+	pula
+	pulb
 	rts
-lsubeqa:
-	clr @tmp
-	clr @tmp+1
-	bra lsubeq
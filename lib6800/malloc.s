@@ -0,0 +1,190 @@
+;
+;	Memory allocator
+;
+;	Blocks come in power of two sizes from 4 bytes to 32K, with a one
+;	byte header in front of the space handed out that holds the class
+;	(the power of two). Each class has its own free list linked through
+;	the two bytes after the header so malloc and free are a pop or a
+;	push. New blocks come from __sbrk. Blocks are never merged, and only
+;	when the heap cannot grow any further is a larger free block split
+;	in halves to satisfy a smaller request.
+;
+;	__malloc	D = size, returns the space in D or 0
+;	__free		X = space or 0
+;	mclass		D = size, returns the class in B, carry set if too big
+;	msize		B = class, returns the block size in D
+;
+;	Uses @tmp to @tmp3, X is lost.
+;
+	.export __malloc
+	.export __free
+	.export mclass
+	.export msize
+
+	.setcpu 6800
+	.code
+
+__malloc:
+	jsr	mclass
+	bcs	none
+	stab	mk
+	jsr	mhead
+	ldx	,x
+	beq	carve
+	jsr	mpop
+	bra	give
+carve:
+	ldab	mk
+	jsr	msize
+	jsr	__sbrk
+	bcs	split
+	staa	@tmp1
+	stab	@tmp1+1
+	ldx	@tmp1
+	ldab	mk
+	stab	,x
+give:
+	ldaa	@tmp1		; the space is after the header
+	ldab	@tmp1+1
+	addb	#1
+	adca	#0
+	rts
+;
+;	Out of heap, take the smallest larger free block and halve it until
+;	it is the right size, putting the top halves on their free lists
+;
+split:
+	ldab	mk
+splitup:
+	incb
+	cmpb	#16
+	beq	none
+	stab	mj
+	bsr	mhead
+	ldx	,x
+	bne	halve0
+	ldab	mj
+	bra	splitup
+halve0:
+	bsr	mpop
+halve:
+	dec	mj
+	ldab	mj
+	bsr	msize
+	addb	@tmp1+1
+	adca	@tmp1
+	staa	@tmp3
+	stab	@tmp3+1
+	ldx	@tmp3
+	ldab	mj
+	stab	,x
+	bsr	mpush
+	ldab	mj
+	cmpb	mk
+	bne	halve
+	ldx	@tmp1
+	stab	,x
+	bra	give
+none:
+	clra
+	clrb
+	rts
+
+__free:
+	stx	@tmp2
+	ldaa	@tmp2
+	oraa	@tmp2+1
+	beq	nofree
+	dex
+	ldab	,x
+	bra	mpush
+nofree:
+	rts
+
+;
+;	The class for a size is the number of bits in it, as the header
+;	takes one byte
+;
+mclass:
+	tsta
+	beq	mbits
+	tab
+	ldaa	#8
+mbits:
+	tstb
+	beq	mgot
+	inca
+	lsrb
+	bra	mbits
+mgot:
+	tab
+	cmpb	#2
+	bcc	mbig
+	ldab	#2
+mbig:
+	ldaa	#15
+	cba			; carry if B > 15
+	rts
+;
+;	D = 1 << B (B >= 1). Uses @tmp2
+;
+msize:
+	stab	@tmp2
+	clra
+	ldab	#1
+msize1:
+	aslb
+	rola
+	dec	@tmp2
+	bne	msize1
+	rts
+;
+;	X = the free list head for class B, also left in @tmp
+;
+mhead:
+	clra
+	aslb
+	addb	#<mheads
+	adca	#>mheads
+	staa	@tmp
+	stab	@tmp+1
+	ldx	@tmp
+	rts
+;
+;	Take the first block X off the list headed at @tmp, left in @tmp1
+;
+mpop:
+	stx	@tmp1
+	ldaa	1,x
+	ldab	2,x
+	ldx	@tmp
+	staa	,x
+	stab	1,x
+	rts
+;
+;	Put block X on the free list for class B. Uses @tmp and @tmp2
+;
+mpush:
+	stx	@tmp2
+	bsr	mhead
+	ldaa	,x
+	ldab	1,x
+	ldx	@tmp2
+	staa	1,x
+	stab	2,x
+	ldx	@tmp
+	ldaa	@tmp2
+	ldab	@tmp2+1
+	staa	,x
+	stab	1,x
+	rts
+
+	.data
+
+mk:
+	.byte	0
+mj:
+	.byte	0
+mheads:
+	.word	0,0,0,0,0,0,0,0
+	.word	0,0,0,0,0,0,0,0
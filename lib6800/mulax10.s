@@ -1,20 +1,23 @@
 ;
 ;	Multiply D by 10
+;
+;	Written by mulgen. Uses @tmp1, X is left alone
 ;
 
 	.export mulax10
 
+	.setcpu 6800
 	.code
 
 mulax10:
-	lslb
-	rola			; x 2
-	staa @tmp
-	stab @tmp+1		; save
-	lslb
-	rola			; x 4
-	lslb
-	rola			; x 8
-	addb @tmp+1
-	adca @tmp		; x 10
+	staa @tmp1
+	stab @tmp1+1
+	aslb
+	rola
+	aslb
+	rola
+	addb @tmp1+1
+	adca @tmp1
+	aslb
+	rola
 	rts
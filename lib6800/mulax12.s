@@ -1,20 +1,23 @@
 ;
 ;	Multiply D by 12
+;
+;	Written by mulgen. Uses @tmp1, X is left alone
 ;
 
 	.export mulax12
 
+	.setcpu 6800
 	.code
 
 mulax12:
-	lslb
-	rola			; x 2
-	lslb
-	rola			; x 4
-	staa @tmp
-	stab @tmp+1		; save
-	lslb
-	rola			; x 8
-	addb @tmp+1
-	adca @tmp		; x 12
+	staa @tmp1
+	stab @tmp1+1
+	aslb
+	rola
+	addb @tmp1+1
+	adca @tmp1
+	aslb
+	rola
+	aslb
+	rola
 	rts
@@ -0,0 +1,25 @@
+;
+;	Multiply D by 14
+;
+;	Written by mulgen. Uses @tmp1, X is left alone
+;
+
+	.export mulax14
+
+	.setcpu 6800
+	.code
+
+mulax14:
+	staa @tmp1
+	stab @tmp1+1
+	aslb
+	rola
+	aslb
+	rola
+	aslb
+	rola
+	subb @tmp1+1
+	sbca @tmp1
+	aslb
+	rola
+	rts
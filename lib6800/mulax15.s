@@ -0,0 +1,25 @@
+;
+;	Multiply D by 15
+;
+;	Written by mulgen. Uses @tmp1, X is left alone
+;
+
+	.export mulax15
+
+	.setcpu 6800
+	.code
+
+mulax15:
+	staa @tmp1
+	stab @tmp1+1
+	aslb
+	rola
+	aslb
+	rola
+	aslb
+	rola
+	aslb
+	rola
+	subb @tmp1+1
+	sbca @tmp1
+	rts
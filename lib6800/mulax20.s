@@ -0,0 +1,25 @@
+;
+;	Multiply D by 20
+;
+;	Written by mulgen. Uses @tmp1, X is left alone
+;
+
+	.export mulax20
+
+	.setcpu 6800
+	.code
+
+mulax20:
+	staa @tmp1
+	stab @tmp1+1
+	aslb
+	rola
+	aslb
+	rola
+	addb @tmp1+1
+	adca @tmp1
+	aslb
+	rola
+	aslb
+	rola
+	rts
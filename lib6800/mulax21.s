@@ -0,0 +1,27 @@
+;
+;	Multiply D by 21
+;
+;	Written by mulgen. Uses @tmp1, X is left alone
+;
+
+	.export mulax21
+
+	.setcpu 6800
+	.code
+
+mulax21:
+	staa @tmp1
+	stab @tmp1+1
+	aslb
+	rola
+	aslb
+	rola
+	addb @tmp1+1
+	adca @tmp1
+	aslb
+	rola
+	aslb
+	rola
+	addb @tmp1+1
+	adca @tmp1
+	rts
@@ -0,0 +1,27 @@
+;
+;	Multiply D by 22
+;
+;	Written by mulgen. Uses @tmp1, X is left alone
+;
+
+	.export mulax22
+
+	.setcpu 6800
+	.code
+
+mulax22:
+	staa @tmp1
+	stab @tmp1+1
+	aslb
+	rola
+	aslb
+	rola
+	addb @tmp1+1
+	adca @tmp1
+	aslb
+	rola
+	addb @tmp1+1
+	adca @tmp1
+	aslb
+	rola
+	rts
@@ -0,0 +1,29 @@
+;
+;	Multiply D by 27
+;
+;	Written by mulgen. Uses @tmp1, X is left alone
+;
+
+	.export mulax27
+
+	.setcpu 6800
+	.code
+
+mulax27:
+	staa @tmp1
+	stab @tmp1+1
+	aslb
+	rola
+	aslb
+	rola
+	aslb
+	rola
+	subb @tmp1+1
+	sbca @tmp1
+	aslb
+	rola
+	aslb
+	rola
+	subb @tmp1+1
+	sbca @tmp1
+	rts
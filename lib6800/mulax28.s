@@ -0,0 +1,27 @@
+;
+;	Multiply D by 28
+;
+;	Written by mulgen. Uses @tmp1, X is left alone
+;
+
+	.export mulax28
+
+	.setcpu 6800
+	.code
+
+mulax28:
+	staa @tmp1
+	stab @tmp1+1
+	aslb
+	rola
+	aslb
+	rola
+	aslb
+	rola
+	subb @tmp1+1
+	sbca @tmp1
+	aslb
+	rola
+	aslb
+	rola
+	rts
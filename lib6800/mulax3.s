@@ -1,14 +1,18 @@
 ;
 ;	Multiply D by 3
 ;
+;	Written by mulgen. Uses @tmp1, X is left alone
+;
+
 	.export mulax3
 
+	.setcpu 6800
 	.code
 
 mulax3:
 	staa @tmp1
 	stab @tmp1+1
-	lslb
+	aslb
 	rola
 	addb @tmp1+1
 	adca @tmp1
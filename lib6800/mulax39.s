@@ -0,0 +1,29 @@
+;
+;	Multiply D by 39
+;
+;	Written by mulgen. Uses @tmp1, X is left alone
+;
+
+	.export mulax39
+
+	.setcpu 6800
+	.code
+
+mulax39:
+	staa @tmp1
+	stab @tmp1+1
+	aslb
+	rola
+	aslb
+	rola
+	addb @tmp1+1
+	adca @tmp1
+	aslb
+	rola
+	aslb
+	rola
+	aslb
+	rola
+	subb @tmp1+1
+	sbca @tmp1
+	rts
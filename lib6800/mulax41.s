@@ -0,0 +1,29 @@
+;
+;	Multiply D by 41
+;
+;	Written by mulgen. Uses @tmp1, X is left alone
+;
+
+	.export mulax41
+
+	.setcpu 6800
+	.code
+
+mulax41:
+	staa @tmp1
+	stab @tmp1+1
+	aslb
+	rola
+	aslb
+	rola
+	addb @tmp1+1
+	adca @tmp1
+	aslb
+	rola
+	aslb
+	rola
+	aslb
+	rola
+	addb @tmp1+1
+	adca @tmp1
+	rts
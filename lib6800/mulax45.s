@@ -0,0 +1,31 @@
+;
+;	Multiply D by 45
+;
+;	Written by mulgen. Uses @tmp1, X is left alone
+;
+
+	.export mulax45
+
+	.setcpu 6800
+	.code
+
+mulax45:
+	staa @tmp1
+	stab @tmp1+1
+	aslb
+	rola
+	aslb
+	rola
+	addb @tmp1+1
+	adca @tmp1
+	aslb
+	rola
+	addb @tmp1+1
+	adca @tmp1
+	aslb
+	rola
+	aslb
+	rola
+	addb @tmp1+1
+	adca @tmp1
+	rts
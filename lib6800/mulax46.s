@@ -0,0 +1,31 @@
+;
+;	Multiply D by 46
+;
+;	Written by mulgen. Uses @tmp1, X is left alone
+;
+
+	.export mulax46
+
+	.setcpu 6800
+	.code
+
+mulax46:
+	staa @tmp1
+	stab @tmp1+1
+	aslb
+	rola
+	aslb
+	rola
+	subb @tmp1+1
+	sbca @tmp1
+	aslb
+	rola
+	aslb
+	rola
+	aslb
+	rola
+	subb @tmp1+1
+	sbca @tmp1
+	aslb
+	rola
+	rts
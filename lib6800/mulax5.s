@@ -1,16 +1,20 @@
 ;
 ;	Multiply D by 5
 ;
+;	Written by mulgen. Uses @tmp1, X is left alone
+;
+
 	.export mulax5
 
+	.setcpu 6800
 	.code
 
 mulax5:
 	staa @tmp1
 	stab @tmp1+1
-	lslb
+	aslb
 	rola
-	lslb
+	aslb
 	rola
 	addb @tmp1+1
 	adca @tmp1
@@ -0,0 +1,31 @@
+;
+;	Multiply D by 51
+;
+;	Written by mulgen. Uses @tmp1, X is left alone
+;
+
+	.export mulax51
+
+	.setcpu 6800
+	.code
+
+mulax51:
+	staa @tmp1
+	stab @tmp1+1
+	aslb
+	rola
+	addb @tmp1+1
+	adca @tmp1
+	aslb
+	rola
+	aslb
+	rola
+	aslb
+	rola
+	addb @tmp1+1
+	adca @tmp1
+	aslb
+	rola
+	addb @tmp1+1
+	adca @tmp1
+	rts
@@ -0,0 +1,29 @@
+;
+;	Multiply D by 52
+;
+;	Written by mulgen. Uses @tmp1, X is left alone
+;
+
+	.export mulax52
+
+	.setcpu 6800
+	.code
+
+mulax52:
+	staa @tmp1
+	stab @tmp1+1
+	aslb
+	rola
+	addb @tmp1+1
+	adca @tmp1
+	aslb
+	rola
+	aslb
+	rola
+	addb @tmp1+1
+	adca @tmp1
+	aslb
+	rola
+	aslb
+	rola
+	rts
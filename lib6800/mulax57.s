@@ -0,0 +1,31 @@
+;
+;	Multiply D by 57
+;
+;	Written by mulgen. Uses @tmp1, X is left alone
+;
+
+	.export mulax57
+
+	.setcpu 6800
+	.code
+
+mulax57:
+	staa @tmp1
+	stab @tmp1+1
+	aslb
+	rola
+	aslb
+	rola
+	aslb
+	rola
+	subb @tmp1+1
+	sbca @tmp1
+	aslb
+	rola
+	aslb
+	rola
+	aslb
+	rola
+	addb @tmp1+1
+	adca @tmp1
+	rts
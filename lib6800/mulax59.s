@@ -0,0 +1,31 @@
+;
+;	Multiply D by 59
+;
+;	Written by mulgen. Uses @tmp1, X is left alone
+;
+
+	.export mulax59
+
+	.setcpu 6800
+	.code
+
+mulax59:
+	staa @tmp1
+	stab @tmp1+1
+	aslb
+	rola
+	aslb
+	rola
+	aslb
+	rola
+	aslb
+	rola
+	subb @tmp1+1
+	sbca @tmp1
+	aslb
+	rola
+	aslb
+	rola
+	subb @tmp1+1
+	sbca @tmp1
+	rts
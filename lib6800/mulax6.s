@@ -1,17 +1,21 @@
 ;
-;	Multiply D by 3
+;	Multiply D by 6
 ;
+;	Written by mulgen. Uses @tmp1, X is left alone
+;
+
 	.export mulax6
 
+	.setcpu 6800
 	.code
 
 mulax6:
 	staa @tmp1
 	stab @tmp1+1
-	lslb
+	aslb
 	rola
 	addb @tmp1+1
 	adca @tmp1
-	lslb
+	aslb
 	rola
 	rts
@@ -0,0 +1,29 @@
+;
+;	Multiply D by 63
+;
+;	Written by mulgen. Uses @tmp1, X is left alone
+;
+
+	.export mulax63
+
+	.setcpu 6800
+	.code
+
+mulax63:
+	staa @tmp1
+	stab @tmp1+1
+	aslb
+	rola
+	aslb
+	rola
+	aslb
+	rola
+	aslb
+	rola
+	aslb
+	rola
+	aslb
+	rola
+	subb @tmp1+1
+	sbca @tmp1
+	rts
@@ -1,6 +1,9 @@
 ;
 ;	Multiply D by 7
 ;
+;	Written by mulgen. Uses @tmp1, X is left alone
+;
+
 	.export mulax7
 
 	.setcpu 6800
@@ -9,14 +12,12 @@
 mulax7:
 	staa @tmp1
 	stab @tmp1+1
-	lslb
+	aslb
+	rola
+	aslb
 	rola
-	lslb
+	aslb
 	rola
-	addb @tmp1
-	adca @tmp1+1
-	addb @tmp1
-	adca @tmp1+1
-	addb @tmp1
-	adca @tmp1+1
+	subb @tmp1+1
+	sbca @tmp1
 	rts
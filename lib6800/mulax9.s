@@ -1,18 +1,22 @@
 ;
 ;	Multiply D by 9
 ;
+;	Written by mulgen. Uses @tmp1, X is left alone
+;
+
 	.export mulax9
 
+	.setcpu 6800
 	.code
 
 mulax9:
 	staa @tmp1
 	stab @tmp1+1
-	lslb
+	aslb
 	rola
-	lslb
+	aslb
 	rola
-	lslb
+	aslb
 	rola
 	addb @tmp1+1
 	adca @tmp1
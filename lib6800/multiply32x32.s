@@ -1,7 +1,12 @@
 ;
-;	32bit multiply by addition
+;	32bit multiply by shift and add
 ;
-;	Multiply 3,x by sreg:d
+;	TOS * sreg:D, popping TOS and returning the result in sreg:D
+;
+;	We work down the bits of sreg:D from the top, doubling the result
+;	and adding TOS in for each 1 bit. The result is zero until the first
+;	1 bit so leading zero bytes can simply be skipped, which is the
+;	common case of a small value widened to long.
 ;
 		.export tosumuleax
 		.export tosmuleax
@@ -16,51 +21,62 @@ tosumuleax:
 		psha		; Work space to zero
 		psha		; We will iteratively add to this for each 1 bit
 		psha
-		psha		; workspace is ,x argument is now 6,x
-		;
-		;	Now work bitwise through it
-		;
-		ldaa @tmp+1
-		beq zero1	; Speed up zero bytes (it's common for a 32 x 32 to have several 0 bytes)
-		bsr bits8
-zero1:
+		psha
+		tsx		; workspace is ,x argument is now 6,x
+		ldaa @sreg
+		bne bits32
+		ldaa @sreg+1
+		bne bits24
 		ldaa @tmp
-		beq zero2
-		bsr bits8
-zero2:
+		bne bits16
+		bra bits8
+bits32:
+		bsr mul8
 		ldaa @sreg+1
-		beq zero3
-		bsr bits8
-zero3:
-		ldaa @sreg
-		beq zero4
-		bsr bits8
+bits24:
+		bsr mul8
+		ldaa @tmp
+bits16:
+		bsr mul8
+bits8:
+		ldaa @tmp+1
+		bsr mul8
 		;
 		;	Now copy out the data
-zero4:
+		;
 		pula
 		staa @sreg
 		pula
 		staa @sreg+1
 		pula
 		pulb
-		jmp pop4		
+		jmp pop4
 
 ;
-;	Process an 8x32 slice of the multiply. We could optimize this if we un-inlined it as we can do 32bit, 24bit, 16bit, 8bit
-;	because we know there are zeros at the end.
+;	Process the 8bits of the multiplier in A
 ;
-bits8:		ldaa #8
-		staa @tmp2
+mul8:		ldab #8
+		stab @tmp2
 next8:
-		rola
+		lsl 3,x		; double the result so far
+		rol 2,x
+		rol 1,x
+		rol ,x
+		asla		; and add the argument in for a 1 bit
 		bcc noadd
-		; 32bit add
+		ldab 3,x
+		addb 9,x
+		stab 3,x
+		ldab 2,x
+		adcb 8,x
+		stab 2,x
+		ldab 1,x
+		adcb 7,x
+		stab 1,x
+		ldab ,x
+		adcb 6,x
+		stab ,x
 noadd:
-		lsl 9,x		; left shift each time we move up a bit
-		rol 8,x		; through the number
-		rol 7,x
-		rol 6,x
 		dec @tmp2
 		bne next8
 		rts
@@ -0,0 +1,86 @@
+;
+;	__realloc	X = space or 0, D = new size, returns the space in D
+;			or 0 with the old space left alone
+;
+;	The space stays where it is if the new size still fits its block,
+;	otherwise the whole of the old block is copied into a new one.
+;
+	.export __realloc
+
+	.setcpu 6800
+	.code
+
+__realloc:
+	stx	rold
+	staa	rsize
+	stab	rsize+1
+	ldx	rold
+	beq	new
+	oraa	rsize+1
+	beq	gone
+	ldaa	rsize
+	jsr	mclass
+	bcs	fail
+	ldx	rold
+	dex
+	cmpb	,x
+	bhi	grow
+	ldaa	rold		; still fits
+	ldab	rold+1
+	rts
+grow:
+	ldab	,x
+	stab	rclass
+	ldaa	rsize
+	ldab	rsize+1
+	jsr	__malloc
+	staa	rnew
+	stab	rnew+1
+	ldx	rnew
+	beq	fail
+	stx	@tmp1
+	ldx	rold
+	stx	@tmp
+	ldab	rclass
+	jsr	msize
+	subb	#1		; the header is not copied
+	sbca	#0
+	staa	@tmp2
+	stab	@tmp2+1
+copy:
+	ldx	@tmp
+	ldaa	,x
+	inx
+	stx	@tmp
+	ldx	@tmp1
+	staa	,x
+	inx
+	stx	@tmp1
+	ldx	@tmp2
+	dex
+	stx	@tmp2
+	bne	copy
+	ldx	rold
+	jsr	__free
+	ldaa	rnew
+	ldab	rnew+1
+	rts
+new:
+	jmp	__malloc
+gone:
+	jsr	__free
+fail:
+	clra
+	clrb
+	rts
+
+	.data
+
+rold:
+	.word	0
+rnew:
+	.word	0
+rsize:
+	.word	0
+rclass:
+	.byte	0
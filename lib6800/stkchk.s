@@ -0,0 +1,41 @@
+;
+;	Stack overflow checks used by code built with --check-stack. The
+;	stack must stay above _stklimit, which defaults to 0 (no limit).
+;	stkchk is called on function entry, cstkchk once the locals are
+;	on the stack. The linker removes the calls it can prove will never
+;	fail. D and X are preserved.
+;
+	.export stkchk
+	.export cstkchk
+	.export _stklimit
+
+	.code
+
+stkchk:
+cstkchk:
+	pshb
+	psha
+	sts @tmp
+	ldaa @tmp
+	ldab @tmp+1
+	subb _stklimit+1
+	sbca _stklimit
+	pula			; pul does not touch the flags
+	pulb
+	bcs overflow
+	rts
+;
+;	Out of stack. There is still a little slack below the limit for
+;	the exit code argument.
+;
+overflow:
+	ldab #$FF
+	pshb
+	pshb
+	pshb
+	pshb
+	jsr _exit
+
+	.data
+_stklimit:
+	.word 0
@@ -1,40 +1,53 @@
 ;
 ;	Left shift 32bit signed
+;
+;	Whole bytes are moved and then at most 7 bits are shifted
 ;
 	.export tosasleax
 	.export tosshleax
 
 	.code
 
-;
-;	TODO: optimize 8, 16 steps on asl and asr cases
-;
 tosasleax:	
 tosshleax:
 	cmpb	#32
 	bcc	ret0
-	tstb
-	beq noshift
 	tsx
+	cmpb	#8
+	bcs	bits
+bytes:
+	ldaa	3,x
+	staa	2,x
+	ldaa	4,x
+	staa	3,x
+	ldaa	5,x
+	staa	4,x
+	clr	5,x
+	subb	#8
+	cmpb	#8
+	bcc	bytes
+bits:
+	tstb
+	beq	done
 loop:
 	asl	5,x
 	rol	4,x
 	rol	3,x
 	rol	2,x
 	decb
-	bne loop
+	bne	loop
+done:
+	; Get the value
 	ldaa	2,x
 	ldab	3,x
-	; Get the value
 	staa	@sreg
 	stab	@sreg+1
 	ldaa	4,x
 	ldab	5,x
-noshift:
-	jmp pop4
+	jmp	pop4
 ret0:
 	clra
 	clrb
 	staa	@sreg
 	stab	@sreg+1
-	bra	noshift
+	jmp	pop4
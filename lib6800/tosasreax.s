@@ -1,35 +1,84 @@
 ;
-;	Right shift 32bit signed
+;	Right shift 32bit signed and unsigned
+;
+;	Whole bytes are moved and then at most 7 bits are shifted
 ;
 	.export tosasreax
+	.export tosshreax
 
 	.code
 
 tosasreax:	
 	cmpb	#32
 	bcc	ret0
-	tstb
-	beq noshift
 	tsx
-loop:
+	cmpb	#8
+	bcs	sbits
+sbytes:
+	ldaa	4,x
+	staa	5,x
+	ldaa	3,x
+	staa	4,x
+	ldaa	2,x
+	staa	3,x
+	asla			; Sign into carry
+	ldaa	#0
+	sbca	#0		; and make it 0 or $FF
+	staa	2,x
+	subb	#8
+	cmpb	#8
+	bcc	sbytes
+sbits:
+	tstb
+	beq	done
+sloop:
 	asr	2,x
 	ror	3,x
 	ror	4,x
 	ror	5,x
 	decb
-	bne loop
+	bne	sloop
+done:
+	; Get the value
 	ldaa	2,x
 	ldab	3,x
-	; Get the value
 	staa	@sreg
 	stab	@sreg+1
 	ldaa	4,x
 	ldab	5,x
-noshift:
-	jmp pop4
+	jmp	pop4
 ret0:
 	clra
 	clrb
 	staa	@sreg
 	stab	@sreg+1
-	bra	noshift
+	jmp	pop4
+
+tosshreax:
+	cmpb	#32
+	bcc	ret0
+	tsx
+	cmpb	#8
+	bcs	ubits
+ubytes:
+	ldaa	4,x
+	staa	5,x
+	ldaa	3,x
+	staa	4,x
+	ldaa	2,x
+	staa	3,x
+	clr	2,x
+	subb	#8
+	cmpb	#8
+	bcc	ubytes
+ubits:
+	tstb
+	beq	done
+uloop:
+	lsr	2,x
+	ror	3,x
+	ror	4,x
+	ror	5,x
+	decb
+	bne	uloop
+	bra	done
@@ -18,7 +18,7 @@ tosmodax:
 	psha
 	ldaa 2,x
 	bita #$80
-	beq negmod
+	bne negmod
 	pula
 	ldx 2,x
 	jsr div16x16		; do the unsigned divide
@@ -72,7 +72,7 @@ absd:
 	beq ispos
 	inc @tmp4
 negd:
-	decb
+	subb #1			; decb doesn't set the carry
 	sbca #0
 	coma
 	comb
@@ -9,5 +9,7 @@ tosgeax:
 		cmpa 2,x
 		bne noteq
 		cmpb 3,x
+		jsr boolule		; the low bytes are unsigned
+		jmp pop2flags
 noteq:		jsr boolle		; we did the comparison backwards
 		jmp pop2flags
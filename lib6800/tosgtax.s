@@ -9,6 +9,7 @@ tosgtax:
 		cmpa 2,x
 		bne noteq
 		cmpb 3,x
+		jsr boolult		; the low bytes are unsigned
+		jmp pop2flags
 noteq:		jsr boollt		; we did the comparison backwards
 		jmp pop2flags
-
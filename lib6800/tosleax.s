@@ -9,5 +9,7 @@ tosleax:
 		cmpa 2,x
 		bne noteq
 		cmpb 3,x
+		jsr booluge		; the low bytes are unsigned
+		jmp pop2flags
 noteq:		jsr boolge		; we did the comparison backwards
 		jmp pop2flags
@@ -9,6 +9,7 @@ tosltax:
 		cmpa 2,x
 		bne noteq
 		cmpb 3,x
-noteq:		jsr boolgt		; as we compare backwardss
-
+		jsr boolugt		; the low bytes are unsigned
+		jmp pop2flags
+noteq:		jsr boolgt		; we did the comparison backwards
 		jmp pop2flags
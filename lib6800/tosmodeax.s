@@ -12,16 +12,20 @@
 tosmodeax:
 		; make working space
 		psha
-		; Arrange stack for the divide helper. TOS is already right
-		; so push the other 4 bytes we need. The divide helper knows
-		; about the fact there is junk (return address) between the
-		; two
+		; The sign of the divisor makes no difference to the
+		; remainder
 		ldaa @sreg
-		staa @tmp4
 		bpl nosignfix
+		pula
 		jsr negeax
+		bra signfixed
 nosignfix:
 		pula
+signfixed:
+		; Arrange stack for the divide helper. TOS is already right
+		; so push the other 4 bytes we need. The divide helper knows
+		; about the fact there is junk (return address) between the
+		; two
 		pshb
 		psha
 		ldaa @sreg
@@ -33,6 +37,7 @@ nosignfix:
 		;
 		tsx
 		ldaa 6,x		; sign of TOS
+		staa @tmp4
 		bpl nosignfix2
 		ldaa 8,x
 		ldab 9,x
@@ -40,7 +45,7 @@ nosignfix:
 		sbca #0
 		staa 8,x
 		stab 9,x
-		ldaa 5,x
+		ldaa 6,x
 		ldab 7,x
 		sbcb #0
 		sbca #0
@@ -51,7 +56,6 @@ nosignfix:
 		com 8,x
 		com 9,x
 nosignfix2:
-		tsx
 		jsr div32x32
 		ins
 		ins
@@ -59,15 +63,14 @@ nosignfix2:
 		ins
 		;
 		;	At this point @tmp2/@tmp3 hold the positive signed
-		;	dividend
+		;	remainder
 		;
 		ldaa @tmp2
 		ldab @tmp2+1
 		staa @sreg
 		stab @sreg+1
 		ldaa @tmp4
-		bita #0x80		; check if negative dividend
-		beq nonega
+		bpl nonega		; check if negative dividend
 		ldaa @tmp3
 		ldab @tmp3+1
 		jsr negeax
@@ -12,10 +12,9 @@
 tosaslax:				; negative shift is not defined
 					; anyway
 tosshlax:
-	clra				; shift of > 15 is meaningless
-	cmpb #15
-	bgt shiftout
 	tsx
+	cmpb #15			; shift of > 15 is meaningless
+	bhi shiftout
 shloop:
 	tstb
 	beq shiftdone
@@ -0,0 +1,57 @@
+;
+;	Arenas
+;
+;	arena_init(arena, base, size)	hand out the memory at base
+;	arena_alloc(arena, size)	the next size bytes, or 0
+;	arena_release(arena, mark)	free everything from mark on, where
+;					mark is a pointer arena_alloc returned
+;
+;	An arena is the next free byte and the end.
+;
+	.export _arena_init
+	.export _arena_alloc
+	.export _arena_release
+
+	.setcpu 6803
+	.code
+
+_arena_init:
+	tsx
+	ldd	4,x
+	addd	2,x
+	std	@tmp
+	ldd	4,x
+	ldx	6,x
+	std	,x
+	ldd	@tmp
+	std	2,x
+	rts
+
+_arena_alloc:
+	tsx
+	ldd	2,x
+	std	@tmp
+	ldx	4,x
+	ldd	2,x		; room left
+	subd	,x
+	subd	@tmp
+	bcs	full
+	ldd	,x
+	pshb
+	psha
+	addd	@tmp
+	std	,x
+	pula
+	pulb
+	rts
+full:
+	clra
+	clrb
+	rts
+
+_arena_release:
+	tsx
+	ldd	2,x
+	ldx	4,x
+	std	,x
+	rts
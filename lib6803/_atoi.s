@@ -1,4 +1,7 @@
-
+;
+;	Skip white space, take an optional sign and then as many digits as
+;	there are. Overflow is undefined so we just wrap.
+;
 		.export _atoi
 
 		.setcpu 6803
@@ -7,25 +10,41 @@
 _atoi:
 		tsx
 		ldx 2,x
-		clra
+		clr @tmp4		; sign
+skip:		ldaa ,x
+		cmpa #' '
+		beq next
+		cmpa #9			; \t \n \v \f \r
+		blo sign
+		cmpa #13
+		bhi sign
+next:		inx
+		bra skip
+sign:		cmpa #'-'
+		bne plus
+		inc @tmp4
+		bra over
+plus:		cmpa #'+'
+		bne digits
+over:		inx
+digits:		clra
 		clrb
-		std @tmp
-		std @tmp2
-_atoil:		ldab ,x
-		cmpb #'0'		; in range ?
-		blt done
-		cmpb #'9'
-		bgt done
+		staa @tmp2
+_atoil:		std @tmp3		; value so far
+		ldab ,x
 		subb #'0'		; make digit
-		stab @tmp2+1		; tmp2 is now the 16bit value
-		ldd @tmp		; existing value
-		std @tmp3		; save d
-		asld			; x 2
-		asld			; x 4
-		addd @tmp		; x 5
-		asld			; x 10
+		cmpb #9			; in range ?
+		bhi done
+		stab @tmp2+1		; tmp2 is now the 16bit digit
+		ldd @tmp3
+		jsr mulax10		; x 10
 		addd @tmp2		; + new
-		std @tmp		; save
 		inx			; next char
 		bra _atoil
-done:		rts
+done:		ldd @tmp3
+		tst @tmp4
+		beq pos
+		coma
+		comb
+		addd @one
+pos:		rts
@@ -0,0 +1,13 @@
+;
+;	calloc(count, size)
+;
+	.export _calloc
+
+	.setcpu 6803
+	.code
+
+_calloc:
+	tsx
+	inx
+	inx
+	jmp	__calloc
@@ -0,0 +1,18 @@
+;
+;	malloc(size) and free(p). The allocator is in lib6800/malloc.s
+;
+	.export _malloc
+	.export _free
+
+	.setcpu 6803
+	.code
+
+_malloc:
+	tsx
+	ldd	2,x
+	jmp	__malloc
+
+_free:
+	tsx
+	ldx	2,x
+	jmp	__free
@@ -5,26 +5,28 @@
 _memccpy:
 		tsx
 		ldd 2,x
-		addd 8,x
-		std @tmp	; end mark
+		beq none
+		addd 6,x
+		std @tmp3	; end mark on the source
 		ldd 8,x
-		std @tmp2	; save 
+		std @tmp2	; destination
 		ldab 5,x	; match char
-		ldx 6,x		; get source int X
+		ldx 6,x		; get source into X
 loop:		ldaa ,x		; get a source byte
-		stx @tmp3
+		inx
+		stx @tmp
 		ldx @tmp2
 		staa ,x		; save it
 		inx
-		stx @tmp2	; swap back
-		ldx @tmp3
+		stx @tmp2
 		cba		; did we match
 		beq match
-		inx
-		cpx @tmp	; are we done ?
+		ldx @tmp
+		cpx @tmp3	; are we done ?
 		bne loop
+none:
 		clra
 		clrb
 		rts
-match:		ldd @tmp3
+match:		ldd @tmp2	; the byte after the match in the destination
 		rts
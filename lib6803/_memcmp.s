@@ -0,0 +1,130 @@
+;
+;	memcmp(a, b, n)
+;
+;	Compare a word at a time, 8 bytes a go using offsets, and only
+;	when a pair of words differ go back and find which byte did it.
+;	The odd byte and words over a whole number of blocks go first.
+;
+;	Cycles per byte for equal blocks: 6803 15.5, 6303 14.3. There was
+;	no memcmp before.
+;
+	.export _memcmp
+
+	.setcpu 6803
+	.code
+
+_memcmp:
+	tsx
+	ldd	2,x		; length
+	jeq	same
+	addd	6,x
+	std	@tmp3		; end of a
+	ldab	3,x
+	andb	#7
+	stab	@tmp1		; bytes over a whole number of blocks
+	ldd	4,x
+	std	@tmp2		; b
+	ldx	6,x		; a
+	lsr	@tmp1
+	bcc	words
+	ldab	,x
+	inx
+	stx	@tmp
+	ldx	@tmp2
+	clra
+	subb	,x
+	sbca	#0
+	bne	out
+	tstb
+	bne	out
+	inx
+	stx	@tmp2
+	ldx	@tmp
+words:
+	tst	@tmp1
+	beq	blocks
+word:
+	stx	@tmp
+	ldd	,x
+	ldx	@tmp2
+	subd	,x
+	bne	diff0
+	inx
+	inx
+	stx	@tmp2
+	ldx	@tmp
+	inx
+	inx
+	dec	@tmp1
+	bne	word
+blocks:
+	cpx	@tmp3
+	beq	same
+block:
+	stx	@tmp
+	ldd	,x
+	ldx	@tmp2
+	subd	,x
+	bne	diff0
+	ldx	@tmp
+	ldd	2,x
+	ldx	@tmp2
+	subd	2,x
+	bne	diff2
+	ldx	@tmp
+	ldd	4,x
+	ldx	@tmp2
+	subd	4,x
+	bne	diff4
+	ldx	@tmp
+	ldd	6,x
+	ldx	@tmp2
+	subd	6,x
+	bne	diff6
+	ldx	@tmp
+	ldab	#8
+	abx
+	stx	@tmp
+	ldx	@tmp2
+	abx
+	stx	@tmp2
+	ldx	@tmp
+	cpx	@tmp3
+	bne	block
+same:
+	clra
+	clrb
+out:
+	rts
+diff6:
+	ldab	#6
+	bra	diff
+diff4:
+	ldab	#4
+	bra	diff
+diff2:
+	ldab	#2
+	bra	diff
+diff0:
+	clrb
+diff:
+	; The words at offset B differ, find the byte
+	abx
+	stx	@tmp2
+	ldx	@tmp
+	abx
+	ldaa	,x
+	ldab	1,x
+	ldx	@tmp2
+	cmpa	,x
+	bne	first
+	clra
+	subb	1,x
+	sbca	#0
+	rts
+first:
+	tab
+	clra
+	subb	,x
+	sbca	#0
+	rts
@@ -1,47 +1,106 @@
 ;
-;	There isn't a nice way to do this on 680x/630x.
+;	memcpy(d, s, n)
 ;
+;	There isn't a nice way to do this on 680x/630x as there is only
+;	one index register. We keep both pointers in the direct page and
+;	load X from them for each word, but we use the offset in the
+;	instruction so the pointers only move once per 16 bytes. The odd
+;	byte and words over a whole number of blocks go first and after
+;	that the end of the source is the only check.
+;
+;	Cycles per byte for a long copy: 6803 10.5, 6303 10.1. The original
+;	byte loop was 36 and 31.
 ;
 	.export _memcpy
+	.export __memcpy
 
 	.setcpu 6803
 	.code
 
 _memcpy:
 	tsx
-	ldd	6,x
-	std	@tmp		; destination
+__memcpy:			; memmove comes in here with X set
 	ldd	2,x		; length
-	beq	nocopy
-	ldx	4,x		; src
-	bsr	nextblock
-	tsx
-nocopy:
+	jeq	done
+	addd	4,x
+	std	@tmp3		; end of the source
+	ldab	3,x
+	andb	#15
+	stab	@tmp1		; bytes over a whole number of blocks
 	ldd	6,x
-	rts
-
-nextblock:
-	tsta
-	beq	tailcopy
-	; Copy 256 bytes repeatedly until we get to the leftovers
-	pshb
-	psha
-	clrb
-	bsr	tailcopy
-	pula
-	pulb
-	deca
-	bra	nextblock
-
-tailcopy:
+	std	@tmp2		; destination
+	ldx	4,x		; source
+	lsr	@tmp1
+	bcc	words
 	ldaa	,x
 	inx
-	pshx
-	ldx	@tmp
+	stx	@tmp
+	ldx	@tmp2
 	staa	,x
 	inx
+	stx	@tmp2
+	ldx	@tmp
+words:
+	tst	@tmp1
+	beq	blocks
+word:
+	ldd	,x
+	inx
+	inx
+	stx	@tmp
+	ldx	@tmp2
+	std	,x
+	inx
+	inx
+	stx	@tmp2
+	ldx	@tmp
+	dec	@tmp1
+	bne	word
+blocks:
 	stx	@tmp
-	pulx
-	decb
-	bne	tailcopy
+	cpx	@tmp3
+	beq	done
+block:
+	ldd	,x
+	ldx	@tmp2
+	std	,x
+	ldx	@tmp
+	ldd	2,x
+	ldx	@tmp2
+	std	2,x
+	ldx	@tmp
+	ldd	4,x
+	ldx	@tmp2
+	std	4,x
+	ldx	@tmp
+	ldd	6,x
+	ldx	@tmp2
+	std	6,x
+	ldx	@tmp
+	ldd	8,x
+	ldx	@tmp2
+	std	8,x
+	ldx	@tmp
+	ldd	10,x
+	ldx	@tmp2
+	std	10,x
+	ldx	@tmp
+	ldd	12,x
+	ldx	@tmp2
+	std	12,x
+	ldx	@tmp
+	ldd	14,x
+	ldx	@tmp2
+	std	14,x
+	ldab	#16
+	abx
+	stx	@tmp2
+	ldx	@tmp
+	abx
+	stx	@tmp
+	cpx	@tmp3
+	bne	block
+done:
+	tsx
+	ldd	6,x		; returns the destination
 	rts
@@ -1,4 +1,13 @@
-
+;
+;	memset(s, c, n)
+;
+;	Store the odd bytes one at a time until what is left is a multiple
+;	of 16, then fill 16 bytes a go with word stores. The end is found
+;	by comparing the pointer with s + n so there is no count to keep.
+;
+;	Cycles per byte for a long fill: 6803 3.4, 6303 3.1. The original
+;	byte loop was 15 and 12.
+;
 	.export _memset
 
 	.setcpu 6803
@@ -6,17 +15,40 @@
 
 _memset:
 	tsx
-	ldd	6,x		; start
-	addd	2,x		; + length
+	ldd	2,x		; length
+	beq	done
+	addd	6,x		; start + length
 	std	@tmp		; end stop
-	ldab	5,x		; fill byte
+	ldab	3,x		; bytes over a whole number of blocks
+	andb	#15
+	ldaa	5,x		; fill byte
 	ldx	6,x		; start
-
-loop:
-	stab	,x
+	tstb
+	beq	blocks
+head:
+	staa	,x
 	inx
+	decb
+	bne	head
+blocks:
+	tab			; D is the fill byte twice
+	cpx	@tmp
+	beq	done
+block:
+	std	,x
+	std	2,x
+	std	4,x
+	std	6,x
+	std	8,x
+	std	10,x
+	std	12,x
+	std	14,x
+	ldab	#16
+	abx
+	tab
 	cpx	@tmp
-	bne	loop
+	bne	block
+done:
 	tsx
-	ldx	6,x		; returns the start passed in
+	ldd	6,x		; returns the start passed in
 	rts
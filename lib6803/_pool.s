@@ -0,0 +1,72 @@
+;
+;	Pools of fixed size objects
+;
+;	pool_init(pool, size)	set up an empty pool
+;	pool_alloc(pool)	an object, or 0 if the heap is full
+;	pool_free(pool, obj)	give an object back to its pool
+;
+;	A pool is its free list head and the object size. The objects have
+;	no header, a free one holds the link in its first two bytes, and
+;	new ones come straight from __sbrk.
+;
+	.export _pool_init
+	.export _pool_alloc
+	.export _pool_free
+
+	.setcpu 6803
+	.code
+
+_pool_init:
+	tsx
+	ldd	2,x
+	subd	#2		; room for the link
+	bcc	sizeok
+	clra
+	clrb
+sizeok:
+	addd	#2
+	ldx	4,x
+	std	2,x
+	clra
+	clrb
+	std	,x
+	rts
+
+_pool_alloc:
+	tsx
+	ldx	2,x
+	stx	@tmp3
+	ldx	,x
+	beq	grow
+	ldd	,x
+	stx	@tmp
+	ldx	@tmp3
+	std	,x
+	ldd	@tmp
+	rts
+grow:
+	ldx	@tmp3
+	ldd	2,x
+	jsr	__sbrk
+	bcc	grown
+	clra
+	clrb
+grown:
+	rts
+
+_pool_free:
+	tsx
+	ldd	2,x
+	ldx	4,x
+	pshx
+	ldx	,x
+	pshx
+	std	@tmp
+	ldx	@tmp
+	pula			; the old head into the object
+	pulb
+	std	,x
+	pulx
+	ldd	@tmp
+	std	,x
+	rts
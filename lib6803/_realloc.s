@@ -0,0 +1,13 @@
+;
+;	realloc(p, size)
+;
+	.export _realloc
+
+	.setcpu 6803
+	.code
+
+_realloc:
+	tsx
+	ldd	2,x
+	ldx	4,x
+	jmp	__realloc
@@ -0,0 +1,18 @@
+;
+;	sbrk(increment) and brk(addr). See lib6800/brk.s
+;
+	.export _sbrk
+	.export _brk
+
+	.setcpu 6803
+	.code
+
+_sbrk:
+	tsx
+	ldd	2,x
+	jmp	__sbrk
+
+_brk:
+	tsx
+	ldd	2,x
+	jmp	__brk
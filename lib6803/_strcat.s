@@ -1,32 +1,37 @@
 ;
-;	Another one that's really hard to do nicely
+;	strcat(d, s)
+;
+;	Find the end of the destination and then copy the source on
 ;
 
 	.export _strcat
 
-	.setcpu 6303
+	.setcpu 6803
 	.code
 
 _strcat:
 	tsx
-	ldd	4,x
-	std	@tmp		; destination
-	ldx	2,x		; src
+	ldx	4,x		; destination
 endhunt:
 	tst	,x
-	beq	copyloop
+	beq	found
 	inx
 	bra	endhunt
+found:
+	stx	@tmp2
+	tsx
+	ldx	2,x		; source
 copyloop:
 	ldaa	,x
 	inx
-	pshx
-	ldx	@tmp
+	stx	@tmp
+	ldx	@tmp2
 	staa	,x
 	inx
-	stx	@tmp
-	pulx
+	stx	@tmp2
+	ldx	@tmp
 	tsta
-	bne copyloop
+	bne	copyloop
+	tsx
 	ldd	4,x
 	rts
@@ -1,28 +1,53 @@
+;
+;	strcmp and strncmp share the compare loop. strcmp has an end mark
+;	it can only reach by wrapping the whole address space.
+;
 		.export _strcmp
+		.export _strncmp
+
 		.setcpu 6803
 		.code
+
+_strncmp:
+		tsx
+		ldd 2,x
+		beq nret	; length 0, and D is 0
+		addd 6,x	; end of s1
+		std @tmp3
+		ldd 4,x
+		std @tmp2
+		ldx 6,x
+		bra compare
+nret:
+		rts
+
 _strcmp:
 		tsx
 		ldd 2,x
+		std @tmp2
 		ldx 4,x
-		std @tmp
-loop:
-		ldab ,x		; get *s1 into B
-		stx @tmp2	; switch pointer
-		ldx @tmp
-		cmpb ,x		; compare with *s2
-		blo ret1
-		bhi retminus1
-		inx		; move on
+		stx @tmp3
+compare:
+		ldaa ,x		; get *s1
+		inx
 		stx @tmp
-		ldx @tmp2	; switch pointer back
+		ldx @tmp2
+		cmpa ,x		; compare with *s2
+		bne diff
 		inx
-		bra loop	; rinse, repeat
-ret1:
-		ldd @one
+		stx @tmp2
+		tsta
+		beq same
+		ldx @tmp
+		cpx @tmp3
+		bne compare
+same:
+		clra
+		clrb
 		rts
-retminus1:
-		ldd #-1
+diff:
+		tab		; the difference as unsigned chars
+		clra
+		subb ,x
+		sbca #0
 		rts
-
-		
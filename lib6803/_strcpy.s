@@ -1,28 +1,72 @@
 ;
-;	Another one that's really hard to do nicely
+;	strcpy(d, s)
+;
+;	Another one that's really hard to do nicely. Copy a byte at a time
+;	as reading a word could touch the byte after the end of the string,
+;	but use offsets so the pointers only move every 8 bytes.
+;
+;	Cycles per byte: 6803 21.3, 6303 20.8. The original loop was 36 and
+;	31.
 ;
 
 	.export _strcpy
 
-	.setcpu 6303
+	.setcpu 6803
 	.code
 
 _strcpy:
 	tsx
 	ldd	4,x
-	std	@tmp		; destination
-	ldx	2,x		; src
+	std	@tmp2		; destination
+	ldx	2,x		; source
 copyloop:
+	stx	@tmp
 	ldaa	,x
-	inx
-	pshx
-	ldx	@tmp
+	ldx	@tmp2
 	staa	,x
-	inx
-	stx	@tmp
-	pulx
-	tsta
-	bne copyloop
+	beq	done
+	ldx	@tmp
+	ldaa	1,x
+	ldx	@tmp2
+	staa	1,x
+	beq	done
+	ldx	@tmp
+	ldaa	2,x
+	ldx	@tmp2
+	staa	2,x
+	beq	done
+	ldx	@tmp
+	ldaa	3,x
+	ldx	@tmp2
+	staa	3,x
+	beq	done
+	ldx	@tmp
+	ldaa	4,x
+	ldx	@tmp2
+	staa	4,x
+	beq	done
+	ldx	@tmp
+	ldaa	5,x
+	ldx	@tmp2
+	staa	5,x
+	beq	done
+	ldx	@tmp
+	ldaa	6,x
+	ldx	@tmp2
+	staa	6,x
+	beq	done
+	ldx	@tmp
+	ldaa	7,x
+	ldx	@tmp2
+	staa	7,x
+	beq	done
+	ldab	#8
+	abx
+	stx	@tmp2
+	ldx	@tmp
+	abx
+	bra	copyloop
+done:
 	tsx
 	ldd	4,x
 	rts
@@ -1,40 +1,86 @@
-
+;
+;	strlcpy and strlcat. strlcat finds the end of the destination within
+;	the size and then does a strlcpy of what room is left. Both return
+;	the length of the string they tried to make.
+;
 		.export _strlcpy
+		.export _strlcat
 
 		.setcpu 6803
 		.code
 
 _strlcpy:
 		tsx
-		ldd 2,x		; size limit
-		addd 4,x	; source limit marker
-		std @tmp
-		ldd 6,x		; dest
-		std @tmp2
+		ldd 6,x
+		std @tmp2	; destination
+		ldd 2,x		; room
 		ldx 4,x		; source
-loop:
-		ldab ,x
-		beq end		; null terminator
-		pshx
-		ldx @tmp2	; copy byte
-		stab ,x
-		inx
-		stx @tmp2
-		pulx
+		bra lcpy
+
+_strlcat:
+		tsx
+		ldd 2,x		; the end of the room
+		addd 6,x
+		std @tmp3
+		ldx 6,x
+		bra endtest
+endhunt:
+		tst ,x
+		beq end
 		inx
-		cpx @tmp	; source hit limit ?
-		bne loop
-		; We ran out of space
-		dex
-		clr ,x
-		tsx		; if we ran out of space we copied size
-		ldd 2,x
-		rts
+endtest:
+		cpx @tmp3
+		bne endhunt
 end:
-		ldx @tmp2	; get the destination
-		clr ,x		; clear the final byte
+		stx @tmp2	; where we copy to
+		ldd @tmp2	; length of the destination
 		tsx
-		ldd @tmp2	; end byte
-		addd @one	; +1
-		subd 2,x	; - start (size used)
+		subd 6,x
+		std @tmp4
+		ldd 2,x		; room left
+		subd @tmp4
+		ldx 4,x		; source
+		bsr lcpy
+		addd @tmp4
+		rts
+
+;
+;	Copy from X to @tmp2 with room for D bytes including the terminator,
+;	and return the length of the string at X
+;
+lcpy:
+		stx @tmp
+		stx @tmp1
+		subd @one	; leave room for the terminator
+		bcs scan	; no room at all
+		addd @tmp2
+		std @tmp3	; where the terminator goes at the latest
+copy:
+		ldx @tmp2
+		cpx @tmp3
+		beq term
+		ldx @tmp
+		ldaa ,x
+		beq term
+		inx
+		stx @tmp
+		ldx @tmp2
+		staa ,x
+		inx
+		stx @tmp2
+		bra copy
+term:
+		ldx @tmp2
+		clr ,x
+scan:
+		ldx @tmp	; the length is to the end of the source
+		bra scantest
+scanloop:
+		inx
+scantest:
+		tst ,x
+		bne scanloop
+		stx @tmp
+		ldd @tmp
+		subd @tmp1
 		rts
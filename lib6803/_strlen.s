@@ -1,19 +1,56 @@
-
-
-	.setcpu 6303
-	.code
+;
+;	strlen(s)
+;
+;	Look at 8 bytes a go using offsets and then work out the length
+;	from where the end was found.
+;
+;	Cycles per byte: 6803 8.0, 6303 7.7. The original loop was 20 and 15.
+;
 	.export _strlen
 
+	.setcpu 6803
+	.code
 
 _strlen:
 	tsx
-	ldx 2,x
-	clra
-	clrb
-cl:	tst ,x
-	beq to_rts
+	ldx	2,x
+loop:
+	ldaa	,x
+	beq	end0
+	ldaa	1,x
+	beq	end1
+	ldaa	2,x
+	beq	end2
+	ldaa	3,x
+	beq	end3
+	ldaa	4,x
+	beq	end4
+	ldaa	5,x
+	beq	end5
+	ldaa	6,x
+	beq	end6
+	ldaa	7,x
+	beq	end7
+	ldab	#8
+	abx
+	bra	loop
+end7:
+	inx
+end6:
+	inx
+end5:
 	inx
-	addd @one
-	bra cl
-to_rts:
+end4:
+	inx
+end3:
+	inx
+end2:
+	inx
+end1:
+	inx
+end0:
+	stx	@tmp
+	ldd	@tmp
+	tsx
+	subd	2,x
 	rts
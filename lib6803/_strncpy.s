@@ -1,20 +1,23 @@
 ;
-;	Another one that's really hard to do nicely
+;	strncpy(d, s, n)
+;
+;	Copy up to n bytes and if the string ends first pad the rest of the
+;	n bytes with zero.
 ;
 
 	.export _strncpy
 
-	.setcpu 6303
+	.setcpu 6803
 	.code
 
 _strncpy:
 	tsx
 	ldd	2,x		; size
-	beq	end3		; size 0 - silly
+	beq	done		; size 0 - silly
 	addd	6,x		; dest end mark
-	std	@tmp2
+	std	@tmp3
 	ldd	6,x
-	std	@tmp		; destination
+	std	@tmp2		; destination
 	ldx	4,x		; src
 	;
 	;	Copy bytes up to the size limit given
@@ -22,31 +25,26 @@ _strncpy:
 copyloop:
 	ldaa	,x
 	inx
-	pshx
-	ldx	@tmp
+	stx	@tmp
+	ldx	@tmp2
 	staa	,x
 	inx
-	stx	@tmp
-	cpx	@tmp2
-	beq	end1
-	pulx
-	tsta
-	bne copyloop
+	stx	@tmp2
+	cpx	@tmp3
+	beq	done
 	ldx	@tmp
+	tsta
+	bne	copyloop
+	ldx	@tmp2
 	;
 	;	Wipe the remainder of the target buffer
 	;
 wipeloop:
-	cpx	@tmp2
-	beq	end2
 	clr	,x
 	inx
-	bra	wipeloop
-end1:
-	pulx
-end2:
+	cpx	@tmp3
+	bne	wipeloop
+done:
 	tsx
-end3:
-	ldd	4,x
+	ldd	6,x
 	rts
-
@@ -1,6 +1,6 @@
 
 
-	.setcpu 6303
+	.setcpu 6803
 	.code
 	.export _strnlen
 
@@ -8,6 +8,7 @@
 _strnlen:
 	tsx
 	ldd 2,x			; work out the stop mark
+	beq to_rts		; length 0, and D is 0
 	addd 4,x
 	std @tmp		; save it
 	ldx 4,x
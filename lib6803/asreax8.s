@@ -11,8 +11,8 @@ asreax8:
 	psha		; Save low 8bits we need
 	ldd @sreg	; Grab top 16
 	staa @sreg+1	; Save the top 8 in the low 8 of sreg
-	cmpa #$80	; Negative ?
-	ldaa #0		; Clear top byte
+	rola		; Sign into carry
+	ldaa #0		; Clear top byte, leaving the carry alone
 	bcc positive
 	coma		; Negative so set top byte for arithmetic shift
 positive:
@@ -18,6 +18,21 @@
 ;	resulting Q(n) bit into the bottom. After 32 cycles we throw N(0)
 ;	out and have shifted all of Q into the result.
 ;
+;	Most divisions don't need all that. The work register R only
+;	grows until it passes the divisor, so while R << 8 plus the next
+;	byte of N is still below the divisor we can move the whole byte
+;	across at once and shift eight zero bits into Q. Then
+;
+;	32/16	when the divisor fits in 16bits R lives in D, and N is
+;		done a 16bit word at a time so only two bytes of it are
+;		shifted each cycle. A 0 high word is skipped
+;	32/32	otherwise R is 32bits, but the top 16bits of N always
+;		go straight into it so at most 16 cycles are left
+;
+;	Timed with sim68 for an unsigned a / b on a 6803, call included,
+;	16/16 takes 600-930 cycles, 32/16 1050-1710 and 32/32 1050-1830
+;	where the plain loop took 3400-3580. Dividing by 0 gives junk.
+;
 
 DIVIS		.equ	0
 ;		4/5,x are a return address and it's easier to just leave
@@ -30,13 +45,143 @@ DIVID		.equ	6
 		.code
 
 div32x32:
-		ldab #32		; 32 iterations for 32 bits
-		stab @tmp
 		ldd @zero
-		; Clear the working register (tmp2/tmp3)
-		; R = 0;
+		; The remainder high word is 0 unless the divisor is 32bit
 		std @tmp2
 		std @tmp3
+		ldd DIVIS,x
+		jne div32
+		;
+		;	A 16bit divisor. Divide the high word and then carry
+		;	the remainder on into dividing the low word, just as
+		;	you would by hand with 16bit digits. If the high word
+		;	is 0 then so is its quotient.
+		;
+		ldd DIVID,x
+		beq low16
+		ldab #16
+		stab @tmp
+prehi:
+		ldaa @tmp3		; R << 8 won't fit so won't be below D
+		bne gohi
+		ldaa @tmp3+1
+		ldab DIVID,x
+		subd DIVIS+2,x
+		bcc gohi
+		; Move the byte into R and shift N and Q a byte
+		ldaa @tmp3+1
+		ldab DIVID,x
+		std @tmp3
+		ldab DIVID+1,x
+		stab DIVID,x
+		clr DIVID+1,x
+		ldab @tmp
+		subb #8
+		stab @tmp
+		bne prehi
+		bra low16
+gohi:
+		ldd @tmp3
+loophi:
+		sec
+		rol DIVID+1,x
+		rol DIVID,x
+		rolb
+		rola
+		; If R overflowed it is certainly bigger than D
+		bcs subhi
+		subd DIVIS+2,x
+		bcc nexthi
+		addd DIVIS+2,x
+		dec DIVID+1,x
+		dec @tmp
+		bne loophi
+		std @tmp3
+		bra low16
+subhi:
+		subd DIVIS+2,x
+nexthi:
+		dec @tmp
+		bne loophi
+		std @tmp3
+low16:
+		ldab #16
+		stab @tmp
+prelo:
+		ldaa @tmp3
+		bne golo
+		ldaa @tmp3+1
+		ldab DIVID+2,x
+		subd DIVIS+2,x
+		bcc golo
+		ldaa @tmp3+1
+		ldab DIVID+2,x
+		std @tmp3
+		ldab DIVID+3,x
+		stab DIVID+2,x
+		clr DIVID+3,x
+		ldab @tmp
+		subb #8
+		stab @tmp
+		bne prelo
+		rts
+golo:
+		ldd @tmp3
+looplo:
+		sec
+		rol DIVID+3,x
+		rol DIVID+2,x
+		rolb
+		rola
+		bcs sublo
+		subd DIVIS+2,x
+		bcc nextlo
+		addd DIVIS+2,x
+		dec DIVID+3,x
+		dec @tmp
+		bne looplo
+		std @tmp3
+		rts
+sublo:
+		subd DIVIS+2,x
+nextlo:
+		dec @tmp
+		bne looplo
+		std @tmp3
+		rts
+		;
+		;	32/32. D is at least 65536 so the top 16bits of N
+		;	go into R without a subtract
+		;
+div32:
+		ldd DIVID,x
+		std @tmp3
+		ldd DIVID+2,x
+		std DIVID,x
+		ldd @zero
+		std DIVID+2,x
+		ldab #16
+		stab @tmp
+		; And one more byte if R << 8 plus it is still below D
+		ldaa DIVIS,x
+		bne pre32
+		ldaa @tmp3+1
+		ldab DIVID,x
+		subd DIVIS+2,x
+		ldaa @tmp3
+		sbca DIVIS+1,x
+		bcc loop
+pre32:
+		ldaa @tmp3
+		staa @tmp2+1
+		ldaa @tmp3+1
+		ldab DIVID,x
+		std @tmp3
+		ldab DIVID+1,x
+		stab DIVID,x
+		clr DIVID+1,x
+		ldab #8
+		stab @tmp
 loop:		; Shift the dividend left and set bit 0 assuming that
 		; R >= D
 		sec
@@ -51,6 +196,8 @@ loop:		; Shift the dividend left and set bit 0 assuming that
 		rol @tmp3		; working register bottom
 		rol @tmp2+1
 		rol @tmp2
+		; If R overflowed it is certainly bigger than D
+		bcs force
 		; Do a 32bit subtract but skip writing the high 16bits
 		; back until we know the comparison
 		;
@@ -75,6 +222,13 @@ done:
 		dec @tmp
 		bne loop
 		rts
+force:
+		ldd @tmp3
+		subd DIVIS+2,x
+		std @tmp3
+		ldd @tmp2
+		sbcb DIVIS+1,x
+		sbca DIVIS,x
 		; We do want to subtract - write back the other bits
 skip:
 		; R -= D
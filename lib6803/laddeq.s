@@ -1,48 +1,43 @@
 ;
-;	On entry X points to the object
+;	Add sreg:D to a 32bit object
 ;
-;	FIXME: need a review and rewrite as we sort out the 680x calling
-;	conventions for this versus 6502
+;	laddeq		X points to the object
+;	laddeqysp	X is the offset of the object from the stack as the
+;			caller sees it with tsx
+;
+;	Both return the new value in sreg:D
 ;
 	.code
-	.export laddeqa
 	.export laddeqysp
 	.export laddeq
 
 	.setcpu 6803
 
-; In this form X is the stack offset. Turn that into X is a pointer and
-; fall into the static form
+; Turn the offset into a pointer and fall into the static form. The return
+; address means the object is 2 further up than the caller would see it
 laddeqysp:
+	std @tmp3
 	stx @tmp
-	sts @tmp2
+	tsx
+	inx
+	inx
+	stx @tmp2
 	ldd @tmp2
 	addd @tmp
 	std @tmp
 	ldx @tmp
-	inx
-laddeqa:
-	std @tmp
-	ldd 2,x		; do the low 16bits
-	addd @tmp
-	bcc l1
-	inc sreg	; carry - we don't have abcd
-l1:
-	std 2,x
-	ldd ,x
-	addd @sreg
-	std ,x
-	rts
-
-;
-;	Add the 32bit sreg/d to the variable at X
-;
+	ldd @tmp3
 laddeq:
 	addd 2,x		; Add the low word
 	std 2,x
+	pshb			; Keep it for the result
+	psha
 	; No adcd
 	ldd ,x			; High word
 	adcb @sreg+1		; 1,x + sreg+1 (byte 3)
 	adca @sreg		; ,x + sreg (byte 4)
 	std ,x
+	std @sreg
+	pula
+	pulb
 	rts
@@ -12,6 +12,7 @@ saveeax:
 	std @regsave
 	ldd @sreg
 	std @regsaveh
+	ldd @regsave	; the caller still wants D
 	rts
 resteax:
 	ldd @regsaveh
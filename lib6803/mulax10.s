@@ -1,5 +1,7 @@
 ;
 ;	Multiply D by 10
+;
+;	Written by mulgen. Uses @tmp1, X is left alone
 ;
 
 	.export mulax10
@@ -8,9 +10,9 @@
 	.code
 
 mulax10:
-	asld			; x 2
-	std @tmp		; save
-	asld			; x 4
-	asld			; x 8
-	addd @tmp		; x 10
+	std @tmp1
+	asld
+	asld
+	addd @tmp1
+	asld
 	rts
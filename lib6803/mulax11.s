@@ -0,0 +1,19 @@
+;
+;	Multiply D by 11
+;
+;	Written by mulgen. Uses @tmp1, X is left alone
+;
+
+	.export mulax11
+
+	.setcpu 6803
+	.code
+
+mulax11:
+	std @tmp1
+	asld
+	asld
+	addd @tmp1
+	asld
+	addd @tmp1
+	rts
@@ -1,5 +1,7 @@
 ;
 ;	Multiply D by 12
+;
+;	Written by mulgen. Uses @tmp1, X is left alone
 ;
 
 	.export mulax12
@@ -8,9 +10,9 @@
 	.code
 
 mulax12:
-	asld			; x 2
-	asld			; x 4
-	std @tmp		; save
-	asld			; x 8
-	addd @tmp		; x 12
+	std @tmp1
+	asld
+	addd @tmp1
+	asld
+	asld
 	rts
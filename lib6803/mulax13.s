@@ -0,0 +1,19 @@
+;
+;	Multiply D by 13
+;
+;	Written by mulgen. Uses @tmp1, X is left alone
+;
+
+	.export mulax13
+
+	.setcpu 6803
+	.code
+
+mulax13:
+	std @tmp1
+	asld
+	addd @tmp1
+	asld
+	asld
+	addd @tmp1
+	rts
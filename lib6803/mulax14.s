@@ -0,0 +1,19 @@
+;
+;	Multiply D by 14
+;
+;	Written by mulgen. Uses @tmp1, X is left alone
+;
+
+	.export mulax14
+
+	.setcpu 6803
+	.code
+
+mulax14:
+	std @tmp1
+	asld
+	asld
+	asld
+	subd @tmp1
+	asld
+	rts
@@ -0,0 +1,19 @@
+;
+;	Multiply D by 15
+;
+;	Written by mulgen. Uses @tmp1, X is left alone
+;
+
+	.export mulax15
+
+	.setcpu 6803
+	.code
+
+mulax15:
+	std @tmp1
+	asld
+	asld
+	asld
+	asld
+	subd @tmp1
+	rts
@@ -0,0 +1,19 @@
+;
+;	Multiply D by 17
+;
+;	Written by mulgen. Uses @tmp1, X is left alone
+;
+
+	.export mulax17
+
+	.setcpu 6803
+	.code
+
+mulax17:
+	std @tmp1
+	asld
+	asld
+	asld
+	asld
+	addd @tmp1
+	rts
@@ -0,0 +1,19 @@
+;
+;	Multiply D by 18
+;
+;	Written by mulgen. Uses @tmp1, X is left alone
+;
+
+	.export mulax18
+
+	.setcpu 6803
+	.code
+
+mulax18:
+	std @tmp1
+	asld
+	asld
+	asld
+	addd @tmp1
+	asld
+	rts
@@ -0,0 +1,20 @@
+;
+;	Multiply D by 19
+;
+;	Written by mulgen. Uses @tmp1, X is left alone
+;
+
+	.export mulax19
+
+	.setcpu 6803
+	.code
+
+mulax19:
+	std @tmp1
+	asld
+	asld
+	asld
+	addd @tmp1
+	asld
+	addd @tmp1
+	rts
@@ -0,0 +1,19 @@
+;
+;	Multiply D by 20
+;
+;	Written by mulgen. Uses @tmp1, X is left alone
+;
+
+	.export mulax20
+
+	.setcpu 6803
+	.code
+
+mulax20:
+	std @tmp1
+	asld
+	asld
+	addd @tmp1
+	asld
+	asld
+	rts
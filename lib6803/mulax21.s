@@ -0,0 +1,20 @@
+;
+;	Multiply D by 21
+;
+;	Written by mulgen. Uses @tmp1, X is left alone
+;
+
+	.export mulax21
+
+	.setcpu 6803
+	.code
+
+mulax21:
+	std @tmp1
+	asld
+	asld
+	addd @tmp1
+	asld
+	asld
+	addd @tmp1
+	rts
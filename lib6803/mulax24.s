@@ -0,0 +1,19 @@
+;
+;	Multiply D by 24
+;
+;	Written by mulgen. Uses @tmp1, X is left alone
+;
+
+	.export mulax24
+
+	.setcpu 6803
+	.code
+
+mulax24:
+	std @tmp1
+	asld
+	addd @tmp1
+	asld
+	asld
+	asld
+	rts
@@ -0,0 +1,20 @@
+;
+;	Multiply D by 25
+;
+;	Written by mulgen. Uses @tmp1, X is left alone
+;
+
+	.export mulax25
+
+	.setcpu 6803
+	.code
+
+mulax25:
+	std @tmp1
+	asld
+	addd @tmp1
+	asld
+	asld
+	asld
+	addd @tmp1
+	rts
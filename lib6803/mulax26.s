@@ -0,0 +1,20 @@
+;
+;	Multiply D by 26
+;
+;	Written by mulgen. Uses @tmp1, X is left alone
+;
+
+	.export mulax26
+
+	.setcpu 6803
+	.code
+
+mulax26:
+	std @tmp1
+	asld
+	addd @tmp1
+	asld
+	asld
+	addd @tmp1
+	asld
+	rts
@@ -0,0 +1,21 @@
+;
+;	Multiply D by 27
+;
+;	Written by mulgen. Uses @tmp1, X is left alone
+;
+
+	.export mulax27
+
+	.setcpu 6803
+	.code
+
+mulax27:
+	std @tmp1
+	asld
+	asld
+	asld
+	subd @tmp1
+	asld
+	asld
+	subd @tmp1
+	rts
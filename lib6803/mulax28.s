@@ -0,0 +1,20 @@
+;
+;	Multiply D by 28
+;
+;	Written by mulgen. Uses @tmp1, X is left alone
+;
+
+	.export mulax28
+
+	.setcpu 6803
+	.code
+
+mulax28:
+	std @tmp1
+	asld
+	asld
+	asld
+	subd @tmp1
+	asld
+	asld
+	rts
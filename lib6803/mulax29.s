@@ -0,0 +1,21 @@
+;
+;	Multiply D by 29
+;
+;	Written by mulgen. Uses @tmp1, X is left alone
+;
+
+	.export mulax29
+
+	.setcpu 6803
+	.code
+
+mulax29:
+	std @tmp1
+	asld
+	asld
+	asld
+	subd @tmp1
+	asld
+	asld
+	addd @tmp1
+	rts
@@ -1,6 +1,9 @@
 ;
 ;	Multiply D by 3
 ;
+;	Written by mulgen. Uses @tmp1, X is left alone
+;
+
 	.export mulax3
 
 	.setcpu 6803
@@ -8,6 +11,6 @@
 
 mulax3:
 	std @tmp1
-	lsld
+	asld
 	addd @tmp1
 	rts
@@ -0,0 +1,20 @@
+;
+;	Multiply D by 30
+;
+;	Written by mulgen. Uses @tmp1, X is left alone
+;
+
+	.export mulax30
+
+	.setcpu 6803
+	.code
+
+mulax30:
+	std @tmp1
+	asld
+	asld
+	asld
+	asld
+	subd @tmp1
+	asld
+	rts
@@ -0,0 +1,20 @@
+;
+;	Multiply D by 31
+;
+;	Written by mulgen. Uses @tmp1, X is left alone
+;
+
+	.export mulax31
+
+	.setcpu 6803
+	.code
+
+mulax31:
+	std @tmp1
+	asld
+	asld
+	asld
+	asld
+	asld
+	subd @tmp1
+	rts
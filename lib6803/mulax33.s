@@ -0,0 +1,20 @@
+;
+;	Multiply D by 33
+;
+;	Written by mulgen. Uses @tmp1, X is left alone
+;
+
+	.export mulax33
+
+	.setcpu 6803
+	.code
+
+mulax33:
+	std @tmp1
+	asld
+	asld
+	asld
+	asld
+	asld
+	addd @tmp1
+	rts
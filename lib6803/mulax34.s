@@ -0,0 +1,20 @@
+;
+;	Multiply D by 34
+;
+;	Written by mulgen. Uses @tmp1, X is left alone
+;
+
+	.export mulax34
+
+	.setcpu 6803
+	.code
+
+mulax34:
+	std @tmp1
+	asld
+	asld
+	asld
+	asld
+	addd @tmp1
+	asld
+	rts
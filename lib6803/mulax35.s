@@ -0,0 +1,21 @@
+;
+;	Multiply D by 35
+;
+;	Written by mulgen. Uses @tmp1, X is left alone
+;
+
+	.export mulax35
+
+	.setcpu 6803
+	.code
+
+mulax35:
+	std @tmp1
+	asld
+	asld
+	asld
+	asld
+	addd @tmp1
+	asld
+	addd @tmp1
+	rts
@@ -0,0 +1,20 @@
+;
+;	Multiply D by 36
+;
+;	Written by mulgen. Uses @tmp1, X is left alone
+;
+
+	.export mulax36
+
+	.setcpu 6803
+	.code
+
+mulax36:
+	std @tmp1
+	asld
+	asld
+	asld
+	addd @tmp1
+	asld
+	asld
+	rts
@@ -0,0 +1,21 @@
+;
+;	Multiply D by 37
+;
+;	Written by mulgen. Uses @tmp1, X is left alone
+;
+
+	.export mulax37
+
+	.setcpu 6803
+	.code
+
+mulax37:
+	std @tmp1
+	asld
+	asld
+	asld
+	addd @tmp1
+	asld
+	asld
+	addd @tmp1
+	rts
@@ -0,0 +1,21 @@
+;
+;	Multiply D by 38
+;
+;	Written by mulgen. Uses @tmp1, X is left alone
+;
+
+	.export mulax38
+
+	.setcpu 6803
+	.code
+
+mulax38:
+	std @tmp1
+	asld
+	asld
+	asld
+	addd @tmp1
+	asld
+	addd @tmp1
+	asld
+	rts
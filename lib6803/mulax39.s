@@ -0,0 +1,21 @@
+;
+;	Multiply D by 39
+;
+;	Written by mulgen. Uses @tmp1, X is left alone
+;
+
+	.export mulax39
+
+	.setcpu 6803
+	.code
+
+mulax39:
+	std @tmp1
+	asld
+	asld
+	addd @tmp1
+	asld
+	asld
+	asld
+	subd @tmp1
+	rts
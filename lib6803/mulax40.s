@@ -0,0 +1,20 @@
+;
+;	Multiply D by 40
+;
+;	Written by mulgen. Uses @tmp1, X is left alone
+;
+
+	.export mulax40
+
+	.setcpu 6803
+	.code
+
+mulax40:
+	std @tmp1
+	asld
+	asld
+	addd @tmp1
+	asld
+	asld
+	asld
+	rts
@@ -0,0 +1,21 @@
+;
+;	Multiply D by 41
+;
+;	Written by mulgen. Uses @tmp1, X is left alone
+;
+
+	.export mulax41
+
+	.setcpu 6803
+	.code
+
+mulax41:
+	std @tmp1
+	asld
+	asld
+	addd @tmp1
+	asld
+	asld
+	asld
+	addd @tmp1
+	rts
@@ -0,0 +1,21 @@
+;
+;	Multiply D by 42
+;
+;	Written by mulgen. Uses @tmp1, X is left alone
+;
+
+	.export mulax42
+
+	.setcpu 6803
+	.code
+
+mulax42:
+	std @tmp1
+	asld
+	asld
+	addd @tmp1
+	asld
+	asld
+	addd @tmp1
+	asld
+	rts
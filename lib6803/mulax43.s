@@ -0,0 +1,22 @@
+;
+;	Multiply D by 43
+;
+;	Written by mulgen. Uses @tmp1, X is left alone
+;
+
+	.export mulax43
+
+	.setcpu 6803
+	.code
+
+mulax43:
+	std @tmp1
+	asld
+	asld
+	addd @tmp1
+	asld
+	asld
+	addd @tmp1
+	asld
+	addd @tmp1
+	rts
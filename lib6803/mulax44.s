@@ -0,0 +1,21 @@
+;
+;	Multiply D by 44
+;
+;	Written by mulgen. Uses @tmp1, X is left alone
+;
+
+	.export mulax44
+
+	.setcpu 6803
+	.code
+
+mulax44:
+	std @tmp1
+	asld
+	asld
+	addd @tmp1
+	asld
+	addd @tmp1
+	asld
+	asld
+	rts
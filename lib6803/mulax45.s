@@ -0,0 +1,22 @@
+;
+;	Multiply D by 45
+;
+;	Written by mulgen. Uses @tmp1, X is left alone
+;
+
+	.export mulax45
+
+	.setcpu 6803
+	.code
+
+mulax45:
+	std @tmp1
+	asld
+	asld
+	asld
+	asld
+	subd @tmp1
+	std @tmp1
+	asld
+	addd @tmp1
+	rts
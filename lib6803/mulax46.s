@@ -0,0 +1,22 @@
+;
+;	Multiply D by 46
+;
+;	Written by mulgen. Uses @tmp1, X is left alone
+;
+
+	.export mulax46
+
+	.setcpu 6803
+	.code
+
+mulax46:
+	std @tmp1
+	asld
+	asld
+	subd @tmp1
+	asld
+	asld
+	asld
+	subd @tmp1
+	asld
+	rts
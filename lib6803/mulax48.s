@@ -0,0 +1,20 @@
+;
+;	Multiply D by 48
+;
+;	Written by mulgen. Uses @tmp1, X is left alone
+;
+
+	.export mulax48
+
+	.setcpu 6803
+	.code
+
+mulax48:
+	std @tmp1
+	asld
+	addd @tmp1
+	asld
+	asld
+	asld
+	asld
+	rts
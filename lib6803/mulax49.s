@@ -0,0 +1,21 @@
+;
+;	Multiply D by 49
+;
+;	Written by mulgen. Uses @tmp1, X is left alone
+;
+
+	.export mulax49
+
+	.setcpu 6803
+	.code
+
+mulax49:
+	std @tmp1
+	asld
+	addd @tmp1
+	asld
+	asld
+	asld
+	asld
+	addd @tmp1
+	rts
@@ -1,6 +1,9 @@
 ;
 ;	Multiply D by 5
 ;
+;	Written by mulgen. Uses @tmp1, X is left alone
+;
+
 	.export mulax5
 
 	.setcpu 6803
@@ -8,7 +11,7 @@
 
 mulax5:
 	std @tmp1
-	lsld
-	lsld
+	asld
+	asld
 	addd @tmp1
 	rts
@@ -0,0 +1,21 @@
+;
+;	Multiply D by 50
+;
+;	Written by mulgen. Uses @tmp1, X is left alone
+;
+
+	.export mulax50
+
+	.setcpu 6803
+	.code
+
+mulax50:
+	std @tmp1
+	asld
+	addd @tmp1
+	asld
+	asld
+	asld
+	addd @tmp1
+	asld
+	rts
@@ -0,0 +1,22 @@
+;
+;	Multiply D by 51
+;
+;	Written by mulgen. Uses @tmp1, X is left alone
+;
+
+	.export mulax51
+
+	.setcpu 6803
+	.code
+
+mulax51:
+	std @tmp1
+	asld
+	asld
+	asld
+	asld
+	addd @tmp1
+	std @tmp1
+	asld
+	addd @tmp1
+	rts
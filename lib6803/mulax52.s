@@ -0,0 +1,21 @@
+;
+;	Multiply D by 52
+;
+;	Written by mulgen. Uses @tmp1, X is left alone
+;
+
+	.export mulax52
+
+	.setcpu 6803
+	.code
+
+mulax52:
+	std @tmp1
+	asld
+	addd @tmp1
+	asld
+	asld
+	addd @tmp1
+	asld
+	asld
+	rts
@@ -0,0 +1,22 @@
+;
+;	Multiply D by 53
+;
+;	Written by mulgen. Uses @tmp1, X is left alone
+;
+
+	.export mulax53
+
+	.setcpu 6803
+	.code
+
+mulax53:
+	std @tmp1
+	asld
+	addd @tmp1
+	asld
+	asld
+	addd @tmp1
+	asld
+	asld
+	addd @tmp1
+	rts
@@ -0,0 +1,22 @@
+;
+;	Multiply D by 54
+;
+;	Written by mulgen. Uses @tmp1, X is left alone
+;
+
+	.export mulax54
+
+	.setcpu 6803
+	.code
+
+mulax54:
+	std @tmp1
+	asld
+	asld
+	asld
+	subd @tmp1
+	asld
+	asld
+	subd @tmp1
+	asld
+	rts
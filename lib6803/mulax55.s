@@ -0,0 +1,22 @@
+;
+;	Multiply D by 55
+;
+;	Written by mulgen. Uses @tmp1, X is left alone
+;
+
+	.export mulax55
+
+	.setcpu 6803
+	.code
+
+mulax55:
+	std @tmp1
+	asld
+	asld
+	asld
+	subd @tmp1
+	asld
+	asld
+	asld
+	subd @tmp1
+	rts
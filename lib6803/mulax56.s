@@ -0,0 +1,21 @@
+;
+;	Multiply D by 56
+;
+;	Written by mulgen. Uses @tmp1, X is left alone
+;
+
+	.export mulax56
+
+	.setcpu 6803
+	.code
+
+mulax56:
+	std @tmp1
+	asld
+	asld
+	asld
+	subd @tmp1
+	asld
+	asld
+	asld
+	rts
@@ -0,0 +1,22 @@
+;
+;	Multiply D by 57
+;
+;	Written by mulgen. Uses @tmp1, X is left alone
+;
+
+	.export mulax57
+
+	.setcpu 6803
+	.code
+
+mulax57:
+	std @tmp1
+	asld
+	asld
+	asld
+	subd @tmp1
+	asld
+	asld
+	asld
+	addd @tmp1
+	rts
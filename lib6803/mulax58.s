@@ -0,0 +1,22 @@
+;
+;	Multiply D by 58
+;
+;	Written by mulgen. Uses @tmp1, X is left alone
+;
+
+	.export mulax58
+
+	.setcpu 6803
+	.code
+
+mulax58:
+	std @tmp1
+	asld
+	asld
+	asld
+	subd @tmp1
+	asld
+	asld
+	addd @tmp1
+	asld
+	rts
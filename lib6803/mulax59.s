@@ -0,0 +1,22 @@
+;
+;	Multiply D by 59
+;
+;	Written by mulgen. Uses @tmp1, X is left alone
+;
+
+	.export mulax59
+
+	.setcpu 6803
+	.code
+
+mulax59:
+	std @tmp1
+	asld
+	asld
+	asld
+	asld
+	subd @tmp1
+	asld
+	asld
+	subd @tmp1
+	rts
@@ -1,6 +1,9 @@
 ;
-;	Multiply D by 3
+;	Multiply D by 6
 ;
+;	Written by mulgen. Uses @tmp1, X is left alone
+;
+
 	.export mulax6
 
 	.setcpu 6803
@@ -8,7 +11,7 @@
 
 mulax6:
 	std @tmp1
-	lsld
+	asld
 	addd @tmp1
-	lsld
+	asld
 	rts
@@ -0,0 +1,21 @@
+;
+;	Multiply D by 60
+;
+;	Written by mulgen. Uses @tmp1, X is left alone
+;
+
+	.export mulax60
+
+	.setcpu 6803
+	.code
+
+mulax60:
+	std @tmp1
+	asld
+	asld
+	asld
+	asld
+	subd @tmp1
+	asld
+	asld
+	rts
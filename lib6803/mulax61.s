@@ -0,0 +1,22 @@
+;
+;	Multiply D by 61
+;
+;	Written by mulgen. Uses @tmp1, X is left alone
+;
+
+	.export mulax61
+
+	.setcpu 6803
+	.code
+
+mulax61:
+	std @tmp1
+	asld
+	asld
+	asld
+	asld
+	subd @tmp1
+	asld
+	asld
+	addd @tmp1
+	rts
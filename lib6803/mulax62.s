@@ -0,0 +1,21 @@
+;
+;	Multiply D by 62
+;
+;	Written by mulgen. Uses @tmp1, X is left alone
+;
+
+	.export mulax62
+
+	.setcpu 6803
+	.code
+
+mulax62:
+	std @tmp1
+	asld
+	asld
+	asld
+	asld
+	asld
+	subd @tmp1
+	asld
+	rts
@@ -0,0 +1,21 @@
+;
+;	Multiply D by 63
+;
+;	Written by mulgen. Uses @tmp1, X is left alone
+;
+
+	.export mulax63
+
+	.setcpu 6803
+	.code
+
+mulax63:
+	std @tmp1
+	asld
+	asld
+	asld
+	asld
+	asld
+	asld
+	subd @tmp1
+	rts
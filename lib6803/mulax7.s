@@ -1,6 +1,9 @@
 ;
 ;	Multiply D by 7
 ;
+;	Written by mulgen. Uses @tmp1, X is left alone
+;
+
 	.export mulax7
 
 	.setcpu 6803
@@ -8,9 +11,8 @@
 
 mulax7:
 	std @tmp1
-	lsld
-	lsld
-	addd @tmp1
-	addd @tmp1
-	addd @tmp1
+	asld
+	asld
+	asld
+	subd @tmp1
 	rts
@@ -1,6 +1,9 @@
 ;
 ;	Multiply D by 9
 ;
+;	Written by mulgen. Uses @tmp1, X is left alone
+;
+
 	.export mulax9
 
 	.setcpu 6803
@@ -8,8 +11,8 @@
 
 mulax9:
 	std @tmp1
-	lsld
-	lsld
-	lsld
+	asld
+	asld
+	asld
 	addd @tmp1
 	rts
@@ -1,7 +1,10 @@
 ;
-;	Right shift 32bit signed
+;	Right shift 32bit signed and unsigned
+;
+;	Whole bytes are moved and then at most 7 bits are shifted
 ;
 	.export tosasreax
+	.export tosshreax
 
 	.setcpu 6803
 	.code
@@ -9,24 +12,70 @@
 tosasreax:	
 	cmpb	#32
 	bcc	ret0
-	tstb
-	beq noshift
 	tsx
-loop:
+	cmpb	#8
+	bcs	sbits
+sbytes:
+	ldaa	4,x
+	staa	5,x
+	ldaa	3,x
+	staa	4,x
+	ldaa	2,x
+	staa	3,x
+	asla			; Sign into carry
+	ldaa	#0
+	sbca	#0		; and make it 0 or $FF
+	staa	2,x
+	subb	#8
+	cmpb	#8
+	bcc	sbytes
+sbits:
+	tstb
+	beq	done
+sloop:
 	asr	2,x
 	ror	3,x
 	ror	4,x
 	ror	5,x
 	decb
-	bne loop
-	ldd	2,x
+	bne	sloop
+done:
 	; Get the value
+	ldd	2,x
 	std	@sreg
 	ldd	4,x
-noshift:
-	jmp pop4
+	jmp	pop4
 ret0:
 	clra
 	clrb
 	std	@sreg
-	bra	noshift
+	jmp	pop4
+
+tosshreax:
+	cmpb	#32
+	bcc	ret0
+	tsx
+	cmpb	#8
+	bcs	ubits
+ubytes:
+	ldaa	4,x
+	staa	5,x
+	ldaa	3,x
+	staa	4,x
+	ldaa	2,x
+	staa	3,x
+	clr	2,x
+	subb	#8
+	cmpb	#8
+	bcc	ubytes
+ubits:
+	tstb
+	beq	done
+uloop:
+	lsr	2,x
+	ror	3,x
+	ror	4,x
+	ror	5,x
+	decb
+	bne	uloop
+	bra	done
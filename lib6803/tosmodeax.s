@@ -13,16 +13,20 @@
 tosmodeax:
 		; make working space
 		psha
-		; Arrange stack for the divide helper. TOS is already right
-		; so push the other 4 bytes we need. The divide helper knows
-		; about the fact there is junk (return address) between the
-		; two
+		; The sign of the divisor makes no difference to the
+		; remainder
 		ldaa @sreg
-		staa @tmp4
 		bpl nosignfix
+		pula
 		jsr negeax
+		bra signfixed
 nosignfix:
 		pula
+signfixed:
+		; Arrange stack for the divide helper. TOS is already right
+		; so push the other 4 bytes we need. The divide helper knows
+		; about the fact there is junk (return address) between the
+		; two
 		pshb
 		psha
 		ldx @sreg
@@ -32,6 +36,7 @@ nosignfix:
 		;
 		tsx
 		ldaa 6,x	; sign of TOS
+		staa @tmp4
 		bpl nosignfix2
 		ldd 8,x
 		subd #1
@@ -45,19 +50,17 @@ nosignfix:
 		com 8,x
 		com 9,x
 nosignfix2:
-		tsx
 		jsr div32x32
 		pulx
 		pulx
 		;
 		;	At this point @tmp2/@tmp3 hold the positive signed
-		;	dividend
+		;	remainder
 		;
 		ldd @tmp2
 		std @sreg
 		ldaa @tmp4
-		bita #0x80		; check if negative dividend
-		beq nonega
+		bpl nonega		; check if negative dividend
 		ldd @tmp3
 		jsr negeax
 		jmp pop4
@@ -0,0 +1,38 @@
+;
+;	D = (D * X) >> 16 (unsigned)
+;
+;	Used for division by a constant. The compiler relies upon the
+;	original value of D being left in @tmp
+;
+	.export umulhiax
+
+	.setcpu 6803
+	.code
+
+umulhiax:
+	std @tmp
+	stx @tmp1
+	ldaa @tmp+1		; low x low, we only want the top byte
+	ldab @tmp1+1
+	mul
+	tab
+	clra
+	std @tmp2
+	ldaa @tmp		; high x low
+	ldab @tmp1+1
+	mul
+	addd @tmp2		; cannot overflow
+	std @tmp2
+	ldaa @tmp+1		; low x high
+	ldab @tmp1
+	mul
+	addd @tmp2		; may carry into bit 16
+	tab
+	ldaa #0			; keeps the carry
+	rola
+	std @tmp2
+	ldaa @tmp		; high x high
+	ldab @tmp1
+	mul
+	addd @tmp2
+	rts
@@ -13,17 +13,18 @@ start:
 	staa @zero+1
 	ldx #__bss
 	ldaa #>__bss_size
-	orab #<__bss_size
+	oraa #<__bss_size
 	beq nobss
 	ldaa #>__bss_size
 	ldab #<__bss_size
 clear_bss:
 	clr ,x
 	inx
-	decb
-	bcc clear_bss
-	deca
-	bcc clear_bss
+	subb #1
+	sbca #0
+	bne clear_bss
+	tstb
+	bne clear_bss
 nobss:
 	sts exitsp
 	psha
@@ -0,0 +1,186 @@
+;
+;	printf and sprintf for a format that cc68 couldn't take apart at
+;	compile time. The format is walked here and the same emitters are
+;	called, so the same conversions are understood: %d %i %u %x %X %c
+;	%s and %%, an l for a long, the '-' and '0' flags and a width of up
+;	to 63. Anything else is written out as it is.
+;
+;	As these are variadic the caller removes the arguments and passes
+;	the size of those after the fixed ones in B, so the format is at
+;	2+B,x after a tsx and the arguments follow it down the stack.
+;
+		.export _printf
+		.export _sprintf
+
+		.code
+
+_sprintf:
+		tsx
+		bsr pfargs
+		ldaa 2,x
+		ldab 3,x
+		jsr pfbuf
+		bra pfrun
+_printf:
+		tsx
+		bsr pfargs
+		jsr pfcon
+		bra pfrun
+;
+;	Point pfap at the format
+;
+pfargs:
+		stx pfap
+		addb pfap+1
+		stab pfap+1
+		bcc pfargs1
+		inc pfap
+pfargs1:
+		ldx pfap
+		inx
+		inx
+		stx pfap
+		rts
+
+pfrun:
+		ldx pfap
+		ldx ,x
+pfnext:
+		ldab ,x
+		beq pfdone
+		inx
+		cmpb #'%'
+		beq pfpct
+pfout:
+		jsr pfchr
+		bra pfnext
+pfdone:
+		jmp pfend
+
+pfpct:
+		clr pfw
+		clr pfwn
+		clr pflong
+pfflag:
+		ldab ,x
+		inx
+		ldaa #$80
+		cmpb #'-'
+		beq pfflag1
+		ldaa #$40
+		cmpb #'0'
+		bne pfwidth
+pfflag1:
+		oraa pfw
+		staa pfw
+		bra pfflag
+pfwidth:
+		cmpb #'0'
+		bcs pfsize
+		cmpb #'9'+1
+		bcc pfsize
+		subb #'0'
+		ldaa pfwn
+		asla
+		asla
+		adda pfwn
+		asla
+		aba
+		staa pfwn
+		ldab ,x
+		inx
+		bra pfwidth
+pfsize:
+		cmpb #'l'
+		bne pfconv
+		inc pflong
+		ldab ,x
+		inx
+pfconv:
+		stx pffp
+		ldaa pfwn
+		cmpa #63
+		bls pfconv1
+		ldaa #63
+pfconv1:
+		oraa pfw
+		staa pfwid
+		ldx #pftab
+pfconv2:
+		tst ,x
+		beq pfother
+		cmpb ,x
+		beq pffound
+		inx
+		inx
+		inx
+		inx
+		inx
+		bra pfconv2
+;
+;	Not one we know, just write it out
+;
+pfother:
+		clr pfwid
+		ldx pffp
+		tstb
+		beq pfdone
+		bra pfout
+pffound:
+		tst pflong
+		beq pffound1
+		inx
+		inx
+pffound1:
+		ldx 1,x
+		stx pfcall
+		ldx pfap
+		dex
+		dex
+		tst pflong
+		beq pfint
+		dex
+		dex
+		ldaa ,x
+		ldab 1,x
+		staa @sreg
+		stab @sreg+1
+		stx pfap
+		ldaa 2,x
+		ldab 3,x
+		bra pfcall1
+pfint:
+		stx pfap
+		ldaa ,x
+		ldab 1,x
+pfcall1:
+		ldx pfcall
+		jsr ,x
+		ldx pffp
+		jmp pfnext
+
+pftab:
+		.byte 'd'
+		.word pfd,pfld
+		.byte 'i'
+		.word pfd,pfld
+		.byte 'u'
+		.word pfu,pflu
+		.byte 'x'
+		.word pfx,pflx
+		.byte 'X'
+		.word pfX,pflX
+		.byte 'c'
+		.word pfc,pfc
+		.byte 's'
+		.word pfs,pfs
+		.byte 0
+
+		.bss
+
+pfap:		.ds 2
+pffp:		.ds 2
+pfcall:		.ds 2
+pfw:		.ds 1
+pfwn:		.ds 1
+pflong:		.ds 1
@@ -0,0 +1,20 @@
+;
+;	Formatted output of the signed int in D
+;
+		.export pfd
+
+		.code
+
+pfd:
+		clr pfsgn
+		tsta
+		bpl pfd1
+		nega
+		negb
+		sbca #0
+		psha
+		ldaa #'-'
+		staa pfsgn
+		pula
+pfd1:
+		jmp pfun
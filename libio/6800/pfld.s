@@ -0,0 +1,18 @@
+;
+;	Formatted output of the signed long in sreg:D
+;
+		.export pfld
+
+		.code
+
+pfld:
+		clr pfsgn
+		tst @sreg
+		bpl pfld1
+		jsr negeax
+		psha
+		ldaa #'-'
+		staa pfsgn
+		pula
+pfld1:
+		jmp pflun
@@ -0,0 +1,80 @@
+;
+;	Formatted output of the unsigned long in sreg:D. pflun leaves the
+;	sign alone for pfld.
+;
+		.export pflu
+		.export pflun
+
+		.code
+
+pflu:
+		clr pfsgn
+pflun:
+		staa pflv+2
+		stab pflv+3
+		ldaa @sreg
+		ldab @sreg+1
+		staa pflv
+		stab pflv+1
+		ldx #pfdig
+		stx pfop
+		ldx #pow10
+pfl1:
+		clr @tmp
+pfl2:
+		ldaa pflv+3
+		suba 3,x
+		staa pflv+3
+		ldaa pflv+2
+		sbca 2,x
+		staa pflv+2
+		ldaa pflv+1
+		sbca 1,x
+		staa pflv+1
+		ldaa pflv
+		sbca ,x
+		staa pflv
+		bcs pfl3
+		inc @tmp
+		bra pfl2
+pfl3:
+		ldaa pflv+3
+		adda 3,x
+		staa pflv+3
+		ldaa pflv+2
+		adca 2,x
+		staa pflv+2
+		ldaa pflv+1
+		adca 1,x
+		staa pflv+1
+		ldaa pflv
+		adca ,x
+		staa pflv
+		stx @tmp1
+		ldab @tmp
+		jsr pfnib
+		ldx @tmp1
+		inx
+		inx
+		inx
+		inx
+		cpx #pow10+36
+		bne pfl1
+		ldab pflv+3
+		jsr pfnib
+		jmp pfnum
+
+pow10:
+		.word $3B9A,$CA00
+		.word $05F5,$E100
+		.word $0098,$9680
+		.word $000F,$4240
+		.word $0001,$86A0
+		.word $0000,$2710
+		.word $0000,$03E8
+		.word $0000,$0064
+		.word $0000,$000A
+
+		.bss
+
+pflv:		.ds 4
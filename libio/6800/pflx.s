@@ -0,0 +1,33 @@
+;
+;	Formatted output of the unsigned long in sreg:D in hex, pflX for
+;	capitals
+;
+		.export pflx
+		.export pflX
+
+		.code
+
+pflX:
+		psha
+		ldaa #7
+		bra pflx1
+pflx:
+		psha
+		ldaa #39
+pflx1:
+		staa pfcase
+		clr pfsgn
+		ldx #pfdig
+		stx pfop
+		pula
+		pshb
+		psha
+		ldab @sreg
+		jsr pfhex
+		ldab @sreg+1
+		jsr pfhex
+		pulb
+		jsr pfhex
+		pulb
+		jsr pfhex
+		jmp pfnum
@@ -0,0 +1,47 @@
+;
+;	Formatted output of the unsigned int in D. pfun leaves the sign
+;	alone for pfd. The digits come from subtracting powers of ten which
+;	is far cheaper than dividing on a CPU with no divide.
+;
+		.export pfu
+		.export pfun
+
+		.code
+
+pfu:
+		clr pfsgn
+pfun:
+		ldx #pfdig
+		stx pfop
+		ldx #pow10
+pfu1:
+		clr @tmp
+pfu2:
+		subb 1,x
+		sbca ,x
+		bcs pfu3
+		inc @tmp
+		bra pfu2
+pfu3:
+		addb 1,x
+		adca ,x
+		stx @tmp1
+		pshb
+		psha
+		ldab @tmp
+		jsr pfnib
+		pula
+		pulb
+		ldx @tmp1
+		inx
+		inx
+		cpx #pow10+8
+		bne pfu1
+		jsr pfnib
+		jmp pfnum
+
+pow10:
+		.word 10000
+		.word 1000
+		.word 100
+		.word 10
@@ -0,0 +1,40 @@
+;
+;	Formatted output of the unsigned int in D in hex, pfX for capitals.
+;	pfhex adds the two digits of B to the number for pflx.
+;
+		.export pfx
+		.export pfX
+		.export pfhex
+
+		.code
+
+pfX:
+		psha
+		ldaa #7
+		bra pfx1
+pfx:
+		psha
+		ldaa #39
+pfx1:
+		staa pfcase
+		clr pfsgn
+		ldx #pfdig
+		stx pfop
+		pula
+		pshb
+		tab
+		bsr pfhex
+		pulb
+		bsr pfhex
+		jmp pfnum
+
+pfhex:
+		pshb
+		lsrb
+		lsrb
+		lsrb
+		lsrb
+		jsr pfnib
+		pulb
+		andb #$0F
+		jmp pfnib
@@ -0,0 +1,21 @@
+;
+;	Formatted output of the signed int in D
+;
+		.export pfd
+
+		.setcpu 6803
+		.code
+
+pfd:
+		clr pfsgn
+		tsta
+		bpl pfd1
+		nega
+		negb
+		sbca #0
+		psha
+		ldaa #'-'
+		staa pfsgn
+		pula
+pfd1:
+		jmp pfun
@@ -0,0 +1,66 @@
+;
+;	Formatted output of the unsigned long in sreg:D. pflun leaves the
+;	sign alone for pfld.
+;
+		.export pflu
+		.export pflun
+
+		.setcpu 6803
+		.code
+
+pflu:
+		clr pfsgn
+pflun:
+		std pflv+2
+		ldd @sreg
+		std pflv
+		ldx #pfdig
+		stx pfop
+		ldx #pow10
+pfl1:
+		clr @tmp
+pfl2:
+		ldd pflv+2
+		subd 2,x
+		std pflv+2
+		ldd pflv
+		sbcb 1,x
+		sbca ,x
+		std pflv
+		bcs pfl3
+		inc @tmp
+		bra pfl2
+pfl3:
+		ldd pflv+2
+		addd 2,x
+		std pflv+2
+		ldd pflv
+		adcb 1,x
+		adca ,x
+		std pflv
+		pshx
+		ldab @tmp
+		jsr pfnib
+		pulx
+		ldab #4
+		abx
+		cpx #pow10+36
+		bne pfl1
+		ldab pflv+3
+		jsr pfnib
+		jmp pfnum
+
+pow10:
+		.word $3B9A,$CA00
+		.word $05F5,$E100
+		.word $0098,$9680
+		.word $000F,$4240
+		.word $0001,$86A0
+		.word $0000,$2710
+		.word $0000,$03E8
+		.word $0000,$0064
+		.word $0000,$000A
+
+		.bss
+
+pflv:		.ds 4
@@ -0,0 +1,207 @@
+;
+;	Formatted output. cc68 takes a printf or sprintf with a literal
+;	format apart at compile time and calls these directly, _printf.s
+;	walks any other format and calls the same code.
+;
+;	pfcon		send the output to the console (__putc)
+;	pfbuf		send the output to the buffer in D
+;	pfchr		output the character in B, preserves X
+;	pfstr		output the string in D
+;	pfs		output the string in D padded to the field
+;	pfc		output the character in B padded to the field
+;	pfend		finish, terminate any buffer and return the count in D
+;
+;	The numbers are in their own modules (pfd, pfu, pfx, pfld, pflu,
+;	pflx) so a program only gets the conversions it uses.
+;
+;	pfwid is the field for the next conversion, bit 7 to left justify,
+;	bit 6 to pad with zeros and the width in bits 0-5. Each conversion
+;	clears it again.
+;
+		.export pfcon
+		.export pfbuf
+		.export pfchr
+		.export pfstr
+		.export pfs
+		.export pfc
+		.export pfend
+		.export pfnib
+		.export pfnum
+		.export pfwid
+		.export pfsgn
+		.export pfcase
+		.export pfop
+		.export pfdig
+
+		.setcpu 6803
+		.code
+
+pfcon:
+		ldd @zero
+pfbuf:
+		std pfptr
+		ldd @zero
+		std pfcnt
+		staa pfwid
+		rts
+
+pfend:
+		ldx pfptr
+		beq pfcount
+		clr ,x
+pfcount:
+		ldd pfcnt
+		rts
+
+pfchr:
+		inc pfcnt+1
+		bne pfchr1
+		inc pfcnt
+pfchr1:
+		tst pfptr
+		bne pfchr2
+		tst pfptr+1
+		bne pfchr2
+		jmp __putc
+pfchr2:
+		pshx
+		ldx pfptr
+		stab ,x
+		inx
+		stx pfptr
+		pulx
+		rts
+
+pfstr:
+		std pfsp
+		ldx pfsp
+pfstr1:
+		ldab ,x
+		beq pfnone
+		bsr pfchr
+		inx
+		bra pfstr1
+
+pfc:
+		ldx #pfdig
+		stab ,x
+		clr 1,x
+		clrb
+		bra pffld
+
+pfs:
+		std pfsp
+		ldx pfsp
+		clrb
+;
+;	Output the string at X padded to the field. B is a sign to go in
+;	front of it or 0
+;
+pffld:
+		stab pfsgn
+		stx pfsp
+		tstb
+		beq pflen
+		ldab #1
+pflen:
+		tst ,x
+		beq pfgot
+		incb
+		inx
+		bra pflen
+pfgot:
+		ldaa pfwid
+		clr pfwid
+		staa pfflg
+		anda #$3F
+		sba
+		bcc pfpad0
+		clra
+pfpad0:
+		staa pfpad
+		ldaa pfflg
+		bmi pfleft
+		asla
+		bmi pfzero
+		bsr pfspc
+		bsr pfsign
+		bra pfbody
+pfzero:
+		bsr pfsign
+		ldab #'0'
+		bsr pfpadb
+		bra pfbody
+pfleft:
+		bsr pfsign
+		bsr pfbody
+pfspc:
+		ldab #' '
+pfpadb:
+		stab pfpc
+pfpad1:
+		tst pfpad
+		beq pfnone
+		ldab pfpc
+		jsr pfchr
+		dec pfpad
+		bra pfpad1
+pfsign:
+		ldab pfsgn
+		beq pfnone
+		jmp pfchr
+pfbody:
+		ldx pfsp
+		bra pfstr1
+pfnone:
+		rts
+
+;
+;	Add the digit in B to the number being built at pfop. Leading
+;	zeros are dropped
+;
+pfnib:
+		ldx pfop
+		tstb
+		bne pfnib1
+		cpx #pfdig
+		beq pfnone
+pfnib1:
+		addb #'0'
+		cmpb #'9'+1
+		bcs pfnib2
+		addb pfcase
+pfnib2:
+		stab ,x
+		inx
+		stx pfop
+		rts
+
+;
+;	The digits are done, output them with the sign in pfsgn
+;
+pfnum:
+		ldx pfop
+		cpx #pfdig
+		bne pfnum1
+		ldab #'0'
+		stab ,x
+		inx
+pfnum1:
+		clr ,x
+		ldx #pfdig
+		ldab pfsgn
+		jmp pffld
+
+		.bss
+
+pfptr:		.ds 2
+pfcnt:		.ds 2
+pfsp:		.ds 2
+pfop:		.ds 2
+pfwid:		.ds 1
+pfflg:		.ds 1
+pfpad:		.ds 1
+pfpc:		.ds 1
+pfsgn:		.ds 1
+pfcase:		.ds 1
+pfdig:		.ds 12
@@ -0,0 +1,46 @@
+;
+;	Formatted output of the unsigned int in D. pfun leaves the sign
+;	alone for pfd. The digits come from subtracting powers of ten which
+;	is far cheaper than dividing.
+;
+		.export pfu
+		.export pfun
+
+		.setcpu 6803
+		.code
+
+pfu:
+		clr pfsgn
+pfun:
+		ldx #pfdig
+		stx pfop
+		ldx #pow10
+pfu1:
+		clr @tmp
+pfu2:
+		subd ,x
+		bcs pfu3
+		inc @tmp
+		bra pfu2
+pfu3:
+		addd ,x
+		pshx
+		pshb
+		psha
+		ldab @tmp
+		jsr pfnib
+		pula
+		pulb
+		pulx
+		inx
+		inx
+		cpx #pow10+8
+		bne pfu1
+		jsr pfnib
+		jmp pfnum
+
+pow10:
+		.word 10000
+		.word 1000
+		.word 100
+		.word 10
@@ -0,0 +1,8 @@
+#
+#	The constant multiply helpers each 680x library carries, one mulaxN
+#	member for each value here. The compiler calls them for the values
+#	MulHelper() in common/mulplan.c accepts, so keep the two in step.
+#
+MULAX = 3 5 6 7 9 10 11 12 13 14 15 17 18 19 20 21 22 23 24 25 26
+MULAX += 27 28 29 30 31 33 34 35 36 37 38 39 40 41 42 43 44 45 46 47
+MULAX += 48 49 50 51 52 53 54 55 56 57 58 59 60 61 62 63
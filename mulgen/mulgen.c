@@ -0,0 +1,124 @@
+/*
+ *	Write the constant multiply helpers for the runtime libraries
+ *
+ *	mulgen [-c cpu] [-s factor] [-i] [-w width] value ...
+ *
+ *	By default each value gets a library member mulaxN that multiplies
+ *	D by N. With -i just the instructions are written so they can be
+ *	pasted inline, in which case -w picks 8, 16 or 32bit (sreg:D, not on
+ *	the 6800). The plans are the ones the compiler uses, and -s is the
+ *	same weighing of cycles against bytes as its --codesize (default 100,
+ *	smaller values favour size).
+ *
+ *	(C) 2019 Alan Cox
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "mulplan.h"
+
+static cpu_t cpu = CPU_6803;
+
+static void line(const char *fmt, ...)
+{
+    va_list ap;
+    putchar('\t');
+    va_start(ap, fmt);
+    vprintf(fmt, ap);
+    va_end(ap);
+    putchar('\n');
+}
+
+static void usage(void)
+{
+    fprintf(stderr, "mulgen: [-c cpu] [-s factor] [-i] [-w width] value...\n");
+    exit(1);
+}
+
+int main(int argc, char *argv[])
+{
+    struct MulPlan p;
+    unsigned long v;
+    unsigned width = MW_16;
+    unsigned size = 100;
+    int inline_only = 0;
+    char *e;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "c:s:iw:")) != -1) {
+        switch (opt) {
+        case 'c':
+            if (strcmp(optarg, "6800") == 0)
+                cpu = CPU_6800;
+            else if (strcmp(optarg, "6803") == 0)
+                cpu = CPU_6803;
+            else if (strcmp(optarg, "6303") == 0)
+                cpu = CPU_6303;
+            else {
+                fprintf(stderr, "mulgen: unknown cpu '%s'.\n", optarg);
+                exit(1);
+            }
+            break;
+        case 's':
+            size = atoi(optarg);
+            break;
+        case 'i':
+            inline_only = 1;
+            break;
+        case 'w':
+            switch (atoi(optarg)) {
+            case 8:
+                width = MW_8;
+                break;
+            case 16:
+                width = MW_16;
+                break;
+            case 32:
+                width = MW_32;
+                break;
+            default:
+                usage();
+            }
+            break;
+        default:
+            usage();
+        }
+    }
+    if (optind == argc)
+        usage();
+    if (width != MW_16 && !inline_only) {
+        fprintf(stderr, "mulgen: library helpers are 16bit only.\n");
+        exit(1);
+    }
+    if (width == MW_32 && cpu == CPU_6800) {
+        fprintf(stderr, "mulgen: no 32bit multiply plans for the 6800.\n");
+        exit(1);
+    }
+
+    for (; optind < argc; optind++) {
+        v = strtoul(argv[optind], &e, 0);
+        if (*e || v == 0) {
+            fprintf(stderr, "mulgen: bad value '%s'.\n", argv[optind]);
+            exit(1);
+        }
+        MulPlanBest(&p, v, width, cpu, size);
+        if (inline_only) {
+            printf(";\tx %lu: %u bytes %u cycles\n", v, p.Bytes, p.Cycles);
+            MulPlanEmit(&p, width, v, cpu, line);
+            continue;
+        }
+        printf(";\n;\tMultiply D by %lu\n;\n", v);
+        printf(";\tWritten by mulgen. Uses @tmp1, X is left alone\n;\n");
+        printf("\n\t.export mulax%lu\n\n", v);
+        printf("\t.setcpu %s\n\t.code\n\n", cpu == CPU_6800 ? "6800" :
+               cpu == CPU_6803 ? "6803" : "6303");
+        printf("mulax%lu:\n", v);
+        MulPlanEmit(&p, width, v, cpu, line);
+        line("rts");
+    }
+    return 0;
+}
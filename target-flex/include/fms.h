@@ -1,6 +1,8 @@
 #ifndef _FLEX_FMS_H
 #define _FLEX_FMS_H
 
+#include <stdint.h>
+
 struct fms_fcb {
     uint8_t function;
     uint8_t error;
@@ -27,13 +29,13 @@ struct fms_fcb {
     uint16_t next;		/* Next FCB in chain */
     uint16_t pos;		/* Current track, sector */
     uint16_t record;		/* Current logical record number */
-    uint8_t dataindex;		/* Data index into record */
+    uint8_t dataindex;		/* Data index into sector, 0 if none read yet */
     uint8_t randindex;		/* Random index */
     uint8_t workbuf[11];
-    uint16_t diraddr;
-    uint16_ firstdel;
-    uint8_t scratch[11];
-    uint8_t sector[256];
+    uint8_t diraddr[3];
+    uint8_t firstdel[3];
+    uint8_t scratch[11];	/* scratch[6] is the space compression flag */
+    uint8_t sector[256];	/* Link, record number and 252 bytes of data */
 };
 
 #define FMS_READBYTE	0x00	/* read/write according to mode */
@@ -65,7 +67,7 @@ struct fms_fcb {
 #define FMS_ERR_ILFUNC	0x01
 #define FMS_ERR_INUSE	0x02
 #define FMS_ERR_EXISTS	0x03
-#defien FMS_ERR_NOENT	0x04
+#define FMS_ERR_NOENT	0x04
 #define FMS_ERR_SYSDE	0x05
 #define FMS_ERR_DIRFUL	0x06
 #define FMS_ERR_DSKFUL	0x07
@@ -92,7 +94,7 @@ struct fms_fcb {
 #define FMS_ERR_HW	0x1C
 
 extern void fms_close(void);
-extern uin16_t fms_call(uint8_t a, uint8_t b, struct fms_fcb *fcb);
+extern uint16_t fms_call(uint8_t a, uint8_t b, struct fms_fcb *fcb);
 extern int fms_getverify(void);
 extern void fms_setverify(int);
 extern int fms_error;
@@ -1,6 +1,11 @@
 #ifndef _STDIO_H
 #define _STDIO_H
 
+#include <stddef.h>
+#include <fms.h>
+
+#define EOF	(-1)
+
 struct __file {
     uint8_t con;
     uint8_t reserved;
@@ -19,6 +24,10 @@ extern int putc(int, FILE *);
 extern int puts(const char *);
 extern int fputs(const char *, FILE *);
 
+/* Binary files move whole sectors of data at a time */
+extern size_t fread(void *, size_t, size_t, FILE *);
+extern size_t fwrite(const void *, size_t, size_t, FILE *);
+
 extern void rewind(FILE *);
 
 extern int fseek(FILE *, long *, int);
@@ -30,4 +39,8 @@ extern int fgets(char *, int, FILE *);
 extern FILE *fopen(const char *, const char *);
 extern int fclose(FILE *);
 
+/* Only %d %i %u %x %X %c %s and %%, with l, '-', '0' and a width */
+extern int printf(const char *, ...);
+extern int sprintf(char *, const char *, ...);
+
 #endif
@@ -9,6 +9,14 @@
 
 _errno:	.word 0
 
+;
+;	FMS error to errno. End of file is not an error
+;
+errtab:		.byte 0,22,16,17,2,5,28,28
+		.byte 0,5,5,30,13,9,22,19
+		.byte 6,13,5,22,9,22,5,5
+		.byte 22,5,22,16,5
+
 		.code
 
 ;
@@ -41,8 +49,10 @@ fcb_to_errno:
 		ldx #errtab
 		jsr $AD36		;	add B to X
 		ldab ,x
-		stab errno+1
-		clr errno
+		beq eof
+		stab _errno+1
+		clr _errno
+eof:
 		ldx @tmp
 noerr:
 		rts
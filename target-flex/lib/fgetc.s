@@ -1,7 +1,7 @@
-
 		.export _fgetc
 		.export _getc
 		.export _getchar
+		.export fmsgetc
 
 		.code
 
@@ -14,13 +14,50 @@ dogetc:
 		beq fms
 		; actually we are a fake logical device
 		; for now just console
-		jmp __getch
+		jmp __getc
 fms:
 		inx
 		inx
+;
+;	Get a byte from the FCB at X into D, or -1. The FCB is left in X.
+;	Unless FMS has to read a sector or expand spaces the byte comes
+;	straight out of the sector buffer (see fmsbuf.s)
+;
+fmsgetc:
+		ldab 34,x
+		beq slow
+		ldaa 59,x
+		beq text
+		inca
+		bne slow	; spaces being expanded
+		jsr secptr
+		ldab ,x
+		bra took
+text:
+		jsr secptr
+		ldab ,x
+		cmpb #9		; compressed spaces
+		beq slowx
+took:
+		ldx @tmp
+		inc 34,x
+		clra
+		rts
+slowx:
+		ldx @tmp
+slow:
 		clr ,x
 		clr 1,x
-		jmp fms_and_errno
+		jsr $BE06
+		bne fail
+		tab
+		clra
+		rts
+fail:
+		jsr fcb_to_errno
+		ldab #$FF
+		tba
+		rts
 
 _getchar:
 		ldx #stdin
@@ -31,9 +31,16 @@ __getc:
 		clra
 		rts
 
+;
+;	As for the FLEX console functions a newline is written as CR/LF
+;
 __putc:
 		tba
+		cmpa #10
+		beq putnl
 		jmp $AD18
+putnl:
+		jmp $AD24
 
 _flex_inch:
 		jsr $AD09
@@ -0,0 +1,122 @@
+;
+;	FMS keeps the current sector of a file in the FCB and only goes to
+;	the disk when the data index runs off the end of it. The data index
+;	(34,x) is the offset of the next byte in the sector buffer (64,x),
+;	0 when no sector is loaded, and data starts at 4 after the link and
+;	record number. The space compression flag (59,x) is $FF for a binary
+;	file, 0 for a text file with no spaces pending and the count when
+;	FMS is part way through expanding a run of them.
+;
+;	So long as a byte is not the one that makes FMS go to the disk, or
+;	one it has to expand, we can move it ourselves without the FMS call
+;	and the FCB looks the same afterwards.
+;
+		.export secptr
+		.export fxinit
+		.export fxdone
+
+		.code
+;
+;	X = FCB, B = index. Returns X pointing at that byte of the sector
+;	buffer with the FCB in @tmp. Uses A, B and @tmp1
+;
+secptr:
+		stx @tmp
+		clra
+		addb #64
+		adca #0
+		addb @tmp+1
+		adca @tmp
+		staa @tmp1
+		stab @tmp1+1
+		ldx @tmp1
+		rts
+
+;
+;	fread and fwrite set up from their arguments, X = the frame
+;	(buffer, size, count, FILE). The buffer goes in @tmp2, the FILE
+;	in @tmp4 and the number of bytes to move in @tmp3 and fxtot.
+;	Returns with Z set if there is nothing to do
+;
+fxinit:
+		ldaa 6,x
+		ldab 7,x
+		staa @tmp
+		stab @tmp+1
+		ldaa 4,x
+		ldab 5,x
+		staa @tmp1
+		stab @tmp1+1
+		ldaa 8,x
+		ldab 9,x
+		staa @tmp2
+		stab @tmp2+1
+		ldaa 2,x
+		ldab 3,x
+		staa @tmp4
+		stab @tmp4+1
+		clra
+		clrb
+fxmul:
+		lsr @tmp1
+		ror @tmp1+1
+		bcc fxmul1
+		addb @tmp+1
+		adca @tmp
+fxmul1:
+		asl @tmp+1
+		rol @tmp
+		tst @tmp1
+		bne fxmul
+		tst @tmp1+1
+		bne fxmul
+		staa fxtot
+		stab fxtot+1
+		staa @tmp3
+		stab @tmp3+1
+		ldx @tmp3
+		rts
+
+;
+;	Return in D how many whole items were moved, X = the frame
+;
+fxdone:
+		ldaa @tmp3
+		oraa @tmp3+1
+		bne fxpart
+		ldaa 4,x		; all of them
+		ldab 5,x
+		rts
+fxpart:
+		ldaa fxtot
+		ldab fxtot+1
+		subb @tmp3+1
+		sbca @tmp3
+		tst 6,x
+		bne fxdiv0
+		pshb
+		ldab 7,x
+		decb
+		pulb
+		beq fxone		; size 1 is common, D is the answer
+fxdiv0:
+		clr @tmp1
+		clr @tmp1+1
+fxdiv:
+		subb 7,x
+		sbca 6,x
+		bcs fxdiv1
+		inc @tmp1+1
+		bne fxdiv
+		inc @tmp1
+		bra fxdiv
+fxdiv1:
+		ldaa @tmp1
+		ldab @tmp1+1
+		rts
+fxone:
+		rts
+
+		.bss
+
+fxtot:		.ds 2
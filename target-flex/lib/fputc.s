@@ -1,12 +1,14 @@
-
 		.export _fputc
+		.export _putc
+		.export _putchar
+		.export fmsputc
 
 		.code
 
 _fputc:
 _putc:
 		tsx
-		ldaa 4,x
+		ldaa 5,x
 doputc:
 		ldx 2,x		; FILE (and thus FCB) pointer
 		tst ,x
@@ -18,24 +20,61 @@ doputc:
 		jsr $AD18
 		clra
 		tsx
-		ldab 4,x
+		ldab 5,x
 		rts
 fms:
 		inx
 		inx
+;
+;	Write the byte in A to the FCB at X, returning it in D or -1. The
+;	FCB is left in X. In a binary file the byte goes straight into the
+;	sector buffer unless it is the last one of the sector, which FMS
+;	writes so that it writes the sector out (see fmsbuf.s). Text files
+;	always go via FMS so it can compress the spaces.
+;
+fmsputc:
+		ldab 59,x
+		incb
+		bne slow
+		ldab 34,x
+		cmpb #4
+		bcs slow
+		cmpb #255
+		beq slow
+		psha
+		jsr secptr
+		pula
+		staa ,x
+		ldx @tmp
+		inc 34,x
+		tab
+		clra
+		rts
+slow:
+		psha
 		clr ,x
 		clr 1,x
-		jmp fms_and_errno
+		jsr $BE06
+		pulb			; leaves the flags alone
+		bne fail
+		clra
+		rts
+fail:
+		jsr fcb_to_errno
+		ldab #$FF
+		tba
+		rts
 
 _putchar:
 		tsx
-		ldaa 2,x
+		ldaa 3,x
 		cmpa #10
 		beq putnl
 		jsr $AD18
 putcdone:
 		clra
-		ldab 2,x
+		tsx
+		ldab 3,x
 		rts
 putnl:		jsr $AD24
 		clra
@@ -26,22 +26,18 @@ nextcon:
 		bra conloop
 fms:		inx
 		inx
-		stx @tmp
+		stx @tmp3
 nextchar:
 		ldx @tmp2
 		ldaa ,x
 		beq done
 		inx
 		stx @tmp2
-		ldx @tmp
-		clr ,x
-		clr 1,x
-		jsr $B403
+		ldx @tmp3
+		jsr fmsputc
+		tsta
 		beq nextchar
-		jsr fcb_to_errno
-		ldaa #$FF
-		tab
-		rts
+		rts			; -1 and errno set
 done:		ldab #1
 		clra
 		rts
@@ -50,8 +46,8 @@ done:		ldab #1
 ; be that FLEX has a redirected console but it sorts that bit out		
 _puts:
 		tsx
-putsl:
 		ldx 2,x
+putsl:
 		ldaa ,x
 		beq putsnl
 		jsr $AD18
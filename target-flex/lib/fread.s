@@ -0,0 +1,99 @@
+;
+;	fread(buf, size, count, fp)
+;
+;	In a binary file we copy all that is left of the sector buffer each
+;	time round, so FMS is only called for the first byte of a sector,
+;	where it reads the next one, and a whole 252 byte sector of data
+;	costs one FMS call. Text files go a byte at a time through fmsgetc
+;	so the spaces are expanded, and the console through __getc.
+;
+		.export _fread
+
+		.code
+
+_fread:
+		tsx
+		jsr fxinit
+		beq none
+		ldx @tmp4
+		tst ,x
+		bne conread
+		inx
+		inx
+		stx @tmp4		; FCB
+rdloop:
+		ldx @tmp3
+		beq rddone
+		ldx @tmp4
+		ldab 59,x
+		incb
+		bne rdbyte		; text file
+		ldab 34,x
+		beq rdbyte		; FMS has to read the next sector
+		negb			; bytes left in the sector
+		tst @tmp3
+		bne rdrun
+		cmpb @tmp3+1
+		bls rdrun
+		ldab @tmp3+1
+rdrun:
+		stab rdlen
+		ldaa 34,x
+		addb 34,x
+		stab 34,x		; 0 if we used up the sector
+		tab
+		jsr secptr
+		ldab rdlen
+rdcopy:
+		ldaa ,x
+		inx
+		stx @tmp1
+		ldx @tmp2
+		staa ,x
+		inx
+		stx @tmp2
+		ldx @tmp1
+		decb
+		bne rdcopy
+		ldaa @tmp3
+		ldab @tmp3+1
+		subb rdlen
+		sbca #0
+		staa @tmp3
+		stab @tmp3+1
+		bra rdloop
+rdbyte:
+		jsr fmsgetc
+		tsta
+		bne rddone		; end of file or error
+		bsr rdput
+		bra rdloop
+
+conread:
+		ldx @tmp3
+		beq rddone
+		jsr __getc
+		bsr rdput
+		bra conread
+
+rddone:
+		tsx
+		jmp fxdone
+none:
+		clra
+		clrb
+		rts
+
+rdput:
+		ldx @tmp2
+		stab ,x
+		inx
+		stx @tmp2
+		ldx @tmp3
+		dex
+		stx @tmp3
+		rts
+
+		.bss
+
+rdlen:		.ds 1
@@ -0,0 +1,114 @@
+;
+;	fwrite(buf, size, count, fp)
+;
+;	In a binary file we fill the sector buffer directly up to its last
+;	byte, which goes through FMS so that it writes the sector out, so a
+;	whole 252 byte sector of data costs one FMS call. Text files go a
+;	byte at a time through fmsputc so the spaces are compressed, and the
+;	console through __putc.
+;
+		.export _fwrite
+
+		.code
+
+_fwrite:
+		tsx
+		jsr fxinit
+		beq none
+		ldx @tmp4
+		tst ,x
+		bne conwrite
+		inx
+		inx
+		stx @tmp4		; FCB
+wrloop:
+		ldx @tmp3
+		beq wrdone
+		ldx @tmp4
+		ldab 59,x
+		incb
+		bne wrbyte		; text file
+		ldab 34,x
+		cmpb #4
+		bcs wrbyte		; no sector yet
+		comb			; room before the last byte
+		beq wrbyte
+		tst @tmp3
+		bne wrrun
+		cmpb @tmp3+1
+		bls wrrun
+		ldab @tmp3+1
+wrrun:
+		stab wrlen
+		ldaa 34,x
+		addb 34,x
+		stab 34,x
+		tab
+		jsr secptr
+		stx @tmp1
+		ldab wrlen
+wrcopy:
+		ldx @tmp2
+		ldaa ,x
+		inx
+		stx @tmp2
+		ldx @tmp1
+		staa ,x
+		inx
+		stx @tmp1
+		decb
+		bne wrcopy
+		ldaa @tmp3
+		ldab @tmp3+1
+		subb wrlen
+		sbca #0
+		staa @tmp3
+		stab @tmp3+1
+		bra wrloop
+wrbyte:
+		bsr wrget
+		jsr fmsputc
+		tsta
+		bne wrdone		; error
+		bsr wrnext
+		bra wrloop
+
+conwrite:
+		ldx @tmp3
+		beq wrdone
+		bsr wrget
+		tab
+		jsr __putc
+		bsr wrnext
+		bra conwrite
+
+wrdone:
+		tsx
+		jmp fxdone
+none:
+		clra
+		clrb
+		rts
+
+;
+;	Get the next byte into A without moving on, keeping X
+;
+wrget:
+		stx @tmp1
+		ldx @tmp2
+		ldaa ,x
+		ldx @tmp1
+		rts
+
+wrnext:
+		ldx @tmp2
+		inx
+		stx @tmp2
+		ldx @tmp3
+		dex
+		stx @tmp3
+		rts
+
+		.bss
+
+wrlen:		.ds 1
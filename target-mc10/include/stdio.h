@@ -18,4 +18,8 @@ extern int puts(const char *);
 
 extern int gets(char *);
 
+/* Only %d %i %u %x %X %c %s and %%, with l, '-', '0' and a width */
+extern int printf(const char *, ...);
+extern int sprintf(char *, const char *, ...);
+
 #endif
@@ -0,0 +1,184 @@
+/*
+ *	Compares against constants and between variables, checked against
+ *	the same compare done on longs. Both the value of the compare and a
+ *	branch on it are tested, at the ends of the range where the flags go
+ *	wrong. Longs are kept in ascending order and checked against where
+ *	the constant sits in the table.
+ */
+
+#include "test.h"
+
+static int v[] = {
+	-32767 - 1, -32767, -256, -255, -1, 0, 1, 255, 256, 0x7ffe, 0x7fff
+};
+static unsigned uv[] = {
+	0, 1, 255, 256, 0x7fff, 0x8000, 0x8001, 0xfffe, 0xffff
+};
+
+static long lv[] = {
+	-2147483647L - 1, -65536L, -65535L, -1L, 0L, 1L, 65535L, 65536L,
+	0x00800000L, 0x7fffffffL
+};
+static unsigned long ulv[] = {
+	0UL, 1UL, 0xffffUL, 0x10000UL, 0x00800000UL, 0x7fffffffUL,
+	0x80000000UL, 0xffff0000UL, 0xffffffffUL
+};
+
+/* Statics are loaded directly, which is what the 6800 rules look for */
+static int g5 = 5, g3 = 3, gm = -1;
+static int ga = 0x0180, gb = 0x0201, gc = 0x7f00, gd = 0x00ff;
+static unsigned char c5 = 5, c3 = 3, cf = 0xff;
+
+#define NV	(sizeof(v) / sizeof(v[0]))
+#define NUV	(sizeof(uv) / sizeof(uv[0]))
+#define NLV	(sizeof(lv) / sizeof(lv[0]))
+#define NULV	(sizeof(ulv) / sizeof(ulv[0]))
+
+#define SCMP(op, c) \
+	for (i = 0; i < NV; i++) { \
+		int want = (long)v[i] op (long)(c); \
+		int got = v[i] op c; \
+		if (v[i] op c) \
+			got |= 2; \
+		CHECK(got == (want ? 3 : 0)); \
+	}
+
+#define UCMP(op, c) \
+	for (i = 0; i < NUV; i++) { \
+		int want = (long)uv[i] op (long)(c); \
+		int got = uv[i] op c; \
+		if (uv[i] op c) \
+			got |= 2; \
+		CHECK(got == (want ? 3 : 0)); \
+	}
+
+/* c is entry k of the table */
+#define LCMP(op, k, c) \
+	for (i = 0; i < NLV; i++) { \
+		int want = i op k; \
+		int got = lv[i] op c; \
+		if (lv[i] op c) \
+			got |= 2; \
+		CHECK(got == (want ? 3 : 0)); \
+	}
+
+#define ULCMP(op, k, c) \
+	for (i = 0; i < NULV; i++) { \
+		int want = i op k; \
+		int got = ulv[i] op c; \
+		if (ulv[i] op c) \
+			got |= 2; \
+		CHECK(got == (want ? 3 : 0)); \
+	}
+
+/* Only the branch, as the value of a compare goes another way. Each of
+   the six compares sets a digit, for a < b that is 110010 */
+#define BCMP(a, b, want) \
+	got = 0; \
+	if (a < b) \
+		got += 100000L; \
+	if (a <= b) \
+		got += 10000; \
+	if (a > b) \
+		got += 1000; \
+	if (a >= b) \
+		got += 100; \
+	if (a == b) \
+		got += 10; \
+	if (a != b) \
+		got += 1; \
+	CHECK(got == want);
+
+#define LT	110001L
+#define EQ	10110L
+#define GT	1101L
+
+/* Every pair of values */
+#define VCMP(op) \
+	for (i = 0; i < NV; i++) \
+		for (j = 0; j < NV; j++) { \
+			int want = (long)v[i] op (long)v[j]; \
+			int got = v[i] op v[j]; \
+			if (v[i] op v[j]) \
+				got |= 2; \
+			CHECK(got == (want ? 3 : 0)); \
+		}
+
+int main(int argc, char *argv[])
+{
+	unsigned i, j;
+	long got;
+
+	/* The old 6800 compare judged the high bytes as unsigned */
+	CHECK(!(gm >= 256));
+	CHECK(gm >= -255);
+	CHECK(!(gm >= 0));
+	CHECK(ga >= -1);
+
+	SCMP(>=, 0x7fff);
+	SCMP(>=, 0x7ffe);
+	SCMP(>=, 256);
+	SCMP(>=, 1);
+	SCMP(>=, -1);
+	SCMP(>=, -255);
+	SCMP(>=, -32767);
+	SCMP(>, 0x7ffe);
+	SCMP(>, 255);
+	SCMP(>, -1);
+	SCMP(>, -32767 - 1);
+	SCMP(<, 0x7fff);
+	SCMP(<, 256);
+	SCMP(<, -255);
+	SCMP(<=, 0x7ffe);
+	SCMP(<=, -1);
+	SCMP(==, 0x7fff);
+	SCMP(!=, -256);
+
+	UCMP(>=, 0xffff);
+	UCMP(>=, 0x8000);
+	UCMP(>=, 256);
+	UCMP(>, 0xfffe);
+	UCMP(>, 0x7fff);
+	UCMP(<, 0x8001);
+	UCMP(<=, 255);
+
+	LCMP(<, 4, 0L);
+	LCMP(>=, 4, 0L);
+	LCMP(<, 7, 65536L);
+	LCMP(>=, 3, -1L);
+	LCMP(>, 5, 1L);
+	LCMP(<=, 2, -65535L);
+
+	ULCMP(>=, 1, 1UL);
+	ULCMP(>=, 3, 0x10000UL);
+	ULCMP(>=, 4, 0x00800000UL);
+	ULCMP(>=, 6, 0x80000000UL);
+	ULCMP(>=, 7, 0xffff0000UL);
+	ULCMP(<, 2, 0xffffUL);
+	ULCMP(<, 8, 0xffffffffUL);
+	ULCMP(>, 5, 0x7fffffffUL);
+
+	BCMP(g5, g3, GT);
+	BCMP(g3, g5, LT);
+	BCMP(g3, g3, EQ);
+	BCMP(ga, gb, LT);
+	BCMP(gb, ga, GT);
+	BCMP(gc, gd, GT);
+	BCMP(gd, gc, LT);
+	BCMP(gm, gd, LT);
+	BCMP(gd, gm, GT);
+	BCMP(c5, c3, GT);
+	BCMP(c3, c5, LT);
+	BCMP(cf, ga, LT);
+	BCMP(ga, cf, GT);
+	BCMP(gd, cf, EQ);
+	BCMP(gm, c3, LT);
+	BCMP(c3, gm, GT);
+
+	VCMP(<);
+	VCMP(<=);
+	VCMP(>);
+	VCMP(>=);
+	VCMP(==);
+	return fails;
+}
@@ -0,0 +1,130 @@
+/*
+ *	32bit division and remainder. div32x32 takes shortcuts for small
+ *	dividends and for divisors that fit 8 or 16 bits, so the vectors
+ *	cover each size of operand, then random ones are checked against
+ *	multiplying back.
+ */
+
+#include "test.h"
+
+struct udiv {
+	unsigned long n, d, q, r;
+};
+
+struct sdiv {
+	long n, d, q, r;
+};
+
+static struct udiv uvec[] = {
+	{ 0x00000000UL, 0x00000001UL, 0x00000000UL, 0x00000000UL },
+	{ 0x00000001UL, 0x00000001UL, 0x00000001UL, 0x00000000UL },
+	{ 0xffffffffUL, 0x00000001UL, 0xffffffffUL, 0x00000000UL },
+	{ 0xffffffffUL, 0xffffffffUL, 0x00000001UL, 0x00000000UL },
+	{ 0xfffffffeUL, 0xffffffffUL, 0x00000000UL, 0xfffffffeUL },
+	{ 0x00000064UL, 0x00000007UL, 0x0000000eUL, 0x00000002UL },
+	{ 0x000000ffUL, 0x00000010UL, 0x0000000fUL, 0x0000000fUL },
+	{ 0x0000ffffUL, 0x000000ffUL, 0x00000101UL, 0x00000000UL },
+	{ 0x00012345UL, 0x00000010UL, 0x00001234UL, 0x00000005UL },
+	{ 0x7fffffffUL, 0x0000ffffUL, 0x00008000UL, 0x00007fffUL },
+	{ 0x80000000UL, 0x00008000UL, 0x00010000UL, 0x00000000UL },
+	{ 0xffffffffUL, 0x00010000UL, 0x0000ffffUL, 0x0000ffffUL },
+	{ 0xffffffffUL, 0x0000ffffUL, 0x00010001UL, 0x00000000UL },
+	{ 0x00010000UL, 0x00010001UL, 0x00000000UL, 0x00010000UL },
+	{ 0xdeadbeefUL, 0x00001234UL, 0x000c3ba5UL, 0x0000076bUL },
+	{ 0xdeadbeefUL, 0x00123456UL, 0x00000c3bUL, 0x0007a71dUL },
+	{ 0xdeadbeefUL, 0x80000001UL, 0x00000001UL, 0x5eadbeeeUL },
+	{ 0x00ffffffUL, 0x00ff00ffUL, 0x00000001UL, 0x0000ff00UL },
+	{ 0x80000000UL, 0x00000003UL, 0x2aaaaaaaUL, 0x00000002UL },
+	{ 0x000f4240UL, 0x000003e8UL, 0x000003e8UL, 0x00000000UL },
+	{ 0x075bcd15UL, 0x0000000aUL, 0x00bc614eUL, 0x00000009UL },
+	{ 0x01000000UL, 0x00ffffffUL, 0x00000001UL, 0x00000001UL },
+	{ 0xffffffffUL, 0x80000000UL, 0x00000001UL, 0x7fffffffUL },
+	{ 0xfffe0001UL, 0x0000ffffUL, 0x0000ffffUL, 0x00000000UL },
+	{ 0x0000e895UL, 0x00000085UL, 0x000001bfUL, 0x0000005aUL },
+	{ 0x00008abeUL, 0x000000b3UL, 0x000000c6UL, 0x0000004cUL },
+	{ 0x0000dcaeUL, 0x00009dddUL, 0x00000001UL, 0x00003ed1UL },
+	{ 0x0000ad39UL, 0x0000e12bUL, 0x00000000UL, 0x0000ad39UL },
+	{ 0xb9a40dfeUL, 0x000000caUL, 0x00eb4481UL, 0x00000034UL },
+	{ 0x8772eaeaUL, 0x000000b9UL, 0x00bb6e96UL, 0x00000084UL },
+	{ 0x9ddccf2dUL, 0x00009195UL, 0x00011598UL, 0x000025b5UL },
+	{ 0x824115e4UL, 0x000099a5UL, 0x0000d907UL, 0x00000561UL },
+	{ 0x00a81cdbUL, 0x0000c642UL, 0x000000d9UL, 0x00000ee9UL },
+	{ 0x008382b5UL, 0x0000b056UL, 0x000000beUL, 0x0000a2e1UL },
+	{ 0xfd4f6854UL, 0x00cd9043UL, 0x0000013bUL, 0x005ee5e3UL },
+	{ 0xb189e370UL, 0x00a24eb8UL, 0x00000118UL, 0x0003ca30UL },
+	{ 0xe0e09044UL, 0x974b9753UL, 0x00000001UL, 0x4994f8f1UL },
+	{ 0xe7b13551UL, 0xc41edca6UL, 0x00000001UL, 0x239258abUL },
+	{ 0x000000b0UL, 0xab8755c5UL, 0x00000000UL, 0x000000b0UL },
+	{ 0x000000d3UL, 0xdbb88633UL, 0x00000000UL, 0x000000d3UL },
+};
+
+static struct sdiv svec[] = {
+	{ 100L, 7L, 14L, 2L },
+	{ -100L, 7L, -14L, -2L },
+	{ 100L, -7L, -14L, 2L },
+	{ -100L, -7L, 14L, -2L },
+	{ -1L, 1L, -1L, 0L },
+	{ -2147483647L, -1L, 2147483647L, 0L },
+	{ (-2147483647L - 1), 1L, (-2147483647L - 1), 0L },
+	{ (-2147483647L - 1), 2L, -1073741824L, 0L },
+	{ 2147483647L, (-2147483647L - 1), 0L, 2147483647L },
+	{ (-2147483647L - 1), (-2147483647L - 1), 1L, 0L },
+	{ -123456789L, 1000L, -123456L, -789L },
+	{ 123456789L, -65536L, -1883L, 52501L },
+	{ -65536L, 256L, -256L, 0L },
+	{ -7L, 100L, 0L, -7L },
+	{ 7L, -100L, 0L, 7L },
+};
+
+#define NU	(sizeof(uvec) / sizeof(uvec[0]))
+#define NS	(sizeof(svec) / sizeof(svec[0]))
+
+static unsigned long seed = 1;
+
+static unsigned long rnd(void)
+{
+	seed = seed * 1103515245UL + 12345;
+	return seed;
+}
+
+/* Keep the top bits set in bytes, so each size of operand turns up */
+static unsigned long mask[] = {
+	0xffUL, 0xffffUL, 0xffffffUL, 0xffffffffUL
+};
+
+int main(int argc, char *argv[])
+{
+	unsigned i;
+	unsigned long n, d, q, r;
+	long sn, sd;
+
+	for (i = 0; i < NU; i++) {
+		n = uvec[i].n;
+		d = uvec[i].d;
+		CHECK(n / d == uvec[i].q);
+		CHECK(n % d == uvec[i].r);
+	}
+	for (i = 0; i < NS; i++) {
+		sn = svec[i].n;
+		sd = svec[i].d;
+		CHECK(sn / sd == svec[i].q);
+		CHECK(sn % sd == svec[i].r);
+	}
+	for (i = 0; i < 64; i++) {
+		n = rnd() & mask[i & 3];
+		d = (rnd() & mask[(i >> 2) & 3]) | 1;
+		q = n / d;
+		r = n % d;
+		CHECK(r < d);
+		CHECK(q * d + r == n);
+		sn = n;
+		sd = d;
+		if (i & 1)
+			sn = -sn;
+		if (i & 2)
+			sd = -sd;
+		CHECK(sn / sd * sd + sn % sd == sn);
+		CHECK((sn % sd < 0) == (sn < 0 && sn % sd));
+	}
+	return fails;
+}
@@ -0,0 +1,108 @@
+/*
+ *	Division, modulus and shifts by constants, checked against the same
+ *	operation with the constant in a variable so that it goes through
+ *	the library. The unsigned divides become reciprocal multiplies on
+ *	the 6803 and 6303, and divisors above 0x8000 leave a shift by 15.
+ */
+
+#include "test.h"
+
+static unsigned seed = 1;
+
+static unsigned rnd(void)
+{
+	seed = seed * 25173 + 13849;
+	return seed;
+}
+
+/* Values worth trying as dividends, then some random ones */
+static unsigned edge[] = {
+	0, 1, 2, 3, 7, 255, 256, 0x7fff, 0x8000, 0x8001, 0xbfff, 0xc000,
+	0xfffe, 0xffff
+};
+
+#define NEDGE	(sizeof(edge) / sizeof(edge[0]))
+
+static unsigned x;
+
+#define UDIV(c) \
+	for (i = 0; i < NEDGE + 40; i++) { \
+		x = i < NEDGE ? edge[i] : rnd(); \
+		d = c; \
+		CHECK(x / c == x / d); \
+		CHECK(x % c == x % d); \
+	}
+
+#define SDIV(c) \
+	for (i = 0; i < NEDGE + 40; i++) { \
+		s = i < NEDGE ? edge[i] : rnd(); \
+		sd = c; \
+		CHECK(s / c == s / sd); \
+		CHECK(s % c == s % sd); \
+	}
+
+#define CDIV(c) \
+	for (i = 0; i < 256; i++) { \
+		uc = i; \
+		d = c; \
+		CHECK(uc / c == uc / d); \
+		CHECK(uc % c == uc % d); \
+	}
+
+#define SHIFT(n) \
+	for (i = 0; i < NEDGE; i++) { \
+		x = edge[i]; \
+		s = edge[i]; \
+		d = n; \
+		CHECK(x >> n == x >> d); \
+		CHECK(x << n == x << d); \
+		CHECK(s >> n == s >> d); \
+	}
+
+int main(int argc, char *argv[])
+{
+	unsigned i, d;
+	int s, sd;
+	unsigned char uc;
+
+	UDIV(3);
+	UDIV(7);
+	UDIV(10);
+	UDIV(100);
+	UDIV(1000);
+	UDIV(0x7fff);
+	UDIV(0x8000);
+	UDIV(0x8001);
+	UDIV(40000);
+	UDIV(0xbfff);
+	UDIV(0xc000);
+	UDIV(0xfffe);
+	UDIV(0xffff);
+
+	SDIV(3);
+	SDIV(10);
+	SDIV(-7);
+	SDIV(1000);
+
+	CDIV(3);
+	CDIV(10);
+	CDIV(100);
+	CDIV(129);
+	CDIV(255);
+
+	/* A divide by a variable over the top of the range */
+	for (i = 0; i < 9; i++) {
+		d = 0x8001 + i * 0x0fff;
+		x = rnd();
+		CHECK(x / d == (x >= d));
+		CHECK(x % d == (x >= d ? x - d : x));
+	}
+
+	SHIFT(1);
+	SHIFT(7);
+	SHIFT(8);
+	SHIFT(9);
+	SHIFT(14);
+	SHIFT(15);
+	return fails;
+}
@@ -0,0 +1,81 @@
+/*
+ *	Reaching into the stack frame. Locals past what n,x can reach are
+ *	found by adding to the stack pointer, variadic functions find their
+ *	arguments from the frame pointer, and an int local can be added to
+ *	a pointer in place. The 6800 has to do each add a byte at a time.
+ *	Struct copies and initialised static locals go through memcpy.
+ */
+
+#include "test.h"
+
+static int tab[4] = { 10, 20, 30, 40 };
+static char ctab[4] = { 1, 2, 3, 4 };
+
+struct two {
+	char a[2];
+};
+
+struct five {
+	int a[5];
+};
+
+static struct five gfive = { { 1, 2, 3, 4, 5 } };
+
+/* Both of these call memcpy, which pops its own arguments on the 6800 */
+static int copy(int n)
+{
+	struct five s;
+	int k = n;
+
+	s = gfive;
+	return s.a[4] + k;
+}
+
+#pragma static-locals (push, on)
+static int init(int n)
+{
+	char buf[12] = "abcdefghijk";
+
+	return buf[10] + n;
+}
+#pragma static-locals (pop)
+
+/* a and b are either side of big, so one of them is past what n,x can
+   reach even with abx on the 6803 */
+static int bigframe(int n)
+{
+	int a;
+	char big[2100];
+	int b;
+
+	a = n;
+	b = n + 1;
+	big[2099] = 3;
+	big[0] = 4;
+	return a + b + big[2099] + big[0];
+}
+
+static int subscript(int *p, int i, char c)
+{
+	return p[i] + ctab[c] + tab[i];
+}
+
+static int member(struct two s, ...)
+{
+	int i = 3;
+	return s.a[i & 1] + s.a[0];
+}
+
+int main(int argc, char *argv[])
+{
+	struct two t;
+
+	t.a[0] = 5;
+	t.a[1] = 9;
+	CHECK(copy(10) == 15);
+	CHECK(init(1) == 'l');
+	CHECK(bigframe(10) == 28);
+	CHECK(subscript(tab, 2, 3) == 64);
+	CHECK(member(t, 1) == 14);
+	return fails;
+}
@@ -0,0 +1,98 @@
+/*
+ *	Inlined functions. Small static functions are pasted in at their
+ *	call sites, so their arguments are found past the caller's frame
+ *	and helpers that pop the stack must be followed exactly.
+ *
+ *	cc: --inline-funcs
+ */
+
+#include "test.h"
+
+int g0 = 300;
+int g1 = -7;
+long l0 = 100000L;
+static int gx = 5;
+static int gy = 9;
+
+static int add(int a, int b)
+{
+	return a + b;
+}
+
+static int sub(int a, int b)
+{
+	return a - b;
+}
+
+static int first(int a, int b)
+{
+	return a;
+}
+
+static int second(int a, int b)
+{
+	return b;
+}
+
+static int mul(int a, int b)
+{
+	return a * b;
+}
+
+static int le(long a, long b)
+{
+	return a <= b;
+}
+
+static long ladd(long a, long b)
+{
+	return a + b;
+}
+
+static int twice(int a)
+{
+	return a + a;
+}
+
+static int neg(int a)
+{
+	if (a < 0)
+		return 1;
+	return 0;
+}
+
+static void store(int a)
+{
+	g1 = a;
+}
+
+static int local(int a, int b)
+{
+	int t = a;
+	return t - b;
+}
+
+int main(int argc, char *argv[])
+{
+	int x = 5, y = 9;
+
+	CHECK(add(x, y) == 14);
+	CHECK(add(gx, gy) == 14);
+	CHECK(sub(gx, gy) == -4);
+	CHECK(add(gx, 3) == 8);
+	CHECK(sub(x, y) == -4);
+	CHECK(first(x, y) == 5);
+	CHECK(second(x, y) == 9);
+	CHECK(mul(g0, g1) == -2100);
+	CHECK(le(l0, 5L) == 0);
+	CHECK(le(5L, l0) == 1);
+	CHECK(ladd(l0, 1L) == 100001L);
+	CHECK(twice(y) == 18);
+	CHECK(twice(add(x, y)) == 28);
+	CHECK(neg(-x) == 1);
+	CHECK(neg(x) == 0);
+	CHECK(local(y, x) == 4);
+	store(x + y);
+	CHECK(g1 == 14);
+	return fails;
+}
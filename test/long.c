@@ -0,0 +1,194 @@
+/*
+ *	32bit arithmetic through the runtime helpers, as expressions and as
+ *	assignment operators on both locals and statics, checked against
+ *	answers worked out on a 32bit host.
+ */
+
+#include "test.h"
+
+#define ADD	0
+#define SUB	1
+#define MUL	2
+#define AND	3
+#define OR	4
+#define XOR	5
+#define SHL	6
+#define SHR	7
+#define ASR	8
+#define NEG	9
+#define COM	10
+
+struct lvec {
+	unsigned long a, b;
+	unsigned s;
+	unsigned long r[11];
+};
+
+static struct lvec vec[] = {
+	{ 0x00000000UL, 0x00000000UL,  0, {
+		0x00000000UL, 0x00000000UL, 0x00000000UL, 0x00000000UL, 0x00000000UL,
+		0x00000000UL, 0x00000000UL, 0x00000000UL, 0x00000000UL, 0x00000000UL, 0xffffffffUL } },
+	{ 0x00000001UL, 0xffffffffUL,  1, {
+		0x00000000UL, 0x00000002UL, 0xffffffffUL, 0x00000001UL, 0xffffffffUL,
+		0xfffffffeUL, 0x00000002UL, 0x00000000UL, 0x00000000UL, 0xffffffffUL, 0xfffffffeUL } },
+	{ 0x7fffffffUL, 0x00000001UL, 31, {
+		0x80000000UL, 0x7ffffffeUL, 0x7fffffffUL, 0x00000001UL, 0x7fffffffUL,
+		0x7ffffffeUL, 0x80000000UL, 0x00000000UL, 0x00000000UL, 0x80000001UL, 0x80000000UL } },
+	{ 0x80000000UL, 0xffffffffUL,  1, {
+		0x7fffffffUL, 0x80000001UL, 0x80000000UL, 0x80000000UL, 0xffffffffUL,
+		0x7fffffffUL, 0x00000000UL, 0x40000000UL, 0xc0000000UL, 0x80000000UL, 0x7fffffffUL } },
+	{ 0x12345678UL, 0x9abcdef0UL,  4, {
+		0xacf13568UL, 0x77777788UL, 0x242d2080UL, 0x12345670UL, 0x9abcdef8UL,
+		0x88888888UL, 0x23456780UL, 0x01234567UL, 0x01234567UL, 0xedcba988UL, 0xedcba987UL } },
+	{ 0x0000ffffUL, 0x00000001UL, 16, {
+		0x00010000UL, 0x0000fffeUL, 0x0000ffffUL, 0x00000001UL, 0x0000ffffUL,
+		0x0000fffeUL, 0xffff0000UL, 0x00000000UL, 0x00000000UL, 0xffff0001UL, 0xffff0000UL } },
+	{ 0x000000ffUL, 0x0000ff01UL,  8, {
+		0x00010000UL, 0xffff01feUL, 0x00fe01ffUL, 0x00000001UL, 0x0000ffffUL,
+		0x0000fffeUL, 0x0000ff00UL, 0x00000000UL, 0x00000000UL, 0xffffff01UL, 0xffffff00UL } },
+	{ 0x00010000UL, 0xffff0000UL, 17, {
+		0x00000000UL, 0x00020000UL, 0x00000000UL, 0x00010000UL, 0xffff0000UL,
+		0xfffe0000UL, 0x00000000UL, 0x00000000UL, 0x00000000UL, 0xffff0000UL, 0xfffeffffUL } },
+	{ 0xdeadbeefUL, 0x00010001UL, 24, {
+		0xdeaebef0UL, 0xdeacbeeeUL, 0x9d9cbeefUL, 0x00010001UL, 0xdeadbeefUL,
+		0xdeacbeeeUL, 0xef000000UL, 0x000000deUL, 0xffffffdeUL, 0x21524111UL, 0x21524110UL } },
+	{ 0x00008000UL, 0x00008000UL, 15, {
+		0x00010000UL, 0x00000000UL, 0x40000000UL, 0x00008000UL, 0x00008000UL,
+		0x00000000UL, 0x40000000UL, 0x00000001UL, 0x00000001UL, 0xffff8000UL, 0xffff7fffUL } },
+	{ 0xe3658966UL, 0x00000066UL,  2, {
+		0xe36589ccUL, 0xe3658900UL, 0x9a74bea4UL, 0x00000066UL, 0xe3658966UL,
+		0xe3658900UL, 0x8d962598UL, 0x38d96259UL, 0xf8d96259UL, 0x1c9a769aUL, 0x1c9a7699UL } },
+	{ 0x96afcff5UL, 0x0000a270UL,  9, {
+		0x96b07265UL, 0x96af2d85UL, 0x2e840530UL, 0x00008270UL, 0x96afeff5UL,
+		0x96af6d85UL, 0x5f9fea00UL, 0x004b57e7UL, 0xffcb57e7UL, 0x6950300bUL, 0x6950300aUL } },
+	{ 0x956f5c71UL, 0x00000007UL,  4, {
+		0x956f5c78UL, 0x956f5c6aUL, 0x160b8717UL, 0x00000001UL, 0x956f5c77UL,
+		0x956f5c76UL, 0x56f5c710UL, 0x0956f5c7UL, 0xf956f5c7UL, 0x6a90a38fUL, 0x6a90a38eUL } },
+	{ 0xc87ced6dUL, 0x00a1d551UL,  3, {
+		0xc91ec2beUL, 0xc7db181cUL, 0xb29fd07dUL, 0x0020c541UL, 0xc8fdfd7dUL,
+		0xc8dd383cUL, 0x43e76b68UL, 0x190f9dadUL, 0xf90f9dadUL, 0x37831293UL, 0x37831292UL } },
+	{ 0xd7d8a6c3UL, 0x00000022UL, 18, {
+		0xd7d8a6e5UL, 0xd7d8a6a1UL, 0xaac625e6UL, 0x00000002UL, 0xd7d8a6e3UL,
+		0xd7d8a6e1UL, 0x9b0c0000UL, 0x000035f6UL, 0xfffff5f6UL, 0x2827593dUL, 0x2827593cUL } },
+	{ 0x871be443UL, 0x00f7c812UL,  5, {
+		0x8813ac55UL, 0x86241c31UL, 0x86ef64b6UL, 0x0013c002UL, 0x87ffec53UL,
+		0x87ec2c51UL, 0xe37c8860UL, 0x0438df22UL, 0xfc38df22UL, 0x78e41bbdUL, 0x78e41bbcUL } },
+	{ 0x65e12e6aUL, 0x5c41c3dbUL,  9, {
+		0xc222f245UL, 0x099f6a8fUL, 0x8ee772aeUL, 0x4441024aUL, 0x7de1effbUL,
+		0x39a0edb1UL, 0xc25cd400UL, 0x0032f097UL, 0x0032f097UL, 0x9a1ed196UL, 0x9a1ed195UL } },
+	{ 0x78815491UL, 0xd4a44057UL,  4, {
+		0x4d2594e8UL, 0xa3dd143aUL, 0x89fbfd47UL, 0x50804011UL, 0xfca554d7UL,
+		0xac2514c6UL, 0x88154910UL, 0x07881549UL, 0x07881549UL, 0x877eab6fUL, 0x877eab6eUL } },
+	{ 0x75a75f20UL, 0x0000006eUL, 14, {
+		0x75a75f8eUL, 0x75a75eb2UL, 0x8deadfc0UL, 0x00000020UL, 0x75a75f6eUL,
+		0x75a75f4eUL, 0xd7c80000UL, 0x0001d69dUL, 0x0001d69dUL, 0x8a58a0e0UL, 0x8a58a0dfUL } },
+	{ 0x562d3d5cUL, 0xc74b7a74UL, 17, {
+		0x1d78b7d0UL, 0x8ee1c2e8UL, 0x19b1a5b0UL, 0x46093854UL, 0xd76f7f7cUL,
+		0x91664728UL, 0x7ab80000UL, 0x00002b16UL, 0x00002b16UL, 0xa9d2c2a4UL, 0xa9d2c2a3UL } },
+};
+
+#define NVEC	(sizeof(vec) / sizeof(vec[0]))
+
+static unsigned long sa;
+
+int main(int argc, char *argv[])
+{
+	unsigned i;
+	unsigned long a, b, *r;
+	unsigned s;
+	long l;
+	int n;
+
+	for (i = 0; i < NVEC; i++) {
+		a = vec[i].a;
+		b = vec[i].b;
+		s = vec[i].s;
+		r = vec[i].r;
+		l = a;
+
+		CHECK(a + b == r[ADD]);
+		CHECK(a - b == r[SUB]);
+		CHECK(a * b == r[MUL]);
+		CHECK((a & b) == r[AND]);
+		CHECK((a | b) == r[OR]);
+		CHECK((a ^ b) == r[XOR]);
+		CHECK(a << s == r[SHL]);
+		CHECK(a >> s == r[SHR]);
+		CHECK((unsigned long)(l >> s) == r[ASR]);
+		CHECK(-a == r[NEG]);
+		CHECK(~a == r[COM]);
+
+		a = vec[i].a;
+		a += b;
+		CHECK(a == r[ADD]);
+		a = vec[i].a;
+		a -= b;
+		CHECK(a == r[SUB]);
+		a = vec[i].a;
+		a *= b;
+		CHECK(a == r[MUL]);
+		a = vec[i].a;
+		a <<= s;
+		CHECK(a == r[SHL]);
+		l >>= s;
+		CHECK((unsigned long)l == r[ASR]);
+
+		sa = vec[i].a;
+		sa += b;
+		CHECK(sa == r[ADD]);
+		sa = vec[i].a;
+		sa -= b;
+		CHECK(sa == r[SUB]);
+		sa = vec[i].a;
+		sa &= b;
+		CHECK(sa == r[AND]);
+		sa = vec[i].a;
+		sa |= b;
+		CHECK(sa == r[OR]);
+		sa = vec[i].a;
+		sa ^= b;
+		CHECK(sa == r[XOR]);
+		sa = vec[i].a;
+		sa >>= s;
+		CHECK(sa == r[SHR]);
+
+		/* Small constants take their own paths */
+		sa = vec[i].a;
+		CHECK(sa++ == vec[i].a);
+		CHECK(sa == vec[i].a + 1);
+		CHECK(--sa == vec[i].a);
+		CHECK(sa-- == vec[i].a);
+		CHECK(sa == vec[i].a - 1);
+		sa = vec[i].a;
+		/* X only holds the low half of a long, so these can't go
+		   that way */
+		l = vec[i].a;
+		CHECK(l++ == (long)vec[i].a);
+		CHECK(l-- == (long)(vec[i].a + 1));
+		CHECK(l == (long)vec[i].a);
+		sa += 200;
+		CHECK(sa == vec[i].a + 200);
+		sa -= 0x10000L;
+		CHECK(sa == vec[i].a + 200 - 0x10000L);
+		a = vec[i].a;
+		a += 1;
+		CHECK(a - 1 == vec[i].a);
+	}
+
+	/* An unsigned count must not make the shift unsigned */
+	n = -256;
+	s = 4;
+	n >>= s;
+	CHECK(n == -16);
+
+	/* The truth of a static long is in all four bytes */
+	sa = 0x100;
+	n = 0;
+	if (sa)
+		n = 1;
+	CHECK(n == 1);
+
+	/* A constant -1 is pushed a byte at a time on the 6800 */
+	CHECK(4294967295UL > sa);
+	return fails;
+}
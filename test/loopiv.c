@@ -0,0 +1,77 @@
+/*
+ *	For loops that index a static array. With -O the index is walked
+ *	through the array as an address and turned back into an index when
+ *	the loop ends, so the index left after the loop is checked as well
+ *	as what the loop stored.
+ *
+ *	cc: -O
+ */
+
+#include "test.h"
+
+static char c[20];
+static int v[20];
+static long l[20];
+/* Past 32K bytes, so the last offsets look negative as an int */
+static int big[16400];
+/* The loops below only use i as the index, which is what gets rewritten */
+static int n;
+
+static int fillc(void)
+{
+	int i;
+	for (i = 0; i < 20; i++)
+		c[i] = n++;
+	return i;
+}
+
+static unsigned fillv(void)
+{
+	unsigned i;
+	for (i = 3; i <= 12; ++i)
+		v[i] = n++;
+	return i;
+}
+
+static int filll(void)
+{
+	int i;
+	for (i = 0; i != 20; i++)
+		l[i] = 100000L * n++;
+	return i;
+}
+
+static int findv(int want)
+{
+	int i;
+	for (i = 0; i < 20; i++)
+		if (v[i] == want)
+			break;
+	return i;
+}
+
+static int fillbig(void)
+{
+	int i;
+	for (i = 16390; i < 16400; i++)
+		big[i] = n++;
+	return i;
+}
+
+int main(int argc, char *argv[])
+{
+	CHECK(fillc() == 20);
+	CHECK(c[0] == 0 && c[19] == 19);
+	n = 0;
+	CHECK(fillv() == 13);
+	CHECK(v[2] == 0 && v[3] == 0 && v[12] == 9 && v[13] == 0);
+	n = 0;
+	CHECK(filll() == 20);
+	CHECK(l[19] == 1900000L);
+	CHECK(findv(6) == 9);
+	CHECK(findv(-1) == 20);
+	n = 0;
+	CHECK(fillbig() == 16400);
+	CHECK(big[16399] == 9 && big[16389] == 0);
+	return fails;
+}
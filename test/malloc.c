@@ -0,0 +1,177 @@
+/*
+ *	The allocator: malloc, free, calloc, realloc, pools, arenas and
+ *	the break. A random run of mallocs and frees checks that no block
+ *	is ever handed out twice and prints how well the heap is used and
+ *	how many cycles a malloc and a free take.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <malloc.h>
+#include "test.h"
+
+extern unsigned stklimit;
+
+/* The sim68 cycle counter */
+static unsigned long cycles(void)
+{
+	volatile unsigned char *p = (volatile unsigned char *)0xFF04;
+	unsigned long c = p[0];		/* reading the first byte latches it */
+	c = (c << 8) | p[1];
+	c = (c << 8) | p[2];
+	return (c << 8) | p[3];
+}
+
+static unsigned seed = 1;
+
+static unsigned rnd(void)
+{
+	seed = seed * 25173 + 13849;
+	return seed;
+}
+
+#define SLOTS	64
+
+static char *slot[SLOTS];
+static unsigned len[SLOTS];
+static unsigned char stamp[SLOTS];
+
+static void verify(unsigned i)
+{
+	unsigned n;
+	for (n = 0; n < len[i]; n++)
+		if ((unsigned char)slot[i][n] != stamp[i]) {
+			printf("block %u overwritten\n", i);
+			fails++;
+			return;
+		}
+}
+
+struct node {
+	struct node *next;
+	int v;
+};
+
+static char abuf[100];
+
+int main(int argc, char *argv[])
+{
+	unsigned i, k, n, nm, nf, top;
+	unsigned long live, peak, tm, tf, t;
+	char *a, *b, *c, *base;
+	int *z;
+	struct pool pl;
+	struct arena ar;
+	struct node *nd[40];
+
+	base = sbrk(0);
+	CHECK((unsigned)base == stklimit);
+
+	/* Size classes and reuse */
+	a = malloc(10);
+	b = malloc(10);
+	c = malloc(100);
+	CHECK(a && b && c);
+	CHECK(b - a == 16);
+	free(a);
+	CHECK(malloc(12) == a);
+	free(0);
+	CHECK(malloc(40000) == 0);
+
+	/* realloc in place, moving and from nothing */
+	strcpy(c, "hello");
+	CHECK(realloc(c, 120) == c);
+	a = realloc(c, 200);
+	CHECK(a != c && strcmp(a, "hello") == 0);
+	CHECK(realloc(0, 5) != 0);
+
+	/* calloc clears and checks the multiply */
+	z = calloc(20, 3);
+	for (i = 0; i < 30; i++)
+		CHECK(z[i] == 0);
+	CHECK(calloc(300, 300) == 0);
+
+	/* Random churn */
+	live = peak = tm = tf = 0;
+	nm = nf = 0;
+	for (k = 0; k < 3000; k++) {
+		i = (rnd() >> 10) & (SLOTS - 1);
+		if (slot[i]) {
+			verify(i);
+			t = cycles();
+			free(slot[i]);
+			tf += cycles() - t;
+			nf++;
+			live -= len[i];
+			slot[i] = 0;
+			continue;
+		}
+		n = (rnd() >> 4) & 127;
+		if (n > 100)
+			n = (rnd() >> 6) & 511;
+		t = cycles();
+		slot[i] = malloc(n);
+		tm += cycles() - t;
+		nm++;
+		if (slot[i] == 0) {
+			printf("out of memory at %u\n", n);
+			fails++;
+			break;
+		}
+		len[i] = n;
+		stamp[i] = k;
+		memset(slot[i], k, n);
+		live += n;
+		if (live > peak)
+			peak = live;
+	}
+	for (i = 0; i < SLOTS; i++)
+		if (slot[i])
+			verify(i);
+	top = (unsigned)sbrk(0) - (unsigned)base;
+	printf("peak live %u, heap %u\n", (unsigned)peak, top);
+	printf("malloc %u cycles, free %u cycles\n", (unsigned)(tm / nm),
+		(unsigned)(tf / nf));
+
+	/* Pools */
+	pool_init(&pl, sizeof(struct node));
+	for (i = 0; i < 40; i++) {
+		nd[i] = pool_alloc(&pl);
+		nd[i]->v = i;
+	}
+	for (i = 0; i < 40; i += 2)
+		pool_free(&pl, nd[i]);
+	for (i = 0; i < 40; i += 2)
+		CHECK(pool_alloc(&pl) == nd[38 - i]);
+	for (i = 1; i < 40; i += 2)
+		CHECK(nd[i]->v == i);
+
+	/* Arenas */
+	arena_init(&ar, abuf, sizeof(abuf));
+	a = arena_alloc(&ar, 60);
+	b = arena_alloc(&ar, 30);
+	CHECK(a == abuf && b == abuf + 60);
+	CHECK(arena_alloc(&ar, 20) == 0);
+	arena_release(&ar, b);
+	CHECK(arena_alloc(&ar, 40) == b);
+
+	/* Fill the heap, sbrk must then refuse and a free 4K block be split */
+	c = malloc(4000);
+	while (malloc(1000))
+		;
+	while (malloc(500))
+		;
+	while (malloc(200))
+		;
+	CHECK(sbrk(1000) == (void *)-1);
+	CHECK(stklimit == (unsigned)sbrk(0));
+	free(c);
+	a = malloc(500);
+	b = malloc(500);
+	CHECK(a >= c && a < c + 4096 && b >= c && b < c + 4096);
+	a = malloc(1500);
+	CHECK(a >= c && a < c + 4096);
+	CHECK(brk(base - 1) == -1);
+	return fails;
+}
@@ -0,0 +1,175 @@
+/*
+ *	Multiplies by constants, which use the mulgen written mulaxN helpers
+ *	or inline shifts and adds, checked against the same multiply with
+ *	the constant in a variable so that it goes through the library.
+ *	Each constant costs a few hundred bytes on the 6800, so longs only
+ *	get a sample.
+ */
+
+#include "test.h"
+
+static int v[] = {
+	0, 1, 2, 3, 7, 100, 255, 256, 1000, 0x1234, 0x7fff, -1, -2, -300,
+	-32767 - 1
+};
+
+#define NV	(sizeof(v) / sizeof(v[0]))
+
+static long lv[] = {
+	0L, 1L, -1L, 65535L, 65536L, 0x12345678L, -100000L
+};
+
+#define NLV	(sizeof(lv) / sizeof(lv[0]))
+
+static unsigned char uc;
+static int n;
+static long l;
+
+/* A CHECK per multiply would not fit, so report the constant instead */
+static void same(int got, int want, int c)
+{
+	if (got != want) {
+		printf("* %d: %d not %d\n", c, got, want);
+		fails++;
+	}
+}
+
+static void lsame(long got, long want, int c)
+{
+	if (got != want) {
+		printf("* %d: %ld not %ld\n", c, got, want);
+		fails++;
+	}
+}
+
+#define MUL(c) \
+	for (i = 0; i < NV; i++) { \
+		x = v[i]; \
+		m = c; \
+		same(x * c, x * m, c); \
+		uc = x; \
+		same((unsigned char)(uc * c), (unsigned char)(uc * m), c); \
+		n = x; \
+		n *= c; \
+		same(n, x * m, c); \
+	}
+
+/* A char multiplied in place stays a byte, where a multiple of 256 is 0 */
+#define CMUL(c) \
+	for (i = 0; i < NV; i++) { \
+		uc = v[i]; \
+		m = c; \
+		uc *= c; \
+		same(uc, (unsigned char)(v[i] * m), c); \
+	}
+
+/* Longs do not use the helpers, so a few constants do */
+#define LMUL(c) \
+	for (i = 0; i < NLV; i++) { \
+		l = lv[i]; \
+		lm = c; \
+		lsame(l * c, l * lm, c); \
+		l *= c; \
+		lsame(l, lv[i] * lm, c); \
+	}
+
+int main(int argc, char *argv[])
+{
+	unsigned i;
+	int x, m;
+	long lm;
+
+	MUL(0);
+	MUL(1);
+	MUL(2);
+	MUL(3);
+	MUL(4);
+	MUL(5);
+	MUL(6);
+	MUL(7);
+	MUL(8);
+	MUL(9);
+	MUL(10);
+	MUL(11);
+	MUL(12);
+	MUL(13);
+	MUL(14);
+	MUL(15);
+	MUL(16);
+	MUL(17);
+	MUL(18);
+	MUL(19);
+	MUL(20);
+	MUL(21);
+	MUL(22);
+	MUL(23);
+	MUL(24);
+	MUL(25);
+	MUL(26);
+	MUL(27);
+	MUL(28);
+	MUL(29);
+	MUL(30);
+	MUL(31);
+	MUL(32);
+	MUL(33);
+	MUL(34);
+	MUL(35);
+	MUL(36);
+	MUL(37);
+	MUL(38);
+	MUL(39);
+	MUL(40);
+	MUL(41);
+	MUL(42);
+	MUL(43);
+	MUL(44);
+	MUL(45);
+	MUL(46);
+	MUL(47);
+	MUL(48);
+	MUL(49);
+	MUL(50);
+	MUL(51);
+	MUL(52);
+	MUL(53);
+	MUL(54);
+	MUL(55);
+	MUL(56);
+	MUL(57);
+	MUL(58);
+	MUL(59);
+	MUL(60);
+	MUL(61);
+	MUL(62);
+	MUL(63);
+	MUL(64);
+	MUL(65);
+	MUL(66);
+	MUL(67);
+	MUL(68);
+	MUL(69);
+	MUL(100);
+	MUL(127);
+	MUL(255);
+	MUL(256);
+	MUL(320);
+	MUL(1000);
+	MUL((-1));
+	MUL((-3));
+	MUL((-10));
+	MUL((-64));
+	CMUL(0);
+	CMUL(3);
+	CMUL(256);
+	CMUL(512);
+	LMUL(0);
+	LMUL(3);
+	LMUL(10);
+	LMUL(17);
+	LMUL(63);
+	LMUL(100);
+	LMUL(1000);
+	LMUL((-10));
+	return fails;
+}
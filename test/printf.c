@@ -0,0 +1,84 @@
+/*
+ *	printf and sprintf. Literal formats are taken apart at compile time,
+ *	so each check is made again with the format in a variable to go
+ *	through the library walker, and the results must agree.
+ *
+ *	cc: --lower-printf
+ */
+
+#include <string.h>
+#include "test.h"
+
+static char buf[40];
+static const char *fmt;
+
+int n = 42;
+int m = -1234;
+unsigned u = 65535U;
+long l = -123456789L;
+unsigned long ul = 4000000000UL;
+char *s = "abc";
+
+/* Run the same format through the library */
+#define SAME(f, a)	(fmt = f, sprintf(buf2, fmt, a), strcmp(buf, buf2) == 0)
+
+int main(int argc, char *argv[])
+{
+	char lb[24];
+	char buf2[40];
+
+	/* The buffer may be a local or a static */
+	CHECK(sprintf(lb, "%d", n) == 2);
+	CHECK(strcmp(lb, "42") == 0);
+	CHECK(sprintf(buf, "%d", n) == 2);
+	CHECK(strcmp(buf, "42") == 0);
+
+	sprintf(buf, "[%d]", m);
+	CHECK(strcmp(buf, "[-1234]") == 0 && SAME("[%d]", m));
+	sprintf(buf, "%u", u);
+	CHECK(strcmp(buf, "65535") == 0 && SAME("%u", u));
+	sprintf(buf, "%x", 0xBEEF);
+	CHECK(strcmp(buf, "beef") == 0 && SAME("%x", 0xBEEF));
+	sprintf(buf, "%X", 0xBEEF);
+	CHECK(strcmp(buf, "BEEF") == 0 && SAME("%X", 0xBEEF));
+	sprintf(buf, "%ld", l);
+	CHECK(strcmp(buf, "-123456789") == 0 && SAME("%ld", l));
+	sprintf(buf, "%lu", ul);
+	CHECK(strcmp(buf, "4000000000") == 0 && SAME("%lu", ul));
+	sprintf(buf, "%lx", ul);
+	CHECK(strcmp(buf, "ee6b2800") == 0 && SAME("%lx", ul));
+	sprintf(buf, "%c%c", 'o', 'k');
+	CHECK(strcmp(buf, "ok") == 0);
+	sprintf(buf, "<%s>", s);
+	CHECK(strcmp(buf, "<abc>") == 0 && SAME("<%s>", s));
+	sprintf(buf, "100%%");
+	CHECK(strcmp(buf, "100%") == 0);
+
+	/* Fields */
+	sprintf(buf, "%5d|", n);
+	CHECK(strcmp(buf, "   42|") == 0 && SAME("%5d|", n));
+	sprintf(buf, "%-5d|", n);
+	CHECK(strcmp(buf, "42   |") == 0 && SAME("%-5d|", n));
+	sprintf(buf, "%05d", m);
+	CHECK(strcmp(buf, "-1234") == 0 && SAME("%05d", m));
+	sprintf(buf, "%06d", m);
+	CHECK(strcmp(buf, "-01234") == 0 && SAME("%06d", m));
+	sprintf(buf, "%04x", 0x1F);
+	CHECK(strcmp(buf, "001f") == 0 && SAME("%04x", 0x1F));
+	sprintf(buf, "%-6s|", s);
+	CHECK(strcmp(buf, "abc   |") == 0 && SAME("%-6s|", s));
+
+	/* Several conversions and the count */
+	CHECK(sprintf(buf, "%d+%d=%d", n, m, n + m) == 14);
+	CHECK(strcmp(buf, "42+-1234=-1192") == 0);
+	CHECK(sprintf(buf, "%s %ld %u", s, l, u) == 20);
+	CHECK(strcmp(buf, "abc -123456789 65535") == 0);
+
+	/* Arguments with side effects are still evaluated once, in order */
+	n = 1;
+	sprintf(buf, "%d %d", n++, n++);
+	CHECK(n == 3);
+
+	CHECK(printf("printf %d\n", 7) == 9);
+	return fails;
+}
@@ -0,0 +1,46 @@
+/*
+ *	The usual conversions. Chars promote to int before anything looks
+ *	at their sign, the logical operators give an int whatever they are
+ *	applied to, and folded constants wrap to the size of their type.
+ */
+
+#include "test.h"
+
+long gl = 20958L;
+long gn = -65442L;
+int gi = 0x3a;
+int gz;
+unsigned char guc = 73;
+unsigned char gc0;
+signed char gsc = -66;
+
+int main(int argc, char *argv[])
+{
+	long l;
+
+	/* && and || are int even with a long operand */
+	CHECK((65536L < (gl || gi)) == 0);
+	CHECK((65536L < (gl && gi)) == 0);
+	CHECK((gz > !gn) == 0);
+
+	/* - and ~ promote an unsigned char to a signed int */
+	l = -guc;
+	CHECK(l == -73);
+	l = ~guc;
+	CHECK(l == -74);
+
+	/* An unsigned char doesn't make the other side unsigned */
+	CHECK(((gc0 & gi) <= -2) == 0);
+	CHECK((gc0 < -1) == 0);
+
+	/* A signed char against an unsigned constant compares unsigned */
+	CHECK((gsc <= 0x8000) == 0);
+	CHECK((gsc > 0x8000U) == 1);
+
+	/* Constants fold in the size of their type */
+	CHECK((gi | !(~4294967295UL)) == 0x3b);
+	CHECK(((~1157) <= 0xFFFF) == 1);
+	CHECK((-1 < 0x8000) == 0);
+	CHECK(-1L + 0 == 0xFFFFFFFFUL);
+	return fails;
+}
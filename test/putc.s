@@ -0,0 +1,10 @@
+;
+;	Console output for printf, on the sim68 trap page
+;
+	.export __putc
+
+	.code
+
+__putc:
+	stab	$FF00
+	rts
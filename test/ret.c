@@ -0,0 +1,139 @@
+/*
+ *	Returns. Functions without a frame return in place, but not straight
+ *	after a helper that pops its operand off the stack, as the optimizer
+ *	would turn the call and return into a jump to the helper. Returning
+ *	the result of a call becomes a jump, unless a pointer into our frame
+ *	may have been passed on.
+ */
+
+#include "test.h"
+
+int g0 = 300;
+int g1 = -7;
+long l0 = 100000L;
+
+static int mul(int a, int b)
+{
+	return a * b;
+}
+
+static int div(int a, int b)
+{
+	return a / b;
+}
+
+static unsigned shl(unsigned a, unsigned n)
+{
+	return a << n;
+}
+
+static long ladd(long a, long b)
+{
+	return a + b;
+}
+
+static long lsub(long a, long b)
+{
+	return a - b;
+}
+
+static long lmul(long a, long b)
+{
+	return a * b;
+}
+
+static int lcmp(long a, long b)
+{
+	return a <= b;
+}
+
+/* No arguments so the 6800 returns with rts as well */
+static int gmul(void)
+{
+	return g0 * g1;
+}
+
+static long gladd(void)
+{
+	return l0 + g0;
+}
+
+/* Returns on every path, so there is no shared exit code */
+static int sign(int a)
+{
+	if (a < 0)
+		return -1;
+	if (a == 0)
+		return 0;
+	return mul(a, 1) / a;
+}
+
+/* Tail calls */
+static int twice(int a)
+{
+	return a + a;
+}
+
+static int viatwice(int a)
+{
+	return twice(a + 1);
+}
+
+static int count(int n, int acc)
+{
+	if (n == 0)
+		return acc;
+	return count(n - 1, acc + 2);
+}
+
+static int deref(int *p)
+{
+	return *p;
+}
+
+static int sum(int *p)
+{
+	return p[0] + p[1];
+}
+
+static int viaparam(int x)
+{
+	return deref(&x);
+}
+
+static int vialocal(int x)
+{
+	int y = x + 1;
+	return deref(&y);
+}
+
+static int viaarray(int x)
+{
+	int a[2];
+	a[0] = x;
+	a[1] = g0;
+	return sum(a);
+}
+
+int main(int argc, char *argv[])
+{
+	CHECK(mul(g0, g1) == -2100);
+	CHECK(div(g0, g1) == -42);
+	CHECK(shl(3, 4) == 48);
+	CHECK(ladd(l0, 23456L) == 123456L);
+	CHECK(lsub(l0, 200000L) == -100000L);
+	CHECK(lmul(l0, 3L) == 300000L);
+	CHECK(lcmp(l0, 99999L) == 0);
+	CHECK(lcmp(-l0, 99999L) == 1);
+	CHECK(gmul() == -2100);
+	CHECK(gladd() == 100300L);
+	CHECK(sign(-5) == -1);
+	CHECK(sign(0) == 0);
+	CHECK(sign(g0) == 1);
+	CHECK(viatwice(g1) == -12);
+	CHECK(count(1000, g1) == 1993);
+	CHECK(viaparam(g0) == 300);
+	CHECK(vialocal(g1) == -6);
+	CHECK(viaarray(g1) == 293);
+	return fails;
+}
@@ -0,0 +1,57 @@
+/*
+ *	Long shifts by constants, checked against the same shift by a
+ *	variable so that it goes through the library. Signed right shifts
+ *	are tried with both signs.
+ */
+
+#include "test.h"
+
+static long v[] = {
+	0L, 1L, -1L, 0x12345678L, -0x12345678L, 0x7fffffffL, -0x7fffffffL - 1,
+	0x00800000L, -0x00800000L, 0x80L, -0x80L
+};
+static unsigned long uv[] = {
+	0UL, 1UL, 0x12345678UL, 0x80000000UL, 0xffffffffUL, 0x00808080UL
+};
+
+#define NV	(sizeof(v) / sizeof(v[0]))
+#define NUV	(sizeof(uv) / sizeof(uv[0]))
+
+#define SHIFT(n) \
+	d = n; \
+	for (i = 0; i < NV; i++) { \
+		CHECK(v[i] >> n == v[i] >> d); \
+		CHECK(v[i] << n == v[i] << d); \
+	} \
+	for (i = 0; i < NUV; i++) { \
+		CHECK(uv[i] >> n == uv[i] >> d); \
+		CHECK(uv[i] << n == uv[i] << d); \
+	}
+
+int main(int argc, char *argv[])
+{
+	unsigned i, d;
+
+	SHIFT(1);
+	SHIFT(3);
+	SHIFT(7);
+	SHIFT(8);
+	SHIFT(9);
+	SHIFT(12);
+	SHIFT(15);
+	SHIFT(16);
+	SHIFT(17);
+	SHIFT(23);
+	SHIFT(24);
+	SHIFT(25);
+	SHIFT(31);
+
+	/* The sign has to come down with the value */
+	CHECK((-0x12345678L >> 8) == -0x123457L);
+	CHECK((0x12345678L >> 8) == 0x123456L);
+	d = 8;
+	CHECK((v[4] >> d) == -0x123457L);
+	CHECK((v[4] >> 8) < 0);
+	CHECK((v[3] >> 8) > 0);
+	return fails;
+}
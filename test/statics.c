@@ -0,0 +1,65 @@
+/*
+ *	Statics updated in place and ints tested for truth. The 6800 has
+ *	no 16bit load that sets Z, and small adds and stores to a static
+ *	are done on the bytes, so values with a zero low byte and adds of
+ *	each size are the ones to try.
+ */
+
+#include "test.h"
+
+static int gi = 0x0100;
+static unsigned gu;
+static unsigned char uc = 0xFE;
+static signed char sc = -2;
+static int *gp = &gi;
+
+static int truth(int n)
+{
+	int r = 0;
+	if (gi)
+		r |= 1;
+	if (n)
+		r |= 2;
+	if (*gp)
+		r |= 4;
+	return r;
+}
+
+static int both(int n)
+{
+	return gi && n;
+}
+
+int main(int argc, char *argv[])
+{
+	CHECK(truth(0x8000) == 7);
+	CHECK(both(0x0200) == 1);
+	gi = 0;
+	CHECK(truth(0) == 0);
+	CHECK(both(0x0200) == 0);
+
+	gu = 124;
+	CHECK(gu == 124);
+	gu += 0;
+	CHECK(gu == 124);
+	gu += 3;
+	CHECK(gu == 127);
+	gu += 4;
+	CHECK(gu == 131);
+	gu += 300;
+	CHECK(gu == 431);
+
+	uc += 3;
+	CHECK(uc == 1);
+	uc += 5;
+	CHECK(uc == 6);
+	uc += 0x81;
+	CHECK(uc == 0x87);
+	sc += 3;
+	CHECK(sc == 1);
+	sc += 4;
+	CHECK(sc == 5);
+	sc += 0x7E;
+	CHECK(sc == -125);
+	return fails;
+}
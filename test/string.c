@@ -0,0 +1,144 @@
+/*
+ *	The string and stdlib helpers, checked against plain C versions for
+ *	each length and alignment up to a little past what the unrolled
+ *	loops handle in one go, then against some fixed answers.
+ */
+
+#include <string.h>
+#include <stdlib.h>
+#include "test.h"
+
+#define LEN	40
+
+static char a[LEN + 8];
+static char b[LEN + 8];
+static char c[LEN + 8];
+
+/* Fill with a pattern that has no zero in it */
+static void fill(char *p, unsigned n, unsigned seed)
+{
+	while (n--)
+		*p++ = 'A' + (seed++ % 26);
+}
+
+static unsigned rlen(const char *s)
+{
+	unsigned n = 0;
+	while (*s++)
+		n++;
+	return n;
+}
+
+static int rcmp(const char *s, const char *t, unsigned n)
+{
+	while (n--) {
+		if (*s != *t)
+			return (unsigned char)*s < (unsigned char)*t ? -1 : 1;
+		if (*s == 0)
+			break;
+		s++;
+		t++;
+	}
+	return 0;
+}
+
+static int sign(int n)
+{
+	if (n < 0)
+		return -1;
+	return n > 0;
+}
+
+int main(int argc, char *argv[])
+{
+	unsigned i, j;
+	char *p;
+
+	for (i = 0; i < LEN; i++) {
+		for (j = 0; j < 3; j++) {
+			/* strlen, strnlen, strchr, strrchr */
+			fill(a + j, i, i);
+			a[i + j] = 0;
+			CHECK(strlen(a + j) == i);
+			CHECK(strnlen(a + j, 5) == (i < 5 ? i : 5));
+			CHECK(strchr(a + j, 0) == a + j + i);
+			p = strchr(a + j, 'A' + i % 26);
+			CHECK(p == (i ? a + j : NULL));
+			p = strrchr(a + j, 'A' + i % 26);
+			CHECK(p == (i ? a + j + ((i - 1) / 26) * 26 : NULL));
+			CHECK(memchr(a + j, 0, i + 1) == a + j + i);
+			CHECK(memchr(a + j, 0, i) == NULL);
+			CHECK(memrchr(a + j, 'A' + i % 26, i) == p);
+
+			/* strcpy, strcmp, strncmp, memcmp */
+			memset(b, 'z', sizeof(b));
+			CHECK(strcpy(b + 1, a + j) == b + 1);
+			CHECK(rlen(b + 1) == i && b[i + 2] == 'z');
+			CHECK(strcmp(b + 1, a + j) == 0);
+			CHECK(memcmp(b + 1, a + j, i + 1) == 0);
+			if (i) {
+				b[i] = '~';
+				CHECK(sign(strcmp(b + 1, a + j)) == 1);
+				CHECK(sign(strcmp(a + j, b + 1)) == -1);
+				CHECK(sign(strncmp(a + j, b + 1, i)) == -1);
+				CHECK(strncmp(a + j, b + 1, i - 1) == 0);
+				CHECK(sign(memcmp(b + 1, a + j, i)) == 1);
+				CHECK(sign(strcmp(a + j, b + 1)) ==
+					rcmp(a + j, b + 1, LEN));
+				b[i] = 0;
+				CHECK(sign(strcmp(a + j, b + 1)) == 1);
+			}
+
+			/* strncpy pads, strlcpy truncates */
+			memset(b, 'z', sizeof(b));
+			CHECK(strncpy(b, a + j, i + 3) == b);
+			CHECK(memcmp(b, a + j, i) == 0);
+			CHECK(b[i] == 0 && b[i + 1] == 0 && b[i + 2] == 0);
+			CHECK(b[i + 3] == 'z');
+			memset(b, 'z', sizeof(b));
+			CHECK(strlcpy(b, a + j, 8) == i);
+			CHECK(rlen(b) == (i < 7 ? i : 7));
+			CHECK(rcmp(b, a + j, i < 7 ? i : 7) == 0);
+
+			/* strcat and strlcat */
+			strcpy(b, "ab");
+			CHECK(strcat(b, a + j) == b);
+			CHECK(rlen(b) == i + 2 && rcmp(b + 2, a + j, LEN) == 0);
+			strcpy(b, "ab");
+			CHECK(strlcat(b, a + j, 10) == i + 2);
+			CHECK(rlen(b) == (i < 7 ? i + 2 : 9));
+
+			/* memcpy, memmove both ways, memset, memccpy */
+			fill(c, sizeof(c), 7);
+			CHECK(memcpy(b + j, c, i) == b + j);
+			CHECK(memcmp(b + j, c, i) == 0);
+			memcpy(b, c, sizeof(b));
+			CHECK(memmove(b + j + 1, b, i) == b + j + 1);
+			CHECK(memcmp(b + j + 1, c, i) == 0);
+			memcpy(b, c, sizeof(b));
+			CHECK(memmove(b, b + j + 1, i) == b);
+			CHECK(memcmp(b, c + j + 1, i) == 0);
+			memset(b, 'z', sizeof(b));
+			CHECK(memset(b + j, 'q', i) == b + j);
+			CHECK(b[j + i] == 'z' && (j == 0 || b[j - 1] == 'z'));
+			CHECK(i == 0 || (b[j] == 'q' && b[j + i - 1] == 'q'));
+			CHECK(memccpy(b, c, c[i], LEN) == b + i % 26 + 1);
+			CHECK(memccpy(b, c, '#', i) == NULL);
+		}
+	}
+
+	CHECK(abs(0) == 0);
+	CHECK(abs(-1) == 1);
+	CHECK(abs(32767) == 32767);
+	CHECK(abs(-32767) == 32767);
+	CHECK(labs(-100000L) == 100000L);
+	CHECK(labs(65536L) == 65536L);
+	CHECK(labs(-1L) == 1L);
+	CHECK(atoi("0") == 0);
+	CHECK(atoi("  123") == 123);
+	CHECK(atoi("-32768") == -32767 - 1);
+	CHECK(atoi("+42x") == 42);
+	CHECK(atoi("9999") == 9999);
+	CHECK(atoi("-") == 0);
+	return fails;
+}
@@ -0,0 +1,10 @@
+/*
+ *	Shared by the regression tests
+ */
+
+extern int printf(const char *, ...);
+extern int sprintf(char *, const char *, ...);
+
+static int fails;
+
+#define CHECK(x)	do { if (!(x)) { printf("%d: %s\n", __LINE__, #x); fails++; } } while (0)
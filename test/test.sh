@@ -0,0 +1,40 @@
+#!/bin/sh
+#
+#	test.sh "cpus" "programs"
+#
+#	Build each program for each cpu with the staged compiler driver,
+#	run it under sim68 and report it as passed if it ran to the end
+#	and returned 0. Extra compiler options for a program are given on
+#	a line of its source starting " *	cc:". The output of a run is left
+#	in out/cpu/program.out.
+#
+
+SIM=../as68/sim68
+LIMIT=200000000
+
+fail=0
+for cpu in $1; do
+	mkdir -p out/$cpu
+	fmt=stage/lib/libfmt$cpu.a
+	[ $cpu = 6303 ] && fmt=stage/lib/libfmt6803.a
+	for prog in $2; do
+		bin=out/$cpu/$prog
+		rm -f $bin $bin.map
+		opts=`sed -n 's/^ \*	cc:[ 	]*//p' $prog.c`
+		if ! ./cc68 -m$cpu -M $opts -o $bin $prog.c putc.s $fmt >$bin.log 2>&1; then
+			echo "$cpu $prog: build failed"
+			fail=1
+			continue
+		fi
+		$SIM -c $cpu -n $LIMIT -m $bin.map $bin >$bin.out 2>$bin.err
+		status=$?
+		if [ $status -ne 0 ]; then
+			echo "$cpu $prog: FAIL ($status)"
+			sed '/^$/q' $bin.err | cat $bin.out - | sed 's/^/	/;20q'
+			fail=1
+		else
+			echo "$cpu $prog: ok"
+		fi
+	done
+done
+exit $fail
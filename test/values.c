@@ -0,0 +1,116 @@
+/*
+ *	Register value tracking. The compiler remembers what D and X hold
+ *	to skip reloads, and copt rewrites loads around the ;invalid DP
+ *	and ;invalid XDP markers, so the two must agree on what is live.
+ */
+
+#include <stdlib.h>
+#include "test.h"
+
+int g0 = 2;
+int g2;
+int g3;
+unsigned long g1 = 0x12345678UL;
+long g7 = 0x0F0F0F0FL;
+
+static int sum(int a, int b)
+{
+	return a + b;
+}
+
+/* Each pushes a copy of a local that is still in D and then uses D */
+static unsigned xorself(unsigned l)
+{
+	l ^= (l - 36292L);
+	return l;
+}
+
+static long andself(int a, long p1)
+{
+	p1 &= (unsigned long)p1;
+	return p1 + a;
+}
+
+static int subnot(int a1, int a2)
+{
+	a1 -= (!g3);
+	return a1 + a2;
+}
+
+static void andmul(int x)
+{
+	g1 &= x * 4294967295UL;
+}
+
+static void xorsum(int x, long y)
+{
+	g7 ^= x + y;
+}
+
+/* Widening the int on the stack must leave the long in D alone */
+static int widen(int a, long l)
+{
+	return a < (l | g3);
+}
+
+static int uwiden(unsigned a, long l)
+{
+	return a < (l | g3);
+}
+
+/* The 6800 loads a constant a byte at a time, so one with two different
+   non zero bytes is loaded into each half separately */
+static unsigned konst(void)
+{
+	return 0x1234;
+}
+
+static void zero_and(void)
+{
+	int l;
+	l = 0;
+	g2 = l & g0;
+}
+
+int main(int argc, char *argv[])
+{
+	int l;
+	char *p;
+
+	zero_and();
+	CHECK(g2 == 0);
+
+	l = 0;
+	g2 = l & g0;
+	CHECK(g2 == 0);
+	l = 5;
+	g2 = l | g0;
+	CHECK(g2 == 7);
+
+	/* The same constant pushed twice */
+	CHECK(sum(300, 300) == 600);
+	CHECK(sum(g0, g0) == 4);
+	CHECK(xorself(5) == 0x7244);
+	CHECK(xorself(0) == 0x723C);
+	CHECK(andself(1, 0x80001234L) == (long)0x80001235L);
+	CHECK(subnot(10, 1) == 10);
+	andmul(1);
+	CHECK(g1 == 0x12345678UL);
+	andmul(-0x7F);
+	CHECK(g1 == 0x78);
+	xorsum(1, 0x100000L);
+	CHECK(g7 == (0x0F0F0F0FL ^ 0x100001L));
+	CHECK(widen(1, 0x100) == 1);
+	CHECK(widen(-1, 0x100) == 1);
+	CHECK(widen(-1, -2L) == 0);
+	CHECK(uwiden(1, 0x100) == 1);
+	CHECK(uwiden(0xFFFF, 0x100) == 0);
+	CHECK(uwiden(0x180, 0x1FF) == 1);
+	CHECK(konst() == 0x1234);
+	g2 = -0x1235;
+	CHECK((g2 >> 8) == -0x13 && (g2 & 0xFF) == 0xCB);
+	p = calloc(300, 300);
+	CHECK(p == 0);
+
+	return fails;
+}